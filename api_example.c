@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <poll.h>
+#include "kernel/api/myos_api.h"
+
+/**
+ * @brief 嵌入式C接口示例（C语言调用方）
+ * @details 创建运行时与x86 VM并订阅执行结束事件，同步执行并拍快照，再提交异步执行、
+ *          通过事件fd等待完成，取出订阅收到的事件，最后恢复快照并读取指标。编译方式见readme“嵌入式库与C接口”一节
+ */
+
+#define CHECK(call)                                                                 \
+    do {                                                                            \
+        myos_status status_ = (call);                                               \
+        if (status_ != MYOS_OK) {                                                   \
+            fprintf(stderr, "%s failed: %s\n", #call, myos_status_name(status_));   \
+            exit(1);                                                                \
+        }                                                                           \
+    } while (0)
+
+int main(void) {
+    /* NOP、INC EAX、ADD EAX,EBX 交替的载荷 */
+    unsigned char payload[256];
+    size_t i;
+    for (i = 0; i < sizeof(payload); i++) {
+        payload[i] = (unsigned char)(i % 3 == 0 ? 0x00 : (i % 3 == 1 ? 0x04 : 0x02));
+    }
+
+    myos_runtime_config config;
+    myos_runtime_config_init(&config);
+    config.async_workers = 2;
+
+    myos_runtime* runtime = NULL;
+    CHECK(myos_runtime_create(&config, &runtime));
+    printf("C API version %u\n", myos_api_version());
+
+    myos_vm* vm = NULL;
+    CHECK(myos_vm_create(runtime, MYOS_ARCH_X86, payload, sizeof(payload), &vm));
+    CHECK(myos_vm_start(vm));
+    myos_subscription* subscription = NULL;
+    CHECK(myos_event_subscribe(runtime, myos_vm_id(vm), MYOS_EVENT_MASK(MYOS_EVENT_RUN_COMPLETE), 0, &subscription));
+
+    uint32_t executed = 0;
+    CHECK(myos_vm_run(vm, 10, &executed));
+    myos_snapshot* snapshot = NULL;
+    CHECK(myos_snapshot_capture(vm, &snapshot));
+    printf("snapshot after %u instructions: %zu bytes\n", executed, myos_snapshot_size(snapshot));
+
+    uint64_t ticket = 0;
+    CHECK(myos_vm_run_async(vm, 50, NULL, NULL, &ticket));
+    int fd = myos_runtime_event_fd(runtime);
+    myos_completion completion;
+    size_t received = 0;
+    while (received == 0) {
+        if (fd >= 0) {
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            poll(&pfd, 1, 1000);
+        }
+        received = myos_runtime_poll_completions(runtime, &completion, 1);
+    }
+    printf("async ticket %llu: %s, executed %u\n", (unsigned long long)completion.ticket,
+           myos_status_name((myos_status)completion.status), completion.executed);
+
+    /* 同步与异步执行各产生一个执行结束事件 */
+    myos_event events[8];
+    size_t event_count = myos_subscription_poll(subscription, events, 8);
+    for (i = 0; i < event_count; i++) {
+        printf("event: vm %u type %u executed %llu\n", events[i].vm_id, (unsigned)events[i].type,
+               (unsigned long long)events[i].detail);
+    }
+
+    myos_vm_info info;
+    memset(&info, 0, sizeof(info));
+    info.struct_size = sizeof(info);
+    CHECK(myos_vm_get_info(vm, &info));
+    printf("before restore: pc=%llu instructions=%llu\n", (unsigned long long)info.pc,
+           (unsigned long long)info.instructions);
+    CHECK(myos_snapshot_restore(vm, snapshot));
+    CHECK(myos_vm_get_info(vm, &info));
+    printf("after restore:  pc=%llu instructions=%llu\n", (unsigned long long)info.pc,
+           (unsigned long long)info.instructions);
+
+    myos_metrics metrics;
+    memset(&metrics, 0, sizeof(metrics));
+    metrics.struct_size = sizeof(metrics);
+    CHECK(myos_runtime_get_metrics(runtime, &metrics));
+    printf("metrics: vms=%u instructions=%llu async=%llu/%llu\n", metrics.vm_count,
+           (unsigned long long)metrics.instructions_executed, (unsigned long long)metrics.async_completed,
+           (unsigned long long)metrics.async_submitted);
+
+    myos_event_unsubscribe(subscription);
+    myos_snapshot_destroy(snapshot);
+    myos_vm_destroy(vm);
+    myos_runtime_destroy(runtime);
+    return 0;
+}
@@ -0,0 +1,239 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "kernel/control/control_protocol.h"
+#include "kernel/CPUvm/vmEvent.h"
+
+/**
+ * @brief 控制套接字命令行客户端
+ * @details 从标准输入逐行读取控制台命令（或由命令行给出一条），全部流水线发送后再读取响应，
+ *          可重复发送以测试控制服务吞吐；--subscribe先订阅VM事件、--watch先请求状态变化推送，
+ *          命令响应之后继续打印推送的内容。
+ *          只支持Unix-like平台
+ */
+
+namespace {
+
+void showUsage(const char* program) {
+    std::cout << "Usage: " << program << " <socket> [--quiet] [--repeat N] [--subscribe SPEC] [--watch MS] [--events N] [command...]"
+              << std::endl;
+    std::cout << "  Commands are read from stdin, one per line, unless given as arguments." << std::endl;
+    std::cout << "  --subscribe SPEC  Subscribe to VM events first; SPEC is \"<vmId|*> [halted fault limit run stopped swap]\""
+              << std::endl;
+    std::cout << "  --watch MS        Stream changed VM states, core owners and counter deltas every MS milliseconds"
+              << std::endl;
+    std::cout << "  --events N        Exit after N events or watch updates (default: until the server disconnects)"
+              << std::endl;
+    std::cout << "  --quiet     Do not request command output (status only)" << std::endl;
+    std::cout << "  --repeat N  Send the command list N times (pipelined) and report throughput" << std::endl;
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t sent = write(fd, data, length);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        length -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool readAll(int fd, uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t received = read(fd, data, length);
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        length -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        showUsage(argv[0]);
+        return 2;
+    }
+
+    std::string socketPath = argv[1];
+    bool quiet = false;
+    uint32_t repeat = 1;
+    std::string inlineCommand;
+    std::string subscribeSpec;
+    std::string watchInterval;
+    uint64_t eventLimit = 0;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--quiet") {
+            quiet = true;
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+            if (repeat == 0) {
+                repeat = 1;
+            }
+        } else if (arg == "--subscribe" && i + 1 < argc) {
+            subscribeSpec = argv[++i];
+        } else if (arg == "--watch" && i + 1 < argc) {
+            watchInterval = argv[++i];
+        } else if (arg == "--events" && i + 1 < argc) {
+            eventLimit = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--help") {
+            showUsage(argv[0]);
+            return 0;
+        } else {
+            inlineCommand += (inlineCommand.empty() ? "" : " ") + arg;
+        }
+    }
+
+    std::vector<std::string> commands;
+    if (!inlineCommand.empty()) {
+        commands.push_back(inlineCommand);
+    } else if ((subscribeSpec.empty() && watchInterval.empty()) || !isatty(STDIN_FILENO)) {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            if (!line.empty() && line[0] != '#') {
+                commands.push_back(line);
+            }
+        }
+    }
+    if (commands.empty() && subscribeSpec.empty() && watchInterval.empty()) {
+        std::cerr << "Error: no commands" << std::endl;
+        return 2;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Error: cannot connect to " << socketPath << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+
+    // 所有请求编码到一个缓冲区后一次发送（流水线），订阅/watch请求在最前面
+    std::vector<uint8_t> requests;
+    uint32_t requestId = 0;
+    auto appendRequest = [&](ControlOpcode opcode, const std::string& body) {
+        S_ControlRequestHeader header;
+        header.length = static_cast<uint32_t>(CONTROL_HEADER_BODY + body.size());
+        header.requestId = requestId++;
+        header.opcode = static_cast<uint16_t>(opcode);
+        header.flags = quiet ? CONTROL_FLAG_QUIET : 0;
+        size_t offset = requests.size();
+        requests.resize(offset + sizeof(header) + body.size());
+        memcpy(&requests[offset], &header, sizeof(header));
+        memcpy(&requests[offset + sizeof(header)], body.data(), body.size());
+    };
+    if (!subscribeSpec.empty()) {
+        appendRequest(ControlOpcode::SUBSCRIBE, subscribeSpec);
+    }
+    uint32_t watchRequestId = requestId;
+    if (!watchInterval.empty()) {
+        appendRequest(ControlOpcode::WATCH, watchInterval);
+    }
+    for (uint32_t round = 0; round < repeat; round++) {
+        for (const auto& command : commands) {
+            appendRequest(ControlOpcode::COMMAND, command);
+        }
+    }
+
+    // 发送与接收并行，服务端因响应积压暂停读取时不会互相等待
+    auto start = std::chrono::steady_clock::now();
+    std::thread sender([fd, &requests]() {
+        if (!writeAll(fd, requests.data(), requests.size())) {
+            std::cerr << "Error: failed to send requests" << std::endl;
+        }
+        shutdown(fd, SHUT_WR);
+    });
+
+    // 推送帧与命令响应交错到达；订阅/watch时读完全部响应后继续读推送
+    uint32_t failed = 0;
+    uint32_t responses = 0;
+    uint64_t eventCount = 0;
+    uint64_t watchCount = 0;
+    bool subscribed = false;
+    bool watching = false;
+    std::vector<char> output;
+    while (responses < requestId ||
+           ((subscribed || watching) && (eventLimit == 0 || eventCount + watchCount < eventLimit))) {
+        S_ControlResponseHeader header;
+        if (!readAll(fd, reinterpret_cast<uint8_t*>(&header), sizeof(header)) ||
+            header.length < CONTROL_HEADER_BODY || header.length > CONTROL_MAX_FRAME) {
+            if (responses < requestId) {
+                std::cerr << "Error: connection closed after " << responses << " responses" << std::endl;
+                failed += requestId - responses;
+            }
+            break;
+        }
+        output.resize(header.length - CONTROL_HEADER_BODY);
+        if (!output.empty() && !readAll(fd, reinterpret_cast<uint8_t*>(output.data()), output.size())) {
+            std::cerr << "Error: truncated response" << std::endl;
+            failed += requestId - responses;
+            break;
+        }
+
+        ControlStatus status = static_cast<ControlStatus>(header.status);
+        if (status == ControlStatus::EVENT) {
+            for (size_t offset = 0; offset + sizeof(S_VmEvent) <= output.size(); offset += sizeof(S_VmEvent)) {
+                S_VmEvent event;
+                memcpy(&event, &output[offset], sizeof(event));
+                std::cout << "[event] vm " << event.vmId << " "
+                          << GetVmEventName(static_cast<VmEventType>(event.type)) << " detail " << event.detail
+                          << " vtime " << event.virtualTime << std::endl;
+                eventCount++;
+            }
+            continue;
+        }
+        if (status == ControlStatus::WATCH) {
+            std::cout.write(output.data(), output.size());
+            std::cout.flush();
+            watchCount++;
+            continue;
+        }
+        if (!subscribeSpec.empty() && header.requestId == 0) {
+            subscribed = status == ControlStatus::OK;
+        }
+        if (!watchInterval.empty() && header.requestId == watchRequestId) {
+            watching = status == ControlStatus::OK;
+        }
+        responses++;
+        if (status != ControlStatus::OK) {
+            failed++;
+        }
+        if (repeat == 1 || status != ControlStatus::OK) {
+            std::cout << "[" << header.requestId << "] " << GetControlStatusName(status) << std::endl;
+            std::cout.write(output.data(), output.size());
+        }
+    }
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    shutdown(fd, SHUT_RDWR);
+    sender.join();
+    close(fd);
+
+    if (subscribed) {
+        std::cout << eventCount << " events received" << std::endl;
+    }
+    if (watching) {
+        std::cout << watchCount << " watch updates received" << std::endl;
+    }
+    if (repeat > 1) {
+        std::cout << requestId << " requests in " << elapsedMs << " ms ("
+                  << static_cast<uint64_t>(requestId / (elapsedMs / 1000.0)) << " req/s), failed " << failed
+                  << std::endl;
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include "kernel/CPUvm/x86Vm.h"
+#include "kernel/CPUvm/armVm.h"
+#include "kernel/CPUvm/x64Vm.h"
+#include "kernel/fuzz/differential.h"
+#include "kernel/payload/payload_generator.h"
+
+/**
+ * @brief 执行方式之间的差分测试工具
+ * @details 按种子生成随机载荷与初始状态，参照方式与被检查方式锁步执行，每个块边界比较完整状态，
+ *          出现不一致时输出第一条不一致的指令、状态项与两侧的值，以及复现用的命令行。
+ *          --candidate all（默认）依次检查参照方式以外的所有方式。
+ *          --profile fuzz（默认）为任意已实现指令的随机序列；其余为载荷生成器的预设
+ *          （mixed/alu/memory/loops，带请求表、计数循环与中断处理程序的合法载荷）。
+ *          --dump写出的是载荷容器，可直接用vm create加载。
+ *          退出码：0=全部一致，1=发现不一致或无法运行，2=用法错误。
+ *
+ * 用法：diff_test <x86|arm|x64> [--reference E] [--candidate E|all] [--profile P] [--payloads N] [--length L]
+ *                 [--seed S] [--block B] [--instructions M] [--memory BYTES] [--stride K] [--dump FILE]
+ */
+namespace {
+
+const uint32_t DEFAULT_PAYLOADS = 200;
+const uint32_t DEFAULT_LENGTH = 256;
+
+std::shared_ptr<I_VmInterface> CreateVm(const std::string& type, uint32_t vmId) {
+    if (type == "x86") {
+        return std::make_shared<X86Vm>(vmId);
+    }
+    if (type == "arm") {
+        return std::make_shared<ArmVm>(vmId);
+    }
+    if (type == "x64") {
+        return std::make_shared<X64Vm>(vmId);
+    }
+    return nullptr;
+}
+
+bool WriteFile(const std::string& path, const S_PayloadImage& payload) {
+    std::vector<uint8_t> data;
+    PayloadEncode(payload, data);
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief 按profile生成第seed个载荷（访问窗口取客户机内存的一半）
+ */
+bool GeneratePayload(const std::string& type, const std::string& profile, uint32_t length, uint32_t memorySize,
+                     uint64_t seed, S_PayloadImage& payload, std::string& error) {
+    if (profile == "fuzz") {
+        payload = S_PayloadImage();
+        payload.architecture = type;
+        payload.seed = seed;
+        return GenerateDiffPayload(type, length, seed, payload.code);
+    }
+    S_PayloadGenConfig config;
+    config.architecture = type;
+    config.seed = seed;
+    config.instructions = length;
+    if (!PayloadGenerator::applyProfile(profile, config)) {
+        error = "unknown profile: " + profile;
+        return false;
+    }
+    config.memoryWindow = memorySize / 2;
+    config.accessBytes = std::min(config.accessBytes, config.memoryWindow);
+    return PayloadGenerator::generate(config, payload, error);
+}
+
+void PrintDivergence(const std::string& type, const std::string& profile, uint32_t length, DiffEngine reference,
+                     DiffEngine candidate, uint64_t seed, const S_DiffDivergence& divergence) {
+    std::cout << "DIVERGENCE (payload seed " << seed << "): ";
+    if (divergence.singleStep) {
+        std::cout << "instruction " << divergence.instruction;
+    } else {
+        std::cout << "block starting at instruction " << divergence.instruction
+                  << " (not reproducible by single-stepping)";
+    }
+    std::cout << " in block " << divergence.block << ", pc 0x" << std::hex << divergence.pc << std::endl
+              << "  " << divergence.field << ": " << GetDiffEngineName(reference) << "=0x"
+              << divergence.referenceValue << " " << GetDiffEngineName(candidate) << "=0x"
+              << divergence.candidateValue << std::dec << std::endl
+              << "  reproduce: diff_test " << type << " --reference " << GetDiffEngineName(reference)
+              << " --candidate " << GetDiffEngineName(candidate) << " --profile " << profile << " --length "
+              << length << " --seed " << seed << " --payloads 1" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || !CreateVm(argv[1], 0)) {
+        std::cerr << "Usage: " << argv[0] << " <x86|arm|x64> [--reference E] [--candidate E|all] [--profile P]"
+                  << " [--payloads N]"
+                  << " [--length L] [--seed S] [--block B] [--instructions M] [--memory BYTES] [--stride K]"
+                  << " [--dump FILE]" << std::endl;
+        std::cerr << "Engines: step, batch, traced, cow, debug" << std::endl;
+        std::cerr << "Profiles: fuzz, mixed, alu, memory, loops" << std::endl;
+        return 2;
+    }
+    std::string type = argv[1];
+    S_DiffConfig config;
+    std::string candidateName = "all";
+    std::string profile = "fuzz";
+    uint32_t payloads = DEFAULT_PAYLOADS;
+    uint32_t length = DEFAULT_LENGTH;
+    uint64_t seed = 1;
+    std::string dumpFile;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return 2;
+        }
+        std::string value = argv[++i];
+        uint32_t number = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 0));
+        if (arg == "--reference") {
+            if (!ParseDiffEngine(value, config.reference)) {
+                std::cerr << "Unknown engine: " << value << std::endl;
+                return 2;
+            }
+        } else if (arg == "--candidate") {
+            candidateName = value;
+        } else if (arg == "--profile") {
+            profile = value;
+        } else if (arg == "--payloads") {
+            payloads = number;
+        } else if (arg == "--length") {
+            length = number;
+        } else if (arg == "--seed") {
+            seed = std::strtoull(value.c_str(), nullptr, 0);
+        } else if (arg == "--block") {
+            config.blockInstructions = number;
+        } else if (arg == "--instructions") {
+            config.maxInstructions = number;
+        } else if (arg == "--memory") {
+            config.memorySize = number;
+        } else if (arg == "--stride") {
+            config.breakpointStride = number;
+        } else if (arg == "--dump") {
+            dumpFile = value;
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 2;
+        }
+    }
+    if (length == 0) {
+        std::cerr << "Payload length must be positive" << std::endl;
+        return 2;
+    }
+    S_PayloadImage payload;
+    std::string error;
+    if (!GeneratePayload(type, profile, length, config.memorySize, seed, payload, error)) {
+        std::cerr << "Invalid payload settings: " << error << std::endl;
+        return 2;
+    }
+
+    std::vector<DiffEngine> candidates;
+    for (uint8_t i = 0; i < static_cast<uint8_t>(DiffEngine::COUNT); i++) {
+        DiffEngine engine = static_cast<DiffEngine>(i);
+        if (candidateName == "all" ? engine != config.reference : candidateName == GetDiffEngineName(engine)) {
+            candidates.push_back(engine);
+        }
+    }
+    if (candidates.empty()) {
+        std::cerr << "Unknown engine: " << candidateName << std::endl;
+        return 2;
+    }
+
+    bool diverged = false;
+    for (DiffEngine engine : candidates) {
+        config.candidate = engine;
+        uint32_t nextVmId = 1;
+        DifferentialRunner runner(config, [&type, &nextVmId]() { return CreateVm(type, nextVmId++); });
+        if (!runner.prepare(error)) {
+            std::cerr << "FAILED: " << error << std::endl;
+            return 1;
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < payloads; i++) {
+            uint64_t payloadSeed = seed + i;
+            S_DiffDivergence divergence;
+            GeneratePayload(type, profile, length, config.memorySize, payloadSeed, payload, error);
+            if (!runner.run(payload, payloadSeed, divergence, error)) {
+                std::cerr << "FAILED: " << error << std::endl;
+                return 1;
+            }
+            if (divergence.found) {
+                PrintDivergence(type, profile, length, config.reference, engine, payloadSeed, divergence);
+                if (!dumpFile.empty() && !diverged) {
+                    std::cout << "  payload written to " << dumpFile
+                              << (WriteFile(dumpFile, payload) ? "" : " (FAILED)") << std::endl;
+                }
+                diverged = true;
+                break;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        const S_DiffStats& stats = runner.getStats();
+        std::cout << type << " " << profile << " " << GetDiffEngineName(config.reference) << " vs " << GetDiffEngineName(engine)
+                  << ": " << stats.payloads << " payloads, " << stats.instructions << " instructions, "
+                  << stats.blocks << " block boundaries compared, " << stats.divergences << " divergent ("
+                  << std::fixed << std::setprecision(2) << seconds << " s)" << std::endl;
+    }
+    return diverged ? 1 : 0;
+}
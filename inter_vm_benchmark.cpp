@@ -0,0 +1,321 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include "kernel/Cross_PlatformUnifiedMacro.h"
+#include "kernel/CPUvm/x86Vm.h"
+#include "kernel/device/virtual_network.h"
+#include "kernel/memory/shared_memory.h"
+
+/**
+ * @brief VM间通信基准测试
+ * @details 两个VM分别运行在VM核池的不同核心上（核2/核3），虚拟交换机运行在核1，
+ *          测量虚拟网络的吞吐与往返延迟，以及共享内存消息环相对memcpy的带宽
+ */
+class InterVmBenchmark {
+private:
+    static const uint32_t GUEST_MEMORY_SIZE = 4 * 1024 * 1024;  // 每个VM的客户机内存
+    static const uint32_t TX_AREA = 0;                          // 发送缓冲区起始地址
+    static const uint32_t RX_AREA = 2 * 1024 * 1024;            // 接收缓冲区起始地址
+    static const uint32_t RX_BUFFERS = 512;                     // 接收缓冲数量
+    static const uint32_t SHM_REGION_SIZE = 8 * 1024 * 1024;    // 共享区域大小
+    static const uint32_t SHM_ADDR = GUEST_MEMORY_SIZE;         // 共享区域映射地址（私有内存之上）
+    static const uint32_t DOORBELL_BATCH = 64;                  // 每提交多少条消息敲一次门铃
+
+    std::shared_ptr<X86Vm> vmA;
+    std::shared_ptr<X86Vm> vmB;
+    int coreA;
+    int coreB;
+
+    static uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static void pinTo(int coreId, const char* who) {
+        if (SetThreadCPUAffinity(coreId) != 0) {
+            std::cerr << "Warning: " << who << " could not be pinned to core " << coreId << std::endl;
+        }
+    }
+
+    static void postAllRxBuffers(VirtualNic& nic) {
+        for (uint32_t i = 0; i < RX_BUFFERS; i++) {
+            nic.postRxBuffer(RX_AREA + i * VirtualNic::MTU);
+        }
+    }
+
+public:
+    InterVmBenchmark() : vmA(std::make_shared<X86Vm>(1)), vmB(std::make_shared<X86Vm>(2)),
+                         coreA(2), coreB(3) {
+        vmA->getMemory().allocate(GUEST_MEMORY_SIZE, GUEST_PERM_RW, GUEST_MEMORY_SIZE + SHM_REGION_SIZE);
+        vmB->getMemory().allocate(GUEST_MEMORY_SIZE, GUEST_PERM_RW, GUEST_MEMORY_SIZE + SHM_REGION_SIZE);
+    }
+
+    /**
+     * @brief 单向吞吐测试：VM A持续发送，VM B持续接收并归还缓冲
+     */
+    void runThroughputTest(uint32_t packetSize, uint32_t packetCount, uint32_t coalescePackets) {
+        std::cout << "\n=== Throughput: " << packetSize << " B packets, coalesce "
+                  << coalescePackets << " ===" << std::endl;
+
+        VirtualSwitch vSwitch;
+        std::shared_ptr<VirtualNic> nicA(new VirtualNic(1, vmA->getMemory()));
+        std::shared_ptr<VirtualNic> nicB(new VirtualNic(2, vmB->getMemory()));
+        nicB->setCoalescing(coalescePackets, 100);
+
+        std::atomic<uint64_t> notifications(0);
+        nicB->setRxNotifier([&notifications](uint32_t) {
+            notifications.fetch_add(1, std::memory_order_relaxed);
+        });
+
+        postAllRxBuffers(*nicB);
+        vSwitch.attach(nicA);
+        vSwitch.attach(nicB);
+        vSwitch.start(1);
+
+        // 发送端数据填充
+        uint8_t* txData = vmA->getMemory().translate(TX_AREA, packetSize, GUEST_PERM_WRITE);
+        for (uint32_t i = 0; i < packetSize; i++) {
+            txData[i] = static_cast<uint8_t>(i);
+        }
+
+        std::atomic<uint64_t> received(0);
+        uint64_t startNs = nowNs();
+
+        std::thread receiver([&]() {
+            pinTo(coreB, "receiver");
+            S_NetPacketDesc batch[64];
+            uint64_t count = 0;
+            while (count < packetCount) {
+                size_t n = nicB->receive(batch, 64);
+                for (size_t i = 0; i < n; i++) {
+                    nicB->postRxBuffer(batch[i].guestAddr);
+                }
+                count += n;
+                received.store(count, std::memory_order_relaxed);
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        std::thread sender([&]() {
+            pinTo(coreA, "sender");
+            uint32_t sent = 0;
+            while (sent < packetCount) {
+                // 控制在途包数不超过接收缓冲数量，避免接收端丢包
+                if (nicA->getTxSubmitted() - received.load(std::memory_order_relaxed) >= RX_BUFFERS / 2) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (nicA->transmit(TX_AREA, packetSize, 2)) {
+                    sent++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        sender.join();
+        receiver.join();
+        uint64_t elapsedNs = nowNs() - startNs;
+        vSwitch.stop();
+
+        double seconds = elapsedNs / 1e9;
+        double pps = packetCount / seconds;
+        S_NicStats stats = nicB->getStats();
+        std::cout << "Packets: " << packetCount << " in " << (elapsedNs / 1000000.0) << " ms" << std::endl;
+        std::cout << "Throughput: " << pps << " pkts/s, "
+                  << (pps * packetSize / (1024.0 * 1024.0)) << " MB/s" << std::endl;
+        std::cout << "Receiver notifications: " << notifications.load()
+                  << " (" << (stats.rxPackets / std::max<uint64_t>(1, notifications.load()))
+                  << " pkts per wakeup), dropped " << stats.rxDropped << std::endl;
+    }
+
+    /**
+     * @brief 往返延迟测试：A发送，B收到后立即回送，A统计往返时间
+     */
+    void runLatencyTest(uint32_t packetSize, uint32_t rounds) {
+        std::cout << "\n=== Latency: " << packetSize << " B ping-pong, "
+                  << rounds << " rounds ===" << std::endl;
+
+        VirtualSwitch vSwitch;
+        std::shared_ptr<VirtualNic> nicA(new VirtualNic(1, vmA->getMemory()));
+        std::shared_ptr<VirtualNic> nicB(new VirtualNic(2, vmB->getMemory()));
+        postAllRxBuffers(*nicA);
+        postAllRxBuffers(*nicB);
+        vSwitch.attach(nicA);
+        vSwitch.attach(nicB);
+        vSwitch.start(1);
+
+        std::vector<uint64_t> samples;
+        samples.reserve(rounds);
+
+        std::thread echo([&]() {
+            pinTo(coreB, "echo");
+            S_NetPacketDesc desc;
+            for (uint32_t i = 0; i < rounds; i++) {
+                while (nicB->receive(&desc, 1) == 0) {
+                    std::this_thread::yield();
+                }
+                // 直接把接收缓冲作为发送缓冲回送，等待发送完成后再归还
+                uint64_t target = nicB->getTxSubmitted() + 1;
+                while (!nicB->transmit(desc.guestAddr, desc.length, 1)) {
+                    std::this_thread::yield();
+                }
+                while (nicB->getTxCompleted() < target) {
+                    std::this_thread::yield();
+                }
+                nicB->postRxBuffer(desc.guestAddr);
+            }
+        });
+
+        std::thread pinger([&]() {
+            pinTo(coreA, "pinger");
+            S_NetPacketDesc desc;
+            for (uint32_t i = 0; i < rounds; i++) {
+                uint64_t begin = nowNs();
+                while (!nicA->transmit(TX_AREA, packetSize, 2)) {
+                    std::this_thread::yield();
+                }
+                while (nicA->receive(&desc, 1) == 0) {
+                    std::this_thread::yield();
+                }
+                samples.push_back(nowNs() - begin);
+                nicA->postRxBuffer(desc.guestAddr);
+            }
+        });
+
+        pinger.join();
+        echo.join();
+        vSwitch.stop();
+
+        std::sort(samples.begin(), samples.end());
+        uint64_t total = 0;
+        for (uint64_t s : samples) {
+            total += s;
+        }
+        std::cout << "RTT avg: " << (total / samples.size() / 1000.0) << " us" << std::endl;
+        std::cout << "RTT p50: " << (samples[samples.size() / 2] / 1000.0) << " us" << std::endl;
+        std::cout << "RTT p99: " << (samples[samples.size() * 99 / 100] / 1000.0) << " us" << std::endl;
+        std::cout << "RTT max: " << (samples.back() / 1000.0) << " us" << std::endl;
+    }
+
+    /**
+     * @brief 共享内存吞吐测试：A把私有内存中的数据写入共享环槽（唯一一次拷贝），
+     *        B原地读取，与同尺寸单线程memcpy带宽对比
+     */
+    void runSharedMemoryTest(uint32_t messageSize, uint32_t messageCount) {
+        std::cout << "\n=== Shared memory ring: " << messageSize << " B messages, "
+                  << messageCount << " messages ===" << std::endl;
+
+        SharedMemoryManager shm;
+        shm.createRegion("bench", SHM_REGION_SIZE);
+        shm.mapRegion("bench", vmA.get(), SHM_ADDR, GUEST_PERM_RW);
+        shm.mapRegion("bench", vmB.get(), SHM_ADDR, GUEST_PERM_RW);
+
+        // 两端各自通过自己的客户机映射访问同一段内存
+        uint8_t* baseA = vmA->getMemory().translate(SHM_ADDR, SHM_REGION_SIZE, GUEST_PERM_RW);
+        uint8_t* baseB = vmB->getMemory().translate(SHM_ADDR, SHM_REGION_SIZE, GUEST_PERM_RW);
+        uint32_t slots = ShmRing::format(baseA, SHM_REGION_SIZE, ShmRingKind::SPSC, messageSize);
+        ShmRing producerRing(baseA, SHM_REGION_SIZE);
+        ShmRing consumerRing(baseB, SHM_REGION_SIZE);
+
+        uint8_t* source = vmA->getMemory().translate(TX_AREA, messageSize, GUEST_PERM_RW);
+        for (uint32_t i = 0; i < messageSize; i++) {
+            source[i] = static_cast<uint8_t>(i * 7);
+        }
+
+        uint64_t checksum = 0;
+        uint64_t startNs = nowNs();
+
+        std::thread consumer([&]() {
+            pinTo(coreB, "consumer");
+            uint64_t sum = 0;
+            for (uint32_t received = 0; received < messageCount;) {
+                uint32_t length;
+                const uint8_t* message = consumerRing.peek(length);
+                if (!message) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                sum += message[0] + message[length - 1];
+                consumerRing.release();
+                received++;
+            }
+            checksum = sum;
+        });
+
+        std::thread producer([&]() {
+            pinTo(coreA, "producer");
+            for (uint32_t sent = 0; sent < messageCount;) {
+                uint64_t ticket;
+                uint8_t* slot = producerRing.reserve(ticket);
+                if (!slot) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                std::memcpy(slot, source, messageSize);
+                producerRing.commit(ticket, messageSize);
+                sent++;
+                if (sent % DOORBELL_BATCH == 0) {
+                    uint32_t notified;
+                    shm.ringDoorbell(1, SHM_ADDR, notified);
+                }
+            }
+        });
+
+        producer.join();
+        consumer.join();
+        uint64_t elapsedNs = nowNs() - startNs;
+
+        // 对照：同尺寸单线程memcpy
+        std::vector<uint8_t> target(messageSize);
+        uint64_t copyStart = nowNs();
+        for (uint32_t i = 0; i < messageCount; i++) {
+            std::memcpy(target.data(), source, messageSize);
+            source[0] = target[messageSize - 1];  // 防止编译器消除拷贝
+        }
+        uint64_t copyNs = nowNs() - copyStart;
+
+        double totalBytes = static_cast<double>(messageSize) * messageCount;
+        double ringGBps = totalBytes / elapsedNs;
+        double copyGBps = totalBytes / std::max<uint64_t>(1, copyNs);
+        std::cout << "Ring slots: " << slots << ", checksum " << checksum << std::endl;
+        std::cout << "Ring throughput: " << ringGBps << " GB/s ("
+                  << (messageCount / (elapsedNs / 1e9)) << " msgs/s)" << std::endl;
+        std::cout << "memcpy baseline: " << copyGBps << " GB/s, ring/memcpy = "
+                  << (ringGBps / copyGBps * 100.0) << "%" << std::endl;
+        std::cout << "Doorbell interrupts raised on VM B: "
+                  << vmB->getInterruptController().getRaisedCount() << std::endl;
+
+        shm.unmapAll(1);
+        shm.unmapAll(2);
+    }
+};
+
+int main() {
+    std::cout << "===========================================" << std::endl;
+    std::cout << "    MyOS VM Inter-VM Communication Benchmark" << std::endl;
+    std::cout << "===========================================" << std::endl;
+    std::cout << "CPU cores: " << GetCPUCoreCount()
+              << " (VM A -> core 2, VM B -> core 3, switch -> core 1)" << std::endl;
+
+    InterVmBenchmark bench;
+
+    bench.runThroughputTest(64, 200000, 1);
+    bench.runThroughputTest(64, 200000, 32);
+    bench.runThroughputTest(1500, 100000, 32);
+    bench.runLatencyTest(64, 10000);
+    bench.runSharedMemoryTest(4096, 200000);
+    bench.runSharedMemoryTest(65536, 20000);
+
+    std::cout << "\n===========================================" << std::endl;
+    std::cout << "    Benchmark Completed" << std::endl;
+    std::cout << "===========================================" << std::endl;
+    return 0;
+}
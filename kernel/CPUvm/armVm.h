@@ -3,7 +3,6 @@
 
 #include "baseVM.h"
 #include <iostream>
-#include <stdexcept>
 
 /**
  * @brief ARM VM实现类，模拟ARM架构的基本功能
@@ -16,6 +15,9 @@ private:
     static const uint32_t FLAG_Z = 1 << 30;  // 零标志
     static const uint32_t FLAG_C = 1 << 29;  // 进位标志
     static const uint32_t FLAG_V = 1 << 28;  // 溢出标志
+    static const uint64_t ARCH_STATE_TAG = 0xA32; // 快照架构标记
+    static const uint32_t SYS_BREAKPOINT = 0x7;   // BKPT：调试器断点陷阱（系统指令子功能）
+    static const uint32_t DEBUG_REGISTER_COUNT = 17; // r0-r15与cpsr
     
     // ARM寄存器扩展
     uint32_t r0, r1, r2, r3, r4, r5, r6, r7;  // 通用寄存器
@@ -42,39 +44,61 @@ public:
           resourceLimit(10000), instructionCount(0), isBigEndian(bigEndian) {}
     
     // 实现基类的纯虚函数
-    void start() override {
+    VmFaultCode start() override {
         if (isRunning) {
-            throw std::runtime_error("VM already running");
+            return raiseFault(VmFaultCode::ALREADY_RUNNING);
+        }
+        VmFaultCode admission = admitStart();
+        if (admission != VmFaultCode::NONE) {
+            return admission;
         }
         isRunning = true;
+        publishStatus();
         std::cout << "ARM VM " << vmId << " started" << (isBigEndian ? " (Big Endian)" : " (Little Endian)") << std::endl;
+        return VmFaultCode::NONE;
     }
     
-    void pause() override {
+    VmFaultCode pause() override {
         if (!isRunning) {
-            throw std::runtime_error("VM not running");
+            return raiseFault(VmFaultCode::NOT_RUNNING);
         }
         isRunning = false;
+        publishStatus();
         saveContext();
         std::cout << "ARM VM " << vmId << " paused" << std::endl;
+        return VmFaultCode::NONE;
     }
     
-    void resume() override {
+    VmFaultCode resume() override {
         if (isRunning) {
-            throw std::runtime_error("VM already running");
+            return raiseFault(VmFaultCode::ALREADY_RUNNING);
+        }
+        VmFaultCode admission = admitStart();
+        if (admission != VmFaultCode::NONE) {
+            return admission;
         }
         loadContext();
         isRunning = true;
+        publishStatus();
         std::cout << "ARM VM " << vmId << " resumed" << std::endl;
+        return VmFaultCode::NONE;
     }
     
     void stop() override {
+        bool wasRunning = isRunning;
         isRunning = false;
+        if (wasRunning) {
+            publishEvent(VmEventType::STOPPED, getProgramCounter());
+        }
         std::cout << "ARM VM " << vmId << " stopped normally" << std::endl;
     }
     
     void forceStop() override {
+        bool wasRunning = isRunning;
         isRunning = false;
+        if (wasRunning) {
+            publishEvent(VmEventType::STOPPED, getProgramCounter());
+        }
         std::cout << "ARM VM " << vmId << " force stopped" << std::endl;
     }
     
@@ -109,26 +133,35 @@ public:
     }
     
     bool runOneInstruction() override {
-        if (!isRunning || !payload || instructionCount >= resourceLimit) {
+        if (!isRunning || isHalted() || instructionCount >= resourceLimit) {
+            return false;
+        }
+        if (!payload) {
+            raiseFault(VmFaultCode::NO_PAYLOAD);
             return false;
         }
         
         // 简单的指令模拟
         if (pc >= payloadSize) {
-            stop();
+            finishPayload();
             return false;
         }
         
         // 获取指令字（考虑大小端模式）
+        uint32_t pcBefore = pc;
         uint32_t instruction = readInstruction(pc);
         executeArmInstruction(instruction);
         
         pc += 4;  // ARM指令长度固定为4字节
         instructionCount++;
+        if (observed) {
+            observeInstruction(pcBefore, pc);
+        }
         
         // 检查是否达到资源限制
         if (instructionCount >= resourceLimit) {
             std::cout << "ARM VM " << vmId << " reached resource limit" << std::endl;
+            raiseFault(VmFaultCode::RESOURCE_LIMIT, resourceLimit);
             pause();
             return false;
         }
@@ -136,12 +169,29 @@ public:
         return true;
     }
     
-    bool runOneSlice() override {
+    VmFaultCode runOneSlice() override {
         // 执行固定数量的指令作为时间片
         const int SLICE_INSTRUCTIONS = 10;
         int executed = 0;
+        sliceFault = VmFaultCode::NONE;
         
-        for (int i = 0; i < SLICE_INSTRUCTIONS && isRunning; i++) {
+        // 管理员控制线程正在对空闲VM执行控制动作时跳过本时间片
+        VmExecutionGuard guard(*this);
+        if (!guard.owns()) {
+            return VmFaultCode::NONE;
+        }
+        
+        // 块边界：先执行故障策略或管理员终端请求的暂停/停止/隔离/封禁
+        if (!applyPendingControl()) {
+            return VmFaultCode::NONE;
+        }
+        
+        // 块边界：投递中断，停机且无中断时不占用时间片
+        if (!serviceInterrupts()) {
+            return VmFaultCode::NONE;
+        }
+        
+        for (int i = 0; i < SLICE_INSTRUCTIONS && isRunning && !isHalted(); i++) {
             if (runOneInstruction()) {
                 executed++;
             } else {
@@ -150,7 +200,65 @@ public:
         }
         
         std::cout << "ARM VM " << vmId << " executed " << executed << " instructions in slice" << std::endl;
-        return executed > 0;
+        return sliceFault;
+    }
+    
+    uint64_t getProgramCounter() const override {
+        return pc;
+    }
+    
+    void setProgramCounter(uint64_t value) override {
+        pc = static_cast<uint32_t>(value);
+    }
+    
+    void captureArchState(std::vector<uint64_t>& state) const override {
+        const uint32_t registers[] = {
+            r0, r1, r2, r3, r4, r5, r6, r7, r8, r9, r10, r11, r12, sp, lr, pc, cpsr
+        };
+        state.assign(1, static_cast<uint64_t>(ARCH_STATE_TAG));
+        state.insert(state.end(), registers, registers + sizeof(registers) / sizeof(registers[0]));
+        state.push_back(instructionCount);
+    }
+    
+    bool restoreArchState(const std::vector<uint64_t>& state) override {
+        uint32_t* const registers[] = {
+            &r0, &r1, &r2, &r3, &r4, &r5, &r6, &r7, &r8, &r9, &r10, &r11, &r12, &sp, &lr, &pc, &cpsr
+        };
+        const size_t count = sizeof(registers) / sizeof(registers[0]);
+        if (state.size() != count + 2 || state[0] != ARCH_STATE_TAG) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            *registers[i] = static_cast<uint32_t>(state[i + 1]);
+        }
+        instructionCount = static_cast<uint32_t>(state[count + 1]);
+        return true;
+    }
+    
+    const S_DebugTarget& getDebugTarget() const override {
+        static const S_DebugRegisterInfo registers[DEBUG_REGISTER_COUNT] = {
+            { "r0", 32, "uint32" }, { "r1", 32, "uint32" }, { "r2", 32, "uint32" }, { "r3", 32, "uint32" },
+            { "r4", 32, "uint32" }, { "r5", 32, "uint32" }, { "r6", 32, "uint32" }, { "r7", 32, "uint32" },
+            { "r8", 32, "uint32" }, { "r9", 32, "uint32" }, { "r10", 32, "uint32" }, { "r11", 32, "uint32" },
+            { "r12", 32, "uint32" }, { "sp", 32, "data_ptr" }, { "lr", 32, "int" }, { "pc", 32, "code_ptr" },
+            { "cpsr", 32, "int" }
+        };
+        static const S_DebugTarget target = {
+            "arm", "org.gnu.gdb.arm.core", registers, DEBUG_REGISTER_COUNT, 4, 4
+        };
+        return target;
+    }
+    
+    uint64_t readDebugRegister(uint32_t index) const override {
+        return index < 16 ? getRegister(index) : (index == 16 ? cpsr : 0);
+    }
+    
+    void writeDebugRegister(uint32_t index, uint64_t value) override {
+        if (index < 16) {
+            setRegister(index, static_cast<uint32_t>(value));
+        } else if (index == 16) {
+            cpsr = static_cast<uint32_t>(value);
+        }
     }
     
     uint32_t getResourceUsage() override {
@@ -172,18 +280,29 @@ public:
         return isBigEndian;
     }
     
+protected:
+    void patchBreakpoint(uint8_t* code, uint64_t pc) const override {
+        // 系统指令（主操作码0xF）子功能BKPT，按VM字节序写入
+        uint32_t instruction = (0xFu << 21) | SYS_BREAKPOINT;
+        for (uint32_t i = 0; i < 4; i++) {
+            uint32_t shift = isBigEndian ? (24 - 8 * i) : (8 * i);
+            code[pc + i] = static_cast<uint8_t>(instruction >> shift);
+        }
+    }
+    
 private:
     /**
      * @brief 从payload读取ARM指令（考虑大小端）
      * @param address 内存地址
+     * @param code 指令来源（默认当前载荷，越过断点时为原载荷）
      * @return 32位指令字
      */
-    uint32_t readInstruction(uint32_t address) {
+    uint32_t readInstruction(uint32_t address, const uint8_t* code = nullptr) {
         if (address + 3 >= payloadSize) {
             return 0;  // 内存越界，返回NOP指令
         }
         
-        const uint8_t* ptr = payload + address;
+        const uint8_t* ptr = (code ? code : payload) + address;
         
         if (isBigEndian) {
             // 大端模式：高位字节在前
@@ -245,12 +364,72 @@ private:
                 break;
             }
                 
+            case 0xF:  // 系统指令，operand2选择子功能
+                executeSystemInstruction(operand2);
+                break;
+                
             default:
                 // 未知指令，简单忽略
                 break;
         }
     }
     
+    /**
+     * @brief 执行系统指令
+     * @param function 子功能号
+     */
+    void executeSystemInstruction(uint32_t function) {
+        switch (function) {
+            case 0x0:  // HVC：r0=请求数组地址，r1=请求条数，r0返回成功条数
+                r0 = invokeHypercall(r0, r1);
+                break;
+                
+            case 0x1:  // WFI：停机直到中断到来
+                enterHalt();
+                break;
+                
+            case 0x2: { // ERET：返回被中断的位置（减4抵消执行后的pc += 4）；不在中断处理程序中时为空操作
+                uint64_t returnPc = 0;
+                if (leaveInterrupt(returnPc)) {
+                    pc = static_cast<uint32_t>(returnPc) - 4;
+                }
+                break;
+            }
+                
+            case 0x3: { // RDCYCLE：r0=虚拟时间低32位，r1=高32位
+                uint64_t now = getVirtualTime();
+                r0 = static_cast<uint32_t>(now);
+                r1 = static_cast<uint32_t>(now >> 32);
+                break;
+            }
+                
+            case 0x4:  // 定时器编程：r0=间隔tick，r1=模式（0停止/1单次/2周期）
+                programTimer(r1, r0);
+                break;
+                
+            case SYS_BREAKPOINT: { // BKPT：调试器断点（载荷自身的BKPT按未知子功能忽略）
+                if (!isBreakpointSite(pc)) {
+                    break;
+                }
+                if (hitBreakpoint(pc)) {
+                    // 停在断点处：抵消执行后的pc += 4与指令计数
+                    pc -= 4;
+                    instructionCount--;
+                    break;
+                }
+                uint32_t original = readInstruction(pc, getOriginalCode());
+                if (((original >> 21) & 0xF) != 0xF || (original & 0xFFF) != SYS_BREAKPOINT) {
+                    executeArmInstruction(original);
+                }
+                break;
+            }
+                
+            default:
+                // 未知子功能，简单忽略
+                break;
+        }
+    }
+    
     /**
      * @brief 获取寄存器值
      * @param regNum 寄存器编号(0-15)
@@ -2,8 +2,20 @@
 #define BASE_VM_H
 
 #include <cstdint>
+#include <atomic>
 #include <memory>
 #include <vector>
+#include <algorithm>
+#include <utility>
+#include "../memory/guest_memory.h"
+#include "../hypercall/hypercall.h"
+#include "../device/interrupt_controller.h"
+#include "../device/virtual_timer.h"
+#include "vmFault.h"
+#include "vmEvent.h"
+#include "vmDebug.h"
+#include "../trace/trace_recorder.h"
+#include "../fuzz/coverage_map.h"
 
 /**
  * @brief VM上下文结构体，保存寄存器状态和标志位
@@ -31,6 +43,57 @@ struct S_VmContext {
     }
 };
 
+/**
+ * @brief VM状态快照
+ * @details 保存寄存器、私有客户机内存、虚拟定时器与停机/中断返回状态，恢复后VM从
+ *          捕获时的指令继续执行。载荷、外部映射（共享内存区域）和中断控制器中
+ *          尚未投递的中断不在快照内，恢复时保持VM当前的设置
+ */
+struct S_VmSnapshot {
+    uint32_t vmId;                      // 捕获快照的VM
+    S_VmContext context;                // 公共上下文（x86寄存器与栈）
+    std::vector<uint64_t> archState;    // 架构相关寄存器与计数（各架构定义顺序）
+    std::vector<uint8_t> memory;        // 私有客户机内存内容
+    VirtualTimer timer;                 // 虚拟定时器
+    uint64_t rngState;                  // 宿主随机数服务状态
+    uint64_t interruptReturnPc;         // 中断返回地址
+    uint64_t idleTicks;                 // 停机期间跳过的虚拟时间
+    bool running;                       // 运行状态
+    bool halted;                        // 停机等待中断
+    bool inInterrupt;                   // 正在执行中断处理程序
+    
+    S_VmSnapshot() : vmId(0), rngState(0), interruptReturnPc(0), idleTicks(0),
+                     running(false), halted(false), inInterrupt(false) {}
+};
+
+/**
+ * @brief 热更新：等待在块边界换入的载荷
+ * @details 载荷由调用方持有；旧载荷要等getPayloadGeneration()达到stagePayloadSwap返回的版本号
+ *          （执行者已越过块边界、不再读取旧载荷）之后才能释放
+ */
+struct S_PayloadSwap {
+    const uint8_t* data;                                    // 新载荷
+    size_t size;                                            // 新载荷大小
+    std::vector<std::pair<uint64_t, uint64_t>> relocations; // 旧PC -> 新PC，按旧PC升序（为空时PC不变）
+    uint64_t generation;                                    // 换入后的载荷版本号（登记时分配）
+    
+    S_PayloadSwap() : data(nullptr), size(0), generation(0) {}
+};
+
+/**
+ * @brief 观察方读取的VM状态（status/watch等，不持有执行权、不加锁）
+ */
+struct S_VmStatus {
+    bool running;               // 运行状态
+    bool halted;                // 停机等待中断
+    VmControlAction hold;       // 未解除的控制动作
+    VmFaultCode lastFault;      // 最近一次故障码
+    uint32_t instructions;      // 已执行指令数（发布时的值）
+    
+    S_VmStatus() : running(false), halted(false), hold(VmControlAction::NONE),
+                   lastFault(VmFaultCode::NONE), instructions(0) {}
+};
+
 /**
  * @brief VM统一接口类，为x86/arm/x64 VM提供统一的操作接口
  * @details 所有具体的VM实现都需要继承此类并实现相应的方法
@@ -39,9 +102,255 @@ class I_VmInterface {
 protected:
     uint32_t vmId;              // VM唯一标识符
     S_VmContext context;        // VM上下文状态
-    bool isRunning;             // VM运行状态
+    std::atomic<bool> isRunning; // VM运行状态（控制请求方在其他线程上读取）
     const uint8_t* payload;     // 指令载荷指针
     size_t payloadSize;         // 载荷大小
+    GuestMemory memory;         // 客户机数据内存（按需分配）
+    I_HypercallHandler* hypercallHandler; // 宿主服务表（nullptr表示不提供宿主服务）
+    uint64_t rngState;          // 宿主随机数服务的VM私有状态
+    std::atomic<bool> halted;   // 停机等待中断（HLT/WFI）
+    VirtualInterruptController interrupts; // VM私有中断控制器
+    bool inInterrupt;           // 正在执行中断处理程序（不嵌套投递）
+    uint64_t interruptReturnPc; // 中断返回地址
+    VirtualTimer timer;         // VM私有虚拟定时器
+    uint64_t idleTicks;         // 停机期间跳过的虚拟时间
+    S_VmFault lastFault;        // 最近一次故障记录
+    VmFaultCode sliceFault;     // 当前时间片内发生的故障（runOneSlice返回）
+    std::atomic<uint8_t> pendingControl; // 故障策略请求的控制动作（VmControlAction，时间片边界执行）
+    std::atomic<uint8_t> controlHold;    // 已执行且尚未解除的控制动作（VmControlAction）
+    std::atomic<bool> executionClaimed;  // 已有线程持有执行权（执行时间片或控制动作）
+    std::atomic<bool> payloadExited;     // 执行到载荷末尾而停止（调度器不再自动启动，启动或恢复快照时清除）
+    I_VmEventSink* eventSink;   // 事件接收方（nullptr表示不发布事件）
+    std::atomic<uint64_t> statusWord;    // 发布的状态字：指令数(高32位)|故障码(8-15位)|运行标志(位0)
+    std::unique_ptr<S_VmDebugState> debugState; // 调试状态（未挂接调试器时为空）
+    std::unique_ptr<TraceRecorder> traceRecorder; // 指令跟踪（未开启时为空）
+    CoverageTracer* coverageTracer;     // 模糊测试的边覆盖记录（不持有，未开启时为空）
+    bool observed;                      // 开启了跟踪或覆盖记录（各架构每条指令只检查这一项）
+    std::atomic<S_PayloadSwap*> stagedSwap;         // 等待换入的载荷（nullptr表示没有）
+    std::atomic<uint64_t> payloadGeneration;        // 已生效的载荷版本号
+    std::atomic<uint64_t> swapSequence;             // 已分配的载荷版本号（登记换入时递增）
+    
+    /**
+     * @brief 按重定位表换算PC（表中没有的PC不变）
+     */
+    static uint64_t relocatePc(const std::vector<std::pair<uint64_t, uint64_t>>& relocations, uint64_t pc) {
+        auto it = std::lower_bound(relocations.begin(), relocations.end(), std::make_pair(pc, uint64_t(0)));
+        return it != relocations.end() && it->first == pc ? it->second : pc;
+    }
+    
+    /**
+     * @brief 换入等待中的载荷（执行者在块边界调用，持有执行权）
+     * @details PC、中断返回地址与中断向量入口按重定位表换算；依赖旧载荷的缓存全部作废：
+     *          调试器的打了陷阱指令的副本按换算后的断点在新载荷上重建（超出新载荷的断点删除），
+     *          指令跟踪从新载荷重新开始，边覆盖记录从当前PC重新开始
+     */
+    void applyPayloadSwap() {
+        if (!stagedSwap.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::unique_ptr<S_PayloadSwap> swap(stagedSwap.exchange(nullptr, std::memory_order_acq_rel));
+        if (!swap) {
+            return;
+        }
+        const std::vector<std::pair<uint64_t, uint64_t>>& relocations = swap->relocations;
+        setProgramCounter(relocatePc(relocations, getProgramCounter()));
+        if (inInterrupt) {
+            interruptReturnPc = relocatePc(relocations, interruptReturnPc);
+        }
+        for (uint32_t vector = 0; vector < VirtualInterruptController::MAX_VECTORS; vector++) {
+            uint32_t entry = interrupts.getVectorEntry(vector);
+            if (entry != VirtualInterruptController::NO_ENTRY) {
+                interrupts.setVectorEntry(vector, static_cast<uint32_t>(relocatePc(relocations, entry)));
+            }
+        }
+        
+        std::vector<uint64_t> sites;
+        listBreakpoints(sites);
+        setPayload(swap->data, swap->size);
+        for (uint64_t site : sites) {
+            insertBreakpoint(relocatePc(relocations, site));
+        }
+        if (traceRecorder) {
+            startTrace(traceRecorder->getBufferBytes());
+        }
+        if (coverageTracer) {
+            coverageTracer->reset(getProgramCounter());
+        }
+        payloadGeneration.store(swap->generation, std::memory_order_release);
+        publishEvent(VmEventType::PAYLOAD_SWAPPED, swap->generation);
+    }
+    
+    /**
+     * @brief 记录故障（生命周期操作与运行循环共用）
+     * @param code 故障码
+     * @param detail 附加信息
+     * @return 传入的故障码，便于直接return
+     */
+    VmFaultCode raiseFault(VmFaultCode code, uint64_t detail = 0) {
+        lastFault.code = code;
+        lastFault.vmId = vmId;
+        lastFault.pc = getProgramCounter();
+        lastFault.virtualTime = getVirtualTime();
+        lastFault.detail = detail;
+        sliceFault = code;
+        if (code == VmFaultCode::RESOURCE_LIMIT) {
+            publishEvent(VmEventType::RESOURCE_LIMIT, detail);
+        } else {
+            publishEvent(VmEventType::FAULT, static_cast<uint64_t>(code));
+        }
+        return code;
+    }
+    
+    /**
+     * @brief 提交一批超级调用（各架构的超级调用指令共用）
+     * @param batchAddr 请求数组的客户机地址
+     * @param count 请求条数
+     * @return 成功完成的请求条数
+     */
+    uint32_t invokeHypercall(uint32_t batchAddr, uint32_t count) {
+        if (!hypercallHandler) {
+            return 0;
+        }
+        S_HypercallContext ctx(vmId, memory, rngState);
+        if (debugState) {
+            ctx.virtualClock = true;
+            ctx.virtualTime = getVirtualTime();
+        }
+        uint32_t completed = hypercallHandler->dispatchBatch(ctx, batchAddr, count);
+        if (coverageTracer) {
+            coverageTracer->onHypercall(getProgramCounter(), completed);
+        }
+        return completed;
+    }
+    
+    /**
+     * @brief 在块（时间片）边界投递中断
+     * @details 取出最高优先级的可投递向量：若注册了处理入口则保存返回地址并跳转，
+     *          否则仅唤醒；停机状态下没有中断可投递时本时间片不执行
+     * @return bool VM可以继续执行返回true
+     */
+    bool serviceInterrupts() {
+        if (timer.poll(getVirtualTime())) {
+            interrupts.raise(IRQ_VECTOR_TIMER);
+        }
+        if (!inInterrupt && interrupts.hasDeliverable()) {
+            int vector = interrupts.acknowledge();
+            if (vector >= 0) {
+                halted.store(false, std::memory_order_release);
+                uint32_t entry = interrupts.getVectorEntry(static_cast<uint32_t>(vector));
+                if (entry != VirtualInterruptController::NO_ENTRY) {
+                    inInterrupt = true;
+                    interruptReturnPc = getProgramCounter();
+                    setProgramCounter(entry);
+                }
+            }
+        }
+        return !halted.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief 停机等待中断（各架构的HLT/WFI指令共用）
+     */
+    void enterHalt() {
+        halted.store(true, std::memory_order_release);
+        publishEvent(VmEventType::HALTED, getProgramCounter());
+    }
+    
+    /**
+     * @brief 编程虚拟定时器（各架构的定时器指令共用）
+     * @param mode VirtualTimerMode取值
+     * @param ticks 间隔（虚拟tick）
+     */
+    void programTimer(uint32_t mode, uint64_t ticks) {
+        timer.program(mode, ticks, getVirtualTime());
+    }
+    
+    /**
+     * @brief 从中断处理程序返回（各架构的IRET指令共用）
+     * @param returnPc 输出返回地址
+     * @return bool 不在中断处理程序中时返回false（调用方按空操作执行，不修改PC）
+     */
+    bool leaveInterrupt(uint64_t& returnPc) {
+        if (!inInterrupt) {
+            return false;
+        }
+        inInterrupt = false;
+        returnPc = interruptReturnPc;
+        return true;
+    }
+    
+    /**
+     * @brief 启动/恢复前的准入检查（各架构的start/resume共用）
+     * @details 隔离中的VM拒绝启动；暂停、强制停止的控制保持在手动启动时解除
+     * @return 允许启动返回NONE
+     */
+    VmFaultCode admitStart() {
+        uint8_t hold = controlHold.load(std::memory_order_acquire);
+        if (hold == static_cast<uint8_t>(VmControlAction::BAN)) {
+            return raiseFault(VmFaultCode::BANNED);
+        }
+        if (hold == static_cast<uint8_t>(VmControlAction::QUARANTINE)) {
+            return raiseFault(VmFaultCode::QUARANTINED);
+        }
+        // 已对停止状态的VM直接生效的同级请求随手动启动一并解除
+        if (hold != static_cast<uint8_t>(VmControlAction::NONE)) {
+            pendingControl.compare_exchange_strong(hold, static_cast<uint8_t>(VmControlAction::NONE),
+                                                   std::memory_order_acq_rel);
+        }
+        controlHold.store(static_cast<uint8_t>(VmControlAction::NONE), std::memory_order_release);
+        payloadExited.store(false, std::memory_order_release);
+        return VmFaultCode::NONE;
+    }
+    
+    /**
+     * @brief 执行到载荷末尾：标记执行完毕并停止VM（STOPPED只随这次停止发布一次）
+     */
+    void finishPayload() {
+        payloadExited.store(true, std::memory_order_release);
+        stop();
+    }
+    
+    /**
+     * @brief 在载荷副本的pc处写入陷阱指令（各架构实现，字节数为getDebugTarget().breakpointSize）
+     */
+    virtual void patchBreakpoint(uint8_t* code, uint64_t pc) const = 0;
+    
+    /**
+     * @brief 陷阱指令所在位置是否为调试器设置的断点（载荷自身的同编码指令返回false）
+     */
+    bool isBreakpointSite(uint64_t pc) const {
+        return debugState && debugState->breakpoints.test(pc);
+    }
+    
+    /**
+     * @brief 记录一条执行完的指令（各架构在指令执行后调用，调用方先检查observed）
+     * @details 停在断点上的陷阱指令没有执行，不记录
+     */
+    void observeInstruction(uint64_t pcBefore, uint64_t pcAfter) {
+        if (debugState && debugState->trapped) {
+            return;
+        }
+        if (traceRecorder) {
+            traceRecorder->onInstruction(pcBefore, pcAfter);
+        }
+        if (coverageTracer) {
+            coverageTracer->onInstruction(pcBefore);
+        }
+    }
+    
+    /**
+     * @brief 执行到断点处的陷阱指令（各架构的陷阱指令共用）
+     * @details 从断点处继续执行时越过一次，由调用方改为执行原指令
+     * @return bool 需要停在断点处返回true（调用方抵消本条指令的PC前进与计数）
+     */
+    bool hitBreakpoint(uint64_t pc) {
+        if (debugState->stepOver && debugState->stepOverPc == pc) {
+            debugState->stepOver = false;
+            return false;
+        }
+        debugState->trapped = true;
+        return true;
+    }
     
 public:
     /**
@@ -49,14 +358,21 @@ public:
      * @param id VM唯一标识符
      */
     explicit I_VmInterface(uint32_t id) 
-        : vmId(id), isRunning(false), payload(nullptr), payloadSize(0) {}
+        : vmId(id), isRunning(false), payload(nullptr), payloadSize(0),
+          hypercallHandler(nullptr), rngState(0x9E3779B97F4A7C15ULL ^ id),
+          halted(false), interrupts(&halted), inInterrupt(false), interruptReturnPc(0),
+          idleTicks(0), sliceFault(VmFaultCode::NONE), pendingControl(0), controlHold(0),
+          executionClaimed(false), payloadExited(false), eventSink(nullptr), statusWord(0),
+          coverageTracer(nullptr), observed(false), stagedSwap(nullptr), payloadGeneration(0), swapSequence(0) {}
     
-    virtual ~I_VmInterface() = default;
+    virtual ~I_VmInterface() {
+        delete stagedSwap.load(std::memory_order_acquire);
+    }
     
-    // 基本控制方法
-    virtual void start() = 0;           // 启动VM开始执行指令
-    virtual void pause() = 0;           // 暂停VM保存当前状态
-    virtual void resume() = 0;          // 恢复VM继续执行
+    // 基本控制方法（失败时返回故障码并记录到lastFault，不抛出异常）
+    virtual VmFaultCode start() = 0;    // 启动VM开始执行指令
+    virtual VmFaultCode pause() = 0;    // 暂停VM保存当前状态
+    virtual VmFaultCode resume() = 0;   // 恢复VM继续执行
     virtual void stop() = 0;            // 正常停止VM释放资源
     virtual void forceStop() = 0;       // 强制终止VM（管理员端专用）
     
@@ -64,9 +380,20 @@ public:
     virtual void saveContext() = 0;     // 保存VM上下文状态
     virtual void loadContext() = 0;     // 恢复VM上下文状态
     
+    // 快照方法：导出/恢复架构相关寄存器与计数（公共状态由captureSnapshot/restoreSnapshot处理）
+    virtual void captureArchState(std::vector<uint64_t>& state) const = 0;
+    virtual bool restoreArchState(const std::vector<uint64_t>& state) = 0;
+    
     // 指令执行方法
     virtual bool runOneInstruction() = 0;   // 执行一条指令
-    virtual bool runOneSlice() = 0;         // 执行一个时间片
+    virtual VmFaultCode runOneSlice() = 0;  // 执行一个时间片，返回时间片内的故障码
+    virtual uint64_t getProgramCounter() const = 0;     // 获取程序计数器
+    virtual void setProgramCounter(uint64_t pc) = 0;    // 设置程序计数器
+    
+    // 调试方法：gdb目标描述与按描述编号访问寄存器
+    virtual const S_DebugTarget& getDebugTarget() const = 0;
+    virtual uint64_t readDebugRegister(uint32_t index) const = 0;
+    virtual void writeDebugRegister(uint32_t index, uint64_t value) = 0;
     
     // 资源管理方法
     virtual uint32_t getResourceUsage() = 0;    // 获取VM资源使用情况
@@ -76,15 +403,560 @@ public:
     uint32_t getVmId() const { return vmId; }
     bool getRunningStatus() const { return isRunning; }
     const S_VmContext& getContext() const { return context; }
+    GuestMemory& getMemory() { return memory; }
+    const GuestMemory& getMemory() const { return memory; }
+    bool isHalted() const { return halted.load(std::memory_order_acquire); }
+    VirtualInterruptController& getInterruptController() { return interrupts; }
+    const VirtualTimer& getTimer() const { return timer; }
+    const S_VmFault& getLastFault() const { return lastFault; }
+    /**
+     * @brief 是否因执行到载荷末尾而停止（调度器据此不再自动启动）
+     */
+    bool hasExited() const { return payloadExited.load(std::memory_order_acquire); }
+    VmControlAction getControlHold() const {
+        return static_cast<VmControlAction>(controlHold.load(std::memory_order_acquire));
+    }
+    
+    /**
+     * @brief 请求控制动作（任意线程，无锁）
+     * @details 多个请求合并为最严格的一个，在VM下一个时间片边界执行
+     * @return bool 请求提高了待执行或已执行动作的级别返回true（重复请求返回false）
+     */
+    bool requestControl(VmControlAction action) {
+        uint8_t desired = static_cast<uint8_t>(action);
+        if (controlHold.load(std::memory_order_acquire) >= desired) {
+            return false;
+        }
+        uint8_t current = pendingControl.load(std::memory_order_relaxed);
+        bool raised = false;
+        while (current < desired) {
+            if (pendingControl.compare_exchange_weak(current, desired, std::memory_order_acq_rel)) {
+                raised = true;
+                break;
+            }
+        }
+        // 未运行的VM没有下一个时间片边界，保持状态立即生效（手动启动时由admitStart拦截）；
+        // 已生效的请求随即撤销，避免解除隔离后被过期的待执行请求再次隔离
+        if (raised && !isRunning.load(std::memory_order_acquire)) {
+            uint8_t hold = controlHold.load(std::memory_order_relaxed);
+            while (hold < desired &&
+                   !controlHold.compare_exchange_weak(hold, desired, std::memory_order_acq_rel)) {
+            }
+            uint8_t applied = desired;
+            pendingControl.compare_exchange_strong(applied, static_cast<uint8_t>(VmControlAction::NONE),
+                                                   std::memory_order_acq_rel);
+        }
+        return raised;
+    }
+    
+    /**
+     * @brief 在时间片边界执行请求的控制动作（只能由持有执行权的线程调用）
+     * @details runOneSlice()开头自动调用；空闲VM由applyControlIfIdle()在请求方线程上执行
+     * @return bool VM仍可执行本时间片返回true
+     */
+    bool applyPendingControl() {
+        applyPayloadSwap();
+        uint8_t request = pendingControl.exchange(static_cast<uint8_t>(VmControlAction::NONE),
+                                                  std::memory_order_acq_rel);
+        switch (static_cast<VmControlAction>(request)) {
+            case VmControlAction::PAUSE:
+            case VmControlAction::QUARANTINE:
+                if (isRunning) {
+                    pause();
+                }
+                controlHold.store(request, std::memory_order_release);
+                break;
+            case VmControlAction::KILL:
+            case VmControlAction::BAN:
+                if (isRunning) {
+                    forceStop();
+                }
+                controlHold.store(request, std::memory_order_release);
+                break;
+            default:
+                break;
+        }
+        return isRunning;
+    }
+    
+    /**
+     * @brief 获取/释放执行权，同一时刻只有一个线程执行VM指令或控制动作
+     * @return bool 获取成功返回true
+     */
+    bool claimExecution() {
+        bool expected = false;
+        return executionClaimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel);
+    }
+    
+    void releaseExecution() {
+        executionClaimed.store(false, std::memory_order_release);
+    }
+    
+    /**
+     * @brief 没有执行者时在调用线程上立即执行控制请求
+     * @details 管理员控制线程与调度器调用；VM正在执行时返回false，由执行者在时间片边界执行
+     * @return bool 已在调用线程上执行返回true
+     */
+    bool applyControlIfIdle() {
+        if (!claimExecution()) {
+            return false;
+        }
+        applyPendingControl();
+        releaseExecution();
+        return true;
+    }
+    
+    bool hasPendingControl() const {
+        return pendingControl.load(std::memory_order_acquire) != static_cast<uint8_t>(VmControlAction::NONE) ||
+               stagedSwap.load(std::memory_order_acquire) != nullptr;
+    }
+    
+    /**
+     * @brief 热更新：登记在下一个块边界换入的载荷（任意线程）
+     * @details 与控制请求一样由执行者在块边界执行（applyPendingControl），VM空闲时调用方可以
+     *          用applyControlIfIdle立即执行。调用方在版本号达到返回值之前须保证新旧载荷都有效
+     * @return uint64_t 换入后的载荷版本号（单调递增，可能不连续）；已有等待中的换入时返回0
+     */
+    uint64_t stagePayloadSwap(std::unique_ptr<S_PayloadSwap> swap) {
+        std::sort(swap->relocations.begin(), swap->relocations.end());
+        uint64_t generation = swapSequence.fetch_add(1, std::memory_order_acq_rel) + 1;
+        swap->generation = generation;
+        S_PayloadSwap* expected = nullptr;
+        if (!stagedSwap.compare_exchange_strong(expected, swap.get(), std::memory_order_acq_rel)) {
+            return 0;
+        }
+        swap.release();     // 之后归执行者所有（换入后删除）
+        return generation;
+    }
+    
+    /**
+     * @brief 已生效的载荷版本号（任意线程，创建时为0）
+     */
+    uint64_t getPayloadGeneration() const { return payloadGeneration.load(std::memory_order_acquire); }
+    
+    /**
+     * @brief 解除隔离（管理端调用），之后可以手动启动
+     */
+    void releaseQuarantine() {
+        uint8_t expected = static_cast<uint8_t>(VmControlAction::QUARANTINE);
+        controlHold.compare_exchange_strong(expected, static_cast<uint8_t>(VmControlAction::PAUSE),
+                                            std::memory_order_acq_rel);
+    }
+    
+    /**
+     * @brief 解除封禁（管理员终端调用），VM保持停止状态，之后可以手动启动
+     * @return bool VM原本处于封禁状态返回true
+     */
+    bool releaseBan() {
+        uint8_t expected = static_cast<uint8_t>(VmControlAction::BAN);
+        return controlHold.compare_exchange_strong(expected, static_cast<uint8_t>(VmControlAction::KILL),
+                                                   std::memory_order_acq_rel);
+    }
+
+    /**
+     * @brief 解除故障策略留下的暂停/强制停止保持（VM被复位后调度器可以再次自动执行）
+     * @details 隔离与封禁不受影响，仍需管理端显式解除
+     */
+    void releaseFaultHold() {
+        uint8_t expected = static_cast<uint8_t>(VmControlAction::PAUSE);
+        if (!controlHold.compare_exchange_strong(expected, static_cast<uint8_t>(VmControlAction::NONE),
+                                                 std::memory_order_acq_rel)) {
+            expected = static_cast<uint8_t>(VmControlAction::KILL);
+            controlHold.compare_exchange_strong(expected, static_cast<uint8_t>(VmControlAction::NONE),
+                                                std::memory_order_acq_rel);
+        }
+    }
+
+    /**
+     * @brief 捕获VM状态快照
+     * @details 调用方需持有执行权（VmExecutionGuard）或保证VM没有在其他线程上执行
+     */
+    void captureSnapshot(S_VmSnapshot& snapshot) const {
+        snapshot.vmId = vmId;
+        snapshot.context = context;
+        captureArchState(snapshot.archState);
+        memory.savePrivate(snapshot.memory);
+        snapshot.timer = timer;
+        snapshot.rngState = rngState;
+        snapshot.interruptReturnPc = interruptReturnPc;
+        snapshot.idleTicks = idleTicks;
+        snapshot.running = isRunning;
+        snapshot.halted = halted.load(std::memory_order_acquire);
+        snapshot.inInterrupt = inInterrupt;
+    }
+    
+    /**
+     * @brief 把VM恢复到快照时的状态（可以恢复同架构、同内存大小的其他VM的快照）
+     * @details 调用方需持有执行权（VmExecutionGuard）或保证VM没有在其他线程上执行
+     * @param dirtyPagesOnly 只复制脏页跟踪记录下的页（调用方保证跟踪开始时内存与该快照一致）
+     * @return bool 架构或私有内存大小不匹配时返回false，VM状态不变
+     */
+    bool restoreSnapshot(const S_VmSnapshot& snapshot, bool dirtyPagesOnly = false) {
+        if (snapshot.memory.size() != memory.getSize() || (dirtyPagesOnly && !memory.isDirtyTracking())) {
+            return false;
+        }
+        if (!restoreArchState(snapshot.archState)) {
+            return false;
+        }
+        if (dirtyPagesOnly) {
+            memory.restoreDirty(snapshot.memory);
+        } else {
+            memory.restorePrivate(snapshot.memory);
+        }
+        context = snapshot.context;
+        timer = snapshot.timer;
+        rngState = snapshot.rngState;
+        interruptReturnPc = snapshot.interruptReturnPc;
+        idleTicks = snapshot.idleTicks;
+        inInterrupt = snapshot.inInterrupt;
+        halted.store(snapshot.halted, std::memory_order_release);
+        isRunning = snapshot.running;
+        payloadExited.store(false, std::memory_order_release);
+        publishStatus();
+        return true;
+    }
+    
+    /**
+     * @brief 获取VM虚拟时间（tick）
+     * @details 已执行指令数加停机期间跳过的时间，只由VM自身的执行决定，可复现
+     */
+    uint64_t getVirtualTime() { return getResourceUsage() + idleTicks; }
+    
+    /**
+     * @brief 停机VM的虚拟时间直接推进到定时器截止时间（调度器定时器处理调用）
+     * @details 停机等待定时器的VM不占用任何时间片，也不等待宿主时间流逝
+     * @return bool 定时器因此到期返回true
+     */
+    bool advanceIdleTime() {
+        if (!isHalted() || !timer.isArmed()) {
+            return false;
+        }
+        uint64_t now = getVirtualTime();
+        if (timer.getDeadline() > now) {
+            idleTicks += timer.getDeadline() - now;
+        }
+        if (timer.poll(getVirtualTime())) {
+            interrupts.raise(IRQ_VECTOR_TIMER);
+            return true;
+        }
+        return false;
+    }
     
     // 载荷设置方法（为第二阶段预留接口）
     virtual void setPayload(const uint8_t* data, size_t size) {
         payload = data;
         payloadSize = size;
+        // 调试中更换载荷：原有断点失效
+        if (debugState) {
+            debugState->originalCode = data;
+            debugState->originalSize = size;
+            debugState->breakpoints.resize(size);
+            debugState->patchedCode.clear();
+        }
     }
     
     virtual const uint8_t* getPayload() const { return payload; }
+    
+    // 宿主服务表挂接
+    void setHypercallHandler(I_HypercallHandler* handler) { hypercallHandler = handler; }
+    I_HypercallHandler* getHypercallHandler() const { return hypercallHandler; }
+    
+    // 事件接收方挂接（VM开始执行前设置）
+    void setEventSink(I_VmEventSink* sink) { eventSink = sink; }
+    
+    /**
+     * @brief 发布VM事件（未挂接接收方时只更新状态字）
+     * @details VM内部在停机、故障、停止时调用；执行vm run的一方在结束时发布RUN_COMPLETE
+     */
+    void publishEvent(VmEventType type, uint64_t detail) {
+        publishStatus();
+        if (!eventSink) {
+            return;
+        }
+        S_VmEvent event;
+        event.timestampNs = VmEventTimestampNs();
+        event.virtualTime = getVirtualTime();
+        event.detail = detail;
+        event.vmId = vmId;
+        event.type = static_cast<uint16_t>(type);
+        eventSink->onVmEvent(event);
+    }
+    
+    /**
+     * @brief 发布状态字（执行方在启动/暂停/恢复、事件与时间片结束时调用）
+     * @details 运行标志、故障码与指令数打包成一个64位原子量，观察方一次读取即得到一致的值，
+     *          不与执行方争用；停机与控制动作本身是原子量，读取时取实时值
+     */
+    void publishStatus() {
+        uint64_t word = (static_cast<uint64_t>(getResourceUsage()) << 32) |
+                        (static_cast<uint64_t>(lastFault.code) << 8) | (isRunning ? 1u : 0u);
+        statusWord.store(word, std::memory_order_release);
+    }
+    
+    /**
+     * @brief 读取已发布的状态（任意线程，无锁）
+     */
+    S_VmStatus getPublishedStatus() const {
+        uint64_t word = statusWord.load(std::memory_order_acquire);
+        S_VmStatus status;
+        status.running = (word & 1) != 0;
+        status.halted = halted.load(std::memory_order_acquire);
+        status.hold = getControlHold();
+        status.lastFault = static_cast<VmFaultCode>((word >> 8) & 0xFF);
+        status.instructions = static_cast<uint32_t>(word >> 32);
+        return status;
+    }
     virtual size_t getPayloadSize() const { return payloadSize; }
+    
+    /**
+     * @brief 挂接/解除调试器
+     * @details 以下调试方法都只能由持有执行权的调试器线程调用；调试器在挂接期间一直持有执行权，
+     *          调度器与vm run不会执行打了陷阱指令的载荷。解除时删除全部断点并恢复原载荷
+     */
+    void debugAttach() {
+        if (debugState) {
+            return;
+        }
+        debugState.reset(new S_VmDebugState());
+        debugState->originalCode = payload;
+        debugState->originalSize = payloadSize;
+        debugState->breakpoints.resize(payloadSize);
+        memory.setWatchHandler(&debugState->watchpoints);
+    }
+    
+    void debugDetach() {
+        if (!debugState) {
+            return;
+        }
+        payload = debugState->originalCode;
+        memory.clearWatches();
+        memory.setWatchHandler(nullptr);
+        debugState.reset();
+    }
+    
+    bool isDebugAttached() const { return debugState != nullptr; }
+    
+    /**
+     * @brief 开启指令跟踪（已开启时重新开始）
+     * @details 调用方需持有执行权；未开启跟踪的VM每条指令只多一次空指针检查
+     * @param bufferBytes 环形缓冲大小
+     */
+    void startTrace(uint32_t bufferBytes) {
+        traceRecorder.reset(new TraceRecorder(getDebugTarget().instructionSize, bufferBytes));
+        observed = true;
+    }
+    
+    void stopTrace() {
+        traceRecorder.reset();
+        observed = coverageTracer != nullptr;
+    }
+    
+    const TraceRecorder* getTraceRecorder() const { return traceRecorder.get(); }
+    
+    /**
+     * @brief 挂接/解除边覆盖记录（模糊测试工作线程，调用方需持有执行权）
+     */
+    void setCoverageTracer(CoverageTracer* tracer) {
+        coverageTracer = tracer;
+        observed = coverageTracer != nullptr || traceRecorder != nullptr;
+    }
+    
+    /**
+     * @brief 未打陷阱指令的原载荷（越过断点时从这里取原指令，调试器显示代码也用它）
+     */
+    const uint8_t* getOriginalCode() const {
+        return debugState ? debugState->originalCode : payload;
+    }
+    
+    /**
+     * @brief 设置断点：在载荷副本的断点处写入陷阱指令
+     * @return bool 未挂接、越界或断点已存在时返回false
+     */
+    bool insertBreakpoint(uint64_t pc) {
+        if (!debugState || !debugState->originalCode ||
+            pc + getDebugTarget().breakpointSize > debugState->originalSize ||
+            !debugState->breakpoints.set(pc)) {
+            return false;
+        }
+        if (debugState->patchedCode.empty()) {
+            debugState->patchedCode.assign(debugState->originalCode,
+                                           debugState->originalCode + debugState->originalSize);
+        }
+        patchBreakpoint(debugState->patchedCode.data(), pc);
+        payload = debugState->patchedCode.data();
+        return true;
+    }
+    
+    /**
+     * @brief 删除断点：恢复原指令，没有断点后载荷指针恢复为原载荷
+     */
+    bool removeBreakpoint(uint64_t pc) {
+        if (!debugState || !debugState->breakpoints.clear(pc)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < getDebugTarget().breakpointSize; i++) {
+            debugState->patchedCode[pc + i] = debugState->originalCode[pc + i];
+        }
+        if (debugState->breakpoints.getCount() == 0) {
+            payload = debugState->originalCode;
+            debugState->patchedCode.clear();
+        }
+        return true;
+    }
+    
+    void listBreakpoints(std::vector<uint64_t>& out) const {
+        out.clear();
+        if (debugState) {
+            debugState->breakpoints.list(out);
+        }
+    }
+    
+    /**
+     * @brief 设置数据观察点：登记区间并去掉所在页上对应的访问权限
+     * @return bool 未挂接、区间越界、观察点已满或已存在时返回false
+     */
+    bool insertWatchpoint(uint32_t address, uint32_t length, WatchKind kind) {
+        S_Watchpoint watchpoint = { address, length, kind };
+        if (!debugState || !debugState->watchpoints.add(watchpoint)) {
+            return false;
+        }
+        if (!memory.watchPages(address, length, WatchpointTable::GetWatchAccess(kind))) {
+            debugState->watchpoints.remove(address, length, kind);
+            return false;
+        }
+        return true;
+    }
+    
+    /**
+     * @brief 删除数据观察点，按剩余观察点重建页的观察状态
+     */
+    bool removeWatchpoint(uint32_t address, uint32_t length, WatchKind kind) {
+        if (!debugState || !debugState->watchpoints.remove(address, length, kind)) {
+            return false;
+        }
+        memory.clearWatches();
+        for (const S_Watchpoint& watchpoint : debugState->watchpoints.getWatchpoints()) {
+            memory.watchPages(watchpoint.address, watchpoint.length, WatchpointTable::GetWatchAccess(watchpoint.kind));
+        }
+        return true;
+    }
+    
+    void listWatchpoints(std::vector<S_Watchpoint>& out) const {
+        out.clear();
+        if (debugState) {
+            out = debugState->watchpoints.getWatchpoints();
+        }
+    }
+    
+    /**
+     * @brief 取出debugRun返回WATCHPOINT时的命中地址与类型
+     */
+    bool takeWatchHit(uint32_t& address, WatchKind& kind) {
+        return debugState && debugState->watchpoints.takeHit(address, kind);
+    }
+    
+    /**
+     * @brief 观察点慢速路径统计：访问被观察页的次数、精确命中次数
+     */
+    void getWatchStatistics(uint64_t& slowChecks, uint64_t& hits) const {
+        slowChecks = debugState ? debugState->watchpoints.getSlowChecks() : 0;
+        hits = debugState ? debugState->watchpoints.getHitCount() : 0;
+    }
+    
+    /**
+     * @brief 连续执行最多maxInstructions条指令（模糊测试等离线批量执行，不输出时间片日志）
+     * @details 调用方需持有执行权。开始时换入等待中的载荷（不执行其他控制动作）；
+     *          每条指令前投递中断；停机时把虚拟时间推进到定时器截止点，
+     *          没有定时器可等时返回。执行到载荷末尾时与stop()一样停止VM，但不输出日志
+     * @param executed 输出：实际执行的指令数
+     * @return VmFaultCode 执行期间发生的故障
+     */
+    VmFaultCode runBatch(uint32_t maxInstructions, uint32_t& executed) {
+        executed = 0;
+        sliceFault = VmFaultCode::NONE;
+        applyPayloadSwap();
+        while (executed < maxInstructions && isRunning) {
+            if (!serviceInterrupts() && !(advanceIdleTime() && serviceInterrupts())) {
+                break;
+            }
+            if (getProgramCounter() >= payloadSize) {
+                payloadExited.store(true, std::memory_order_release);
+                isRunning = false;
+                publishEvent(VmEventType::STOPPED, getProgramCounter());
+                break;
+            }
+            if (!runOneInstruction()) {
+                break;
+            }
+            executed++;
+        }
+        return sliceFault;
+    }
+    
+    /**
+     * @brief 调试器执行：最多执行maxInstructions条指令，命中断点、停机或停止时提前返回
+     * @details 开始时执行控制动作，每条指令前投递中断，从上次命中的断点处开始时越过该断点一次；
+     *          观察点在访问内存的指令执行完后停下
+     * @return DebugStopReason maxInstructions为1时正常执行完返回STEP，否则返回NONE
+     */
+    DebugStopReason debugRun(uint32_t maxInstructions) {
+        if (!debugState || !applyPendingControl()) {
+            return DebugStopReason::EXITED;
+        }
+        if (!serviceInterrupts()) {
+            return DebugStopReason::HALTED;
+        }
+        // 上次停在断点上时越过它；批次恰好在断点处结束时不越过（该断点尚未报告）
+        uint64_t startPc = getProgramCounter();
+        debugState->stepOver = debugState->trapped && isBreakpointSite(startPc);
+        debugState->stepOverPc = startPc;
+        debugState->trapped = false;
+        debugState->watchpoints.clearHit();
+        for (uint32_t i = 0; i < maxInstructions && isRunning && !debugState->trapped &&
+                            !debugState->watchpoints.hasHit(); i++) {
+            // 每条指令前都投递中断：投递位置只取决于指令计数，与调用方的分批方式无关（反向执行重放依赖这一点）
+            if ((i > 0 && !serviceInterrupts()) || !runOneInstruction()) {
+                break;
+            }
+        }
+        debugState->stepOver = false;
+        publishStatus();
+        if (debugState->trapped) {
+            return DebugStopReason::BREAKPOINT;
+        }
+        if (debugState->watchpoints.hasHit()) {
+            return DebugStopReason::WATCHPOINT;
+        }
+        if (!isRunning) {
+            return DebugStopReason::EXITED;
+        }
+        if (isHalted()) {
+            return DebugStopReason::HALTED;
+        }
+        return maxInstructions == 1 ? DebugStopReason::STEP : DebugStopReason::NONE;
+    }
+};
+
+/**
+ * @brief VM执行权的作用域守卫
+ * @details 执行时间片或连续单步执行时持有，离开作用域自动释放
+ */
+class VmExecutionGuard {
+private:
+    I_VmInterface& vm;
+    bool owned;
+    
+public:
+    explicit VmExecutionGuard(I_VmInterface& target) : vm(target), owned(target.claimExecution()) {}
+    ~VmExecutionGuard() {
+        if (owned) {
+            vm.releaseExecution();
+        }
+    }
+    VmExecutionGuard(const VmExecutionGuard&) = delete;
+    VmExecutionGuard& operator=(const VmExecutionGuard&) = delete;
+    
+    bool owns() const { return owned; }
 };
 
 #endif // BASE_VM_H
\ No newline at end of file
@@ -0,0 +1,275 @@
+#ifndef VM_DEBUG_H
+#define VM_DEBUG_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include "../memory/guest_memory.h"
+
+/**
+ * @brief 调试器停止原因
+ * @details 新增原因时需同步更新GetDebugStopName()的名称表
+ */
+enum class DebugStopReason : uint8_t {
+    NONE        = 0,    // 仍可继续执行（continue的一批指令执行完）
+    STEP        = 1,    // 单步完成
+    BREAKPOINT  = 2,    // 命中断点（PC停在断点指令上，尚未执行）
+    HALTED      = 3,    // 停机等待中断
+    EXITED      = 4,    // VM不再运行（载荷执行完、停止、暂停或达到资源限制）
+    WATCHPOINT  = 5,    // 观察点命中（访问内存的指令已执行完）
+    COUNT
+};
+
+inline const char* GetDebugStopName(DebugStopReason reason) {
+    static const char* const names[] = {
+        "NONE",
+        "STEP",
+        "BREAKPOINT",
+        "HALTED",
+        "EXITED",
+        "WATCHPOINT"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(DebugStopReason::COUNT),
+                  "debug stop name table out of sync with DebugStopReason");
+    uint8_t index = static_cast<uint8_t>(reason);
+    return index < static_cast<uint8_t>(DebugStopReason::COUNT) ? names[index] : "UNKNOWN";
+}
+
+/**
+ * @brief 调试器看到的一个寄存器（gdb目标描述中的一项）
+ */
+struct S_DebugRegisterInfo {
+    const char* name;       // 寄存器名（与gdb架构特性要求的名称一致）
+    uint32_t bits;          // 位宽
+    const char* type;       // gdb类型（int32/int64/code_ptr/data_ptr/i387_ext）
+};
+
+/**
+ * @brief 架构的调试描述
+ * @details 寄存器按表中顺序编号，即gdb远程协议g/p包中的顺序；
+ *          表中VM没有实现的寄存器（段寄存器、x87寄存器等）读为0、写入忽略
+ */
+struct S_DebugTarget {
+    const char* architecture;                   // gdb架构名
+    const char* feature;                        // gdb核心寄存器特性名
+    const S_DebugRegisterInfo* registers;       // 寄存器表
+    uint32_t registerCount;                     // 寄存器数
+    uint32_t breakpointSize;                    // 陷阱指令占用的字节数
+    uint32_t instructionSize;                   // 指令长度（定长指令集，指令跟踪据此重建顺序执行）
+};
+
+/**
+ * @brief 断点位图（按载荷字节偏移，每个PC一位）
+ */
+class BreakpointMap {
+private:
+    std::vector<uint64_t> bits;
+    uint32_t count;
+
+public:
+    BreakpointMap() : count(0) {}
+
+    void resize(size_t codeSize) { bits.assign((codeSize + 63) / 64, 0); count = 0; }
+    size_t getCapacity() const { return bits.size() * 64; }
+    uint32_t getCount() const { return count; }
+
+    bool test(uint64_t pc) const {
+        return pc < getCapacity() && (bits[pc >> 6] >> (pc & 63)) & 1;
+    }
+
+    bool set(uint64_t pc) {
+        if (pc >= getCapacity() || test(pc)) {
+            return false;
+        }
+        bits[pc >> 6] |= 1ULL << (pc & 63);
+        count++;
+        return true;
+    }
+
+    bool clear(uint64_t pc) {
+        if (!test(pc)) {
+            return false;
+        }
+        bits[pc >> 6] &= ~(1ULL << (pc & 63));
+        count--;
+        return true;
+    }
+
+    /**
+     * @brief 按PC升序列出所有断点
+     */
+    void list(std::vector<uint64_t>& out) const {
+        out.clear();
+        for (size_t word = 0; word < bits.size(); word++) {
+            uint64_t value = bits[word];
+            while (value) {
+                uint32_t bit = 0;
+                while (((value >> bit) & 1) == 0) {
+                    bit++;
+                }
+                out.push_back(word * 64 + bit);
+                value &= value - 1;
+            }
+        }
+    }
+};
+
+/**
+ * @brief 观察点类型（与gdb远程协议Z2/Z3/Z4的顺序一致）
+ * @details 新增类型时需同步更新GetWatchKindName()的名称表
+ */
+enum class WatchKind : uint8_t {
+    WRITE   = 0,    // 写
+    READ    = 1,    // 读
+    ACCESS  = 2,    // 读或写
+    COUNT
+};
+
+inline const char* GetWatchKindName(WatchKind kind) {
+    static const char* const names[] = {
+        "WRITE",
+        "READ",
+        "ACCESS"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(WatchKind::COUNT),
+                  "watch kind name table out of sync with WatchKind");
+    uint8_t index = static_cast<uint8_t>(kind);
+    return index < static_cast<uint8_t>(WatchKind::COUNT) ? names[index] : "UNKNOWN";
+}
+
+/**
+ * @brief 一个数据观察点
+ */
+struct S_Watchpoint {
+    uint32_t address;       // 起始地址
+    uint32_t length;        // 字节数
+    WatchKind kind;         // 类型
+};
+
+/**
+ * @brief 观察点表：登记观察点并作为客户机内存的观察点处理者
+ * @details 客户机内存把观察点所在的页去掉对应权限，只有访问这些页时才调用onWatchedAccess，
+ *          这里再按精确区间与类型判断是否命中。设备可能在其他线程上写入VM内存，
+ *          表由互斥锁保护（只在慢速路径上获取），命中记录在原子变量中，VM在下一条指令结束时停下。
+ */
+class WatchpointTable : public I_GuestWatchHandler {
+public:
+    static const size_t MAX_WATCHPOINTS = 32;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<S_Watchpoint> watchpoints;
+    std::atomic<bool> hit;                  // 有未报告的命中
+    std::atomic<uint32_t> hitAddress;       // 命中的地址（访问区间与观察区间的交集起点）
+    std::atomic<uint8_t> hitKind;           // 命中的观察点类型
+    std::atomic<uint64_t> slowChecks;       // 慢速路径检查次数（访问了被观察的页）
+    std::atomic<uint64_t> hitCount;         // 累计命中次数
+
+    static bool matches(WatchKind kind, uint8_t permission) {
+        switch (kind) {
+            case WatchKind::WRITE:  return (permission & GUEST_PERM_WRITE) != 0;
+            case WatchKind::READ:   return (permission & GUEST_PERM_READ) != 0;
+            default:                return (permission & GUEST_PERM_RW) != 0;
+        }
+    }
+
+public:
+    WatchpointTable() : hit(false), hitAddress(0), hitKind(0), slowChecks(0), hitCount(0) {}
+
+    /**
+     * @brief 观察点类型对应的页访问权限
+     */
+    static uint8_t GetWatchAccess(WatchKind kind) {
+        return kind == WatchKind::WRITE ? GUEST_PERM_WRITE
+             : kind == WatchKind::READ ? GUEST_PERM_READ : GUEST_PERM_RW;
+    }
+
+    bool add(const S_Watchpoint& watchpoint) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (watchpoints.size() >= MAX_WATCHPOINTS || watchpoint.length == 0) {
+            return false;
+        }
+        for (const S_Watchpoint& existing : watchpoints) {
+            if (existing.address == watchpoint.address && existing.length == watchpoint.length &&
+                existing.kind == watchpoint.kind) {
+                return false;
+            }
+        }
+        watchpoints.push_back(watchpoint);
+        return true;
+    }
+
+    bool remove(uint32_t address, uint32_t length, WatchKind kind) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < watchpoints.size(); i++) {
+            if (watchpoints[i].address == address && watchpoints[i].length == length && watchpoints[i].kind == kind) {
+                watchpoints.erase(watchpoints.begin() + i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<S_Watchpoint> getWatchpoints() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return watchpoints;
+    }
+
+    void onWatchedAccess(uint32_t addr, uint32_t len, uint8_t permission) override {
+        slowChecks.fetch_add(1, std::memory_order_relaxed);
+        uint64_t end = static_cast<uint64_t>(addr) + len;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const S_Watchpoint& watchpoint : watchpoints) {
+            uint64_t watchEnd = static_cast<uint64_t>(watchpoint.address) + watchpoint.length;
+            if (addr < watchEnd && watchpoint.address < end && matches(watchpoint.kind, permission)) {
+                hitAddress.store(addr > watchpoint.address ? addr : watchpoint.address, std::memory_order_relaxed);
+                hitKind.store(static_cast<uint8_t>(watchpoint.kind), std::memory_order_relaxed);
+                hit.store(true, std::memory_order_release);
+                hitCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    bool hasHit() const { return hit.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 取出未报告的命中
+     */
+    bool takeHit(uint32_t& address, WatchKind& kind) {
+        if (!hit.exchange(false, std::memory_order_acq_rel)) {
+            return false;
+        }
+        address = hitAddress.load(std::memory_order_relaxed);
+        kind = static_cast<WatchKind>(hitKind.load(std::memory_order_relaxed));
+        return true;
+    }
+
+    void clearHit() { hit.store(false, std::memory_order_release); }
+    uint64_t getSlowChecks() const { return slowChecks.load(std::memory_order_relaxed); }
+    uint64_t getHitCount() const { return hitCount.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief VM的调试状态（调试器挂接期间存在，未挂接的VM没有任何调试开销）
+ * @details 设置断点时复制一份载荷，把断点处替换为陷阱指令，VM的载荷指针改指向副本；
+ *          解码器照常取指，只有执行到陷阱指令时才查询位图，断点检查不进入普通指令的执行路径。
+ *          删除最后一个断点后载荷指针恢复为原载荷。
+ *          观察点见WatchpointTable，未被观察的内存页访问路径不变。
+ */
+struct S_VmDebugState {
+    BreakpointMap breakpoints;          // 断点位图
+    WatchpointTable watchpoints;        // 数据观察点
+    std::vector<uint8_t> patchedCode;   // 打了陷阱指令的载荷副本（没有断点时为空）
+    const uint8_t* originalCode;        // 原载荷
+    size_t originalSize;                // 原载荷大小
+    bool trapped;                       // 上次执行停在断点上
+    bool stepOver;                      // 越过stepOverPc处的断点（从命中的断点处继续执行时设置）
+    uint64_t stepOverPc;                // 要越过的断点
+
+    S_VmDebugState() : originalCode(nullptr), originalSize(0), trapped(false), stepOver(false), stepOverPc(0) {}
+};
+
+#endif // VM_DEBUG_H
@@ -0,0 +1,83 @@
+#ifndef VM_EVENT_H
+#define VM_EVENT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+
+/**
+ * @brief VM事件类型
+ * @details 新增事件类型时需同步更新GetVmEventName()的名称表；
+ *          订阅方用VmEventMask()组合的位掩码过滤，类型数不超过32
+ */
+enum class VmEventType : uint16_t {
+    HALTED          = 0,    // 停机等待中断（detail为PC）
+    FAULT           = 1,    // 故障（detail为VmFaultCode）
+    RESOURCE_LIMIT  = 2,    // 指令数达到资源限制（detail为限制值）
+    RUN_COMPLETE    = 3,    // 一次vm run执行结束（detail为执行的指令数）
+    STOPPED         = 4,    // VM停止（载荷执行完、手动停止或强制停止，detail为PC）
+    PAYLOAD_SWAPPED = 5,    // 热更新的载荷在块边界生效（detail为新的载荷版本号）
+    COUNT
+};
+
+static_assert(static_cast<uint32_t>(VmEventType::COUNT) <= 32, "VmEventType must fit a 32-bit mask");
+
+/**
+ * @brief 获取事件类型的显示名称
+ */
+inline const char* GetVmEventName(VmEventType type) {
+    static const char* const names[] = {
+        "HALTED",
+        "FAULT",
+        "RESOURCE_LIMIT",
+        "RUN_COMPLETE",
+        "STOPPED",
+        "PAYLOAD_SWAPPED"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(VmEventType::COUNT),
+                  "event name table out of sync with VmEventType");
+    uint16_t index = static_cast<uint16_t>(type);
+    return index < static_cast<uint16_t>(VmEventType::COUNT) ? names[index] : "UNKNOWN";
+}
+
+inline uint32_t VmEventMask(VmEventType type) {
+    return 1u << static_cast<uint32_t>(type);
+}
+
+static const uint32_t VM_EVENT_MASK_ALL = (1u << static_cast<uint32_t>(VmEventType::COUNT)) - 1;
+
+/**
+ * @brief VM事件记录（定长32字节，经无锁环传递，也直接作为控制套接字事件帧的载荷）
+ */
+struct S_VmEvent {
+    uint64_t timestampNs;   // 宿主单调时钟（纳秒）
+    uint64_t virtualTime;   // VM虚拟时间
+    uint64_t detail;        // 附加信息（含义见VmEventType）
+    uint32_t vmId;          // 产生事件的VM
+    uint16_t type;          // VmEventType
+    uint16_t reserved;
+
+    S_VmEvent() : timestampNs(0), virtualTime(0), detail(0), vmId(0), type(0), reserved(0) {}
+};
+
+static_assert(sizeof(S_VmEvent) == 32, "S_VmEvent must stay 32 bytes");
+
+/**
+ * @brief VM事件接收方（事件总线实现），VM只持有该接口指针
+ * @details onVmEvent()在产生事件的线程（VM执行线程、调度线程等）上调用，实现必须无阻塞
+ */
+class I_VmEventSink {
+public:
+    virtual ~I_VmEventSink() = default;
+    virtual void onVmEvent(const S_VmEvent& event) = 0;
+};
+
+/**
+ * @brief 事件时间戳（宿主单调时钟）
+ */
+inline uint64_t VmEventTimestampNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#endif // VM_EVENT_H
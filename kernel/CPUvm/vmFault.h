@@ -0,0 +1,91 @@
+#ifndef VM_FAULT_H
+#define VM_FAULT_H
+
+#include <cstdint>
+
+/**
+ * @brief VM故障码
+ * @details 生命周期操作与运行循环以返回值报告故障，不抛出C++异常；
+ *          新增故障码时需同步更新GetVmFaultName()的名称表
+ */
+enum class VmFaultCode : uint8_t {
+    NONE                    = 0,    // 无故障
+    ALREADY_RUNNING         = 1,    // 对运行中的VM执行start/resume
+    NOT_RUNNING             = 2,    // 对未运行的VM执行pause
+    NO_PAYLOAD              = 3,    // 未设置指令载荷
+    RESOURCE_LIMIT          = 4,    // 指令数达到资源限制
+    RESOURCE_TIMEOUT        = 5,    // 长时间未得到调度
+    MEMORY_ACCESS_VIOLATION = 6,    // 客户机内存越界或权限不足
+    INVALID_INSTRUCTION     = 7,    // 无法解码的指令
+    QUARANTINED             = 8,    // VM已被隔离，拒绝启动/恢复
+    BANNED                  = 9,    // VM已被管理员封禁，拒绝启动/恢复
+    COUNT
+};
+
+/**
+ * @brief 故障记录（定长，无堆分配）
+ */
+struct S_VmFault {
+    VmFaultCode code;       // 故障码
+    uint32_t vmId;          // 发生故障的VM
+    uint64_t pc;            // 故障时的程序计数器
+    uint64_t virtualTime;   // 故障时的VM虚拟时间
+    uint64_t detail;        // 附加信息（出错地址、资源限制值等）
+
+    S_VmFault() : code(VmFaultCode::NONE), vmId(0), pc(0), virtualTime(0), detail(0) {}
+};
+
+/**
+ * @brief 获取故障码的显示名称（静态字符串，仅用于输出）
+ */
+inline const char* GetVmFaultName(VmFaultCode code) {
+    static const char* const names[] = {
+        "NONE",
+        "ALREADY_RUNNING",
+        "NOT_RUNNING",
+        "NO_PAYLOAD",
+        "RESOURCE_LIMIT",
+        "RESOURCE_TIMEOUT",
+        "MEMORY_ACCESS_VIOLATION",
+        "INVALID_INSTRUCTION",
+        "QUARANTINED",
+        "BANNED"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(VmFaultCode::COUNT),
+                  "fault name table out of sync with VmFaultCode");
+    uint8_t index = static_cast<uint8_t>(code);
+    return index < static_cast<uint8_t>(VmFaultCode::COUNT) ? names[index] : "UNKNOWN";
+}
+
+/**
+ * @brief 故障处理策略对VM施加的控制动作
+ * @details 处理线程只登记请求，VM在下一个时间片边界自行执行，
+ *          不阻塞也不打断正在执行的工作线程；数值越大越严格
+ */
+enum class VmControlAction : uint8_t {
+    NONE        = 0,    // 无动作（仅记录）
+    PAUSE       = 1,    // 暂停，调度器不再自动启动，手动start/resume后解除
+    KILL        = 2,    // 强制停止，手动start后解除
+    QUARANTINE  = 3,    // 暂停并隔离，需显式解除隔离后才能再次启动
+    BAN         = 4,    // 强制停止并封禁（管理员终端），解封前不能再次启动
+    COUNT
+};
+
+/**
+ * @brief 获取控制动作的显示名称
+ */
+inline const char* GetVmControlName(VmControlAction action) {
+    static const char* const names[] = {
+        "NONE",
+        "PAUSE",
+        "KILL",
+        "QUARANTINE",
+        "BAN"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(VmControlAction::COUNT),
+                  "control name table out of sync with VmControlAction");
+    uint8_t index = static_cast<uint8_t>(action);
+    return index < static_cast<uint8_t>(VmControlAction::COUNT) ? names[index] : "UNKNOWN";
+}
+
+#endif // VM_FAULT_H
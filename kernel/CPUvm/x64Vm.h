@@ -3,7 +3,6 @@
 
 #include "baseVM.h"
 #include <iostream>
-#include <stdexcept>
 #include <cstdint>
 
 /**
@@ -27,6 +26,9 @@ private:
     static const uint64_t FLAG_ZF = 1ULL << 6;   // 零标志
     static const uint64_t FLAG_SF = 1ULL << 7;   // 符号标志
     static const uint64_t FLAG_OF = 1ULL << 11;  // 溢出标志
+    static const uint64_t ARCH_STATE_TAG = 0x64;  // 快照架构标记
+    static const uint8_t OPCODE_BREAKPOINT = 0xCC; // INT3：调试器断点陷阱指令
+    static const uint32_t DEBUG_GPR_COUNT = 18;   // 调试寄存器表中由VM提供的寄存器数（其余读为0）
     
     uint32_t resourceLimit;     // 资源限制
     uint32_t instructionCount;  // 已执行指令计数
@@ -44,39 +46,61 @@ public:
           resourceLimit(10000), instructionCount(0) {}
     
     // 实现基类的纯虚函数
-    void start() override {
+    VmFaultCode start() override {
         if (isRunning) {
-            throw std::runtime_error("VM already running");
+            return raiseFault(VmFaultCode::ALREADY_RUNNING);
+        }
+        VmFaultCode admission = admitStart();
+        if (admission != VmFaultCode::NONE) {
+            return admission;
         }
         isRunning = true;
+        publishStatus();
         std::cout << "x64 VM " << vmId << " started" << std::endl;
+        return VmFaultCode::NONE;
     }
     
-    void pause() override {
+    VmFaultCode pause() override {
         if (!isRunning) {
-            throw std::runtime_error("VM not running");
+            return raiseFault(VmFaultCode::NOT_RUNNING);
         }
         isRunning = false;
+        publishStatus();
         saveContext();
         std::cout << "x64 VM " << vmId << " paused" << std::endl;
+        return VmFaultCode::NONE;
     }
     
-    void resume() override {
+    VmFaultCode resume() override {
         if (isRunning) {
-            throw std::runtime_error("VM already running");
+            return raiseFault(VmFaultCode::ALREADY_RUNNING);
+        }
+        VmFaultCode admission = admitStart();
+        if (admission != VmFaultCode::NONE) {
+            return admission;
         }
         loadContext();
         isRunning = true;
+        publishStatus();
         std::cout << "x64 VM " << vmId << " resumed" << std::endl;
+        return VmFaultCode::NONE;
     }
     
     void stop() override {
+        bool wasRunning = isRunning;
         isRunning = false;
+        if (wasRunning) {
+            publishEvent(VmEventType::STOPPED, getProgramCounter());
+        }
         std::cout << "x64 VM " << vmId << " stopped normally" << std::endl;
     }
     
     void forceStop() override {
+        bool wasRunning = isRunning;
         isRunning = false;
+        if (wasRunning) {
+            publishEvent(VmEventType::STOPPED, getProgramCounter());
+        }
         std::cout << "x64 VM " << vmId << " force stopped" << std::endl;
     }
     
@@ -110,26 +134,35 @@ public:
     }
     
     bool runOneInstruction() override {
-        if (!isRunning || !payload || instructionCount >= resourceLimit) {
+        if (!isRunning || isHalted() || instructionCount >= resourceLimit) {
+            return false;
+        }
+        if (!payload) {
+            raiseFault(VmFaultCode::NO_PAYLOAD);
             return false;
         }
         
         // 简单的指令模拟
         if (rip >= payloadSize) {
-            stop();
+            finishPayload();
             return false;
         }
         
         // 获取指令字节
+        uint64_t pcBefore = rip;
         uint8_t opcode = payload[rip];
         executeX64Instruction(opcode);
         
         rip++;
         instructionCount++;
+        if (observed) {
+            observeInstruction(pcBefore, rip);
+        }
         
         // 检查是否达到资源限制
         if (instructionCount >= resourceLimit) {
             std::cout << "x64 VM " << vmId << " reached resource limit" << std::endl;
+            raiseFault(VmFaultCode::RESOURCE_LIMIT, resourceLimit);
             pause();
             return false;
         }
@@ -137,12 +170,29 @@ public:
         return true;
     }
     
-    bool runOneSlice() override {
+    VmFaultCode runOneSlice() override {
         // 执行固定数量的指令作为时间片
         const int SLICE_INSTRUCTIONS = 10;
         int executed = 0;
+        sliceFault = VmFaultCode::NONE;
+        
+        // 管理员控制线程正在对空闲VM执行控制动作时跳过本时间片
+        VmExecutionGuard guard(*this);
+        if (!guard.owns()) {
+            return VmFaultCode::NONE;
+        }
+        
+        // 块边界：先执行故障策略或管理员终端请求的暂停/停止/隔离/封禁
+        if (!applyPendingControl()) {
+            return VmFaultCode::NONE;
+        }
+        
+        // 块边界：投递中断，停机且无中断时不占用时间片
+        if (!serviceInterrupts()) {
+            return VmFaultCode::NONE;
+        }
         
-        for (int i = 0; i < SLICE_INSTRUCTIONS && isRunning; i++) {
+        for (int i = 0; i < SLICE_INSTRUCTIONS && isRunning && !isHalted(); i++) {
             if (runOneInstruction()) {
                 executed++;
             } else {
@@ -151,7 +201,80 @@ public:
         }
         
         std::cout << "x64 VM " << vmId << " executed " << executed << " instructions in slice" << std::endl;
-        return executed > 0;
+        return sliceFault;
+    }
+    
+    uint64_t getProgramCounter() const override {
+        return rip;
+    }
+    
+    void setProgramCounter(uint64_t pc) override {
+        rip = pc;
+    }
+    
+    void captureArchState(std::vector<uint64_t>& state) const override {
+        const uint64_t registers[] = {
+            rax, rbx, rcx, rdx, rsi, rdi, rbp, rsp, r8, r9, r10, r11, r12, r13, r14, r15, rip, rflags
+        };
+        state.assign(1, static_cast<uint64_t>(ARCH_STATE_TAG));
+        state.insert(state.end(), registers, registers + sizeof(registers) / sizeof(registers[0]));
+        state.push_back(instructionCount);
+    }
+    
+    bool restoreArchState(const std::vector<uint64_t>& state) override {
+        uint64_t* const registers[] = {
+            &rax, &rbx, &rcx, &rdx, &rsi, &rdi, &rbp, &rsp, &r8, &r9, &r10, &r11, &r12, &r13, &r14, &r15,
+            &rip, &rflags
+        };
+        const size_t count = sizeof(registers) / sizeof(registers[0]);
+        if (state.size() != count + 2 || state[0] != ARCH_STATE_TAG) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            *registers[i] = state[i + 1];
+        }
+        instructionCount = static_cast<uint32_t>(state[count + 1]);
+        return true;
+    }
+    
+    const S_DebugTarget& getDebugTarget() const override {
+        // gdb amd64使用i386核心特性：通用寄存器、段寄存器与x87寄存器
+        static const S_DebugRegisterInfo registers[] = {
+            { "rax", 64, "int64" }, { "rbx", 64, "int64" }, { "rcx", 64, "int64" }, { "rdx", 64, "int64" },
+            { "rsi", 64, "int64" }, { "rdi", 64, "int64" }, { "rbp", 64, "data_ptr" }, { "rsp", 64, "data_ptr" },
+            { "r8", 64, "int64" }, { "r9", 64, "int64" }, { "r10", 64, "int64" }, { "r11", 64, "int64" },
+            { "r12", 64, "int64" }, { "r13", 64, "int64" }, { "r14", 64, "int64" }, { "r15", 64, "int64" },
+            { "rip", 64, "code_ptr" }, { "eflags", 32, "int32" },
+            { "cs", 32, "int32" }, { "ss", 32, "int32" }, { "ds", 32, "int32" },
+            { "es", 32, "int32" }, { "fs", 32, "int32" }, { "gs", 32, "int32" },
+            { "st0", 80, "i387_ext" }, { "st1", 80, "i387_ext" }, { "st2", 80, "i387_ext" }, { "st3", 80, "i387_ext" },
+            { "st4", 80, "i387_ext" }, { "st5", 80, "i387_ext" }, { "st6", 80, "i387_ext" }, { "st7", 80, "i387_ext" },
+            { "fctrl", 32, "int" }, { "fstat", 32, "int" }, { "ftag", 32, "int" }, { "fiseg", 32, "int" },
+            { "fioff", 32, "int" }, { "foseg", 32, "int" }, { "fooff", 32, "int" }, { "fop", 32, "int" }
+        };
+        static const S_DebugTarget target = {
+            "i386:x86-64", "org.gnu.gdb.i386.core", registers,
+            static_cast<uint32_t>(sizeof(registers) / sizeof(registers[0])), 1, 1
+        };
+        return target;
+    }
+    
+    uint64_t readDebugRegister(uint32_t index) const override {
+        const uint64_t* const registers[DEBUG_GPR_COUNT] = {
+            &rax, &rbx, &rcx, &rdx, &rsi, &rdi, &rbp, &rsp, &r8, &r9, &r10, &r11, &r12, &r13, &r14, &r15,
+            &rip, &rflags
+        };
+        return index < DEBUG_GPR_COUNT ? *registers[index] : 0;
+    }
+    
+    void writeDebugRegister(uint32_t index, uint64_t value) override {
+        uint64_t* const registers[DEBUG_GPR_COUNT] = {
+            &rax, &rbx, &rcx, &rdx, &rsi, &rdi, &rbp, &rsp, &r8, &r9, &r10, &r11, &r12, &r13, &r14, &r15,
+            &rip, &rflags
+        };
+        if (index < DEBUG_GPR_COUNT) {
+            *registers[index] = value;
+        }
     }
     
     uint32_t getResourceUsage() override {
@@ -205,6 +328,11 @@ public:
         else if (regName == "r15") r15 = value;
     }
     
+protected:
+    void patchBreakpoint(uint8_t* code, uint64_t pc) const override {
+        code[pc] = OPCODE_BREAKPOINT;
+    }
+    
 private:
     /**
      * @brief 执行x64指令
@@ -242,6 +370,33 @@ private:
                 updateFlags64(rax);
                 break;
                 
+            case 0x0F: // VMCALL：RBX=请求数组地址，RCX=请求条数，RAX返回成功条数
+                rax = invokeHypercall(static_cast<uint32_t>(rbx), static_cast<uint32_t>(rcx));
+                break;
+                
+            case 0x30: // 定时器编程：RCX=模式（0停止/1单次/2周期），RAX=间隔tick
+                programTimer(static_cast<uint32_t>(rcx), rax);
+                break;
+                
+            case 0x31: { // RDTSC：EDX:EAX=虚拟时间（高32位清零）
+                uint64_t now = getVirtualTime();
+                rax = now & 0xFFFFFFFF;
+                rdx = now >> 32;
+                break;
+            }
+                
+            case 0xCF: { // IRETQ：返回被中断的位置（减1抵消执行后的rip++）；不在中断处理程序中时为空操作
+                uint64_t returnPc = 0;
+                if (leaveInterrupt(returnPc)) {
+                    rip = returnPc - 1;
+                }
+                break;
+            }
+                
+            case 0xF4: // HLT：停机直到中断到来
+                enterHalt();
+                break;
+                
             case 0x50: // PUSH r64 (简化版本)
                 push64(rax);
                 break;
@@ -250,6 +405,19 @@ private:
                 rax = pop64();
                 break;
                 
+            case OPCODE_BREAKPOINT: // INT3：调试器断点（载荷自身的0xCC按未知指令跳过）
+                if (!isBreakpointSite(rip)) {
+                    break;
+                }
+                if (hitBreakpoint(rip)) {
+                    // 停在断点处：抵消执行后的rip++与指令计数
+                    rip--;
+                    instructionCount--;
+                } else if (getOriginalCode()[rip] != OPCODE_BREAKPOINT) {
+                    executeX64Instruction(getOriginalCode()[rip]);
+                }
+                break;
+                
             default:
                 // 未知指令，简单跳过
                 break;
@@ -3,7 +3,6 @@
 
 #include "baseVM.h"
 #include <iostream>
-#include <stdexcept>
 
 /**
  * @brief x86 VM实现类，模拟x86架构的基本功能
@@ -18,6 +17,9 @@ private:
     static const uint32_t FLAG_ZF = 1 << 6;  // 零标志
     static const uint32_t FLAG_SF = 1 << 7;  // 符号标志
     static const uint32_t FLAG_OF = 1 << 11; // 溢出标志
+    static const uint64_t ARCH_STATE_TAG = 0x86; // 快照架构标记
+    static const uint8_t OPCODE_BREAKPOINT = 0xCC; // INT3：调试器断点陷阱指令
+    static const uint32_t DEBUG_GPR_COUNT = 10;  // 调试寄存器表中由上下文提供的寄存器数（其余读为0）
     
     uint32_t resourceLimit;     // 资源限制
     uint32_t instructionCount;  // 已执行指令计数
@@ -32,39 +34,61 @@ public:
                                  instructionCount(0) {}
     
     // 实现基类的纯虚函数
-    void start() override {
+    VmFaultCode start() override {
         if (isRunning) {
-            throw std::runtime_error("VM already running");
+            return raiseFault(VmFaultCode::ALREADY_RUNNING);
+        }
+        VmFaultCode admission = admitStart();
+        if (admission != VmFaultCode::NONE) {
+            return admission;
         }
         isRunning = true;
+        publishStatus();
         std::cout << "VM " << vmId << " started" << std::endl;
+        return VmFaultCode::NONE;
     }
     
-    void pause() override {
+    VmFaultCode pause() override {
         if (!isRunning) {
-            throw std::runtime_error("VM not running");
+            return raiseFault(VmFaultCode::NOT_RUNNING);
         }
         isRunning = false;
+        publishStatus();
         saveContext();
         std::cout << "VM " << vmId << " paused" << std::endl;
+        return VmFaultCode::NONE;
     }
     
-    void resume() override {
+    VmFaultCode resume() override {
         if (isRunning) {
-            throw std::runtime_error("VM already running");
+            return raiseFault(VmFaultCode::ALREADY_RUNNING);
+        }
+        VmFaultCode admission = admitStart();
+        if (admission != VmFaultCode::NONE) {
+            return admission;
         }
         loadContext();
         isRunning = true;
+        publishStatus();
         std::cout << "VM " << vmId << " resumed" << std::endl;
+        return VmFaultCode::NONE;
     }
     
     void stop() override {
+        bool wasRunning = isRunning;
         isRunning = false;
+        if (wasRunning) {
+            publishEvent(VmEventType::STOPPED, getProgramCounter());
+        }
         std::cout << "VM " << vmId << " stopped normally" << std::endl;
     }
     
     void forceStop() override {
+        bool wasRunning = isRunning;
         isRunning = false;
+        if (wasRunning) {
+            publishEvent(VmEventType::STOPPED, getProgramCounter());
+        }
         std::cout << "VM " << vmId << " force stopped" << std::endl;
     }
     
@@ -79,26 +103,35 @@ public:
     }
     
     bool runOneInstruction() override {
-        if (!isRunning || !payload || instructionCount >= resourceLimit) {
+        if (!isRunning || isHalted() || instructionCount >= resourceLimit) {
+            return false;
+        }
+        if (!payload) {
+            raiseFault(VmFaultCode::NO_PAYLOAD);
             return false;
         }
         
         // 简单的指令模拟 - 实际项目中会更复杂
         if (context.eip >= payloadSize) {
-            stop();
+            finishPayload();
             return false;
         }
         
         // 模拟执行一条指令（这里简化处理）
+        uint32_t pcBefore = context.eip;
         uint8_t opcode = payload[context.eip];
         executeInstruction(opcode);
         
         context.eip++;
         instructionCount++;
+        if (observed) {
+            observeInstruction(pcBefore, context.eip);
+        }
         
         // 检查是否达到资源限制
         if (instructionCount >= resourceLimit) {
             std::cout << "VM " << vmId << " reached resource limit" << std::endl;
+            raiseFault(VmFaultCode::RESOURCE_LIMIT, resourceLimit);
             pause();
             return false;
         }
@@ -106,12 +139,29 @@ public:
         return true;
     }
     
-    bool runOneSlice() override {
+    VmFaultCode runOneSlice() override {
         // 执行固定数量的指令作为时间片
         const int SLICE_INSTRUCTIONS = 10;
         int executed = 0;
+        sliceFault = VmFaultCode::NONE;
+        
+        // 管理员控制线程正在对空闲VM执行控制动作时跳过本时间片
+        VmExecutionGuard guard(*this);
+        if (!guard.owns()) {
+            return VmFaultCode::NONE;
+        }
+        
+        // 块边界：先执行故障策略或管理员终端请求的暂停/停止/隔离/封禁
+        if (!applyPendingControl()) {
+            return VmFaultCode::NONE;
+        }
+        
+        // 块边界：投递中断，停机且无中断时不占用时间片
+        if (!serviceInterrupts()) {
+            return VmFaultCode::NONE;
+        }
         
-        for (int i = 0; i < SLICE_INSTRUCTIONS && isRunning; i++) {
+        for (int i = 0; i < SLICE_INSTRUCTIONS && isRunning && !isHalted(); i++) {
             if (runOneInstruction()) {
                 executed++;
             } else {
@@ -120,7 +170,67 @@ public:
         }
         
         std::cout << "VM " << vmId << " executed " << executed << " instructions in slice" << std::endl;
-        return executed > 0;
+        return sliceFault;
+    }
+    
+    uint64_t getProgramCounter() const override {
+        return context.eip;
+    }
+    
+    void setProgramCounter(uint64_t pc) override {
+        context.eip = static_cast<uint32_t>(pc);
+    }
+    
+    void captureArchState(std::vector<uint64_t>& state) const override {
+        // 寄存器都在公共上下文中，只需保存架构标记与指令计数
+        state.assign(1, static_cast<uint64_t>(ARCH_STATE_TAG));
+        state.push_back(instructionCount);
+    }
+    
+    bool restoreArchState(const std::vector<uint64_t>& state) override {
+        if (state.size() != 2 || state[0] != ARCH_STATE_TAG) {
+            return false;
+        }
+        instructionCount = static_cast<uint32_t>(state[1]);
+        return true;
+    }
+    
+    const S_DebugTarget& getDebugTarget() const override {
+        // gdb i386核心特性要求的寄存器：通用寄存器、段寄存器与x87寄存器
+        static const S_DebugRegisterInfo registers[] = {
+            { "eax", 32, "int32" }, { "ecx", 32, "int32" }, { "edx", 32, "int32" }, { "ebx", 32, "int32" },
+            { "esp", 32, "data_ptr" }, { "ebp", 32, "data_ptr" }, { "esi", 32, "int32" }, { "edi", 32, "int32" },
+            { "eip", 32, "code_ptr" }, { "eflags", 32, "int32" },
+            { "cs", 32, "int32" }, { "ss", 32, "int32" }, { "ds", 32, "int32" },
+            { "es", 32, "int32" }, { "fs", 32, "int32" }, { "gs", 32, "int32" },
+            { "st0", 80, "i387_ext" }, { "st1", 80, "i387_ext" }, { "st2", 80, "i387_ext" }, { "st3", 80, "i387_ext" },
+            { "st4", 80, "i387_ext" }, { "st5", 80, "i387_ext" }, { "st6", 80, "i387_ext" }, { "st7", 80, "i387_ext" },
+            { "fctrl", 32, "int" }, { "fstat", 32, "int" }, { "ftag", 32, "int" }, { "fiseg", 32, "int" },
+            { "fioff", 32, "int" }, { "foseg", 32, "int" }, { "fooff", 32, "int" }, { "fop", 32, "int" }
+        };
+        static const S_DebugTarget target = {
+            "i386", "org.gnu.gdb.i386.core", registers,
+            static_cast<uint32_t>(sizeof(registers) / sizeof(registers[0])), 1, 1
+        };
+        return target;
+    }
+    
+    uint64_t readDebugRegister(uint32_t index) const override {
+        const uint32_t* const registers[DEBUG_GPR_COUNT] = {
+            &context.eax, &context.ecx, &context.edx, &context.ebx, &context.esp,
+            &context.ebp, &context.esi, &context.edi, &context.eip, &context.eflags
+        };
+        return index < DEBUG_GPR_COUNT ? *registers[index] : 0;
+    }
+    
+    void writeDebugRegister(uint32_t index, uint64_t value) override {
+        uint32_t* const registers[DEBUG_GPR_COUNT] = {
+            &context.eax, &context.ecx, &context.edx, &context.ebx, &context.esp,
+            &context.ebp, &context.esi, &context.edi, &context.eip, &context.eflags
+        };
+        if (index < DEBUG_GPR_COUNT) {
+            *registers[index] = static_cast<uint32_t>(value);
+        }
     }
     
     uint32_t getResourceUsage() override {
@@ -132,6 +242,11 @@ public:
         std::cout << "VM " << vmId << " resource limit set to " << limit << std::endl;
     }
     
+protected:
+    void patchBreakpoint(uint8_t* code, uint64_t pc) const override {
+        code[pc] = OPCODE_BREAKPOINT;
+    }
+    
 private:
     /**
      * @brief 执行单条指令
@@ -180,6 +295,46 @@ private:
                 }
                 break;
                 
+            case 0x0F: // VMCALL：EBX=请求数组地址，ECX=请求条数，EAX返回成功条数
+                context.eax = invokeHypercall(context.ebx, context.ecx);
+                break;
+                
+            case 0x30: // 定时器编程：ECX=模式（0停止/1单次/2周期），EAX=间隔tick
+                programTimer(context.ecx, context.eax);
+                break;
+                
+            case 0x31: { // RDTSC：EDX:EAX=虚拟时间
+                uint64_t now = getVirtualTime();
+                context.eax = static_cast<uint32_t>(now);
+                context.edx = static_cast<uint32_t>(now >> 32);
+                break;
+            }
+                
+            case 0xCF: { // IRET：返回被中断的位置（减1抵消执行后的eip++）；不在中断处理程序中时为空操作
+                uint64_t returnPc = 0;
+                if (leaveInterrupt(returnPc)) {
+                    context.eip = static_cast<uint32_t>(returnPc) - 1;
+                }
+                break;
+            }
+                
+            case 0xF4: // HLT：停机直到中断到来
+                enterHalt();
+                break;
+                
+            case OPCODE_BREAKPOINT: // INT3：调试器断点（载荷自身的0xCC按未知指令跳过）
+                if (!isBreakpointSite(context.eip)) {
+                    break;
+                }
+                if (hitBreakpoint(context.eip)) {
+                    // 停在断点处：抵消执行后的eip++与指令计数
+                    context.eip--;
+                    instructionCount--;
+                } else if (getOriginalCode()[context.eip] != OPCODE_BREAKPOINT) {
+                    executeInstruction(getOriginalCode()[context.eip]);
+                }
+                break;
+                
             default:
                 // 未知指令，简单跳过
                 break;
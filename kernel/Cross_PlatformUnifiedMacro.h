@@ -126,6 +126,18 @@ static inline int FileExists(const char* path) {
 #endif
 }
 
+// 把文件数据刷到持久存储（跨平台统一接口，不强制刷新与数据无关的元数据）
+// 返回值：0=成功，非0=失败
+static inline int FileDataSync(int fd) {
+#ifdef PLATFORM_WINDOWS
+    return _commit(fd);
+#elif defined(PLATFORM_LINUX)
+    return fdatasync(fd);
+#else
+    return fsync(fd); // macOS无fdatasync
+#endif
+}
+
 // 获取系统CPU核心数（跨平台统一接口）
 // 返回值：CPU核心数（失败返回-1）
 static inline int GetCPUCoreCount() {
@@ -170,6 +182,23 @@ static inline int SetThreadCPUAffinity(int cpu_index) {
 #endif
 }
 
+// 把当前线程提升为实时调度优先级（跨平台统一接口）
+// 参数：level - 距最高优先级的级数（0表示最高）
+// 返回值：0=成功，非0=失败（Linux需要CAP_SYS_NICE或root）
+static inline int SetThreadRealtimePriority(int level) {
+#ifdef PLATFORM_WINDOWS
+    int priority = (level == 0) ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+    return SetThreadPriority(GetCurrentThread(), priority) ? 0 : -2;
+#elif defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS)
+    // Linux/macOS：SCHED_FIFO，同优先级先到先服务，不被普通线程抢占
+    struct sched_param param;
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO) - level;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#else
+    return -3; // 未知平台不支持
+#endif
+}
+
 /************************* 兼容性宏（避免重复定义） *************************/
 // 修复Windows下缺少的Unix风格宏
 #ifdef PLATFORM_WINDOWS
@@ -0,0 +1,340 @@
+#include "admin_control.h"
+#include "../dispatch/scheduler.h"
+#include "../security/operation_log.h"
+#include "../Cross_PlatformUnifiedMacro.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+namespace {
+
+uint64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 控制线程的通用准备：绑定核心并提升为实时优先级，失败只告警
+void prepareControlThread(const char* name, int coreId, int priorityLevel) {
+    if (coreId >= 0 && SetThreadCPUAffinity(coreId) != 0) {
+        std::cerr << "Warning: Failed to set admin " << name << " thread affinity to core " << coreId << std::endl;
+    }
+    if (SetThreadRealtimePriority(priorityLevel) != 0) {
+        std::cerr << "Warning: Failed to raise admin " << name
+                  << " thread to realtime priority (needs CAP_SYS_NICE), running at normal priority" << std::endl;
+    }
+}
+
+} // namespace
+
+AdminControlPlane::AdminControlPlane()
+    : commandChannel(COMMAND_CHANNEL_CAPACITY), inflightChannel(INFLIGHT_CAPACITY), isRunning(false),
+      nextCommandId(1), scheduler(nullptr), operationLog(nullptr), deadlineUs(DEFAULT_DEADLINE_US),
+      submitted(0), rejected(0), failed(0), completed(0), deadlineMisses(0), latencyTotalNs(0), latencyMaxNs(0) {
+    for (uint32_t i = 0; i < LATENCY_BUCKETS; i++) {
+        latencyHistogram[i].store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < static_cast<size_t>(AdminCommandType::COUNT); i++) {
+        commandCounts[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+AdminControlPlane::~AdminControlPlane() {
+    stop();
+}
+
+void AdminControlPlane::start(int coreId) {
+    if (isRunning) {
+        return;
+    }
+    isRunning = true;
+    commandThread = std::thread(&AdminControlPlane::commandLoop, this, coreId);
+    watchdogThread = std::thread(&AdminControlPlane::watchdogLoop, this, coreId);
+}
+
+void AdminControlPlane::stop() {
+    if (!isRunning) {
+        return;
+    }
+    isRunning = false;
+    if (commandThread.joinable()) {
+        commandThread.join();
+    }
+    if (watchdogThread.joinable()) {
+        watchdogThread.join();
+    }
+}
+
+void AdminControlPlane::setOperationLog(OperationLog* log) {
+    operationLog.store(log, std::memory_order_release);
+}
+
+void AdminControlPlane::attachVm(const std::shared_ptr<I_VmInterface>& vm) {
+    if (!vm) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(vmMutex);
+    vmTable[vm->getVmId()] = vm;
+}
+
+void AdminControlPlane::detachVm(uint32_t vmId) {
+    std::lock_guard<std::mutex> lock(vmMutex);
+    vmTable.erase(vmId);
+}
+
+std::shared_ptr<I_VmInterface> AdminControlPlane::findVm(uint32_t vmId) {
+    std::lock_guard<std::mutex> lock(vmMutex);
+    auto it = vmTable.find(vmId);
+    return it != vmTable.end() ? it->second.lock() : std::shared_ptr<I_VmInterface>();
+}
+
+void AdminControlPlane::setDeadlineUs(uint32_t deadline) {
+    deadlineUs.store(deadline > 0 ? deadline : 1, std::memory_order_relaxed);
+}
+
+uint64_t AdminControlPlane::submit(AdminCommandType type, uint32_t target) {
+    if (!isRunning.load(std::memory_order_acquire) || type >= AdminCommandType::COUNT) {
+        return 0;
+    }
+    S_AdminCommand command;
+    command.type = type;
+    command.target = target;
+    command.id = nextCommandId.fetch_add(1, std::memory_order_relaxed);
+    command.submitNs = monotonicNs();
+    if (!commandChannel.tryPush(command)) {
+        rejected.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    submitted.fetch_add(1, std::memory_order_relaxed);
+    return command.id;
+}
+
+void AdminControlPlane::commandLoop(int coreId) {
+    prepareControlThread("command", coreId, 0);
+
+    // 实时优先级线程与其他核0线程共享核心，空闲时必须休眠而不是忙等
+    uint32_t idleRounds = 0;
+    S_AdminCommand command;
+    while (isRunning) {
+        if (!commandChannel.tryPop(command)) {
+            idleRounds++;
+            if (idleRounds < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            continue;
+        }
+        idleRounds = 0;
+
+        S_AdminInflight inflight;
+        inflight.command = command;
+        commandCounts[static_cast<size_t>(command.type)].fetch_add(1, std::memory_order_relaxed);
+        if (!execute(command, inflight)) {
+            failed.fetch_add(1, std::memory_order_relaxed);
+        }
+        // 失败的命令同样交给监测线程输出；队列满时在此等待监测线程，命令已下发，只是延迟确认
+        while (!inflightChannel.tryPush(inflight) && isRunning) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool AdminControlPlane::execute(const S_AdminCommand& command, S_AdminInflight& inflight) {
+    if (command.type == AdminCommandType::RECLAIM_CORE) {
+        if (!scheduler || !scheduler->requestCoreReclaim(command.target)) {
+            inflight.failure = "is not a VM pool core";
+            return false;
+        }
+    } else {
+        std::shared_ptr<I_VmInterface> vm = findVm(command.target);
+        if (!vm) {
+            inflight.failure = "not found";
+            return false;
+        }
+        inflight.vm = vm;
+        // 已处于更高或同级控制状态时请求不会提升级别，但命令同样视为生效；
+        // VM空闲时直接在本线程执行，否则由执行者在下一个时间片边界执行
+        switch (command.type) {
+            case AdminCommandType::FORCE_STOP:
+                vm->requestControl(VmControlAction::KILL);
+                vm->applyControlIfIdle();
+                break;
+            case AdminCommandType::BAN:
+                vm->requestControl(VmControlAction::BAN);
+                vm->applyControlIfIdle();
+                break;
+            case AdminCommandType::UNBAN:
+                if (!vm->releaseBan()) {
+                    inflight.failure = "is not banned";
+                    return false;
+                }
+                break;
+            default:
+                inflight.failure = "unknown command";
+                return false;
+        }
+    }
+    return true;
+}
+
+void AdminControlPlane::report(const S_AdminInflight& inflight) {
+    const S_AdminCommand& command = inflight.command;
+    const char* targetKind = (command.type == AdminCommandType::RECLAIM_CORE) ? "core " : "VM ";
+    if (inflight.failure) {
+        std::cout << "[ADMIN] Command " << command.id << ": " << targetKind << command.target
+                  << " " << inflight.failure << std::endl;
+        return;
+    }
+
+    OperationLog* log = operationLog.load(std::memory_order_acquire);
+    if (!log) {
+        return;
+    }
+    switch (command.type) {
+        case AdminCommandType::FORCE_STOP:
+            log->append(OpLogEvent::VM_FORCE_STOP, command.target, "admin force stop");
+            break;
+        case AdminCommandType::BAN:
+            log->append(OpLogEvent::USER_BAN, command.target, "admin ban (per VM)");
+            break;
+        case AdminCommandType::UNBAN:
+            log->append(OpLogEvent::USER_UNBAN, command.target, "admin unban");
+            break;
+        case AdminCommandType::RECLAIM_CORE:
+            log->append(OpLogEvent::CORE_UNBIND, 0, "admin reclaim core " + std::to_string(command.target));
+            break;
+        default:
+            break;
+    }
+}
+
+bool AdminControlPlane::isEffective(S_AdminInflight& inflight) {
+    const S_AdminCommand& command = inflight.command;
+    switch (command.type) {
+        case AdminCommandType::RECLAIM_CORE:
+            return scheduler && scheduler->consumeReclaimCompletion(command.target);
+        case AdminCommandType::UNBAN:
+            return true;
+        default: {
+            std::shared_ptr<I_VmInterface> vm = inflight.vm.lock();
+            if (!vm) {
+                return true; // VM已被删除
+            }
+            VmControlAction required = (command.type == AdminCommandType::BAN) ? VmControlAction::BAN
+                                                                              : VmControlAction::KILL;
+            return vm->getControlHold() >= required && !vm->getRunningStatus();
+        }
+    }
+}
+
+void AdminControlPlane::recordLatency(uint64_t latencyNs) {
+    completed.fetch_add(1, std::memory_order_relaxed);
+    latencyTotalNs.fetch_add(latencyNs, std::memory_order_relaxed);
+    uint64_t currentMax = latencyMaxNs.load(std::memory_order_relaxed);
+    while (latencyNs > currentMax &&
+           !latencyMaxNs.compare_exchange_weak(currentMax, latencyNs, std::memory_order_relaxed)) {
+    }
+
+    // 第i桶覆盖[2^(i-1), 2^i)微秒，第0桶为不足1微秒
+    uint64_t latencyUs = latencyNs / 1000;
+    uint32_t bucket = 0;
+    while (latencyUs > 0 && bucket < LATENCY_BUCKETS - 1) {
+        latencyUs >>= 1;
+        bucket++;
+    }
+    latencyHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void AdminControlPlane::watchdogLoop(int coreId) {
+    prepareControlThread("watchdog", coreId, 1);
+
+    std::vector<S_AdminInflight> pending;
+    S_AdminInflight inflight;
+    while (isRunning) {
+        while (inflightChannel.tryPop(inflight)) {
+            report(inflight);
+            if (!inflight.failure) {
+                pending.push_back(inflight);
+            }
+        }
+
+        uint64_t nowNs = monotonicNs();
+        uint64_t deadlineNs = static_cast<uint64_t>(deadlineUs.load(std::memory_order_relaxed)) * 1000ULL;
+        for (size_t i = 0; i < pending.size();) {
+            S_AdminInflight& entry = pending[i];
+            uint64_t elapsedNs = nowNs - entry.command.submitNs;
+            if (isEffective(entry)) {
+                recordLatency(elapsedNs);
+                if (entry.deadlineMissed) {
+                    std::cout << "[ADMIN] Command " << entry.command.id << " ("
+                              << GetAdminCommandName(entry.command.type) << " " << entry.command.target
+                              << ") took effect after " << elapsedNs / 1000 << "us" << std::endl;
+                }
+                pending[i] = pending.back();
+                pending.pop_back();
+                continue;
+            }
+            if (!entry.deadlineMissed && elapsedNs > deadlineNs) {
+                entry.deadlineMissed = true;
+                deadlineMisses.fetch_add(1, std::memory_order_relaxed);
+                std::cout << "[ADMIN] Warning: command " << entry.command.id << " ("
+                          << GetAdminCommandName(entry.command.type) << " " << entry.command.target
+                          << ") missed its " << deadlineNs / 1000 << "us deadline" << std::endl;
+            }
+            i++;
+        }
+
+        // 有待确认命令时按调度节拍的细分轮询，否则低频检查
+        std::this_thread::sleep_for(std::chrono::microseconds(pending.empty() ? 1000 : 100));
+    }
+}
+
+std::string AdminControlPlane::getStatistics() const {
+    uint64_t count = completed.load(std::memory_order_relaxed);
+    std::ostringstream oss;
+    oss << "=== Admin Control Plane ===" << std::endl;
+    oss << "Control Threads: " << (isRunning ? "RUNNING" : "STOPPED") << " (core " << ADMIN_CORE << ")" << std::endl;
+    oss << "Submitted: " << submitted.load(std::memory_order_relaxed)
+        << ", Rejected (channel full): " << rejected.load(std::memory_order_relaxed)
+        << ", Failed: " << failed.load(std::memory_order_relaxed) << std::endl;
+    oss << "Commands:";
+    for (size_t i = 0; i < static_cast<size_t>(AdminCommandType::COUNT); i++) {
+        oss << " " << GetAdminCommandName(static_cast<AdminCommandType>(i)) << "="
+            << commandCounts[i].load(std::memory_order_relaxed);
+    }
+    oss << std::endl;
+    oss << "Channel Depth: " << commandChannel.sizeApprox() << "/" << commandChannel.capacity() << std::endl;
+    oss << "Deadline: " << deadlineUs.load(std::memory_order_relaxed) << "us, Misses: "
+        << deadlineMisses.load(std::memory_order_relaxed) << std::endl;
+    oss << "Completed: " << count << std::endl;
+    if (count == 0) {
+        return oss.str();
+    }
+
+    // 由直方图估计p99（取所在桶的上界）
+    uint64_t p99Target = count - count / 100;
+    uint64_t cumulative = 0;
+    uint64_t p99UpperUs = 0;
+    for (uint32_t i = 0; i < LATENCY_BUCKETS; i++) {
+        cumulative += latencyHistogram[i].load(std::memory_order_relaxed);
+        if (cumulative >= p99Target) {
+            p99UpperUs = 1ULL << i;
+            break;
+        }
+    }
+    oss << std::fixed << std::setprecision(1);
+    oss << "Latency: avg " << latencyTotalNs.load(std::memory_order_relaxed) / 1000.0 / count
+        << "us, max " << latencyMaxNs.load(std::memory_order_relaxed) / 1000.0
+        << "us, p99 < " << p99UpperUs << "us" << std::endl;
+    oss << "Latency Histogram:" << std::endl;
+    for (uint32_t i = 0; i < LATENCY_BUCKETS; i++) {
+        uint64_t bucketCount = latencyHistogram[i].load(std::memory_order_relaxed);
+        if (bucketCount == 0) {
+            continue;
+        }
+        oss << "  < " << std::setw(8) << (1ULL << i) << "us: " << bucketCount << std::endl;
+    }
+    return oss.str();
+}
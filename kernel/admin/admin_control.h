@@ -0,0 +1,163 @@
+#ifndef ADMIN_CONTROL_H
+#define ADMIN_CONTROL_H
+
+#include <cstdint>
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include "../CPUvm/baseVM.h"
+#include "../common/lockfree_ring.h"
+
+class Scheduler;
+class OperationLog;
+
+/**
+ * @brief 管理员命令类型
+ */
+enum class AdminCommandType : uint8_t {
+    FORCE_STOP      = 0,    // 强制终结VM
+    BAN             = 1,    // 强制终结并封禁VM
+    UNBAN           = 2,    // 解除封禁
+    RECLAIM_CORE    = 3,    // 回收VM核池中的核心
+    COUNT
+};
+
+/**
+ * @brief 获取管理员命令的显示名称
+ */
+inline const char* GetAdminCommandName(AdminCommandType type) {
+    static const char* const names[] = {
+        "FORCE_STOP",
+        "BAN",
+        "UNBAN",
+        "RECLAIM_CORE"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(AdminCommandType::COUNT),
+                  "admin command name table out of sync with AdminCommandType");
+    uint8_t index = static_cast<uint8_t>(type);
+    return index < static_cast<uint8_t>(AdminCommandType::COUNT) ? names[index] : "UNKNOWN";
+}
+
+/**
+ * @brief 管理员命令（定长，经MPSC通道传递）
+ */
+struct S_AdminCommand {
+    AdminCommandType type;      // 命令类型
+    uint32_t target;            // 目标VM ID或核心ID
+    uint64_t id;                // 命令序号
+    uint64_t submitNs;          // 提交时间（单调时钟）
+
+    S_AdminCommand() : type(AdminCommandType::FORCE_STOP), target(0), id(0), submitNs(0) {}
+};
+
+/**
+ * @brief 已处理的命令（命令线程交给监测线程，由监测线程输出、写审计日志并确认生效）
+ */
+struct S_AdminInflight {
+    S_AdminCommand command;                 // 原始命令
+    std::weak_ptr<I_VmInterface> vm;        // 目标VM（核心回收时为空）
+    const char* failure;                    // 执行失败原因（静态字符串），nullptr表示已下发
+    bool deadlineMissed;                    // 已计入超时
+
+    S_AdminInflight() : failure(nullptr), deadlineMissed(false) {}
+};
+
+/**
+ * @brief 内核管理员控制面
+ * @details 两个绑定核0、实时优先级的线程：命令线程从专用MPSC通道取命令，通过控制标志
+ *          （VM控制请求、调度器核心回收位图）下发强制终结、封禁与核心回收，不获取调度器锁；
+ *          查找目标VM需短暂持有vmMutex，该锁只与VM登记/注销竞争。命令线程不输出、不写审计日志，
+ *          处理结果（含失败原因）全部交给监测线程。
+ *          监测线程输出失败命令、为已下发的命令写审计日志，并确认其生效（VM到达时间片边界完成停止、
+ *          调度器完成回收），统计从提交到生效的延迟分布，对超过时限的命令计数告警。
+ *          控制台等调用方的submit()无锁、不等待执行结果。
+ */
+class AdminControlPlane {
+public:
+    static const int ADMIN_CORE = 0;                        // 控制线程绑定的核心
+    static const uint32_t COMMAND_CHANNEL_CAPACITY = 256;   // 命令通道容量
+    static const uint32_t INFLIGHT_CAPACITY = 1024;         // 待确认命令容量
+    static const uint32_t DEFAULT_DEADLINE_US = 50000;      // 默认生效时限（调度节拍的数倍）
+    static const uint32_t LATENCY_BUCKETS = 32;             // 延迟直方图桶数（按2的幂微秒分桶）
+
+private:
+    MpscRing<S_AdminCommand> commandChannel;                // 专用命令通道
+    SpscRing<S_AdminInflight> inflightChannel;              // 命令线程 -> 监测线程
+    std::atomic<bool> isRunning;                            // 控制线程运行状态
+    std::thread commandThread;                              // 命令线程
+    std::thread watchdogThread;                             // 监测线程
+    std::atomic<uint64_t> nextCommandId;                    // 下一个命令序号
+
+    Scheduler* scheduler;                                   // 核心回收目标（start前设置）
+    std::atomic<OperationLog*> operationLog;                // 审计日志（可为空）
+    std::map<uint32_t, std::weak_ptr<I_VmInterface>> vmTable; // 命令目标VM
+    mutable std::mutex vmMutex;                             // 保护vmTable（仅登记/注销/查找）
+
+    std::atomic<uint32_t> deadlineUs;                       // 生效时限
+    std::atomic<uint64_t> submitted;                        // 已提交命令数
+    std::atomic<uint64_t> rejected;                         // 通道满被拒绝的命令数
+    std::atomic<uint64_t> failed;                           // 目标不存在等执行失败的命令数
+    std::atomic<uint64_t> completed;                        // 已确认生效的命令数
+    std::atomic<uint64_t> deadlineMisses;                   // 超过时限的命令数
+    std::atomic<uint64_t> latencyTotalNs;                   // 延迟累计
+    std::atomic<uint64_t> latencyMaxNs;                     // 最坏延迟
+    std::atomic<uint64_t> latencyHistogram[LATENCY_BUCKETS]; // 延迟直方图
+    std::atomic<uint64_t> commandCounts[static_cast<size_t>(AdminCommandType::COUNT)]; // 按类型统计
+
+    void commandLoop(int coreId);
+    void watchdogLoop(int coreId);
+    bool execute(const S_AdminCommand& command, S_AdminInflight& inflight);
+    void report(const S_AdminInflight& inflight);
+    bool isEffective(S_AdminInflight& inflight);
+    void recordLatency(uint64_t latencyNs);
+    std::shared_ptr<I_VmInterface> findVm(uint32_t vmId);
+
+public:
+    AdminControlPlane();
+    ~AdminControlPlane();
+    AdminControlPlane(const AdminControlPlane&) = delete;
+    AdminControlPlane& operator=(const AdminControlPlane&) = delete;
+
+    /**
+     * @brief 启动命令线程与监测线程
+     * @param coreId 绑定的核心，-1表示不绑定
+     */
+    void start(int coreId = ADMIN_CORE);
+
+    /**
+     * @brief 停止控制线程
+     */
+    void stop();
+
+    /**
+     * @brief 设置核心回收目标与审计日志（start前调用）
+     */
+    void setScheduler(Scheduler* target) { scheduler = target; }
+    void setOperationLog(OperationLog* log);
+
+    /**
+     * @brief 登记/注销命令目标VM
+     */
+    void attachVm(const std::shared_ptr<I_VmInterface>& vm);
+    void detachVm(uint32_t vmId);
+
+    /**
+     * @brief 提交管理员命令（任意线程，无锁，不等待执行）
+     * @param type 命令类型
+     * @param target 目标VM ID或核心ID
+     * @return 命令序号，控制面未运行或通道已满返回0
+     */
+    uint64_t submit(AdminCommandType type, uint32_t target);
+
+    /**
+     * @brief 设置命令生效时限（微秒）
+     */
+    void setDeadlineUs(uint32_t deadline);
+
+    std::string getStatistics() const;
+};
+
+#endif // ADMIN_CONTROL_H
@@ -0,0 +1,720 @@
+#include "myos_api.h"
+#include "../Cross_PlatformUnifiedMacro.h"
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <new>
+#include "../CPUvm/x86Vm.h"
+#include "../CPUvm/armVm.h"
+#include "../CPUvm/x64Vm.h"
+#include "../dispatch/scheduler.h"
+#include "../dispatch/exception_handler.h"
+#include "../hypercall/hypercall.h"
+#include "../security/operation_log.h"
+#include "../common/lockfree_ring.h"
+#include "../event/vm_event_bus.h"
+
+#ifdef PLATFORM_LINUX
+#include <sys/eventfd.h>
+#endif
+
+namespace {
+
+const uint32_t DEFAULT_GUEST_MEMORY_SIZE = 64 * 1024;          // 与控制台创建的VM一致
+const uint32_t DEFAULT_GUEST_ADDRESS_SPACE = 4 * 1024 * 1024;
+const uint32_t DEFAULT_ASYNC_WORKERS = 2;
+const uint32_t DEFAULT_ASYNC_CAPACITY = 256;
+const uint32_t MAX_ASYNC_WORKERS = 64;
+
+/**
+ * @brief 异步执行请求
+ */
+struct S_ApiAsyncJob {
+    uint64_t ticket;                                // 请求号
+    std::shared_ptr<I_VmInterface> vm;              // 目标VM（句柄销毁后仍有效）
+    std::shared_ptr<std::vector<uint8_t>> payload;  // 载荷（VM只保存指针）
+    uint32_t steps;                                 // 指令数上限
+    myos_completion_fn callback;                    // 完成回调（nullptr表示放入完成队列）
+    void* userData;                                 // 用户数据
+
+    S_ApiAsyncJob() : ticket(0), steps(0), callback(nullptr), userData(nullptr) {}
+};
+
+/**
+ * @brief 按调用方声明的结构体大小输出（旧调用方只得到它认识的前缀字段）
+ */
+template <typename T>
+bool copyVersioned(T* dst, T src) {
+    if (!dst || dst->struct_size < sizeof(uint32_t)) {
+        return false;
+    }
+    uint32_t size = dst->struct_size < sizeof(T) ? dst->struct_size : static_cast<uint32_t>(sizeof(T));
+    src.struct_size = size;
+    std::memcpy(dst, &src, size);
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief 运行时：调度器、故障处理、宿主服务表与异步执行线程
+ */
+struct myos_runtime {
+    myos_runtime_config config;                     // 生效配置（oplog_path不保留）
+    std::unique_ptr<OperationLog> operationLog;     // 操作日志（未配置时为空）
+    VmEventBus eventBus;                            // VM事件总线（VM只保存指针，最后析构）
+    std::unique_ptr<ExceptionManager> exceptionManager;
+    std::unique_ptr<Scheduler> scheduler;
+    std::unique_ptr<HypercallTable> hypercalls;
+
+    std::mutex vmMutex;                             // 保护vms与nextVmId
+    std::map<uint32_t, myos_vm*> vms;               // 存活的VM句柄
+    uint32_t nextVmId;
+
+    std::deque<S_ApiAsyncJob> jobQueue;             // 待执行的异步请求
+    std::mutex jobMutex;
+    std::condition_variable jobCV;
+    bool stopping;
+    std::vector<std::thread> workers;
+    std::unique_ptr<MpscRing<myos_completion>> completions; // 无回调请求的完成队列（单消费者）
+    int eventFd;                                    // 完成通知eventfd（-1表示不支持）
+
+    std::atomic<uint32_t> outstanding;              // 已提交、完成记录尚未被取走的请求数
+    std::atomic<uint64_t> nextTicket;
+    std::atomic<uint64_t> asyncSubmitted;
+    std::atomic<uint64_t> asyncCompleted;
+    std::atomic<uint64_t> instructions;
+
+    myos_runtime() : nextVmId(1), stopping(false), eventFd(-1), outstanding(0), nextTicket(1),
+                     asyncSubmitted(0), asyncCompleted(0), instructions(0) {}
+
+    void workerLoop();
+    void complete(const S_ApiAsyncJob& job, myos_status status, uint32_t executed);
+    void appendLog(OpLogEvent event, uint32_t vmId, const std::string& detail) {
+        if (operationLog) {
+            operationLog->append(event, vmId, detail);
+        }
+    }
+};
+
+/**
+ * @brief VM句柄
+ */
+struct myos_vm {
+    myos_runtime* runtime;
+    myos_arch arch;
+    std::shared_ptr<I_VmInterface> vm;
+    std::shared_ptr<std::vector<uint8_t>> payload;
+};
+
+/**
+ * @brief 事件订阅句柄
+ */
+struct myos_subscription {
+    myos_runtime* runtime;
+    std::shared_ptr<VmEventSubscription> subscription;
+};
+
+/**
+ * @brief 快照句柄
+ */
+struct myos_snapshot {
+    S_VmSnapshot state;
+};
+
+namespace {
+
+/**
+ * @brief 持有执行权执行指令（同步与异步执行共用，与控制台vm run一致）
+ */
+myos_status executeSteps(myos_runtime* runtime, I_VmInterface& vm, uint32_t steps, uint32_t& executed) {
+    executed = 0;
+    VmExecutionGuard guard(vm);
+    if (!guard.owns()) {
+        return MYOS_ERROR_BUSY;
+    }
+    // 每步经runBatch投递中断、停机时推进虚拟时间，与调度器时间片内的行为一致
+    while (executed < steps && vm.getRunningStatus()) {
+        if (vm.hasPendingControl() && !vm.applyPendingControl()) {
+            break;
+        }
+        uint32_t ran = 0;
+        vm.runBatch(1, ran);
+        if (ran == 0) {
+            break;
+        }
+        executed += ran;
+    }
+    runtime->instructions.fetch_add(executed, std::memory_order_relaxed);
+    vm.publishEvent(VmEventType::RUN_COMPLETE, executed);
+    return MYOS_OK;
+}
+
+myos_status faultStatus(VmFaultCode fault) {
+    return fault == VmFaultCode::NONE ? MYOS_OK : MYOS_ERROR_VM_FAULT;
+}
+
+void signalEventFd(int fd) {
+#ifdef PLATFORM_LINUX
+    uint64_t one = 1;
+    if (fd >= 0 && write(fd, &one, sizeof(one)) < 0) {
+        // 计数溢出之前调用方必然已被唤醒，忽略
+    }
+#else
+    (void)fd;
+#endif
+}
+
+} // namespace
+
+void myos_runtime::workerLoop() {
+    for (;;) {
+        S_ApiAsyncJob job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobCV.wait(lock, [this] { return stopping || !jobQueue.empty(); });
+            if (jobQueue.empty()) {
+                return;
+            }
+            job = jobQueue.front();
+            jobQueue.pop_front();
+        }
+        uint32_t executed = 0;
+        myos_status status = executeSteps(this, *job.vm, job.steps, executed);
+        complete(job, status, executed);
+    }
+}
+
+void myos_runtime::complete(const S_ApiAsyncJob& job, myos_status status, uint32_t executed) {
+    myos_completion completion;
+    completion.ticket = job.ticket;
+    completion.vm_id = job.vm->getVmId();
+    completion.status = status;
+    completion.executed = executed;
+    completion.last_fault = static_cast<uint32_t>(job.vm->getLastFault().code);
+    completion.user_data = job.userData;
+    asyncCompleted.fetch_add(1, std::memory_order_relaxed);
+
+    if (job.callback) {
+        job.callback(&completion);
+        outstanding.fetch_sub(1, std::memory_order_acq_rel);
+        return;
+    }
+    // 提交时已按容量限制未取走的请求数，完成队列不会满
+    completions->tryPush(completion);
+    signalEventFd(eventFd);
+}
+
+/************************* 运行时 *************************/
+
+uint32_t myos_api_version(void) {
+    return MYOS_API_VERSION;
+}
+
+const char* myos_status_name(myos_status status) {
+    static const char* const names[] = {
+        "OK",
+        "INVALID_ARGUMENT",
+        "UNSUPPORTED",
+        "BUSY",
+        "VM_FAULT",
+        "SCHEDULER",
+        "MISMATCH",
+        "CANCELLED",
+        "INTERNAL"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == MYOS_ERROR_INTERNAL + 1,
+                  "status name table out of sync with myos_status");
+    uint32_t index = static_cast<uint32_t>(status);
+    return index <= MYOS_ERROR_INTERNAL ? names[index] : "UNKNOWN";
+}
+
+const char* myos_fault_name(uint32_t fault) {
+    return fault < static_cast<uint32_t>(VmFaultCode::COUNT) ? GetVmFaultName(static_cast<VmFaultCode>(fault))
+                                                             : "UNKNOWN";
+}
+
+void myos_runtime_config_init(myos_runtime_config* config) {
+    if (!config) {
+        return;
+    }
+    myos_runtime_config defaults;
+    defaults.struct_size = sizeof(myos_runtime_config);
+    defaults.guest_memory_size = DEFAULT_GUEST_MEMORY_SIZE;
+    defaults.address_space_size = DEFAULT_GUEST_ADDRESS_SPACE;
+    defaults.async_workers = DEFAULT_ASYNC_WORKERS;
+    defaults.async_capacity = DEFAULT_ASYNC_CAPACITY;
+    defaults.oplog_path = nullptr;
+    *config = defaults;
+}
+
+myos_status myos_runtime_create(const myos_runtime_config* config, myos_runtime** out) {
+    if (!out) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+
+    // 旧调用方的配置结构体较短，未提供的字段取默认值；较新的调用方多出的字段忽略
+    myos_runtime_config effective;
+    myos_runtime_config_init(&effective);
+    if (config) {
+        if (config->struct_size < sizeof(uint32_t)) {
+            return MYOS_ERROR_INVALID_ARGUMENT;
+        }
+        std::memcpy(&effective, config, config->struct_size < sizeof(myos_runtime_config)
+                                            ? config->struct_size : sizeof(myos_runtime_config));
+        effective.struct_size = sizeof(myos_runtime_config);
+    }
+    if (effective.guest_memory_size == 0 || effective.address_space_size < effective.guest_memory_size ||
+        effective.async_workers == 0 || effective.async_workers > MAX_ASYNC_WORKERS ||
+        effective.async_capacity == 0) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+
+    try {
+        std::unique_ptr<myos_runtime> runtime(new myos_runtime());
+        if (effective.oplog_path) {
+            runtime->operationLog.reset(new OperationLog());
+            std::string error;
+            if (!runtime->operationLog->open(effective.oplog_path, error)) {
+                return MYOS_ERROR_INVALID_ARGUMENT;
+            }
+            runtime->operationLog->start();
+        }
+        effective.oplog_path = nullptr;
+        runtime->config = effective;
+
+        runtime->exceptionManager.reset(new ExceptionManager());
+        runtime->exceptionManager->setOperationLog(runtime->operationLog.get());
+        runtime->scheduler.reset(new Scheduler());
+        runtime->scheduler->setExceptionManager(runtime->exceptionManager.get());
+        runtime->exceptionManager->start();
+        runtime->hypercalls.reset(new HypercallTable());
+
+        runtime->completions.reset(new MpscRing<myos_completion>(effective.async_capacity));
+#ifdef PLATFORM_LINUX
+        runtime->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+        for (uint32_t i = 0; i < effective.async_workers; i++) {
+            runtime->workers.push_back(std::thread(&myos_runtime::workerLoop, runtime.get()));
+        }
+        *out = runtime.release();
+        return MYOS_OK;
+    } catch (...) {
+        return MYOS_ERROR_INTERNAL;
+    }
+}
+
+void myos_runtime_destroy(myos_runtime* runtime) {
+    if (!runtime) {
+        return;
+    }
+
+    // 取消未执行的请求，等待执行中的请求完成
+    std::deque<S_ApiAsyncJob> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(runtime->jobMutex);
+        runtime->stopping = true;
+        cancelled.swap(runtime->jobQueue);
+    }
+    runtime->jobCV.notify_all();
+    for (auto& worker : runtime->workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    for (const auto& job : cancelled) {
+        runtime->complete(job, MYOS_ERROR_CANCELLED, 0);
+    }
+
+    // 调度器停止后不再有故障上报，再停止故障处理与日志
+    runtime->scheduler->stop();
+    runtime->exceptionManager->stop();
+
+    std::map<uint32_t, myos_vm*> remaining;
+    {
+        std::lock_guard<std::mutex> lock(runtime->vmMutex);
+        remaining.swap(runtime->vms);
+    }
+    for (auto& pair : remaining) {
+        delete pair.second;
+    }
+    runtime->scheduler.reset();
+    runtime->exceptionManager.reset();
+    if (runtime->operationLog) {
+        runtime->operationLog->stop();
+    }
+#ifdef PLATFORM_LINUX
+    if (runtime->eventFd >= 0) {
+        close(runtime->eventFd);
+    }
+#endif
+    delete runtime;
+}
+
+int myos_runtime_event_fd(myos_runtime* runtime) {
+    return runtime ? runtime->eventFd : -1;
+}
+
+size_t myos_runtime_poll_completions(myos_runtime* runtime, myos_completion* out, size_t max_count) {
+    if (!runtime || !out || max_count == 0) {
+        return 0;
+    }
+#ifdef PLATFORM_LINUX
+    // 先清除通知计数再取记录，之后完成的请求会重新置位
+    uint64_t value = 0;
+    if (runtime->eventFd >= 0 && read(runtime->eventFd, &value, sizeof(value)) < 0) {
+        // 非阻塞eventfd没有计数时返回EAGAIN
+    }
+#endif
+    size_t count = 0;
+    while (count < max_count && runtime->completions->tryPop(out[count])) {
+        count++;
+    }
+    if (count > 0) {
+        runtime->outstanding.fetch_sub(static_cast<uint32_t>(count), std::memory_order_acq_rel);
+    }
+    // 本次没有取完时保持可读
+    if (!runtime->completions->empty()) {
+        signalEventFd(runtime->eventFd);
+    }
+    return count;
+}
+
+myos_status myos_runtime_get_metrics(myos_runtime* runtime, myos_metrics* metrics) {
+    if (!runtime || !metrics) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    myos_metrics result;
+    std::memset(&result, 0, sizeof(result));
+    {
+        std::lock_guard<std::mutex> lock(runtime->vmMutex);
+        result.vm_count = static_cast<uint32_t>(runtime->vms.size());
+    }
+    result.instructions_executed = runtime->instructions.load(std::memory_order_relaxed);
+    result.async_submitted = runtime->asyncSubmitted.load(std::memory_order_relaxed);
+    result.async_completed = runtime->asyncCompleted.load(std::memory_order_relaxed);
+
+    S_SchedulerCounters counters = runtime->scheduler->getCounters();
+    result.sched_running = counters.running ? 1 : 0;
+    result.sched_vm_cores = counters.vmCores;
+    result.sched_static_bindings = counters.staticBindings;
+    result.sched_queued_vms = counters.queuedVms;
+    result.sched_slice_faults = counters.sliceFaults;
+    result.sched_timer_fast_forwards = counters.timerFastForwards;
+    result.sched_core_reclaims = counters.coreReclaims;
+    return copyVersioned(metrics, result) ? MYOS_OK : MYOS_ERROR_INVALID_ARGUMENT;
+}
+
+/************************* VM *************************/
+
+myos_status myos_vm_create(myos_runtime* runtime, myos_arch arch, const void* payload, size_t size,
+                           myos_vm** out) {
+    if (!runtime || !payload || size == 0 || !out) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+    try {
+        std::unique_ptr<myos_vm> handle(new myos_vm());
+        handle->runtime = runtime;
+        handle->arch = arch;
+        const uint8_t* bytes = static_cast<const uint8_t*>(payload);
+        handle->payload = std::make_shared<std::vector<uint8_t>>(bytes, bytes + size);
+
+        std::lock_guard<std::mutex> lock(runtime->vmMutex);
+        uint32_t vmId = runtime->nextVmId;
+        switch (arch) {
+            case MYOS_ARCH_X86: handle->vm = std::make_shared<X86Vm>(vmId); break;
+            case MYOS_ARCH_ARM: handle->vm = std::make_shared<ArmVm>(vmId); break;
+            case MYOS_ARCH_X64: handle->vm = std::make_shared<X64Vm>(vmId); break;
+            default: return MYOS_ERROR_INVALID_ARGUMENT;
+        }
+        handle->vm->setPayload(handle->payload->data(), handle->payload->size());
+        if (!handle->vm->getMemory().allocate(runtime->config.guest_memory_size, GUEST_PERM_RW,
+                                              runtime->config.address_space_size)) {
+            return MYOS_ERROR_INTERNAL;
+        }
+        handle->vm->setHypercallHandler(runtime->hypercalls.get());
+        handle->vm->setEventSink(&runtime->eventBus);
+        runtime->exceptionManager->attachVm(handle->vm);
+        runtime->nextVmId++;
+        runtime->vms[vmId] = handle.get();
+        *out = handle.release();
+        return MYOS_OK;
+    } catch (...) {
+        return MYOS_ERROR_INTERNAL;
+    }
+}
+
+void myos_vm_destroy(myos_vm* vm) {
+    if (!vm) {
+        return;
+    }
+    myos_runtime* runtime = vm->runtime;
+    uint32_t vmId = vm->vm->getVmId();
+    {
+        std::lock_guard<std::mutex> lock(runtime->vmMutex);
+        runtime->vms.erase(vmId);
+    }
+    // 先从调度器移除，之后调度器不会再启动它；再在执行权下强制停止，
+    // 取得执行权即表示正在执行的时间片已结束，随后释放句柄
+    runtime->scheduler->removeVm(vmId);
+    vm->vm->requestControl(VmControlAction::KILL);
+    while (!vm->vm->applyControlIfIdle()) {
+        std::this_thread::yield();
+    }
+    runtime->exceptionManager->detachVm(vmId);
+    runtime->appendLog(OpLogEvent::VM_DELETE, vmId, "api vm destroy");
+    delete vm;
+}
+
+uint32_t myos_vm_id(const myos_vm* vm) {
+    return vm ? vm->vm->getVmId() : 0;
+}
+
+myos_status myos_vm_start(myos_vm* vm) {
+    return vm ? faultStatus(vm->vm->start()) : MYOS_ERROR_INVALID_ARGUMENT;
+}
+
+myos_status myos_vm_pause(myos_vm* vm) {
+    return vm ? faultStatus(vm->vm->pause()) : MYOS_ERROR_INVALID_ARGUMENT;
+}
+
+myos_status myos_vm_resume(myos_vm* vm) {
+    return vm ? faultStatus(vm->vm->resume()) : MYOS_ERROR_INVALID_ARGUMENT;
+}
+
+myos_status myos_vm_stop(myos_vm* vm) {
+    if (!vm) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    vm->vm->stop();
+    return MYOS_OK;
+}
+
+uint32_t myos_vm_last_fault(const myos_vm* vm) {
+    return vm ? static_cast<uint32_t>(vm->vm->getLastFault().code) : 0;
+}
+
+myos_status myos_vm_get_info(myos_vm* vm, myos_vm_info* info) {
+    if (!vm || !info) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    myos_vm_info result;
+    std::memset(&result, 0, sizeof(result));
+    result.vm_id = vm->vm->getVmId();
+    result.arch = static_cast<uint32_t>(vm->arch);
+    result.running = vm->vm->getRunningStatus() ? 1 : 0;
+    result.halted = vm->vm->isHalted() ? 1 : 0;
+    result.last_fault = static_cast<uint32_t>(vm->vm->getLastFault().code);
+    result.pc = vm->vm->getProgramCounter();
+    result.instructions = vm->vm->getResourceUsage();
+    result.virtual_time = vm->vm->getVirtualTime();
+    return copyVersioned(info, result) ? MYOS_OK : MYOS_ERROR_INVALID_ARGUMENT;
+}
+
+myos_status myos_vm_run(myos_vm* vm, uint32_t steps, uint32_t* executed) {
+    if (!vm) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    uint32_t count = 0;
+    myos_status status = executeSteps(vm->runtime, *vm->vm, steps, count);
+    if (executed) {
+        *executed = count;
+    }
+    return status;
+}
+
+myos_status myos_vm_run_async(myos_vm* vm, uint32_t steps, myos_completion_fn callback, void* user_data,
+                              uint64_t* ticket) {
+    if (!vm) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    myos_runtime* runtime = vm->runtime;
+    // 未取走的完成记录数不超过完成队列容量
+    uint32_t current = runtime->outstanding.load(std::memory_order_relaxed);
+    do {
+        if (current >= runtime->config.async_capacity) {
+            return MYOS_ERROR_BUSY;
+        }
+    } while (!runtime->outstanding.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel));
+
+    try {
+        S_ApiAsyncJob job;
+        job.ticket = runtime->nextTicket.fetch_add(1, std::memory_order_relaxed);
+        job.vm = vm->vm;
+        job.payload = vm->payload;
+        job.steps = steps;
+        job.callback = callback;
+        job.userData = user_data;
+        {
+            std::lock_guard<std::mutex> lock(runtime->jobMutex);
+            runtime->jobQueue.push_back(job);
+        }
+        runtime->jobCV.notify_one();
+        runtime->asyncSubmitted.fetch_add(1, std::memory_order_relaxed);
+        if (ticket) {
+            *ticket = job.ticket;
+        }
+        return MYOS_OK;
+    } catch (...) {
+        runtime->outstanding.fetch_sub(1, std::memory_order_acq_rel);
+        return MYOS_ERROR_INTERNAL;
+    }
+}
+
+/************************* 快照 *************************/
+
+myos_status myos_snapshot_capture(myos_vm* vm, myos_snapshot** out) {
+    if (!vm || !out) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+    try {
+        std::unique_ptr<myos_snapshot> snapshot(new myos_snapshot());
+        VmExecutionGuard guard(*vm->vm);
+        if (!guard.owns()) {
+            return MYOS_ERROR_BUSY;
+        }
+        vm->vm->captureSnapshot(snapshot->state);
+        *out = snapshot.release();
+        return MYOS_OK;
+    } catch (...) {
+        return MYOS_ERROR_INTERNAL;
+    }
+}
+
+myos_status myos_snapshot_restore(myos_vm* vm, const myos_snapshot* snapshot) {
+    if (!vm || !snapshot) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    VmExecutionGuard guard(*vm->vm);
+    if (!guard.owns()) {
+        return MYOS_ERROR_BUSY;
+    }
+    return vm->vm->restoreSnapshot(snapshot->state) ? MYOS_OK : MYOS_ERROR_MISMATCH;
+}
+
+size_t myos_snapshot_size(const myos_snapshot* snapshot) {
+    if (!snapshot) {
+        return 0;
+    }
+    const S_VmSnapshot& state = snapshot->state;
+    return state.memory.size() + state.archState.size() * sizeof(uint64_t) +
+           state.context.stack.size() * sizeof(uint32_t) + sizeof(S_VmSnapshot);
+}
+
+void myos_snapshot_destroy(myos_snapshot* snapshot) {
+    delete snapshot;
+}
+
+/************************* VM事件订阅 *************************/
+
+static_assert(sizeof(myos_event) == sizeof(S_VmEvent), "myos_event must match S_VmEvent layout");
+static_assert(offsetof(myos_event, vm_id) == offsetof(S_VmEvent, vmId) &&
+              offsetof(myos_event, type) == offsetof(S_VmEvent, type),
+              "myos_event must match S_VmEvent layout");
+static_assert(MYOS_EVENT_MASK_ALL == VM_EVENT_MASK_ALL, "myos event types out of sync with VmEventType");
+
+myos_status myos_event_subscribe(myos_runtime* runtime, uint32_t vm_id, uint32_t type_mask, size_t capacity,
+                                 myos_subscription** out) {
+    if (!runtime || !out) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    *out = nullptr;
+    try {
+        std::unique_ptr<myos_subscription> handle(new myos_subscription());
+        handle->runtime = runtime;
+        handle->subscription = runtime->eventBus.subscribe(type_mask == 0 ? VM_EVENT_MASK_ALL : type_mask, vm_id,
+                                                           capacity == 0 ? VmEventBus::DEFAULT_CAPACITY : capacity);
+        if (!handle->subscription) {
+            return MYOS_ERROR_INTERNAL;
+        }
+        *out = handle.release();
+        return MYOS_OK;
+    } catch (...) {
+        return MYOS_ERROR_INTERNAL;
+    }
+}
+
+void myos_event_unsubscribe(myos_subscription* subscription) {
+    if (!subscription) {
+        return;
+    }
+    subscription->runtime->eventBus.unsubscribe(subscription->subscription);
+    delete subscription;
+}
+
+int myos_subscription_event_fd(const myos_subscription* subscription) {
+    return subscription ? subscription->subscription->getEventFd() : -1;
+}
+
+size_t myos_subscription_poll(myos_subscription* subscription, myos_event* out, size_t max_count) {
+    if (!subscription || !out || max_count == 0) {
+        return 0;
+    }
+    // 布局相同（见上方static_assert），直接取到调用方缓冲区
+    return subscription->subscription->drain(reinterpret_cast<S_VmEvent*>(out), max_count);
+}
+
+uint64_t myos_subscription_dropped(const myos_subscription* subscription) {
+    return subscription ? subscription->subscription->getDropped() : 0;
+}
+
+/************************* 调度器 *************************/
+
+myos_status myos_sched_start(myos_runtime* runtime) {
+    if (!runtime) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    if (runtime->scheduler->getCounters().running) {
+        return MYOS_OK;
+    }
+    if (!runtime->scheduler->initialize()) {
+        return MYOS_ERROR_SCHEDULER;
+    }
+    runtime->scheduler->start();
+    return MYOS_OK;
+}
+
+myos_status myos_sched_stop(myos_runtime* runtime) {
+    if (!runtime) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    runtime->scheduler->stop();
+    return MYOS_OK;
+}
+
+myos_status myos_sched_add(myos_runtime* runtime, myos_vm* vm, uint32_t priority) {
+    if (!runtime || !vm || vm->runtime != runtime) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    return runtime->scheduler->addVm(vm->vm, priority) ? MYOS_OK : MYOS_ERROR_SCHEDULER;
+}
+
+myos_status myos_sched_bind(myos_runtime* runtime, myos_vm* vm, uint32_t core) {
+    if (!runtime || !vm || vm->runtime != runtime) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    return runtime->scheduler->applyStaticCore(vm->vm->getVmId(), core) ? MYOS_OK : MYOS_ERROR_SCHEDULER;
+}
+
+myos_status myos_sched_unbind(myos_runtime* runtime, myos_vm* vm) {
+    if (!runtime || !vm || vm->runtime != runtime) {
+        return MYOS_ERROR_INVALID_ARGUMENT;
+    }
+    uint32_t vmId = vm->vm->getVmId();
+    if (!runtime->scheduler->releaseStaticCore(vmId)) {
+        return MYOS_ERROR_SCHEDULER;
+    }
+    runtime->appendLog(OpLogEvent::CORE_UNBIND, vmId, "api sched unbind");
+    return MYOS_OK;
+}
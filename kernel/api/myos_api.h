@@ -0,0 +1,286 @@
+#ifndef MYOS_API_H
+#define MYOS_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief VM内核的嵌入式C接口（稳定C ABI，静态库/动态库共用）
+ * @details 宿主进程直接调用VM创建/执行/快照、调度器控制与指标读取，不经过控制台命令解析。
+ *          所有对象都是不透明句柄，只能通过本文件的函数访问；带struct_size字段的结构体
+ *          由调用方填写sizeof，库按较小的一方读写，新版本只在结构体末尾追加字段。
+ *          函数不抛出C++异常，失败时返回myos_status。
+ *          非阻塞执行（myos_vm_run_async）在库内执行线程上完成：提供回调时在执行线程上调用回调，
+ *          否则放入完成队列并使事件fd可读，调用方用myos_runtime_poll_completions()取出。
+ *          VM事件（停机、故障、资源限制、执行结束、停止）通过订阅接收：每个订阅有自己的
+ *          事件环与eventfd，调用方加入自己的epoll循环后用myos_subscription_poll()取出。
+ */
+
+/************************* 导出宏 *************************/
+// 与Cross_PlatformUnifiedMacro.h中的API_EXPORT一致；C调用方不需要引入该头文件中的平台函数
+#ifndef API_EXPORT
+    #ifdef _WIN32
+        #ifdef LIB_EXPORT
+            #define API_EXPORT __declspec(dllexport)
+        #else
+            #define API_EXPORT __declspec(dllimport)
+        #endif
+    #else
+        #define API_EXPORT __attribute__((visibility("default")))
+    #endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MYOS_API_VERSION 1      // ABI版本，不兼容修改时递增
+
+/************************* 不透明句柄 *************************/
+typedef struct myos_runtime myos_runtime;   // 运行时（调度器、故障处理、执行线程）
+typedef struct myos_vm myos_vm;             // VM
+typedef struct myos_snapshot myos_snapshot; // VM状态快照
+typedef struct myos_subscription myos_subscription; // VM事件订阅
+
+/**
+ * @brief 返回状态码
+ */
+typedef enum myos_status {
+    MYOS_OK                     = 0,    // 成功
+    MYOS_ERROR_INVALID_ARGUMENT = 1,    // 参数非法（空句柄、未知架构、空载荷等）
+    MYOS_ERROR_UNSUPPORTED      = 2,    // 当前平台不支持
+    MYOS_ERROR_BUSY             = 3,    // VM正被其他线程执行，或异步队列已满
+    MYOS_ERROR_VM_FAULT         = 4,    // VM拒绝操作，故障码见myos_vm_last_fault()
+    MYOS_ERROR_SCHEDULER        = 5,    // 调度器操作失败
+    MYOS_ERROR_MISMATCH         = 6,    // 快照与VM的架构或内存大小不一致
+    MYOS_ERROR_CANCELLED        = 7,    // 运行时销毁时尚未执行的异步请求
+    MYOS_ERROR_INTERNAL         = 8     // 内部错误（如内存不足）
+} myos_status;
+
+/**
+ * @brief VM架构
+ */
+typedef enum myos_arch {
+    MYOS_ARCH_X86 = 0,
+    MYOS_ARCH_ARM = 1,
+    MYOS_ARCH_X64 = 2
+} myos_arch;
+
+/**
+ * @brief 运行时配置（先用myos_runtime_config_init()填默认值）
+ */
+typedef struct myos_runtime_config {
+    uint32_t struct_size;           // sizeof(myos_runtime_config)
+    uint32_t guest_memory_size;     // 每个VM的客户机私有内存（字节）
+    uint32_t address_space_size;    // 每个VM的客户机地址空间（字节）
+    uint32_t async_workers;         // 异步执行线程数
+    uint32_t async_capacity;        // 同时未完成的异步请求上限
+    const char* oplog_path;         // 操作日志文件路径，NULL表示不记录
+} myos_runtime_config;
+
+/**
+ * @brief VM状态
+ */
+typedef struct myos_vm_info {
+    uint32_t struct_size;           // sizeof(myos_vm_info)
+    uint32_t vm_id;                 // VM ID
+    uint32_t arch;                  // myos_arch
+    uint32_t running;               // 运行中为1
+    uint32_t halted;                // 停机等待中断为1
+    uint32_t last_fault;            // 最近一次故障码（VmFaultCode）
+    uint64_t pc;                    // 程序计数器
+    uint64_t instructions;          // 已执行指令数
+    uint64_t virtual_time;          // 虚拟时间（tick）
+} myos_vm_info;
+
+/**
+ * @brief 运行时指标
+ */
+typedef struct myos_metrics {
+    uint32_t struct_size;               // sizeof(myos_metrics)
+    uint32_t vm_count;                  // 当前VM数
+    uint64_t instructions_executed;     // 经本接口执行的指令总数
+    uint64_t async_submitted;           // 已提交的异步请求数
+    uint64_t async_completed;           // 已完成的异步请求数（含取消）
+    uint32_t sched_running;             // 调度器运行中为1
+    uint32_t sched_vm_cores;            // 调度器可用核心数
+    uint32_t sched_static_bindings;     // 静态绑定数
+    uint32_t sched_queued_vms;          // 动态调度队列长度
+    uint64_t sched_slice_faults;        // 时间片故障次数
+    uint64_t sched_timer_fast_forwards; // 停机VM定时器快进次数
+    uint64_t sched_core_reclaims;       // 核心回收次数
+} myos_metrics;
+
+/**
+ * @brief 异步请求完成记录
+ */
+typedef struct myos_completion {
+    uint64_t ticket;                // 提交时返回的请求号
+    uint32_t vm_id;                 // 目标VM
+    int32_t status;                 // myos_status
+    uint32_t executed;              // 实际执行的指令数
+    uint32_t last_fault;            // 完成时VM的最近故障码
+    void* user_data;                // 提交时传入的用户数据
+} myos_completion;
+
+/**
+ * @brief 异步完成回调（在库内执行线程上调用，不能在回调中销毁运行时）
+ */
+typedef void (*myos_completion_fn)(const myos_completion* completion);
+
+/**
+ * @brief VM事件类型（myos_event.type）
+ */
+typedef enum myos_event_type {
+    MYOS_EVENT_HALTED = 0,          // 停机等待中断（detail为PC）
+    MYOS_EVENT_FAULT = 1,           // 故障（detail为故障码，见myos_fault_name）
+    MYOS_EVENT_RESOURCE_LIMIT = 2,  // 指令数达到资源限制（detail为限制值）
+    MYOS_EVENT_RUN_COMPLETE = 3,    // 一次同步/异步执行结束（detail为执行的指令数）
+    MYOS_EVENT_STOPPED = 4,         // VM停止（detail为PC）
+    MYOS_EVENT_PAYLOAD_SWAPPED = 5  // 热更新的载荷生效（detail为新的载荷版本号）
+} myos_event_type;
+
+#define MYOS_EVENT_MASK(type) (1u << (type))
+#define MYOS_EVENT_MASK_ALL 0x3Fu
+
+/**
+ * @brief VM事件记录（定长32字节，与控制套接字EVENT帧的载荷布局相同）
+ */
+typedef struct myos_event {
+    uint64_t timestamp_ns;          // 宿主单调时钟（纳秒）
+    uint64_t virtual_time;          // VM虚拟时间
+    uint64_t detail;                // 附加信息（含义见myos_event_type）
+    uint32_t vm_id;                 // 产生事件的VM
+    uint16_t type;                  // myos_event_type
+    uint16_t reserved;
+} myos_event;
+
+/************************* 运行时 *************************/
+API_EXPORT uint32_t myos_api_version(void);
+API_EXPORT const char* myos_status_name(myos_status status);
+API_EXPORT const char* myos_fault_name(uint32_t fault);
+
+API_EXPORT void myos_runtime_config_init(myos_runtime_config* config);
+
+/**
+ * @brief 创建运行时
+ * @param config 配置，NULL表示全部默认
+ * @param out 返回的运行时句柄
+ */
+API_EXPORT myos_status myos_runtime_create(const myos_runtime_config* config, myos_runtime** out);
+
+/**
+ * @brief 销毁运行时：取消未执行的异步请求、停止调度器并释放全部VM句柄
+ */
+API_EXPORT void myos_runtime_destroy(myos_runtime* runtime);
+
+/**
+ * @brief 获取完成通知事件fd（Linux eventfd，有完成记录时可读；其他平台返回-1）
+ * @details 可加入调用方自己的epoll/poll循环；读到可读后调用myos_runtime_poll_completions()
+ */
+API_EXPORT int myos_runtime_event_fd(myos_runtime* runtime);
+
+/**
+ * @brief 取出完成记录（只允许一个线程调用）
+ * @return 取出的记录数
+ */
+API_EXPORT size_t myos_runtime_poll_completions(myos_runtime* runtime, myos_completion* out, size_t max_count);
+
+API_EXPORT myos_status myos_runtime_get_metrics(myos_runtime* runtime, myos_metrics* metrics);
+
+/************************* VM *************************/
+/**
+ * @brief 创建VM（载荷由库复制保存）
+ */
+API_EXPORT myos_status myos_vm_create(myos_runtime* runtime, myos_arch arch, const void* payload, size_t size,
+                                      myos_vm** out);
+
+/**
+ * @brief 销毁VM句柄（仍在执行的异步请求照常完成）
+ */
+API_EXPORT void myos_vm_destroy(myos_vm* vm);
+
+API_EXPORT uint32_t myos_vm_id(const myos_vm* vm);
+API_EXPORT myos_status myos_vm_start(myos_vm* vm);
+API_EXPORT myos_status myos_vm_pause(myos_vm* vm);
+API_EXPORT myos_status myos_vm_resume(myos_vm* vm);
+API_EXPORT myos_status myos_vm_stop(myos_vm* vm);
+API_EXPORT uint32_t myos_vm_last_fault(const myos_vm* vm);
+API_EXPORT myos_status myos_vm_get_info(myos_vm* vm, myos_vm_info* info);
+
+/**
+ * @brief 在调用线程上执行最多steps条指令（阻塞）
+ * @param executed 实际执行的指令数，可为NULL
+ */
+API_EXPORT myos_status myos_vm_run(myos_vm* vm, uint32_t steps, uint32_t* executed);
+
+/**
+ * @brief 提交异步执行，立即返回
+ * @param callback 完成回调，NULL表示放入完成队列并通知事件fd
+ * @param user_data 原样带回的用户数据
+ * @param ticket 返回的请求号，可为NULL
+ */
+API_EXPORT myos_status myos_vm_run_async(myos_vm* vm, uint32_t steps, myos_completion_fn callback,
+                                         void* user_data, uint64_t* ticket);
+
+/************************* 快照 *************************/
+/**
+ * @brief 捕获VM状态快照（VM正被其他线程执行时返回MYOS_ERROR_BUSY）
+ */
+API_EXPORT myos_status myos_snapshot_capture(myos_vm* vm, myos_snapshot** out);
+
+/**
+ * @brief 把VM恢复到快照状态（可以恢复到同架构、同内存配置的另一个VM）
+ */
+API_EXPORT myos_status myos_snapshot_restore(myos_vm* vm, const myos_snapshot* snapshot);
+
+/**
+ * @brief 快照占用的状态字节数
+ */
+API_EXPORT size_t myos_snapshot_size(const myos_snapshot* snapshot);
+API_EXPORT void myos_snapshot_destroy(myos_snapshot* snapshot);
+
+/************************* VM事件订阅 *************************/
+/**
+ * @brief 订阅VM事件
+ * @param vm_id 只接收该VM的事件，0表示全部
+ * @param type_mask 事件类型掩码（MYOS_EVENT_MASK组合），0表示全部
+ * @param capacity 事件环容量，0表示默认；环满时新事件丢弃
+ * @details 事件在产生事件的线程上放入事件环，不经过库内线程；销毁运行时之前必须取消全部订阅
+ */
+API_EXPORT myos_status myos_event_subscribe(myos_runtime* runtime, uint32_t vm_id, uint32_t type_mask,
+                                            size_t capacity, myos_subscription** out);
+
+/**
+ * @brief 取消订阅并释放句柄
+ */
+API_EXPORT void myos_event_unsubscribe(myos_subscription* subscription);
+
+/**
+ * @brief 获取订阅的通知eventfd（有事件时可读；其他平台返回-1，只能轮询）
+ */
+API_EXPORT int myos_subscription_event_fd(const myos_subscription* subscription);
+
+/**
+ * @brief 取出事件（每个订阅只允许一个线程调用）
+ * @return 取出的事件数
+ */
+API_EXPORT size_t myos_subscription_poll(myos_subscription* subscription, myos_event* out, size_t max_count);
+
+/**
+ * @brief 因事件环满丢弃的事件数
+ */
+API_EXPORT uint64_t myos_subscription_dropped(const myos_subscription* subscription);
+
+/************************* 调度器 *************************/
+API_EXPORT myos_status myos_sched_start(myos_runtime* runtime);
+API_EXPORT myos_status myos_sched_stop(myos_runtime* runtime);
+API_EXPORT myos_status myos_sched_add(myos_runtime* runtime, myos_vm* vm, uint32_t priority);
+API_EXPORT myos_status myos_sched_bind(myos_runtime* runtime, myos_vm* vm, uint32_t core);
+API_EXPORT myos_status myos_sched_unbind(myos_runtime* runtime, myos_vm* vm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MYOS_API_H
@@ -0,0 +1,236 @@
+#ifndef LOCKFREE_RING_H
+#define LOCKFREE_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 缓存行大小，用于隔离生产者/消费者索引，避免伪共享
+static const size_t LOCKFREE_CACHE_LINE = 64;
+
+/**
+ * @brief 单生产者单消费者无锁环形队列
+ * @details 容量向上取整为2的幂，索引单调递增并用掩码取模。
+ *          生产者只写tail、消费者只写head，各自缓存对端索引以减少跨核缓存行往返。
+ *          同一时刻只允许一个线程调用push系列方法、一个线程调用pop系列方法。
+ */
+template <typename T>
+class SpscRing {
+private:
+    std::vector<T> slots;                   // 槽位数组
+    size_t mask;                            // 容量掩码
+
+    char padHead[LOCKFREE_CACHE_LINE];
+    std::atomic<size_t> head;               // 消费者索引（仅消费者写）
+    size_t cachedTail;                      // 消费者缓存的生产者索引
+
+    char padTail[LOCKFREE_CACHE_LINE];
+    std::atomic<size_t> tail;               // 生产者索引（仅生产者写）
+    size_t cachedHead;                      // 生产者缓存的消费者索引
+
+    char padEnd[LOCKFREE_CACHE_LINE];
+
+    static size_t roundUpPow2(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 期望容量（向上取整为2的幂）
+     */
+    explicit SpscRing(size_t capacity)
+        : slots(roundUpPow2(capacity)), mask(roundUpPow2(capacity) - 1),
+          head(0), cachedTail(0), tail(0), cachedHead(0) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief 生产者压入单个元素
+     * @return 队列已满返回false
+     */
+    bool tryPush(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead > mask) {
+                return false;
+            }
+        }
+        slots[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 生产者批量压入，只发布一次tail
+     * @return 实际压入的元素数量
+     */
+    size_t pushBatch(const T* values, size_t count) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t space = mask + 1 - (t - cachedHead);
+        if (space < count) {
+            cachedHead = head.load(std::memory_order_acquire);
+            space = mask + 1 - (t - cachedHead);
+        }
+        size_t n = count < space ? count : space;
+        for (size_t i = 0; i < n; i++) {
+            slots[(t + i) & mask] = values[i];
+        }
+        if (n > 0) {
+            tail.store(t + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /**
+     * @brief 消费者弹出单个元素
+     * @return 队列为空返回false
+     */
+    bool tryPop(T& out) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) {
+                return false;
+            }
+        }
+        out = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 消费者批量弹出，只发布一次head
+     * @return 实际弹出的元素数量
+     */
+    size_t popBatch(T* out, size_t maxCount) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t available = cachedTail - h;
+        if (available < maxCount) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            available = cachedTail - h;
+        }
+        size_t n = maxCount < available ? maxCount : available;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = slots[(h + i) & mask];
+        }
+        if (n > 0) {
+            head.store(h + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // 近似元素数量（任意线程可调用）；生产者调用时不小于实际数量，可据此判断是否有空位
+    size_t sizeApprox() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return mask + 1; }
+    bool empty() const { return sizeApprox() == 0; }
+};
+
+/**
+ * @brief 多生产者单消费者有界无锁队列（Vyukov有界队列）
+ * @details 每个槽带序号：序号等于位置时可写，等于位置+1时可读，消费后置为位置+容量。
+ *          生产者以CAS抢占tail，互不阻塞；队列满时tryPush立即返回false，
+ *          调用方自行决定丢弃或重试。只允许一个线程调用tryPop。
+ */
+template <typename T>
+class MpscRing {
+private:
+    struct S_Slot {
+        std::atomic<size_t> sequence;       // 槽状态序号
+        T value;                            // 元素
+    };
+
+    std::vector<S_Slot> slots;              // 槽位数组
+    size_t mask;                            // 容量掩码
+
+    char padTail[LOCKFREE_CACHE_LINE];
+    std::atomic<size_t> tail;               // 生产位置（生产者CAS）
+
+    char padHead[LOCKFREE_CACHE_LINE];
+    std::atomic<size_t> head;               // 消费位置（仅消费者写）
+
+    char padEnd[LOCKFREE_CACHE_LINE];
+
+    static size_t roundUpPow2(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 期望容量（向上取整为2的幂）
+     */
+    explicit MpscRing(size_t capacity)
+        : slots(roundUpPow2(capacity)), mask(roundUpPow2(capacity) - 1), tail(0), head(0) {
+        for (size_t i = 0; i < slots.size(); i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /**
+     * @brief 压入单个元素（任意线程）
+     * @return 队列已满返回false
+     */
+    bool tryPush(const T& value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            S_Slot& slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief 弹出单个元素（仅消费者线程）
+     * @return 队列为空（或队首槽尚未提交）返回false
+     */
+    bool tryPop(T& out) {
+        size_t position = head.load(std::memory_order_relaxed);
+        S_Slot& slot = slots[position & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
+        }
+        out = slot.value;
+        slot.sequence.store(position + mask + 1, std::memory_order_release);
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似元素数量（任意线程可调用）；生产者调用时不小于实际数量，可据此判断是否有空位
+    size_t sizeApprox() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return mask + 1; }
+    bool empty() const { return sizeApprox() == 0; }
+};
+
+#endif // LOCKFREE_RING_H
@@ -0,0 +1,79 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief 顺序锁保护的值（单写者、多读者，读者无锁且不阻塞写者）
+ * @details 写者把序号置为奇数、逐字写入数据、再把序号置为偶数；读者读取前后两次序号，
+ *          序号为奇数或前后不一致时重试。数据按64位字保存在原子变量中（relaxed访问），
+ *          读到一半的数据不会构成数据竞争，只会被序号校验丢弃。
+ *          多个写者必须由调用方串行化（例如都在同一把锁内调用store）。
+ *          T必须可平凡复制，适合几百字节以内、读远多于写的状态快照。
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+private:
+    static const size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence;         // 偶数：数据稳定；奇数：写入中
+    std::atomic<uint64_t> words[WORD_COUNT]; // 数据
+
+public:
+    SeqLock() : sequence(0) {
+        store(T());
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * @brief 写入新值（写者之间须已串行化）
+     */
+    void store(const T& value) {
+        uint64_t buffer[WORD_COUNT] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORD_COUNT; i++) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief 读取一致的值（写入进行中时自旋重试）
+     */
+    T load() const {
+        uint64_t buffer[WORD_COUNT];
+        uint32_t before;
+        uint32_t after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORD_COUNT; i++) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief 当前序号（每次写入加2，可用于判断是否有新数据）
+     */
+    uint32_t getSequence() const { return sequence.load(std::memory_order_acquire); }
+};
+
+#endif // SEQLOCK_H
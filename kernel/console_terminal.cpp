@@ -5,11 +5,120 @@
 #include <thread>
 #include <iomanip>
 #include <ctime>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+
+const uint32_t DEFAULT_GUEST_MEMORY_SIZE = 64 * 1024;  // 每个VM默认客户机内存大小
+const uint32_t DEFAULT_GUEST_ADDRESS_SPACE = 4 * 1024 * 1024; // 每个VM的地址空间（私有内存之上用于共享区域映射）
+const uint32_t NET_RX_BUFFER_COUNT = 8;                // net attach时预投递的接收缓冲数
+const char* const DEFAULT_OPLOG_PATH = "myos_oplog.bin"; // 操作日志文件（当前目录）
+const uint32_t SCRIPT_ASYNC_WORKERS = 4;               // 脚本异步命令执行线程数
+const uint32_t TRACE_DEFAULT_KB = 256;                 // trace start默认环形缓冲大小
+const uint32_t TRACE_MAX_KB = 64 * 1024;               // 单个VM跟踪缓冲上限
+const uint32_t TRACE_CLAIM_TIMEOUT_MS = 1000;          // trace命令等待VM执行权的时间
+const uint32_t FUZZ_DEFAULT_SECONDS = 10;              // fuzz run默认运行时间
+const uint32_t FUZZ_DEFAULT_INSTRUCTIONS = 10000;      // fuzz run默认每次执行的指令数
+const uint32_t CTF_DEFAULT_MAX_INSTANCES = 4;          // 每个选手默认同时存在的实例数
+const uint32_t CTF_INSTANCE_PRIORITY = 10;             // 调度器运行时新实例自动加入的优先级
+const int PAYLOAD_LOADER_CORE = 1;                     // 载荷加载线程绑定的核心（杂务核）
+const uint32_t LOAD_CLAIM_TIMEOUT_MS = 1000;           // 装入载荷时等待VM执行权的时间
+
+thread_local std::unique_lock<std::mutex>* tlsCommandLock = nullptr; // 当前线程正在执行的命令持有的终端锁
+thread_local uint32_t tlsCommandErrors = 0;            // 当前线程执行命令期间输出的错误数
+thread_local std::ostream* tlsOutput = nullptr;       // 当前线程的命令输出目标（控制套接字请求时捕获输出）
+const char* const DEFAULT_CONTROL_SOCKET = "myos_control.sock"; // 控制套接字默认路径（当前目录）
+
+/**
+ * @brief 命令输出流：控制套接字请求执行期间写入捕获缓冲，否则写到标准输出
+ */
+std::ostream& consoleOut() {
+    return tlsOutput ? *tlsOutput : std::cout;
+}
+
+/**
+ * @brief 在长时间执行阶段临时释放终端锁，离开作用域时重新获取
+ */
+class CommandLockRelease {
+private:
+    std::unique_lock<std::mutex>* lock;
+    
+public:
+    CommandLockRelease() : lock(tlsCommandLock) {
+        if (lock && lock->owns_lock()) {
+            lock->unlock();
+        } else {
+            lock = nullptr;
+        }
+    }
+    ~CommandLockRelease() {
+        if (lock) {
+            lock->lock();
+        }
+    }
+    CommandLockRelease(const CommandLockRelease&) = delete;
+    CommandLockRelease& operator=(const CommandLockRelease&) = delete;
+};
+
+double elapsedMsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief 等待VM当前执行者（调度器时间片、vm run）释放执行权
+ * @return bool 超时返回false（例如调试器正挂接该VM）
+ */
+bool claimExecutionWithin(I_VmInterface& vm, uint32_t timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!vm.claimExecution()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
 
 ConsoleTerminal::ConsoleTerminal() 
-    : isRunning(false), nextVmId(1) {
+    : isRunning(false), nextVmId(1), asyncOutstanding(0), asyncFailures(0), asyncStopping(false) {
+    operationLog.reset(new OperationLog());
+    std::string oplogError;
+    if (operationLog->open(DEFAULT_OPLOG_PATH, oplogError)) {
+        operationLog->start();
+    } else {
+        std::cerr << "Warning: Operation log disabled: " << oplogError << std::endl;
+    }
+    exceptionManager.reset(new ExceptionManager());
+    exceptionManager->setOperationLog(operationLog.get());
     scheduler.reset(new Scheduler());
+    scheduler->setExceptionManager(exceptionManager.get());
+    exceptionManager->start();
+    adminPlane.reset(new AdminControlPlane());
+    adminPlane->setScheduler(scheduler.get());
+    adminPlane->setOperationLog(operationLog.get());
+    adminPlane->start();
     perfMonitor.reset(new PerformanceMonitor());
+    vSwitch.reset(new VirtualSwitch());
+    hypercalls.reset(new HypercallTable());
+    sharedMemory.reset(new SharedMemoryManager());
+    hypercalls->setDoorbellTarget(sharedMemory.get());
+    eventBus.reset(new VmEventBus());
+    watchSource.reset(new StatusWatchSource());
+    watchSource->setScheduler(scheduler.get());
+    statsPublisher.reset(new StatsPagePublisher(*watchSource, scheduler.get()));
+    ctfManager.reset(new CtfManager([this](const std::string& type, uint32_t id) {
+        return createVmInstance(type, id);
+    }, CTF_DEFAULT_MAX_INSTANCES));
+    // 加载线程完成一批后获取终端锁装入载荷（等待加载的命令在等待期间释放终端锁）
+    payloadLoader.reset(new PayloadLoader());
+    payloadLoader->setCompletionNotifier([this]() {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        completePayloadLoads();
+    });
+    payloadLoader->start(PAYLOAD_LOADER_CORE);
     registerCommands();
 }
 
@@ -23,8 +132,10 @@ void ConsoleTerminal::start() {
     
     std::string input;
     while (isRunning) {
-        std::cout << "\nMyOS> ";
-        std::getline(std::cin, input);
+        consoleOut() << "\nMyOS> ";
+        if (!std::getline(std::cin, input)) {
+            break; // 输入结束（管道/重定向）
+        }
         
         if (!input.empty()) {
             processCommand(input);
@@ -33,7 +144,40 @@ void ConsoleTerminal::start() {
 }
 
 void ConsoleTerminal::stop() {
+    // 从exit命令调用时先释放终端锁，避免等待中的远程请求与异步命令无法退出
+    CommandLockRelease unlocked;
     isRunning = false;
+    
+    // 先停止控制套接字服务，之后不再有远程命令
+    if (controlServer) {
+        controlServer->stop();
+    }
+    // 断开gdb连接，调试器释放所挂接VM的执行权
+    if (gdbServer) {
+        gdbServer->stop();
+    }
+    stopAsyncWorkers();
+    
+    // 停止载荷加载线程，之后注册表不再被完成通知修改
+    if (payloadLoader) {
+        payloadLoader->stop();
+    }
+    
+    // 统计页只读取无锁快照，停止发布并删除共享内存
+    if (statsPublisher) {
+        statsPublisher->stop();
+    }
+    
+    // 先停止虚拟交换机，之后不再有设备向VM触发中断
+    if (vSwitch) {
+        vSwitch->stop();
+    }
+    
+    // 先停止管理员控制线程，之后不再有对调度器和VM的控制请求
+    if (adminPlane) {
+        adminPlane->stop();
+    }
+    
     // 停止所有运行的VM
     for (auto& pair : vmRegistry) {
         if (pair.second.vmPtr && pair.second.vmPtr->getRunningStatus()) {
@@ -45,59 +189,150 @@ void ConsoleTerminal::stop() {
     if (scheduler) {
         scheduler->stop();
     }
+    
+    // 调度器停止后不再有故障上报，最后停止故障处理线程
+    if (exceptionManager) {
+        exceptionManager->stop();
+    }
+    
+    // 故障处理线程停止后不再有审计记录，写完并落盘剩余记录
+    if (operationLog) {
+        operationLog->stop();
+    }
 }
 
 void ConsoleTerminal::showWelcome() {
-    std::cout << "\n===========================================" << std::endl;
-    std::cout << "    MyOS VM System Console Terminal" << std::endl;
-    std::cout << "===========================================" << std::endl;
-    std::cout << "Type 'help' for available commands" << std::endl;
-    std::cout << "Type 'exit' to quit" << std::endl;
+    consoleOut() << "\n===========================================" << std::endl;
+    consoleOut() << "    MyOS VM System Console Terminal" << std::endl;
+    consoleOut() << "===========================================" << std::endl;
+    consoleOut() << "Type 'help' for available commands" << std::endl;
+    consoleOut() << "Type 'exit' to quit" << std::endl;
 }
 
 void ConsoleTerminal::showHelp() {
-    std::cout << "\n=== Available Commands ===" << std::endl;
-    std::cout << "\n# System Commands:" << std::endl;
-    std::cout << "help                    - Show this help message" << std::endl;
-    std::cout << "status                  - Show system status" << std::endl;
-    std::cout << "exit                    - Exit the terminal" << std::endl;
-    
-    std::cout << "\n# VM Management:" << std::endl;
-    std::cout << "vm create <type> <file> - Create VM (x86/arm/x64)" << std::endl;
-    std::cout << "vm list                 - List all VMs" << std::endl;
-    std::cout << "vm start <id>          - Start VM" << std::endl;
-    std::cout << "vm stop <id>           - Stop VM" << std::endl;
-    std::cout << "vm pause <id>          - Pause VM" << std::endl;
-    std::cout << "vm resume <id>         - Resume VM" << std::endl;
-    std::cout << "vm run <id> <steps>    - Run VM for N steps" << std::endl;
-    std::cout << "vm info <id>           - Show VM information" << std::endl;
-    std::cout << "vm delete <id>         - Delete VM" << std::endl;
-    
-    std::cout << "\n# Scheduler Commands:" << std::endl;
-    std::cout << "sched start            - Start scheduler" << std::endl;
-    std::cout << "sched stop             - Stop scheduler" << std::endl;
-    std::cout << "sched add <id> <pri>   - Add VM to scheduler queue" << std::endl;
-    std::cout << "sched bind <id> <core> - Bind VM to specific core" << std::endl;
-    std::cout << "sched unbind <id>      - Unbind VM from core" << std::endl;
-    std::cout << "sched stats            - Show scheduler statistics" << std::endl;
-    
-    std::cout << "\n# Performance Monitoring:" << std::endl;
-    std::cout << "perf start <id>        - Start performance monitoring" << std::endl;
-    std::cout << "perf stop <id>         - Stop performance monitoring" << std::endl;
-    std::cout << "perf report            - Show performance report" << std::endl;
+    consoleOut() << "\n=== Available Commands ===" << std::endl;
+    consoleOut() << "\n# System Commands:" << std::endl;
+    consoleOut() << "help                    - Show this help message" << std::endl;
+    consoleOut() << "status                  - Show system status" << std::endl;
+    consoleOut() << "exit                    - Exit the terminal" << std::endl;
+    
+    consoleOut() << "\n# VM Management:" << std::endl;
+    consoleOut() << "vm create <type> <file> [--wait] - Create VM (x86/arm/x64); payload loads in background" << std::endl;
+    consoleOut() << "vm list                 - List all VMs" << std::endl;
+    consoleOut() << "vm start <id>          - Start VM" << std::endl;
+    consoleOut() << "vm stop <id>           - Stop VM" << std::endl;
+    consoleOut() << "vm pause <id>          - Pause VM" << std::endl;
+    consoleOut() << "vm resume <id>         - Resume VM" << std::endl;
+    consoleOut() << "vm run <id> <steps>    - Run VM for N steps" << std::endl;
+    consoleOut() << "vm info <id>           - Show VM information" << std::endl;
+    consoleOut() << "vm delete <id>         - Delete VM" << std::endl;
+    consoleOut() << "vm swap <id> <file> [reloc] - Hot-swap payload at next block boundary" << std::endl;
+    consoleOut() << "vm prefetch <file>...  - Map and hash payload files ahead of vm create" << std::endl;
+    consoleOut() << "vm loader              - Show payload loader statistics" << std::endl;
+    
+    consoleOut() << "\n# Scheduler Commands:" << std::endl;
+    consoleOut() << "sched start            - Start scheduler" << std::endl;
+    consoleOut() << "sched stop             - Stop scheduler" << std::endl;
+    consoleOut() << "sched add <id> <pri>   - Add VM to scheduler queue" << std::endl;
+    consoleOut() << "sched bind <id> <core> - Bind VM to specific core" << std::endl;
+    consoleOut() << "sched unbind <id>      - Unbind VM from core" << std::endl;
+    consoleOut() << "sched stats            - Show scheduler statistics" << std::endl;
+    
+    consoleOut() << "\n# Performance Monitoring:" << std::endl;
+    consoleOut() << "perf start <id>        - Start performance monitoring" << std::endl;
+    consoleOut() << "perf stop <id>         - Stop performance monitoring" << std::endl;
+    consoleOut() << "perf report            - Show performance report" << std::endl;
+    consoleOut() << "perf publish [name] [ms] [vms] - Publish stats to a shared-memory page" << std::endl;
+    consoleOut() << "perf unpublish         - Stop publishing the stats page" << std::endl;
+    consoleOut() << "perf page              - Show stats page status" << std::endl;
+    
+    consoleOut() << "\n# Virtual Network:" << std::endl;
+    consoleOut() << "net attach <id> [pkts] [us]   - Attach VM NIC (optional irq coalescing)" << std::endl;
+    consoleOut() << "net send <src> <dst> <addr> <len> - Send guest memory range to VM" << std::endl;
+    consoleOut() << "net recv <id>          - Drain received packets" << std::endl;
+    consoleOut() << "net stats              - Show virtual switch statistics" << std::endl;
+    
+    consoleOut() << "\n# Virtual Interrupts:" << std::endl;
+    consoleOut() << "irq raise <id> <vec>   - Raise interrupt vector on VM" << std::endl;
+    consoleOut() << "irq config <id> <vec> <pri> [pkts] [us] - Set priority and coalescing" << std::endl;
+    consoleOut() << "irq entry <id> <vec> <pc> - Set guest handler entry" << std::endl;
+    consoleOut() << "irq mask <id> <vec>    - Mask interrupt vector" << std::endl;
+    consoleOut() << "irq unmask <id> <vec>  - Unmask interrupt vector" << std::endl;
+    consoleOut() << "irq stats <id>         - Show interrupt controller state" << std::endl;
+    
+    consoleOut() << "\n# Shared Memory:" << std::endl;
+    consoleOut() << "shm create <name> <size>      - Create named shared region" << std::endl;
+    consoleOut() << "shm destroy <name>            - Destroy unmapped region" << std::endl;
+    consoleOut() << "shm map <name> <id> <addr> <r|rw> - Map region into VM address space" << std::endl;
+    consoleOut() << "shm unmap <name> <id>         - Unmap region from VM" << std::endl;
+    consoleOut() << "shm format <name> <spsc|mpsc> <slot> - Format region as message ring" << std::endl;
+    consoleOut() << "shm ring <name> <id>          - Ring doorbell as VM" << std::endl;
+    consoleOut() << "shm list                      - List regions and mappings" << std::endl;
+    
+    consoleOut() << "\n# Fault Handling:" << std::endl;
+    consoleOut() << "exc policy <fault> <none|pause|kill|quarantine> - Set fault policy" << std::endl;
+    consoleOut() << "exc rate <burst> <per_sec> <window_ms> - Set per-VM log rate limit" << std::endl;
+    consoleOut() << "exc release <id>       - Release quarantined VM" << std::endl;
+    consoleOut() << "exc stats              - Show exception pipeline statistics" << std::endl;
+    
+    consoleOut() << "\n# Operation Log:" << std::endl;
+    consoleOut() << "oplog stats            - Show operation log status" << std::endl;
+    consoleOut() << "oplog verify [file]    - Verify hash chain (default: current log)" << std::endl;
+    
+    consoleOut() << "\n# Admin Control (core 0):" << std::endl;
+    consoleOut() << "admin kill <id>        - Force stop VM" << std::endl;
+    consoleOut() << "admin ban <id>         - Force stop and ban VM" << std::endl;
+    consoleOut() << "admin unban <id>       - Lift VM ban" << std::endl;
+    consoleOut() << "admin reclaim <core>   - Reclaim VM pool core" << std::endl;
+    consoleOut() << "admin stats            - Show command latency statistics" << std::endl;
+    
+    consoleOut() << "\n# Control Socket:" << std::endl;
+    consoleOut() << "ctl start [path]       - Start control socket server (default: myos_control.sock)" << std::endl;
+    consoleOut() << "ctl stop               - Stop control socket server" << std::endl;
+    consoleOut() << "ctl stats              - Show control server statistics" << std::endl;
+    consoleOut() << "events                 - Show VM event bus statistics (subscribe via control socket)" << std::endl;
+    consoleOut() << "watch [ms] [n]         - Print only changed VM states, core owners and counter deltas, n times" << std::endl;
+    
+    consoleOut() << "\n# Debugger:" << std::endl;
+    consoleOut() << "debug start <port> [id] [n] - Start gdb remote server on 127.0.0.1 (attach VM id on connect," << std::endl;
+    consoleOut() << "                       snapshot every n instructions for reverse execution, default 1000)" << std::endl;
+    consoleOut() << "debug stop             - Stop gdb remote server and detach" << std::endl;
+    consoleOut() << "debug stats            - Show gdb server statistics" << std::endl;
+    
+    consoleOut() << "\n# Tracing:" << std::endl;
+    consoleOut() << "trace start <id> [kb]  - Record compressed control-flow trace into a ring buffer (default 256 KB)" << std::endl;
+    consoleOut() << "trace stop <id>        - Stop tracing and discard the buffer" << std::endl;
+    consoleOut() << "trace dump <id> <file> - Write the trace for offline decoding (trace_decode)" << std::endl;
+    consoleOut() << "trace stats            - Show trace size and compression per traced VM" << std::endl;
+    
+    consoleOut() << "\n# Fuzzing:" << std::endl;
+    consoleOut() << "fuzz run <id> <addr> <len> [sec] [workers] [insns] - Coverage-guided fuzzing from the VM's current" << std::endl;
+    consoleOut() << "                       state: inputs of up to len bytes at guest addr, workers on the VM core pool" << std::endl;
+    consoleOut() << "fuzz report            - Show executions per second per core, coverage and crashes of the last run" << std::endl;
+    consoleOut() << "fuzz export <dir>      - Write corpus and crash inputs of the last run into an existing directory" << std::endl;
+    
+    consoleOut() << "\n# CTF:" << std::endl;
+    consoleOut() << "ctf template <name> <id> - Make challenge template from VM's current state (memory shared copy-on-write)" << std::endl;
+    consoleOut() << "ctf drop <name>        - Remove challenge template without instances" << std::endl;
+    consoleOut() << "ctf create <name> <player> - Create player instance of challenge (scheduled if scheduler runs)" << std::endl;
+    consoleOut() << "ctf reset <id>         - Roll instance back to challenge template" << std::endl;
+    consoleOut() << "ctf delete <id>        - Delete instance" << std::endl;
+    consoleOut() << "ctf quota <player> <max_instances> <slices_per_sec> - Set player quota (0 slices: unlimited)" << std::endl;
+    consoleOut() << "ctf list               - List challenges, players and instances with create/reset latency" << std::endl;
 }
 
 void ConsoleTerminal::showStatus() {
-    std::cout << "\n=== System Status ===" << std::endl;
-    std::cout << "Terminal: " << (isRunning ? "RUNNING" : "STOPPED") << std::endl;
-    std::cout << "Registered VMs: " << vmRegistry.size() << std::endl;
-    std::cout << "Scheduler: " << (scheduler ? "AVAILABLE" : "NOT INITIALIZED") << std::endl;
-    std::cout << "Performance Monitor: " << (perfMonitor ? "ACTIVE" : "INACTIVE") << std::endl;
+    consoleOut() << "\n=== System Status ===" << std::endl;
+    consoleOut() << "Terminal: " << (isRunning ? "RUNNING" : "STOPPED") << std::endl;
+    consoleOut() << "Registered VMs: " << vmRegistry.size() << std::endl;
+    consoleOut() << "Scheduler: " << (scheduler ? "AVAILABLE" : "NOT INITIALIZED") << std::endl;
+    consoleOut() << "Performance Monitor: " << (perfMonitor ? "ACTIVE" : "INACTIVE") << std::endl;
+    consoleOut() << hypercalls->getStatistics() << std::endl;
     
     if (!vmRegistry.empty()) {
-        std::cout << "\nVM Status:" << std::endl;
+        consoleOut() << "\nVM Status:" << std::endl;
         for (const auto& pair : vmRegistry) {
-            std::cout << "  VM " << pair.first << " (" << pair.second.type << "): " 
+            consoleOut() << "  VM " << pair.first << " (" << pair.second.type << "): " 
                       << pair.second.status << std::endl;
         }
     }
@@ -112,11 +347,15 @@ void ConsoleTerminal::processCommand(const std::string& input) {
     
     auto it = commandMap.find(command);
     if (it != commandMap.end()) {
+        std::unique_lock<std::mutex> lock(commandMutex);
+        std::unique_lock<std::mutex>* outerLock = tlsCommandLock;
+        tlsCommandLock = &lock;
         try {
             it->second(args);
         } catch (const std::exception& e) {
             showError(std::string("Command execution failed: ") + e.what());
         }
+        tlsCommandLock = outerLock;
     } else {
         showError("Unknown command: " + command + ". Type 'help' for available commands.");
     }
@@ -132,19 +371,20 @@ void ConsoleTerminal::cmdStatus(const std::vector<std::string>& args) {
 }
 
 void ConsoleTerminal::cmdExit(const std::vector<std::string>& args) {
-    std::cout << "Shutting down console terminal..." << std::endl;
+    consoleOut() << "Shutting down console terminal..." << std::endl;
     stop();
 }
 
 // VM管理命令实现
 void ConsoleTerminal::cmdVmCreate(const std::vector<std::string>& args) {
     if (args.size() < 2) {
-        showError("Usage: vm create <type> <payload_file>");
+        showError("Usage: vm create <type> <payload_file> [--wait]");
         return;
     }
     
     std::string type = args[0];
     std::string filename = args[1];
+    bool waitLoad = args.size() > 2 && args[2] == "--wait";
     
     // 检查支持的VM类型
     if (type != "x86" && type != "arm" && type != "x64") {
@@ -152,13 +392,6 @@ void ConsoleTerminal::cmdVmCreate(const std::vector<std::string>& args) {
         return;
     }
     
-    // 加载payload
-    std::vector<uint8_t> payload;
-    if (!loadPayloadFromFile(filename, payload)) {
-        showError("Failed to load payload from file: " + filename);
-        return;
-    }
-    
     // 创建VM实例
     auto vm = createVmInstance(type, nextVmId);
     if (!vm) {
@@ -166,29 +399,68 @@ void ConsoleTerminal::cmdVmCreate(const std::vector<std::string>& args) {
         return;
     }
     
-    // 设置payload
-    vm->setPayload(payload.data(), payload.size());
+    // 分配客户机数据内存（宿主服务表与事件接收方在注册时挂接）
+    vm->getMemory().allocate(DEFAULT_GUEST_MEMORY_SIZE, GUEST_PERM_RW, DEFAULT_GUEST_ADDRESS_SPACE);
     
-    // 注册VM
+    // 载荷交给核1的加载流水线读取与解码，完成后由completePayloadLoads装入（LOADING -> CREATED）；
+    // 载荷由注册表持有，VM只保存指针
     S_VmInfo vmInfo;
     vmInfo.id = nextVmId;
     vmInfo.type = type;
-    vmInfo.status = "CREATED";
+    vmInfo.status = "LOADING";
     vmInfo.payloadFile = filename;
     vmInfo.vmPtr = vm;
+    vmInfo.loadTicket = payloadLoader->submit(filename, type, true);
+    pendingLoads[vmInfo.loadTicket] = vmInfo.id;
     
-    vmRegistry[nextVmId] = vmInfo;
-    showSuccess("VM " + std::to_string(nextVmId) + " (" + type + ") created successfully");
-    nextVmId++;
+    registerVm(vmInfo);
+    uint32_t vmId = nextVmId++;
+    if (!waitLoad) {
+        showSuccess("VM " + std::to_string(vmId) + " (" + type + ") created, loading " + filename);
+        return;
+    }
+    if (awaitVmLoaded(vmId)) {
+        showSuccess("VM " + std::to_string(vmId) + " (" + type + ") created successfully");
+    }
+}
+
+void ConsoleTerminal::registerVm(const S_VmInfo& vmInfo) {
+    vmInfo.vmPtr->setHypercallHandler(hypercalls.get());
+    vmInfo.vmPtr->setEventSink(eventBus.get());
+    vmRegistry[vmInfo.id] = vmInfo;
+    exceptionManager->attachVm(vmInfo.vmPtr);
+    adminPlane->attachVm(vmInfo.vmPtr);
+    watchSource->attachVm(vmInfo.vmPtr);
+}
+
+void ConsoleTerminal::unregisterVm(std::map<uint32_t, S_VmInfo>::iterator it) {
+    uint32_t vmId = it->first;
+    
+    // 停止VM如果正在运行
+    if (it->second.vmPtr->getRunningStatus()) {
+        it->second.vmPtr->stop();
+    }
+    
+    // 摘除网卡，避免交换机继续访问已释放的客户机内存
+    scheduler->removeVm(vmId);
+    vSwitch->detach(vmId);
+    sharedMemory->unmapAll(vmId);
+    exceptionManager->detachVm(vmId);
+    adminPlane->detachVm(vmId);
+    watchSource->detachVm(vmId);
+    ctfManager->removeInstance(vmId);
+    operationLog->append(OpLogEvent::VM_DELETE, vmId, it->second.type + " " + it->second.payloadFile);
+    
+    vmRegistry.erase(it);
 }
 
 void ConsoleTerminal::cmdVmList(const std::vector<std::string>& args) {
     if (vmRegistry.empty()) {
-        std::cout << "No VMs registered" << std::endl;
+        consoleOut() << "No VMs registered" << std::endl;
         return;
     }
     
-    std::cout << "\n=== Registered VMs ===" << std::endl;
+    consoleOut() << "\n=== Registered VMs ===" << std::endl;
     for (const auto& pair : vmRegistry) {
         printVmInfo(pair.second);
     }
@@ -201,19 +473,22 @@ void ConsoleTerminal::cmdVmStart(const std::vector<std::string>& args) {
     }
     
     uint32_t vmId = std::stoul(args[0]);
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
     auto it = vmRegistry.find(vmId);
     if (it == vmRegistry.end()) {
         showError("VM " + std::to_string(vmId) + " not found");
         return;
     }
     
-    try {
-        it->second.vmPtr->start();
-        it->second.status = "RUNNING";
-        showSuccess("VM " + std::to_string(vmId) + " started");
-    } catch (const std::exception& e) {
-        showError("Failed to start VM: " + std::string(e.what()));
+    VmFaultCode fault = it->second.vmPtr->start();
+    if (fault != VmFaultCode::NONE) {
+        showError(std::string("Failed to start VM: ") + GetVmFaultName(fault));
+        return;
     }
+    it->second.status = "RUNNING";
+    showSuccess("VM " + std::to_string(vmId) + " started");
 }
 
 void ConsoleTerminal::cmdVmStop(const std::vector<std::string>& args) {
@@ -223,6 +498,9 @@ void ConsoleTerminal::cmdVmStop(const std::vector<std::string>& args) {
     }
     
     uint32_t vmId = std::stoul(args[0]);
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
     auto it = vmRegistry.find(vmId);
     if (it == vmRegistry.end()) {
         showError("VM " + std::to_string(vmId) + " not found");
@@ -245,19 +523,22 @@ void ConsoleTerminal::cmdVmPause(const std::vector<std::string>& args) {
     }
     
     uint32_t vmId = std::stoul(args[0]);
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
     auto it = vmRegistry.find(vmId);
     if (it == vmRegistry.end()) {
         showError("VM " + std::to_string(vmId) + " not found");
         return;
     }
     
-    try {
-        it->second.vmPtr->pause();
-        it->second.status = "PAUSED";
-        showSuccess("VM " + std::to_string(vmId) + " paused");
-    } catch (const std::exception& e) {
-        showError("Failed to pause VM: " + std::string(e.what()));
+    VmFaultCode fault = it->second.vmPtr->pause();
+    if (fault != VmFaultCode::NONE) {
+        showError(std::string("Failed to pause VM: ") + GetVmFaultName(fault));
+        return;
     }
+    it->second.status = "PAUSED";
+    showSuccess("VM " + std::to_string(vmId) + " paused");
 }
 
 void ConsoleTerminal::cmdVmResume(const std::vector<std::string>& args) {
@@ -267,19 +548,22 @@ void ConsoleTerminal::cmdVmResume(const std::vector<std::string>& args) {
     }
     
     uint32_t vmId = std::stoul(args[0]);
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
     auto it = vmRegistry.find(vmId);
     if (it == vmRegistry.end()) {
         showError("VM " + std::to_string(vmId) + " not found");
         return;
     }
     
-    try {
-        it->second.vmPtr->resume();
-        it->second.status = "RUNNING";
-        showSuccess("VM " + std::to_string(vmId) + " resumed");
-    } catch (const std::exception& e) {
-        showError("Failed to resume VM: " + std::string(e.what()));
+    VmFaultCode fault = it->second.vmPtr->resume();
+    if (fault != VmFaultCode::NONE) {
+        showError(std::string("Failed to resume VM: ") + GetVmFaultName(fault));
+        return;
     }
+    it->second.status = "RUNNING";
+    showSuccess("VM " + std::to_string(vmId) + " resumed");
 }
 
 void ConsoleTerminal::cmdVmRun(const std::vector<std::string>& args) {
@@ -291,6 +575,9 @@ void ConsoleTerminal::cmdVmRun(const std::vector<std::string>& args) {
     uint32_t vmId = std::stoul(args[0]);
     uint32_t steps = std::stoul(args[1]);
     
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
     auto it = vmRegistry.find(vmId);
     if (it == vmRegistry.end()) {
         showError("VM " + std::to_string(vmId) + " not found");
@@ -303,11 +590,26 @@ void ConsoleTerminal::cmdVmRun(const std::vector<std::string>& args) {
             perfMonitor->recordVmStart(vmId);
         }
         
-        // 执行指定步数
+        // 执行指定步数，期间持有执行权，管理员控制请求在每步之间生效；
+        // 执行阶段释放终端锁，脚本中的异步vm run可以在不同VM上并行
+        std::shared_ptr<I_VmInterface> vm = it->second.vmPtr;
         uint32_t executed = 0;
-        for (uint32_t i = 0; i < steps && it->second.vmPtr->getRunningStatus(); i++) {
-            if (it->second.vmPtr->runOneInstruction()) {
-                executed++;
+        bool busy = false;
+        {
+            CommandLockRelease unlocked;
+            VmExecutionGuard guard(*vm);
+            busy = !guard.owns();
+            // 每步经runBatch投递中断、停机时推进虚拟时间，与调度器时间片内的行为一致
+            while (!busy && executed < steps && vm->getRunningStatus()) {
+                if (vm->hasPendingControl() && !vm->applyPendingControl()) {
+                    break;
+                }
+                uint32_t ran = 0;
+                vm->runBatch(1, ran);
+                if (ran == 0) {
+                    break;
+                }
+                executed += ran;
             }
         }
         
@@ -316,6 +618,11 @@ void ConsoleTerminal::cmdVmRun(const std::vector<std::string>& args) {
             perfMonitor->recordVmStop(vmId, executed);
         }
         
+        if (busy) {
+            showError("VM " + std::to_string(vmId) + " is being executed by another command");
+            return;
+        }
+        vm->publishEvent(VmEventType::RUN_COMPLETE, executed);
         showSuccess("VM " + std::to_string(vmId) + " executed " + std::to_string(executed) + " instructions");
     } catch (const std::exception& e) {
         showError("Failed to run VM: " + std::string(e.what()));
@@ -339,13 +646,13 @@ void ConsoleTerminal::cmdVmInfo(const std::vector<std::string>& args) {
     
     // 显示寄存器状态
     const auto& context = it->second.vmPtr->getContext();
-    std::cout << "Registers:" << std::endl;
-    std::cout << "  EAX: 0x" << std::hex << std::setfill('0') << std::setw(8) << context.eax << std::dec << std::endl;
-    std::cout << "  EBX: 0x" << std::hex << std::setfill('0') << std::setw(8) << context.ebx << std::dec << std::endl;
-    std::cout << "  ECX: 0x" << std::hex << std::setfill('0') << std::setw(8) << context.ecx << std::dec << std::endl;
-    std::cout << "  EDX: 0x" << std::hex << std::setfill('0') << std::setw(8) << context.edx << std::dec << std::endl;
-    std::cout << "  EIP: 0x" << std::hex << std::setfill('0') << std::setw(8) << context.eip << std::dec << std::endl;
-    std::cout << "  ESP: 0x" << std::hex << std::setfill('0') << std::setw(8) << context.esp << std::dec << std::endl;
+    consoleOut() << "Registers:" << std::endl;
+    consoleOut() << "  EAX: 0x" << std::hex << std::setfill('0') << std::setw(8) << context.eax << std::dec << std::endl;
+    consoleOut() << "  EBX: 0x" << std::hex << std::setfill('0') << std::setw(8) << context.ebx << std::dec << std::endl;
+    consoleOut() << "  ECX: 0x" << std::hex << std::setfill('0') << std::setw(8) << context.ecx << std::dec << std::endl;
+    consoleOut() << "  EDX: 0x" << std::hex << std::setfill('0') << std::setw(8) << context.edx << std::dec << std::endl;
+    consoleOut() << "  EIP: 0x" << std::hex << std::setfill('0') << std::setw(8) << context.eip << std::dec << std::endl;
+    consoleOut() << "  ESP: 0x" << std::hex << std::setfill('0') << std::setw(8) << context.esp << std::dec << std::endl;
 }
 
 void ConsoleTerminal::cmdVmDelete(const std::vector<std::string>& args) {
@@ -361,13 +668,211 @@ void ConsoleTerminal::cmdVmDelete(const std::vector<std::string>& args) {
         return;
     }
     
-    // 停止VM如果正在运行
-    if (it->second.vmPtr->getRunningStatus()) {
-        it->second.vmPtr->stop();
+    unregisterVm(it);
+    reclaimRetiredPayloads();
+    showSuccess("VM " + std::to_string(vmId) + " deleted");
+}
+
+void ConsoleTerminal::cmdVmSwap(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        showError("Usage: vm swap <id> <payload_file> [relocation_file]");
+        return;
     }
     
-    vmRegistry.erase(it);
-    showSuccess("VM " + std::to_string(vmId) + " deleted");
+    uint32_t vmId = std::stoul(args[0]);
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    reclaimRetiredPayloads();
+    
+    // 热替换只换代码段；容器的数据段、初始寄存器与入口属于启动状态，不重新装入
+    std::vector<uint8_t> fileData;
+    if (!loadPayloadFromFile(args[1], fileData)) {
+        showError("Failed to load payload from file: " + args[1]);
+        return;
+    }
+    S_PayloadImage image;
+    std::string error;
+    if (!PayloadDecode(fileData.data(), fileData.size(), image, error)) {
+        showError("Invalid payload " + args[1] + ": " + error);
+        return;
+    }
+    if (!image.architecture.empty() && image.architecture != it->second.type) {
+        showError("Payload is built for " + image.architecture + ", not " + it->second.type);
+        return;
+    }
+    
+    std::unique_ptr<S_PayloadSwap> swap(new S_PayloadSwap());
+    if (args.size() > 2 && !loadRelocationFile(args[2], swap->relocations)) {
+        showError("Invalid relocation file: " + args[2]);
+        return;
+    }
+    std::shared_ptr<std::vector<uint8_t>> payload = std::make_shared<std::vector<uint8_t>>();
+    payload->swap(image.code);
+    swap->data = payload->data();
+    swap->size = payload->size();
+    size_t relocationCount = swap->relocations.size();
+    
+    std::shared_ptr<I_VmInterface> vm = it->second.vmPtr;
+    uint64_t generation = vm->stagePayloadSwap(std::move(swap));
+    if (generation == 0) {
+        showError("Payload swap already pending for VM " + std::to_string(vmId));
+        return;
+    }
+    
+    // 旧载荷等VM换入新版本后回收；空闲的VM立即换入
+    S_RetiredPayload retired;
+    retired.vm = vm;
+    retired.generation = generation;
+    retired.payloadData = it->second.payloadData;
+    retiredPayloads.push_back(retired);
+    it->second.payloadData = payload;
+    it->second.payloadFile = args[1];
+    vm->applyControlIfIdle();
+    reclaimRetiredPayloads();
+    
+    operationLog->append(OpLogEvent::PAYLOAD_SWAP, vmId, args[1]);
+    bool applied = vm->getPayloadGeneration() >= generation;
+    showSuccess("VM " + std::to_string(vmId) + " payload " + (applied ? "swapped" : "staged") + " (version " +
+                std::to_string(generation) + ", " + std::to_string(payload->size()) + " bytes, " +
+                std::to_string(relocationCount) + " relocations)");
+}
+
+void ConsoleTerminal::cmdVmPrefetch(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: vm prefetch <payload_file>...");
+        return;
+    }
+    for (const std::string& file : args) {
+        payloadLoader->submit(file, "", false);
+    }
+    showSuccess("Prefetching " + std::to_string(args.size()) + " payload file(s) on core " +
+                std::to_string(PAYLOAD_LOADER_CORE));
+}
+
+void ConsoleTerminal::cmdVmLoader(const std::vector<std::string>& args) {
+    (void)args;
+    consoleOut() << payloadLoader->getStatistics();
+    if (!pendingLoads.empty()) {
+        consoleOut() << "Loading VMs:";
+        for (const auto& pair : pendingLoads) {
+            consoleOut() << " " << pair.second;
+        }
+        consoleOut() << std::endl;
+    }
+}
+
+void ConsoleTerminal::completePayloadLoads() {
+    std::vector<S_PayloadLoadResult> results;
+    if (!payloadLoader || payloadLoader->collect(results) == 0) {
+        return;
+    }
+    for (const S_PayloadLoadResult& result : results) {
+        // 预取请求与已删除VM的结果直接丢弃
+        auto pending = pendingLoads.find(result.ticket);
+        if (pending == pendingLoads.end()) {
+            continue;
+        }
+        auto it = vmRegistry.find(pending->second);
+        pendingLoads.erase(pending);
+        if (it == vmRegistry.end() || it->second.loadTicket != result.ticket) {
+            continue;
+        }
+        
+        S_VmInfo& vmInfo = it->second;
+        vmInfo.loadTicket = 0;
+        std::string error = result.error;
+        // 装入载荷与入口状态需要执行权（管理员控制面等可能正在该VM上执行控制请求）
+        if (result.ok && !claimExecutionWithin(*vmInfo.vmPtr, LOAD_CLAIM_TIMEOUT_MS)) {
+            error = "VM is busy";
+        } else if (result.ok) {
+            vmInfo.vmPtr->setPayload(result.code->data(), result.code->size());
+            bool applied = PayloadApplyEntryState(*vmInfo.vmPtr, vmInfo.type, result.image, error);
+            if (!applied) {
+                vmInfo.vmPtr->setPayload(nullptr, 0);
+            }
+            vmInfo.vmPtr->releaseExecution();
+            if (applied) {
+                vmInfo.payloadData = result.code;
+                vmInfo.status = "CREATED";
+                continue;
+            }
+        }
+        vmInfo.status = "LOAD_FAILED";
+        vmInfo.loadError = error;
+    }
+}
+
+bool ConsoleTerminal::awaitVmLoaded(uint32_t vmId) {
+    auto it = vmRegistry.find(vmId);
+    if (it != vmRegistry.end() && it->second.loadTicket != 0) {
+        uint64_t ticket = it->second.loadTicket;
+        {
+            CommandLockRelease unlocked;
+            payloadLoader->wait(ticket);
+        }
+        completePayloadLoads();
+        it = vmRegistry.find(vmId);
+    }
+    // VM不存在时由调用方报告
+    if (it == vmRegistry.end()) {
+        return true;
+    }
+    if (it->second.loadTicket != 0) {
+        showError("VM " + std::to_string(vmId) + " payload is still loading");
+        return false;
+    }
+    if (it->second.status == "LOAD_FAILED") {
+        showError("VM " + std::to_string(vmId) + " payload failed to load: " + it->second.loadError);
+        return false;
+    }
+    return true;
+}
+
+void ConsoleTerminal::reclaimRetiredPayloads() {
+    auto retiredEnd = std::remove_if(retiredPayloads.begin(), retiredPayloads.end(),
+        [](const S_RetiredPayload& retired) {
+            std::shared_ptr<I_VmInterface> vm = retired.vm.lock();
+            return !vm || vm->getPayloadGeneration() >= retired.generation;
+        });
+    retiredPayloads.erase(retiredEnd, retiredPayloads.end());
+}
+
+bool ConsoleTerminal::loadRelocationFile(const std::string& filename,
+                                         std::vector<std::pair<uint64_t, uint64_t>>& relocations) {
+    // 每行"旧PC 新PC"（十进制或0x十六进制），#开头为注释
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string from;
+        std::string to;
+        if (!(iss >> from) || from[0] == '#') {
+            continue;
+        }
+        if (!(iss >> to)) {
+            return false;
+        }
+        char* end = nullptr;
+        uint64_t oldPc = std::strtoull(from.c_str(), &end, 0);
+        if (*end != '\0') {
+            return false;
+        }
+        uint64_t newPc = std::strtoull(to.c_str(), &end, 0);
+        if (*end != '\0') {
+            return false;
+        }
+        relocations.push_back(std::make_pair(oldPc, newPc));
+    }
+    return true;
 }
 
 // 调度器命令实现
@@ -408,21 +913,20 @@ void ConsoleTerminal::cmdSchedAdd(const std::vector<std::string>& args) {
     uint32_t vmId = std::stoul(args[0]);
     uint32_t priority = std::stoul(args[1]);
     
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
     auto it = vmRegistry.find(vmId);
     if (it == vmRegistry.end()) {
         showError("VM " + std::to_string(vmId) + " not found");
         return;
     }
     
-    // 注意：当前调度器只支持X86Vm类型
-    if (auto x86vm = std::dynamic_pointer_cast<X86Vm>(it->second.vmPtr)) {
-        if (scheduler->addVm(x86vm, priority)) {
-            showSuccess("VM " + std::to_string(vmId) + " added to scheduler with priority " + std::to_string(priority));
-        } else {
-            showError("Failed to add VM to scheduler");
-        }
+    // CTF实例受所属选手的时间片配额约束
+    if (scheduler->addVm(it->second.vmPtr, priority, ctfManager->getTenantId(vmId))) {
+        showSuccess("VM " + std::to_string(vmId) + " added to scheduler with priority " + std::to_string(priority));
     } else {
-        showError("Only x86 VMs are currently supported by scheduler");
+        showError("Failed to add VM to scheduler");
     }
 }
 
@@ -461,6 +965,7 @@ void ConsoleTerminal::cmdSchedUnbind(const std::vector<std::string>& args) {
     uint32_t vmId = std::stoul(args[0]);
     
     if (scheduler->releaseStaticCore(vmId)) {
+        operationLog->append(OpLogEvent::CORE_UNBIND, vmId, "sched unbind");
         showSuccess("VM " + std::to_string(vmId) + " unbound from core");
     } else {
         showError("Failed to unbind VM from core");
@@ -473,7 +978,7 @@ void ConsoleTerminal::cmdSchedStats(const std::vector<std::string>& args) {
         return;
     }
     
-    std::cout << scheduler->getStatistics() << std::endl;
+    consoleOut() << scheduler->getStatistics() << std::endl;
 }
 
 // 性能监控命令实现
@@ -519,97 +1024,1570 @@ void ConsoleTerminal::cmdPerfReport(const std::vector<std::string>& args) {
     perfMonitor->printPerformanceReport();
 }
 
-// 辅助方法实现
-std::vector<std::string> ConsoleTerminal::parseArguments(const std::string& input) {
-    std::vector<std::string> args;
-    std::istringstream iss(input);
-    std::string token;
-    
-    while (iss >> token) {
-        args.push_back(token);
+void ConsoleTerminal::cmdPerfPublish(const std::vector<std::string>& args) {
+    const uint32_t MIN_INTERVAL_MS = 10;
+    const uint32_t MAX_INTERVAL_MS = 60 * 1000;
+    const uint32_t MAX_VM_RECORDS = 4096;
+    
+    std::string name = args.size() > 0 ? args[0] : DEFAULT_STATS_PAGE_NAME;
+    uint32_t intervalMs = args.size() > 1 ? static_cast<uint32_t>(std::stoul(args[1])) : 100;
+    uint32_t vmRecords = args.size() > 2 ? static_cast<uint32_t>(std::stoul(args[2])) : 256;
+    if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos ||
+        intervalMs < MIN_INTERVAL_MS || intervalMs > MAX_INTERVAL_MS || vmRecords == 0 || vmRecords > MAX_VM_RECORDS) {
+        showError("Usage: perf publish [/name] [interval_ms (10-60000)] [vm_records (1-4096)]");
+        return;
     }
     
-    return args;
+    std::string error;
+    if (!statsPublisher->start(name, intervalMs, vmRecords, error)) {
+        showError("Failed to publish stats page: " + error);
+        return;
+    }
+    showSuccess("Publishing stats page " + name + " every " + std::to_string(intervalMs) + " ms");
 }
 
-void ConsoleTerminal::registerCommands() {
-    // 系统命令
-    commandMap["help"] = [this](const std::vector<std::string>& args) { cmdHelp(args); };
-    commandMap["status"] = [this](const std::vector<std::string>& args) { cmdStatus(args); };
-    commandMap["exit"] = [this](const std::vector<std::string>& args) { cmdExit(args); };
-    
-    // VM管理命令
-    commandMap["vm"] = [this](const std::vector<std::string>& args) {
-        if (args.empty()) {
-            showError("VM command requires subcommand");
-            return;
-        }
-        
-        std::string subcommand = args[0];
-        std::vector<std::string> subArgs(args.begin() + 1, args.end());
-        
-        if (subcommand == "create") cmdVmCreate(subArgs);
-        else if (subcommand == "list") cmdVmList(subArgs);
-        else if (subcommand == "start") cmdVmStart(subArgs);
-        else if (subcommand == "stop") cmdVmStop(subArgs);
-        else if (subcommand == "pause") cmdVmPause(subArgs);
-        else if (subcommand == "resume") cmdVmResume(subArgs);
-        else if (subcommand == "run") cmdVmRun(subArgs);
-        else if (subcommand == "info") cmdVmInfo(subArgs);
-        else if (subcommand == "delete") cmdVmDelete(subArgs);
-        else showError("Unknown VM subcommand: " + subcommand);
-    };
-    
-    // 调度器命令
-    commandMap["sched"] = [this](const std::vector<std::string>& args) {
-        if (args.empty()) {
-            showError("Scheduler command requires subcommand");
-            return;
-        }
-        
-        std::string subcommand = args[0];
-        std::vector<std::string> subArgs(args.begin() + 1, args.end());
-        
-        if (subcommand == "start") cmdSchedStart(subArgs);
-        else if (subcommand == "stop") cmdSchedStop(subArgs);
-        else if (subcommand == "add") cmdSchedAdd(subArgs);
-        else if (subcommand == "bind") cmdSchedBind(subArgs);
-        else if (subcommand == "unbind") cmdSchedUnbind(subArgs);
-        else if (subcommand == "stats") cmdSchedStats(subArgs);
-        else showError("Unknown scheduler subcommand: " + subcommand);
-    };
-    
-    // 性能监控命令
-    commandMap["perf"] = [this](const std::vector<std::string>& args) {
-        if (args.empty()) {
-            showError("Performance command requires subcommand");
-            return;
-        }
-        
-        std::string subcommand = args[0];
-        std::vector<std::string> subArgs(args.begin() + 1, args.end());
-        
-        if (subcommand == "start") cmdPerfStart(subArgs);
-        else if (subcommand == "stop") cmdPerfStop(subArgs);
-        else if (subcommand == "report") cmdPerfReport(subArgs);
-        else showError("Unknown performance subcommand: " + subcommand);
-    };
+void ConsoleTerminal::cmdPerfUnpublish(const std::vector<std::string>& args) {
+    (void)args;
+    if (!statsPublisher->getRunningStatus()) {
+        showError("Stats page is not being published");
+        return;
+    }
+    std::string name = statsPublisher->getPageName();
+    statsPublisher->stop();
+    showSuccess("Stats page " + name + " removed");
 }
 
-bool ConsoleTerminal::loadPayloadFromFile(const std::string& filename, std::vector<uint8_t>& payload) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        return false;
+void ConsoleTerminal::cmdPerfPage(const std::vector<std::string>& args) {
+    (void)args;
+    consoleOut() << statsPublisher->getStatistics();
+}
+
+// 虚拟网络命令实现
+void ConsoleTerminal::cmdNetAttach(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: net attach <id> [coalesce_packets] [coalesce_us]");
+        return;
     }
     
-    // 获取文件大小
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    // 读取文件内容
-    payload.resize(fileSize);
-    file.read(reinterpret_cast<char*>(payload.data()), fileSize);
+    uint32_t vmId = std::stoul(args[0]);
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    
+    GuestMemory& memory = it->second.vmPtr->getMemory();
+    if (memory.getSize() < NET_RX_BUFFER_COUNT * VirtualNic::MTU) {
+        showError("VM " + std::to_string(vmId) + " has not enough guest memory for a NIC");
+        return;
+    }
+    
+    std::shared_ptr<VirtualNic> nic(new VirtualNic(vmId, memory));
+    // 接收通知转为VM的网卡中断（vm delete会先摘除网卡，VM指针在回调期间有效）
+    I_VmInterface* vm = it->second.vmPtr.get();
+    nic->setRxNotifier([vm](uint32_t) {
+        vm->getInterruptController().raise(IRQ_VECTOR_NET_RX);
+    });
+    if (args.size() >= 3) {
+        nic->setCoalescing(std::stoul(args[1]), std::stoul(args[2]));
+    } else if (args.size() == 2) {
+        nic->setCoalescing(std::stoul(args[1]), 0);
+    }
+    
+    // 在客户机内存顶端预投递接收缓冲
+    uint32_t rxBase = memory.getSize() - NET_RX_BUFFER_COUNT * VirtualNic::MTU;
+    for (uint32_t i = 0; i < NET_RX_BUFFER_COUNT; i++) {
+        nic->postRxBuffer(rxBase + i * VirtualNic::MTU);
+    }
+    
+    if (!vSwitch->attach(nic)) {
+        showError("Failed to attach NIC for VM " + std::to_string(vmId));
+        return;
+    }
+    
+    vSwitch->start();
+    showSuccess("VM " + std::to_string(vmId) + " NIC attached (MAC " + std::to_string(vmId) + ")");
+}
+
+void ConsoleTerminal::cmdNetSend(const std::vector<std::string>& args) {
+    if (args.size() < 4) {
+        showError("Usage: net send <src_id> <dst_id> <guest_addr> <length>");
+        return;
+    }
+    
+    uint32_t srcId = std::stoul(args[0]);
+    uint32_t dstId = std::stoul(args[1]);
+    uint32_t addr = std::stoul(args[2], nullptr, 0);
+    uint32_t length = std::stoul(args[3]);
+    
+    auto nic = vSwitch->findNic(srcId);
+    if (!nic) {
+        showError("VM " + std::to_string(srcId) + " has no attached NIC");
+        return;
+    }
+    
+    if (nic->transmit(addr, length, dstId)) {
+        showSuccess("Queued " + std::to_string(length) + " bytes from VM " + std::to_string(srcId) +
+                    " to VM " + std::to_string(dstId));
+    } else {
+        showError("Transmit rejected (bad range, permission or ring full)");
+    }
+}
+
+void ConsoleTerminal::cmdNetRecv(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: net recv <id>");
+        return;
+    }
+    
+    uint32_t vmId = std::stoul(args[0]);
+    auto nic = vSwitch->findNic(vmId);
+    if (!nic) {
+        showError("VM " + std::to_string(vmId) + " has no attached NIC");
+        return;
+    }
+    
+    S_NetPacketDesc packets[NET_RX_BUFFER_COUNT];
+    size_t count = nic->receive(packets, NET_RX_BUFFER_COUNT);
+    for (size_t i = 0; i < count; i++) {
+        consoleOut() << "  from VM " << packets[i].srcMac << ": " << packets[i].length
+                  << " bytes at 0x" << std::hex << packets[i].guestAddr << std::dec << std::endl;
+        // 归还接收缓冲
+        nic->postRxBuffer(packets[i].guestAddr);
+    }
+    showSuccess("VM " + std::to_string(vmId) + " received " + std::to_string(count) + " packets");
+}
+
+void ConsoleTerminal::cmdNetStats(const std::vector<std::string>& args) {
+    (void)args;
+    consoleOut() << vSwitch->getStatistics() << std::endl;
+}
+
+// 虚拟中断命令实现
+void ConsoleTerminal::cmdIrqRaise(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        showError("Usage: irq raise <id> <vector>");
+        return;
+    }
+    
+    uint32_t vmId = std::stoul(args[0]);
+    uint32_t vector = std::stoul(args[1]);
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    if (vector >= VirtualInterruptController::MAX_VECTORS) {
+        showError("Vector out of range (0-" + std::to_string(VirtualInterruptController::MAX_VECTORS - 1) + ")");
+        return;
+    }
+    
+    it->second.vmPtr->getInterruptController().raise(vector);
+    showSuccess("Raised vector " + std::to_string(vector) + " on VM " + std::to_string(vmId));
+}
+
+void ConsoleTerminal::cmdIrqConfig(const std::vector<std::string>& args) {
+    if (args.size() < 3) {
+        showError("Usage: irq config <id> <vector> <priority> [coalesce_count] [coalesce_us]");
+        return;
+    }
+    
+    uint32_t vmId = std::stoul(args[0]);
+    uint32_t vector = std::stoul(args[1]);
+    uint32_t priority = std::stoul(args[2]);
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    if (vector >= VirtualInterruptController::MAX_VECTORS ||
+        priority >= VirtualInterruptController::PRIORITY_LEVELS) {
+        showError("Vector or priority out of range");
+        return;
+    }
+    
+    VirtualInterruptController& controller = it->second.vmPtr->getInterruptController();
+    controller.setPriority(vector, priority);
+    uint32_t coalesceCount = args.size() >= 4 ? std::stoul(args[3]) : 1;
+    uint32_t coalesceUs = args.size() >= 5 ? std::stoul(args[4]) : 0;
+    controller.setCoalescing(vector, coalesceCount, coalesceUs);
+    showSuccess("VM " + std::to_string(vmId) + " vector " + std::to_string(vector) +
+                ": priority " + std::to_string(priority) + ", coalesce " +
+                std::to_string(coalesceCount) + " raises / " + std::to_string(coalesceUs) + " us");
+}
+
+void ConsoleTerminal::cmdIrqEntry(const std::vector<std::string>& args) {
+    if (args.size() < 3) {
+        showError("Usage: irq entry <id> <vector> <pc>");
+        return;
+    }
+    
+    uint32_t vmId = std::stoul(args[0]);
+    uint32_t vector = std::stoul(args[1]);
+    uint32_t entryPc = std::stoul(args[2], nullptr, 0);
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    if (vector >= VirtualInterruptController::MAX_VECTORS) {
+        showError("Vector out of range");
+        return;
+    }
+    
+    it->second.vmPtr->getInterruptController().setVectorEntry(vector, entryPc);
+    showSuccess("VM " + std::to_string(vmId) + " vector " + std::to_string(vector) +
+                " handler entry set to " + std::to_string(entryPc));
+}
+
+void ConsoleTerminal::cmdIrqMask(const std::vector<std::string>& args, bool maskVector) {
+    if (args.size() < 2) {
+        showError(std::string("Usage: irq ") + (maskVector ? "mask" : "unmask") + " <id> <vector>");
+        return;
+    }
+    
+    uint32_t vmId = std::stoul(args[0]);
+    uint32_t vector = std::stoul(args[1]);
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    
+    VirtualInterruptController& controller = it->second.vmPtr->getInterruptController();
+    if (maskVector) {
+        controller.mask(vector);
+    } else {
+        controller.unmask(vector);
+    }
+    showSuccess("VM " + std::to_string(vmId) + " vector " + std::to_string(vector) +
+                (maskVector ? " masked" : " unmasked"));
+}
+
+void ConsoleTerminal::cmdIrqStats(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: irq stats <id>");
+        return;
+    }
+    
+    uint32_t vmId = std::stoul(args[0]);
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    
+    const VirtualInterruptController& controller = it->second.vmPtr->getInterruptController();
+    consoleOut() << "VM " << vmId << " interrupt controller:" << std::endl;
+    consoleOut() << "  Halted: " << (it->second.vmPtr->isHalted() ? "YES" : "NO") << std::endl;
+    consoleOut() << "  Pending: 0x" << std::hex << controller.getPendingBitmap()
+              << ", Masked: 0x" << controller.getMaskedBitmap() << std::dec << std::endl;
+    consoleOut() << "  Raised: " << controller.getRaisedCount()
+              << ", Coalesced: " << controller.getCoalescedCount()
+              << ", Delivered: " << controller.getDeliveredCount() << std::endl;
+}
+
+// 共享内存命令实现
+void ConsoleTerminal::cmdShmCreate(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        showError("Usage: shm create <name> <size>");
+        return;
+    }
+    
+    uint32_t size = std::stoul(args[1], nullptr, 0);
+    if (sharedMemory->createRegion(args[0], size)) {
+        showSuccess("Shared region '" + args[0] + "' created");
+    } else {
+        showError("Failed to create region (duplicate name or size out of range, max " +
+                  std::to_string(SharedMemoryManager::MAX_REGION_SIZE) + ")");
+    }
+}
+
+void ConsoleTerminal::cmdShmDestroy(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: shm destroy <name>");
+        return;
+    }
+    
+    if (sharedMemory->destroyRegion(args[0])) {
+        showSuccess("Shared region '" + args[0] + "' destroyed");
+    } else {
+        showError("Region not found or still mapped");
+    }
+}
+
+void ConsoleTerminal::cmdShmMap(const std::vector<std::string>& args) {
+    if (args.size() < 4) {
+        showError("Usage: shm map <name> <id> <guest_addr> <r|rw>");
+        return;
+    }
+    
+    uint32_t vmId = std::stoul(args[1]);
+    uint32_t guestAddr = std::stoul(args[2], nullptr, 0);
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    
+    uint8_t permission;
+    if (args[3] == "r") {
+        permission = GUEST_PERM_READ;
+    } else if (args[3] == "rw") {
+        permission = GUEST_PERM_RW;
+    } else {
+        showError("Permission must be r or rw");
+        return;
+    }
+    
+    if (sharedMemory->mapRegion(args[0], it->second.vmPtr.get(), guestAddr, permission)) {
+        showSuccess("Region '" + args[0] + "' mapped into VM " + std::to_string(vmId) +
+                    " at " + args[2] + " (" + args[3] + ")");
+    } else {
+        showError("Map failed (unknown region, already mapped, unaligned or overlapping address; "
+                  "private memory ends at " + std::to_string(it->second.vmPtr->getMemory().getSize()) + ")");
+    }
+}
+
+void ConsoleTerminal::cmdShmUnmap(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        showError("Usage: shm unmap <name> <id>");
+        return;
+    }
+    
+    uint32_t vmId = std::stoul(args[1]);
+    if (sharedMemory->unmapRegion(args[0], vmId)) {
+        showSuccess("Region '" + args[0] + "' unmapped from VM " + std::to_string(vmId));
+    } else {
+        showError("Region not found or not mapped by VM " + std::to_string(vmId));
+    }
+}
+
+void ConsoleTerminal::cmdShmFormat(const std::vector<std::string>& args) {
+    if (args.size() < 3) {
+        showError("Usage: shm format <name> <spsc|mpsc> <slot_size>");
+        return;
+    }
+    
+    ShmRingKind kind;
+    if (args[1] == "spsc") {
+        kind = ShmRingKind::SPSC;
+    } else if (args[1] == "mpsc") {
+        kind = ShmRingKind::MPSC;
+    } else {
+        showError("Ring kind must be spsc or mpsc");
+        return;
+    }
+    
+    uint32_t size = 0;
+    uint8_t* base = sharedMemory->getRegionBase(args[0], &size);
+    if (!base) {
+        showError("Region '" + args[0] + "' not found");
+        return;
+    }
+    
+    uint32_t slots = ShmRing::format(base, size, kind, std::stoul(args[2]));
+    if (slots == 0) {
+        showError("Region too small for two slots of that size");
+        return;
+    }
+    showSuccess("Region '" + args[0] + "' formatted as " + args[1] + " ring with " +
+                std::to_string(slots) + " slots");
+}
+
+void ConsoleTerminal::cmdShmRing(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        showError("Usage: shm ring <name> <id>");
+        return;
+    }
+    
+    int notified = sharedMemory->ringDoorbell(args[0], std::stoul(args[1]));
+    if (notified < 0) {
+        showError("Region '" + args[0] + "' not found");
+        return;
+    }
+    showSuccess("Doorbell delivered to " + std::to_string(notified) + " VM(s)");
+}
+
+void ConsoleTerminal::cmdShmList(const std::vector<std::string>& args) {
+    (void)args;
+    consoleOut() << sharedMemory->getStatistics();
+}
+
+// 故障处理命令实现
+void ConsoleTerminal::cmdExcPolicy(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        showError("Usage: exc policy <fault> <none|pause|kill|quarantine>");
+        return;
+    }
+    
+    VmFaultCode code = VmFaultCode::NONE;
+    for (uint8_t i = 1; i < static_cast<uint8_t>(VmFaultCode::COUNT); i++) {
+        if (args[0] == GetVmFaultName(static_cast<VmFaultCode>(i))) {
+            code = static_cast<VmFaultCode>(i);
+            break;
+        }
+    }
+    if (code == VmFaultCode::NONE) {
+        showError("Unknown fault type: " + args[0]);
+        return;
+    }
+    
+    VmControlAction action;
+    if (args[1] == "none") action = VmControlAction::NONE;
+    else if (args[1] == "pause") action = VmControlAction::PAUSE;
+    else if (args[1] == "kill") action = VmControlAction::KILL;
+    else if (args[1] == "quarantine") action = VmControlAction::QUARANTINE;
+    else {
+        showError("Unknown policy action: " + args[1]);
+        return;
+    }
+    
+    exceptionManager->setPolicy(code, action);
+    operationLog->append(OpLogEvent::FAULT_POLICY_CHANGE, 0,
+                         std::string(GetVmFaultName(code)) + " -> " + GetVmControlName(action));
+    showSuccess(std::string(GetVmFaultName(code)) + " -> " + GetVmControlName(action));
+}
+
+void ConsoleTerminal::cmdExcRate(const std::vector<std::string>& args) {
+    if (args.size() < 3) {
+        showError("Usage: exc rate <burst> <per_sec> <window_ms>");
+        return;
+    }
+    
+    uint32_t burst = std::stoul(args[0]);
+    uint32_t perSec = std::stoul(args[1]);
+    uint32_t window = std::stoul(args[2]);
+    exceptionManager->setRateLimit(burst, perSec, window);
+    operationLog->append(OpLogEvent::RATE_LIMIT_CHANGE, 0,
+                         "burst " + std::to_string(burst) + " rate " + std::to_string(perSec) +
+                         " window " + std::to_string(window));
+    showSuccess("Fault log rate limit set to burst " + std::to_string(burst) + ", " +
+                std::to_string(perSec) + "/s, window " + std::to_string(window) + "ms");
+}
+
+void ConsoleTerminal::cmdExcRelease(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: exc release <id>");
+        return;
+    }
+    
+    uint32_t vmId = std::stoul(args[0]);
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    
+    if (it->second.vmPtr->getControlHold() != VmControlAction::QUARANTINE) {
+        showError("VM " + std::to_string(vmId) + " is not quarantined");
+        return;
+    }
+    it->second.vmPtr->releaseQuarantine();
+    operationLog->append(OpLogEvent::QUARANTINE_RELEASE, vmId, "exc release");
+    showSuccess("VM " + std::to_string(vmId) + " released from quarantine (use vm start/resume to run)");
+}
+
+void ConsoleTerminal::cmdExcStats(const std::vector<std::string>& args) {
+    (void)args;
+    consoleOut() << exceptionManager->getStatistics();
+}
+
+// 操作日志命令实现
+void ConsoleTerminal::cmdOplogStats(const std::vector<std::string>& args) {
+    (void)args;
+    consoleOut() << operationLog->getStatistics();
+}
+
+void ConsoleTerminal::cmdOplogVerify(const std::vector<std::string>& args) {
+    std::string filePath = args.empty() ? operationLog->getPath() : args[0];
+    if (filePath.empty()) {
+        showError("Usage: oplog verify <file>");
+        return;
+    }
+    
+    // 校验当前日志前先等待已追加的记录落盘
+    if (args.empty()) {
+        operationLog->flush();
+    }
+    
+    S_OpLogVerifyResult result;
+    if (!OperationLog::verifyFile(filePath, result)) {
+        showError("Operation log verification failed: " + result.error);
+        return;
+    }
+    consoleOut() << "Records: " << result.recordCount << std::endl;
+    consoleOut() << "Chain Anchor: " << OperationLog::hashToHex(result.lastHash) << std::endl;
+    if (result.truncatedTail) {
+        consoleOut() << "Note: incomplete tail record (interrupted write)" << std::endl;
+    }
+    showSuccess("Operation log " + filePath + " verified");
+}
+
+// 管理员命令实现
+void ConsoleTerminal::cmdAdminSubmit(AdminCommandType type, const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError(type == AdminCommandType::RECLAIM_CORE ? "Usage: admin reclaim <core>"
+                                                         : "Usage: admin kill|ban|unban <id>");
+        return;
+    }
+    
+    uint32_t target = std::stoul(args[0]);
+    if (type != AdminCommandType::RECLAIM_CORE && vmRegistry.find(target) == vmRegistry.end()) {
+        showError("VM " + std::to_string(target) + " not found");
+        return;
+    }
+    
+    // 只投递到控制面的命令通道，执行与生效确认由核0控制线程完成
+    uint64_t commandId = adminPlane->submit(type, target);
+    if (commandId == 0) {
+        showError("Admin command channel unavailable or full");
+        return;
+    }
+    showSuccess(std::string(GetAdminCommandName(type)) + " " + std::to_string(target) +
+                " submitted as admin command " + std::to_string(commandId));
+}
+
+void ConsoleTerminal::cmdAdminStats(const std::vector<std::string>& args) {
+    (void)args;
+    consoleOut() << adminPlane->getStatistics();
+}
+
+// 控制套接字命令实现
+bool ConsoleTerminal::startControlServer(const std::string& socketPath, std::string& error) {
+    if (!controlServer) {
+        controlServer.reset(new ControlServer(
+            [this](ControlOpcode opcode, const std::string& args, std::string& output) {
+                return executeControlRequest(opcode, args, output);
+            }));
+        controlServer->setEventBus(eventBus.get());
+        controlServer->setWatchSource(watchSource.get());
+    }
+    return controlServer->start(socketPath, error);
+}
+
+ControlStatus ConsoleTerminal::executeControlRequest(ControlOpcode opcode, const std::string& args,
+                                                     std::string& output) {
+    const char* prefix = GetControlOpcodeCommand(opcode);
+    if (!prefix) {
+        return ControlStatus::BAD_OPCODE;
+    }
+    std::string line = (opcode == ControlOpcode::COMMAND) ? args : std::string(prefix) + " " + args;
+    
+    // 退出终端与控制服务自身的命令不允许远程执行（执行线程不能停止自己所在的服务）
+    auto words = parseArguments(line);
+    if (words.empty() || words[0] == "exit" || (words[0] == "ctl" && (words.size() < 2 || words[1] != "stats"))) {
+        output = "Error: command not allowed over the control socket\n";
+        return ControlStatus::REJECTED;
+    }
+    
+    std::ostringstream captured;
+    std::ostream* outerOutput = tlsOutput;
+    tlsOutput = &captured;
+    tlsCommandErrors = 0;
+    processCommand(line);
+    bool ok = tlsCommandErrors == 0;
+    tlsOutput = outerOutput;
+    output = captured.str();
+    return ok ? ControlStatus::OK : ControlStatus::COMMAND_FAILED;
+}
+
+void ConsoleTerminal::cmdCtlStart(const std::vector<std::string>& args) {
+    std::string socketPath = args.empty() ? DEFAULT_CONTROL_SOCKET : args[0];
+    std::string error;
+    if (!startControlServer(socketPath, error)) {
+        showError("Failed to start control server: " + error);
+        return;
+    }
+    showSuccess("Control server listening on " + socketPath);
+}
+
+void ConsoleTerminal::cmdCtlStop(const std::vector<std::string>& args) {
+    (void)args;
+    if (!controlServer || !controlServer->getRunningStatus()) {
+        showError("Control server is not running");
+        return;
+    }
+    // 远程请求可能正在等待终端锁，停止期间释放
+    CommandLockRelease unlocked;
+    controlServer->stop();
+    showSuccess("Control server stopped");
+}
+
+void ConsoleTerminal::cmdCtlStats(const std::vector<std::string>& args) {
+    (void)args;
+    if (!controlServer) {
+        consoleOut() << "Control server has not been started" << std::endl;
+        return;
+    }
+    consoleOut() << controlServer->getStatistics();
+}
+
+// VM事件命令实现
+void ConsoleTerminal::cmdEvents(const std::vector<std::string>& args) {
+    (void)args;
+    consoleOut() << eventBus->getStatistics();
+}
+
+// 状态观察命令实现
+void ConsoleTerminal::cmdWatch(const std::vector<std::string>& args) {
+    const uint32_t MIN_INTERVAL_MS = 10;
+    const uint32_t MAX_INTERVAL_MS = 60 * 1000;
+    const uint32_t MAX_UPDATES = 100000;
+    
+    uint32_t intervalMs = args.size() > 0 ? static_cast<uint32_t>(std::stoul(args[0])) : 1000;
+    uint32_t updates = args.size() > 1 ? static_cast<uint32_t>(std::stoul(args[1])) : 10;
+    if (intervalMs < MIN_INTERVAL_MS || intervalMs > MAX_INTERVAL_MS || updates == 0 || updates > MAX_UPDATES) {
+        showError("Usage: watch [interval_ms (10-60000)] [updates (1-100000)]");
+        return;
+    }
+    
+    // 只读取无锁快照，等待期间释放终端锁，其他命令照常执行
+    StatusWatcher watcher(*watchSource);
+    consoleOut() << watcher.poll();
+    CommandLockRelease unlocked;
+    for (uint32_t i = 0; i < updates; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        std::string update = watcher.poll();
+        if (!update.empty()) {
+            consoleOut() << update << std::flush;
+        }
+    }
+    consoleOut() << "Watch finished: " << watcher.getChangeCount() << " changes" << std::endl;
+}
+
+// 调试器命令实现
+void ConsoleTerminal::cmdDebugStart(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: debug start <port> [vm_id] [snapshot_interval]");
+        return;
+    }
+    unsigned long port = std::stoul(args[0]);
+    uint32_t vmId = args.size() > 1 ? static_cast<uint32_t>(std::stoul(args[1])) : 0;
+    uint32_t interval = args.size() > 2 ? static_cast<uint32_t>(std::stoul(args[2])) : ReverseHistory::DEFAULT_INTERVAL;
+    if (port == 0 || port > 65535) {
+        showError("Invalid port: " + args[0]);
+        return;
+    }
+    if (interval == 0) {
+        showError("Snapshot interval must be positive");
+        return;
+    }
+    if (vmId != 0) {
+        if (!awaitVmLoaded(vmId)) {
+            return;
+        }
+        if (vmRegistry.find(vmId) == vmRegistry.end()) {
+            showError("VM " + std::to_string(vmId) + " not found");
+            return;
+        }
+    }
+    
+    if (!gdbServer) {
+        // 挂接发生在服务线程上，查找VM时获取终端锁；载荷尚未装入或装入失败的VM不可挂接
+        gdbServer.reset(new GdbServer([this](uint32_t id) -> std::shared_ptr<I_VmInterface> {
+            std::lock_guard<std::mutex> lock(commandMutex);
+            auto it = vmRegistry.find(id);
+            if (it == vmRegistry.end() || it->second.loadTicket != 0 || it->second.status == "LOAD_FAILED") {
+                return nullptr;
+            }
+            return it->second.vmPtr;
+        }));
+    }
+    gdbServer->setSnapshotInterval(interval);
+    std::string error;
+    if (!gdbServer->start(static_cast<uint16_t>(port), vmId, error)) {
+        showError("Failed to start gdb server: " + error);
+        return;
+    }
+    showSuccess("GDB server listening on 127.0.0.1:" + std::to_string(port) +
+                (vmId ? " (VM " + std::to_string(vmId) + ")" : std::string(" (use attach <vm id>)")));
+}
+
+void ConsoleTerminal::cmdDebugStop(const std::vector<std::string>& args) {
+    (void)args;
+    if (!gdbServer || !gdbServer->getRunningStatus()) {
+        showError("GDB server is not running");
+        return;
+    }
+    // 服务线程挂接VM时需要终端锁，停止期间释放
+    CommandLockRelease unlocked;
+    gdbServer->stop();
+    showSuccess("GDB server stopped");
+}
+
+void ConsoleTerminal::cmdDebugStats(const std::vector<std::string>& args) {
+    (void)args;
+    if (!gdbServer) {
+        consoleOut() << "GDB server has not been started" << std::endl;
+        return;
+    }
+    consoleOut() << gdbServer->getStatistics();
+}
+
+// 指令跟踪命令实现
+void ConsoleTerminal::cmdTraceStart(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: trace start <vm_id> [buffer_kb]");
+        return;
+    }
+    uint32_t vmId = static_cast<uint32_t>(std::stoul(args[0]));
+    uint32_t kb = args.size() > 1 ? static_cast<uint32_t>(std::stoul(args[1])) : TRACE_DEFAULT_KB;
+    if (kb == 0 || kb > TRACE_MAX_KB) {
+        showError("Buffer size must be 1-" + std::to_string(TRACE_MAX_KB) + " KB");
+        return;
+    }
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    I_VmInterface& vm = *it->second.vmPtr;
+    if (!claimExecutionWithin(vm, TRACE_CLAIM_TIMEOUT_MS)) {
+        showError("VM " + std::to_string(vmId) + " is being executed by another command");
+        return;
+    }
+    vm.startTrace(kb * 1024);
+    vm.releaseExecution();
+    showSuccess("Tracing VM " + std::to_string(vmId) + " (" + std::to_string(kb) + " KB ring buffer)");
+}
+
+void ConsoleTerminal::cmdTraceStop(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: trace stop <vm_id>");
+        return;
+    }
+    uint32_t vmId = static_cast<uint32_t>(std::stoul(args[0]));
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end() || !it->second.vmPtr->getTraceRecorder()) {
+        showError("VM " + std::to_string(vmId) + " is not being traced");
+        return;
+    }
+    I_VmInterface& vm = *it->second.vmPtr;
+    if (!claimExecutionWithin(vm, TRACE_CLAIM_TIMEOUT_MS)) {
+        showError("VM " + std::to_string(vmId) + " is being executed by another command");
+        return;
+    }
+    vm.stopTrace();
+    vm.releaseExecution();
+    showSuccess("Tracing stopped for VM " + std::to_string(vmId));
+}
+
+void ConsoleTerminal::cmdTraceDump(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        showError("Usage: trace dump <vm_id> <file>");
+        return;
+    }
+    uint32_t vmId = static_cast<uint32_t>(std::stoul(args[0]));
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end() || !it->second.vmPtr->getTraceRecorder()) {
+        showError("VM " + std::to_string(vmId) + " is not being traced");
+        return;
+    }
+    I_VmInterface& vm = *it->second.vmPtr;
+    std::vector<uint8_t> data;
+    if (!claimExecutionWithin(vm, TRACE_CLAIM_TIMEOUT_MS)) {
+        showError("VM " + std::to_string(vmId) + " is being executed by another command");
+        return;
+    }
+    vm.getTraceRecorder()->exportTrace(vmId, vm.getDebugTarget().architecture, vm.getOriginalCode(),
+                                       vm.getPayloadSize(), data);
+    vm.releaseExecution();
+    
+    std::ofstream file(args[1], std::ios::binary);
+    if (!file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+        showError("Failed to write " + args[1]);
+        return;
+    }
+    showSuccess("Trace of VM " + std::to_string(vmId) + " written to " + args[1] + " (" +
+                std::to_string(data.size()) + " bytes, payload " + it->second.payloadFile + ")");
+}
+
+void ConsoleTerminal::cmdTraceStats(const std::vector<std::string>& args) {
+    (void)args;
+    consoleOut() << "=== Instruction Trace ===" << std::endl;
+    uint32_t traced = 0;
+    for (const auto& entry : vmRegistry) {
+        I_VmInterface& vm = *entry.second.vmPtr;
+        if (!vm.getTraceRecorder() || !claimExecutionWithin(vm, TRACE_CLAIM_TIMEOUT_MS)) {
+            continue;
+        }
+        const TraceRecorder& recorder = *vm.getTraceRecorder();
+        uint64_t instructions = recorder.getInstructionCount();
+        uint64_t bytes = recorder.getEncodedBytes();
+        consoleOut() << "VM " << entry.first << ": instructions " << instructions
+                     << ", records " << recorder.getRecordCount() << ", encoded " << bytes << " bytes";
+        if (instructions > 0) {
+            consoleOut() << " (" << std::fixed << std::setprecision(2)
+                         << (8.0 * static_cast<double>(bytes) / static_cast<double>(instructions)) << " bits/instruction)";
+        }
+        consoleOut() << ", buffer " << recorder.getBufferSize() / 1024 << " KB, dropped chunks "
+                     << recorder.getDroppedChunks() << std::endl;
+        vm.releaseExecution();
+        traced++;
+    }
+    if (traced == 0) {
+        consoleOut() << "No VMs are being traced" << std::endl;
+    }
+}
+
+// 模糊测试命令实现
+void ConsoleTerminal::cmdFuzzRun(const std::vector<std::string>& args) {
+    if (args.size() < 3) {
+        showError("Usage: fuzz run <vm_id> <input_addr> <max_len> [seconds] [workers] [instructions]");
+        return;
+    }
+    uint32_t vmId = static_cast<uint32_t>(std::stoul(args[0]));
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    
+    // 默认每个VM核心一个工作线程，依次绑定到核心池中的核心
+    S_SchedulerSnapshot cores = scheduler->getSnapshot();
+    S_FuzzConfig config;
+    config.inputAddress = static_cast<uint32_t>(std::stoul(args[1], nullptr, 0));
+    config.maxInputLength = static_cast<uint32_t>(std::stoul(args[2], nullptr, 0));
+    config.durationMs = (args.size() > 3 ? static_cast<uint32_t>(std::stoul(args[3])) : FUZZ_DEFAULT_SECONDS) * 1000;
+    config.workers = args.size() > 4 ? static_cast<uint32_t>(std::stoul(args[4]))
+                                     : (cores.coreCount > 0 ? cores.coreCount : 1);
+    config.execInstructions = args.size() > 5 ? static_cast<uint32_t>(std::stoul(args[5])) : FUZZ_DEFAULT_INSTRUCTIONS;
+    config.seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    for (uint32_t i = 0; i < cores.coreCount; i++) {
+        config.cores.push_back(static_cast<int>(cores.firstCoreId + i));
+    }
+    
+    I_VmInterface& vm = *it->second.vmPtr;
+    if (!claimExecutionWithin(vm, TRACE_CLAIM_TIMEOUT_MS)) {
+        showError("VM " + std::to_string(vmId) + " is being executed by another command");
+        return;
+    }
+    std::string type = it->second.type;
+    fuzzer.reset(new Fuzzer(config, [this, type](uint32_t) { return createVmInstance(type, 0); }));
+    consoleOut() << "Fuzzing VM " << vmId << " for " << config.durationMs / 1000 << " s with "
+                 << config.workers << " workers..." << std::endl;
+    std::string error;
+    bool ok = fuzzer->run(vm, std::vector<std::vector<uint8_t>>(), error);
+    vm.releaseExecution();
+    if (!ok) {
+        showError("Fuzzing failed: " + error);
+        return;
+    }
+    consoleOut() << fuzzer->getReport();
+}
+
+void ConsoleTerminal::cmdFuzzReport(const std::vector<std::string>& args) {
+    (void)args;
+    if (!fuzzer) {
+        showError("No fuzzing run yet");
+        return;
+    }
+    consoleOut() << "=== Fuzzing Report ===" << std::endl;
+    consoleOut() << fuzzer->getReport();
+}
+
+void ConsoleTerminal::cmdFuzzExport(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: fuzz export <dir>");
+        return;
+    }
+    if (!fuzzer) {
+        showError("No fuzzing run yet");
+        return;
+    }
+    std::vector<std::vector<uint8_t>> corpus = fuzzer->getCorpus();
+    std::vector<S_FuzzCrash> crashes = fuzzer->getCrashes();
+    auto writeInput = [](const std::string& path, const std::vector<uint8_t>& data) {
+        std::ofstream file(path, std::ios::binary);
+        return static_cast<bool>(file.write(reinterpret_cast<const char*>(data.data()),
+                                            static_cast<std::streamsize>(data.size())));
+    };
+    for (size_t i = 0; i < corpus.size(); i++) {
+        std::ostringstream name;
+        name << args[0] << "/corpus_" << std::setw(6) << std::setfill('0') << i << ".bin";
+        if (!writeInput(name.str(), corpus[i])) {
+            showError("Failed to write " + name.str());
+            return;
+        }
+    }
+    for (size_t i = 0; i < crashes.size(); i++) {
+        std::ostringstream name;
+        name << args[0] << "/crash_" << std::setw(3) << std::setfill('0') << i << "_"
+             << GetVmFaultName(crashes[i].fault) << "_pc" << std::hex << crashes[i].pc << ".bin";
+        if (!writeInput(name.str(), crashes[i].input)) {
+            showError("Failed to write " + name.str());
+            return;
+        }
+    }
+    showSuccess("Exported " + std::to_string(corpus.size()) + " corpus and " + std::to_string(crashes.size()) +
+                " crash inputs to " + args[0]);
+}
+
+// CTF实例管理命令实现
+void ConsoleTerminal::cmdCtfTemplate(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        showError("Usage: ctf template <name> <vm_id>");
+        return;
+    }
+    uint32_t vmId = static_cast<uint32_t>(std::stoul(args[1]));
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    I_VmInterface& vm = *it->second.vmPtr;
+    if (!claimExecutionWithin(vm, TRACE_CLAIM_TIMEOUT_MS)) {
+        showError("VM " + std::to_string(vmId) + " is being executed by another command");
+        return;
+    }
+    std::string error;
+    bool ok = ctfManager->createChallenge(args[0], it->second.type, it->second.payloadFile, it->second.payloadData,
+                                          vm, error);
+    vm.releaseExecution();
+    if (!ok) {
+        showError(error);
+        return;
+    }
+    showSuccess("Challenge " + args[0] + " created from VM " + std::to_string(vmId));
+}
+
+void ConsoleTerminal::cmdCtfDrop(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: ctf drop <name>");
+        return;
+    }
+    std::string error;
+    if (!ctfManager->removeChallenge(args[0], error)) {
+        showError(error);
+        return;
+    }
+    showSuccess("Challenge " + args[0] + " removed");
+}
+
+void ConsoleTerminal::cmdCtfCreate(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        showError("Usage: ctf create <challenge> <player>");
+        return;
+    }
+    uint64_t createNs = 0;
+    std::string error;
+    std::shared_ptr<I_VmInterface> vm = ctfManager->createInstance(args[0], args[1], nextVmId, createNs, error);
+    if (!vm) {
+        showError(error);
+        return;
+    }
+    
+    std::shared_ptr<const S_CtfChallenge> challenge = ctfManager->getChallenge(args[0]);
+    S_VmInfo vmInfo;
+    vmInfo.id = nextVmId;
+    vmInfo.type = challenge->type;
+    vmInfo.status = "CREATED";
+    vmInfo.payloadFile = challenge->payloadFile;
+    vmInfo.vmPtr = vm;
+    vmInfo.payloadData = challenge->payload;
+    registerVm(vmInfo);
+    nextVmId++;
+    
+    // 调度器运行中时直接加入，受选手时间片配额约束
+    if (scheduler->getCounters().running) {
+        scheduler->addVm(vm, CTF_INSTANCE_PRIORITY, ctfManager->getTenantId(vmInfo.id));
+    }
+    std::ostringstream message;
+    message << "VM " << vmInfo.id << " created for " << args[1] << " from challenge " << args[0] << " in "
+            << std::fixed << std::setprecision(1) << createNs / 1000.0 << " us";
+    showSuccess(message.str());
+}
+
+void ConsoleTerminal::cmdCtfReset(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: ctf reset <vm_id>");
+        return;
+    }
+    uint32_t vmId = static_cast<uint32_t>(std::stoul(args[0]));
+    if (!awaitVmLoaded(vmId)) {
+        return;
+    }
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end()) {
+        showError("VM " + std::to_string(vmId) + " not found");
+        return;
+    }
+    I_VmInterface& vm = *it->second.vmPtr;
+    if (!claimExecutionWithin(vm, TRACE_CLAIM_TIMEOUT_MS)) {
+        showError("VM " + std::to_string(vmId) + " is being executed by another command");
+        return;
+    }
+    uint64_t resetNs = 0;
+    size_t pages = 0;
+    std::string error;
+    bool ok = ctfManager->resetInstance(vmId, resetNs, pages, error);
+    vm.releaseExecution();
+    if (!ok) {
+        showError(error);
+        return;
+    }
+    std::ostringstream message;
+    message << "VM " << vmId << " reset in " << std::fixed << std::setprecision(1) << resetNs / 1000.0
+            << " us (" << pages << " pages rolled back)";
+    showSuccess(message.str());
+}
+
+void ConsoleTerminal::cmdCtfDelete(const std::vector<std::string>& args) {
+    if (args.empty()) {
+        showError("Usage: ctf delete <vm_id>");
+        return;
+    }
+    uint32_t vmId = static_cast<uint32_t>(std::stoul(args[0]));
+    auto it = vmRegistry.find(vmId);
+    if (it == vmRegistry.end() || !ctfManager->isInstance(vmId)) {
+        showError("VM " + std::to_string(vmId) + " is not a challenge instance");
+        return;
+    }
+    unregisterVm(it);
+    showSuccess("Instance " + std::to_string(vmId) + " deleted");
+}
+
+void ConsoleTerminal::cmdCtfQuota(const std::vector<std::string>& args) {
+    if (args.size() < 3) {
+        showError("Usage: ctf quota <player> <max_instances> <slices_per_sec>");
+        return;
+    }
+    uint32_t maxInstances = static_cast<uint32_t>(std::stoul(args[1]));
+    uint32_t slices = static_cast<uint32_t>(std::stoul(args[2]));
+    uint32_t tenantId = ctfManager->setPlayerQuota(args[0], maxInstances, slices);
+    scheduler->setTenantQuota(tenantId, slices);
+    operationLog->append(OpLogEvent::QUOTA_CHANGE, 0, "ctf " + args[0] + " instances " + args[1] +
+                         " slices/s " + args[2]);
+    showSuccess("Player " + args[0] + " (tenant " + std::to_string(tenantId) + "): " + args[1] +
+                " instances, " + (slices ? args[2] + " slices/s" : std::string("unlimited slices")));
+}
+
+void ConsoleTerminal::cmdCtfList(const std::vector<std::string>& args) {
+    (void)args;
+    consoleOut() << "=== CTF Instances ===" << std::endl;
+    consoleOut() << ctfManager->getReport();
+    std::map<std::string, S_CtfPlayer> players = ctfManager->getPlayers();
+    consoleOut() << "Players: " << players.size() << std::endl;
+    for (const auto& pair : players) {
+        const S_CtfPlayer& player = pair.second;
+        consoleOut() << "  " << pair.first << " (tenant " << player.tenantId << "): " << player.instances << "/"
+                     << player.maxInstances << " instances, ";
+        S_TenantQuota usage;
+        if (player.slicesPerPeriod > 0 && scheduler->getTenantQuota(player.tenantId, usage)) {
+            consoleOut() << usage.usedSlices << "/" << usage.slicesPerPeriod << " slices this period, "
+                         << usage.totalSlices << " total, throttled " << usage.throttled;
+        } else {
+            consoleOut() << "unlimited slices";
+        }
+        consoleOut() << std::endl;
+    }
+}
+
+// 脚本模式实现
+uint32_t ConsoleTerminal::runScript(std::istream& input, const std::string& sourceName,
+                                    const S_ScriptOptions& options) {
+    scriptOptions = options;
+    isRunning = true;
+    asyncFailures = 0;
+    
+    uint32_t lineNumber = 0;
+    uint32_t commandCount = 0;
+    uint32_t asyncCount = 0;
+    uint32_t failedCount = 0;
+    uint32_t skippedLines = 0;
+    auto scriptStart = std::chrono::steady_clock::now();
+    
+    std::string line;
+    while (isRunning && std::getline(input, line)) {
+        lineNumber++;
+        
+        // 去掉首尾空白（含Windows换行符）
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        size_t last = line.find_last_not_of(" \t\r");
+        line = line.substr(first, last - first + 1);
+        
+        bool async = false;
+        if (line[line.size() - 1] == '&') {
+            async = true;
+            line.erase(line.size() - 1);
+            line.erase(line.find_last_not_of(" \t") + 1);
+        }
+        
+        auto args = parseArguments(line);
+        if (args.empty()) {
+            continue;
+        }
+        
+        if (args[0] == "wait") {
+            auto waitStart = std::chrono::steady_clock::now();
+            waitAsyncCommands();
+            if (options.timing) {
+                consoleOut() << "[timing] line " << lineNumber << ": wait - " << std::fixed << std::setprecision(3)
+                          << elapsedMsSince(waitStart) << " ms" << std::endl;
+            }
+            continue;
+        }
+        if (args[0] == "exit") {
+            break;
+        }
+        // 说明文字、标题等非命令行直接跳过
+        if (commandMap.find(args[0]) == commandMap.end()) {
+            skippedLines++;
+            continue;
+        }
+        
+        commandCount++;
+        if (async) {
+            asyncCount++;
+            S_AsyncCommand command;
+            command.id = asyncCount;
+            command.lineNumber = lineNumber;
+            command.line = line;
+            if (options.echo) {
+                consoleOut() << "[&" << command.id << "] " << line << std::endl;
+            }
+            submitAsyncCommand(command);
+            continue;
+        }
+        
+        if (options.echo) {
+            consoleOut() << "MyOS> " << line << std::endl;
+        }
+        double elapsedMs = 0;
+        bool ok = executeTimed(line, elapsedMs);
+        if (options.timing) {
+            consoleOut() << "[timing] line " << lineNumber << ": " << line << " - " << std::fixed
+                      << std::setprecision(3) << elapsedMs << " ms" << (ok ? "" : " (FAILED)") << std::endl;
+        }
+        if (!ok) {
+            failedCount++;
+            if (options.stopOnError) {
+                std::cerr << "Script stopped at line " << lineNumber << " (" << sourceName << ")" << std::endl;
+                break;
+            }
+        }
+    }
+    
+    // 脚本结束时隐式等待全部异步命令
+    waitAsyncCommands();
+    stopAsyncWorkers();
+    {
+        std::lock_guard<std::mutex> lock(asyncMutex);
+        failedCount += asyncFailures;
+    }
+    
+    consoleOut() << "\n=== Script Summary ===" << std::endl;
+    consoleOut() << "Source: " << sourceName << std::endl;
+    consoleOut() << "Commands: " << commandCount << " (async " << asyncCount << "), Failed: " << failedCount
+              << ", Skipped Lines: " << skippedLines << std::endl;
+    consoleOut() << "Elapsed: " << std::fixed << std::setprecision(3) << elapsedMsSince(scriptStart) << " ms"
+              << std::endl;
+    return failedCount;
+}
+
+bool ConsoleTerminal::executeTimed(const std::string& line, double& elapsedMs) {
+    tlsCommandErrors = 0;
+    auto start = std::chrono::steady_clock::now();
+    processCommand(line);
+    elapsedMs = elapsedMsSince(start);
+    return tlsCommandErrors == 0;
+}
+
+void ConsoleTerminal::submitAsyncCommand(const S_AsyncCommand& command) {
+    std::lock_guard<std::mutex> lock(asyncMutex);
+    if (asyncWorkers.empty()) {
+        asyncStopping = false;
+        for (uint32_t i = 0; i < SCRIPT_ASYNC_WORKERS; i++) {
+            asyncWorkers.push_back(std::thread(&ConsoleTerminal::asyncWorkerLoop, this));
+        }
+    }
+    asyncQueue.push_back(command);
+    asyncOutstanding++;
+    asyncCV.notify_one();
+}
+
+void ConsoleTerminal::asyncWorkerLoop() {
+    while (true) {
+        S_AsyncCommand command;
+        {
+            std::unique_lock<std::mutex> lock(asyncMutex);
+            asyncCV.wait(lock, [this]() { return asyncStopping || !asyncQueue.empty(); });
+            if (asyncQueue.empty()) {
+                return;
+            }
+            command = asyncQueue.front();
+            asyncQueue.pop_front();
+        }
+        
+        double elapsedMs = 0;
+        bool ok = executeTimed(command.line, elapsedMs);
+        if (scriptOptions.timing) {
+            std::ostringstream oss;
+            oss << "[timing] line " << command.lineNumber << ": [&" << command.id << "] " << command.line
+                << " - " << std::fixed << std::setprecision(3) << elapsedMs << " ms" << (ok ? "" : " (FAILED)")
+                << std::endl;
+            consoleOut() << oss.str();
+        }
+        
+        std::lock_guard<std::mutex> lock(asyncMutex);
+        if (!ok) {
+            asyncFailures++;
+        }
+        asyncOutstanding--;
+        if (asyncOutstanding == 0) {
+            asyncIdleCV.notify_all();
+        }
+    }
+}
+
+void ConsoleTerminal::waitAsyncCommands() {
+    std::unique_lock<std::mutex> lock(asyncMutex);
+    asyncIdleCV.wait(lock, [this]() { return asyncOutstanding == 0; });
+}
+
+void ConsoleTerminal::stopAsyncWorkers() {
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(asyncMutex);
+        asyncStopping = true;
+        workers.swap(asyncWorkers);
+    }
+    asyncCV.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// 辅助方法实现
+std::vector<std::string> ConsoleTerminal::parseArguments(const std::string& input) {
+    std::vector<std::string> args;
+    std::istringstream iss(input);
+    std::string token;
+    
+    while (iss >> token) {
+        args.push_back(token);
+    }
+    
+    return args;
+}
+
+void ConsoleTerminal::registerCommands() {
+    // 系统命令
+    commandMap["help"] = [this](const std::vector<std::string>& args) { cmdHelp(args); };
+    commandMap["status"] = [this](const std::vector<std::string>& args) { cmdStatus(args); };
+    commandMap["exit"] = [this](const std::vector<std::string>& args) { cmdExit(args); };
+    
+    // VM管理命令
+    commandMap["vm"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("VM command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "create") cmdVmCreate(subArgs);
+        else if (subcommand == "list") cmdVmList(subArgs);
+        else if (subcommand == "start") cmdVmStart(subArgs);
+        else if (subcommand == "stop") cmdVmStop(subArgs);
+        else if (subcommand == "pause") cmdVmPause(subArgs);
+        else if (subcommand == "resume") cmdVmResume(subArgs);
+        else if (subcommand == "run") cmdVmRun(subArgs);
+        else if (subcommand == "info") cmdVmInfo(subArgs);
+        else if (subcommand == "delete") cmdVmDelete(subArgs);
+        else if (subcommand == "swap") cmdVmSwap(subArgs);
+        else if (subcommand == "prefetch") cmdVmPrefetch(subArgs);
+        else if (subcommand == "loader") cmdVmLoader(subArgs);
+        else showError("Unknown VM subcommand: " + subcommand);
+    };
+    
+    // 调度器命令
+    commandMap["sched"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("Scheduler command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "start") cmdSchedStart(subArgs);
+        else if (subcommand == "stop") cmdSchedStop(subArgs);
+        else if (subcommand == "add") cmdSchedAdd(subArgs);
+        else if (subcommand == "bind") cmdSchedBind(subArgs);
+        else if (subcommand == "unbind") cmdSchedUnbind(subArgs);
+        else if (subcommand == "stats") cmdSchedStats(subArgs);
+        else showError("Unknown scheduler subcommand: " + subcommand);
+    };
+    
+    // 性能监控命令
+    commandMap["perf"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("Performance command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "start") cmdPerfStart(subArgs);
+        else if (subcommand == "stop") cmdPerfStop(subArgs);
+        else if (subcommand == "report") cmdPerfReport(subArgs);
+        else if (subcommand == "publish") cmdPerfPublish(subArgs);
+        else if (subcommand == "unpublish") cmdPerfUnpublish(subArgs);
+        else if (subcommand == "page") cmdPerfPage(subArgs);
+        else showError("Unknown performance subcommand: " + subcommand);
+    };
+    
+    // 虚拟网络命令
+    commandMap["net"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("Network command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "attach") cmdNetAttach(subArgs);
+        else if (subcommand == "send") cmdNetSend(subArgs);
+        else if (subcommand == "recv") cmdNetRecv(subArgs);
+        else if (subcommand == "stats") cmdNetStats(subArgs);
+        else showError("Unknown network subcommand: " + subcommand);
+    };
+    
+    // 虚拟中断命令
+    commandMap["irq"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("Interrupt command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "raise") cmdIrqRaise(subArgs);
+        else if (subcommand == "config") cmdIrqConfig(subArgs);
+        else if (subcommand == "entry") cmdIrqEntry(subArgs);
+        else if (subcommand == "mask") cmdIrqMask(subArgs, true);
+        else if (subcommand == "unmask") cmdIrqMask(subArgs, false);
+        else if (subcommand == "stats") cmdIrqStats(subArgs);
+        else showError("Unknown interrupt subcommand: " + subcommand);
+    };
+    
+    // 共享内存命令
+    commandMap["shm"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("Shared memory command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "create") cmdShmCreate(subArgs);
+        else if (subcommand == "destroy") cmdShmDestroy(subArgs);
+        else if (subcommand == "map") cmdShmMap(subArgs);
+        else if (subcommand == "unmap") cmdShmUnmap(subArgs);
+        else if (subcommand == "format") cmdShmFormat(subArgs);
+        else if (subcommand == "ring") cmdShmRing(subArgs);
+        else if (subcommand == "list") cmdShmList(subArgs);
+        else showError("Unknown shared memory subcommand: " + subcommand);
+    };
+    
+    // 故障处理命令
+    commandMap["exc"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("Exception command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "policy") cmdExcPolicy(subArgs);
+        else if (subcommand == "rate") cmdExcRate(subArgs);
+        else if (subcommand == "release") cmdExcRelease(subArgs);
+        else if (subcommand == "stats") cmdExcStats(subArgs);
+        else showError("Unknown exception subcommand: " + subcommand);
+    };
+    
+    // 操作日志命令
+    commandMap["oplog"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("Operation log command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "stats") cmdOplogStats(subArgs);
+        else if (subcommand == "verify") cmdOplogVerify(subArgs);
+        else showError("Unknown operation log subcommand: " + subcommand);
+    };
+    
+    commandMap["ctl"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("Control server command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "start") cmdCtlStart(subArgs);
+        else if (subcommand == "stop") cmdCtlStop(subArgs);
+        else if (subcommand == "stats") cmdCtlStats(subArgs);
+        else showError("Unknown control server subcommand: " + subcommand);
+    };
+    
+    commandMap["events"] = [this](const std::vector<std::string>& args) {
+        cmdEvents(args);
+    };
+    
+    commandMap["debug"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("Debug command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "start") cmdDebugStart(subArgs);
+        else if (subcommand == "stop") cmdDebugStop(subArgs);
+        else if (subcommand == "stats") cmdDebugStats(subArgs);
+        else showError("Unknown debug subcommand: " + subcommand);
+    };
+    
+    commandMap["trace"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("Trace command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "start") cmdTraceStart(subArgs);
+        else if (subcommand == "stop") cmdTraceStop(subArgs);
+        else if (subcommand == "dump") cmdTraceDump(subArgs);
+        else if (subcommand == "stats") cmdTraceStats(subArgs);
+        else showError("Unknown trace subcommand: " + subcommand);
+    };
+    
+    commandMap["fuzz"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("Fuzz command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "run") cmdFuzzRun(subArgs);
+        else if (subcommand == "report") cmdFuzzReport(subArgs);
+        else if (subcommand == "export") cmdFuzzExport(subArgs);
+        else showError("Unknown fuzz subcommand: " + subcommand);
+    };
+    
+    commandMap["ctf"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("CTF command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "template") cmdCtfTemplate(subArgs);
+        else if (subcommand == "drop") cmdCtfDrop(subArgs);
+        else if (subcommand == "create") cmdCtfCreate(subArgs);
+        else if (subcommand == "reset") cmdCtfReset(subArgs);
+        else if (subcommand == "delete") cmdCtfDelete(subArgs);
+        else if (subcommand == "quota") cmdCtfQuota(subArgs);
+        else if (subcommand == "list") cmdCtfList(subArgs);
+        else showError("Unknown ctf subcommand: " + subcommand);
+    };
+    
+    commandMap["watch"] = [this](const std::vector<std::string>& args) {
+        cmdWatch(args);
+    };
+    
+    commandMap["admin"] = [this](const std::vector<std::string>& args) {
+        if (args.empty()) {
+            showError("Admin command requires subcommand");
+            return;
+        }
+        
+        std::string subcommand = args[0];
+        std::vector<std::string> subArgs(args.begin() + 1, args.end());
+        
+        if (subcommand == "kill") cmdAdminSubmit(AdminCommandType::FORCE_STOP, subArgs);
+        else if (subcommand == "ban") cmdAdminSubmit(AdminCommandType::BAN, subArgs);
+        else if (subcommand == "unban") cmdAdminSubmit(AdminCommandType::UNBAN, subArgs);
+        else if (subcommand == "reclaim") cmdAdminSubmit(AdminCommandType::RECLAIM_CORE, subArgs);
+        else if (subcommand == "stats") cmdAdminStats(subArgs);
+        else showError("Unknown admin subcommand: " + subcommand);
+    };
+}
+
+bool ConsoleTerminal::loadPayloadFromFile(const std::string& filename, std::vector<uint8_t>& payload) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    // 获取文件大小
+    file.seekg(0, std::ios::end);
+    size_t fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+    
+    // 读取文件内容
+    payload.resize(fileSize);
+    file.read(reinterpret_cast<char*>(payload.data()), fileSize);
     file.close();
     
     return true;
@@ -627,19 +2605,40 @@ std::shared_ptr<I_VmInterface> ConsoleTerminal::createVmInstance(const std::stri
 }
 
 void ConsoleTerminal::printVmInfo(const S_VmInfo& vmInfo) {
-    std::cout << "VM ID: " << vmInfo.id << std::endl;
-    std::cout << "  Type: " << vmInfo.type << std::endl;
-    std::cout << "  Status: " << vmInfo.status << std::endl;
-    std::cout << "  Payload File: " << vmInfo.payloadFile << std::endl;
-    std::cout << "  Resource Usage: " << vmInfo.vmPtr->getResourceUsage() << std::endl;
+    consoleOut() << "VM ID: " << vmInfo.id << std::endl;
+    consoleOut() << "  Type: " << vmInfo.type << std::endl;
+    consoleOut() << "  Status: " << vmInfo.status << std::endl;
+    consoleOut() << "  Payload File: " << vmInfo.payloadFile << std::endl;
+    consoleOut() << "  Payload Version: " << vmInfo.vmPtr->getPayloadGeneration() << std::endl;
+    if (!vmInfo.loadError.empty()) {
+        consoleOut() << "  Load Error: " << vmInfo.loadError << std::endl;
+    }
+    consoleOut() << "  Resource Usage: " << vmInfo.vmPtr->getResourceUsage() << std::endl;
+    consoleOut() << "  Virtual Time: " << vmInfo.vmPtr->getVirtualTime() << " ticks" << std::endl;
+    
+    const VirtualTimer& timer = vmInfo.vmPtr->getTimer();
+    consoleOut() << "  Timer: ";
+    if (timer.isArmed()) {
+        consoleOut() << (timer.getMode() == VirtualTimerMode::PERIODIC ? "PERIODIC" : "ONE_SHOT")
+                  << ", deadline " << timer.getDeadline();
+    } else {
+        consoleOut() << "DISABLED";
+    }
+    consoleOut() << ", fired " << timer.getFiredCount() << std::endl;
+    
+    VmControlAction hold = vmInfo.vmPtr->getControlHold();
+    if (hold != VmControlAction::NONE) {
+        consoleOut() << "  Fault Hold: " << GetVmControlName(hold) << std::endl;
+    }
 }
 
 void ConsoleTerminal::showError(const std::string& error) {
-    std::cerr << "Error: " << error << std::endl;
+    tlsCommandErrors++;
+    (tlsOutput ? *tlsOutput : std::cerr) << "Error: " << error << std::endl;
 }
 
 void ConsoleTerminal::showSuccess(const std::string& message) {
-    std::cout << "Success: " << message << std::endl;
+    consoleOut() << "Success: " << message << std::endl;
 }
 
 void AutoTestSuite::runAllTests() {
@@ -651,6 +2650,8 @@ void AutoTestSuite::runAllTests() {
     testSchedulerIntegration();
     testPerformanceMonitoring();
     runStressTest();
+    testOperationLogTamper();
+    testPayloadSwap();
     
     std::cout << "\n===========================================" << std::endl;
     std::cout << "    All Tests Completed" << std::endl;
@@ -775,6 +2776,154 @@ void AutoTestSuite::testPerformanceMonitoring() {
     }
 }
 
+void AutoTestSuite::testOperationLogTamper() {
+    std::cout << "\n--- Testing Operation Log Tamper Evidence ---" << std::endl;
+    
+    const std::string logFile = "test_oplog.bin";
+    const std::string tamperedFile = "test_oplog_tampered.bin";
+    const std::string truncatedFile = "test_oplog_truncated.bin";
+    std::remove(logFile.c_str());
+    
+    try {
+        // 写入一段日志（写入线程未启动，append同步落盘）
+        std::string error;
+        {
+            OperationLog log;
+            if (!log.open(logFile, error)) {
+                throw std::runtime_error("cannot open log: " + error);
+            }
+            log.append(OpLogEvent::VM_FORCE_STOP, 1, "test force stop");
+            log.append(OpLogEvent::USER_BAN, 0, "test ban");
+            log.append(OpLogEvent::PAYLOAD_SWAP, 1, "test_payload.bin");
+            log.close();
+        }
+        
+        S_OpLogVerifyResult original;
+        if (!OperationLog::verifyFile(logFile, original) || original.truncatedTail || original.recordCount < 2) {
+            throw std::runtime_error("intact log rejected: " + original.error);
+        }
+        
+        std::ifstream input(logFile, std::ios::binary);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        input.close();
+        
+        // 修改第一条记录记录头之后的一个字节：记录哈希或后续链接必须校验失败
+        std::vector<uint8_t> tampered = data;
+        tampered[sizeof(S_OpLogRecordHeader)] ^= 0xFF;
+        std::ofstream tamperedOut(tamperedFile, std::ios::binary);
+        tamperedOut.write(reinterpret_cast<const char*>(tampered.data()), tampered.size());
+        tamperedOut.close();
+        
+        S_OpLogVerifyResult tamperedResult;
+        if (OperationLog::verifyFile(tamperedFile, tamperedResult)) {
+            throw std::runtime_error("tampered log accepted");
+        }
+        std::cout << "Tampered log rejected: " << tamperedResult.error << std::endl;
+        
+        // 截掉末尾几个字节（模拟写入中途崩溃）：校验通过并报告不完整尾部
+        std::ofstream truncatedOut(truncatedFile, std::ios::binary);
+        truncatedOut.write(reinterpret_cast<const char*>(data.data()), data.size() - 5);
+        truncatedOut.close();
+        
+        S_OpLogVerifyResult truncated;
+        if (!OperationLog::verifyFile(truncatedFile, truncated) || !truncated.truncatedTail ||
+            truncated.recordCount != original.recordCount - 1) {
+            throw std::runtime_error("truncated log not recovered: " + truncated.error);
+        }
+        
+        // 重新打开时截断不完整尾部后续写，之后整条链完整
+        {
+            OperationLog log;
+            if (!log.open(truncatedFile, error)) {
+                throw std::runtime_error("cannot reopen truncated log: " + error);
+            }
+            log.close();
+        }
+        S_OpLogVerifyResult recovered;
+        if (!OperationLog::verifyFile(truncatedFile, recovered) || recovered.truncatedTail) {
+            throw std::runtime_error("reopened log invalid: " + recovered.error);
+        }
+        std::cout << "Truncated log recovered: " << truncated.recordCount << " records kept, "
+                  << recovered.recordCount << " after reopen" << std::endl;
+        
+        std::cout << "✓ Operation log tamper evidence test passed" << std::endl;
+        
+    } catch (const std::exception& e) {
+        std::cout << "✗ Operation log tamper evidence test failed: " << e.what() << std::endl;
+    }
+    
+    std::remove(logFile.c_str());
+    std::remove(tamperedFile.c_str());
+    std::remove(truncatedFile.c_str());
+}
+
+void AutoTestSuite::testPayloadSwap() {
+    std::cout << "\n--- Testing Payload Swap ---" << std::endl;
+    
+    // 旧载荷16字节、新载荷32字节NOP，重定位表把旧PC 4映射到新PC 0x14
+    std::vector<uint8_t> oldPayload(16, 0x00);
+    std::vector<uint8_t> newPayload(32, 0x00);
+    std::ofstream oldFile("test_swap_old.bin", std::ios::binary);
+    oldFile.write(reinterpret_cast<const char*>(oldPayload.data()), oldPayload.size());
+    oldFile.close();
+    std::ofstream newFile("test_swap_new.bin", std::ios::binary);
+    newFile.write(reinterpret_cast<const char*>(newPayload.data()), newPayload.size());
+    newFile.close();
+    std::ofstream relocationFile("test_swap.reloc");
+    relocationFile << "# oldPC newPC" << std::endl;
+    relocationFile << "4 0x14" << std::endl;
+    relocationFile.close();
+    
+    try {
+        // VM编号取决于前面的测试，从创建输出中解析
+        std::string output;
+        if (terminal.executeControlRequest(ControlOpcode::COMMAND, "vm create x86 test_swap_old.bin --wait",
+                                           output) != ControlStatus::OK) {
+            throw std::runtime_error("create failed: " + output);
+        }
+        std::cout << output;
+        size_t pos = output.find("VM ");
+        if (pos == std::string::npos) {
+            throw std::runtime_error("cannot parse VM id: " + output);
+        }
+        std::string vmId = std::to_string(std::stoul(output.substr(pos + 3)));
+        
+        terminal.processCommand("vm start " + vmId);
+        terminal.processCommand("vm run " + vmId + " 4");
+        
+        // VM空闲，替换立即生效，EIP按重定位表移到新载荷
+        if (terminal.executeControlRequest(ControlOpcode::COMMAND,
+                                           "vm swap " + vmId + " test_swap_new.bin test_swap.reloc",
+                                           output) != ControlStatus::OK) {
+            throw std::runtime_error("swap failed: " + output);
+        }
+        std::cout << output;
+        if (output.find("swapped") == std::string::npos) {
+            throw std::runtime_error("swap not applied to idle VM");
+        }
+        
+        terminal.executeControlRequest(ControlOpcode::COMMAND, "vm info " + vmId, output);
+        std::cout << output;
+        if (output.find("EIP: 0x00000014") == std::string::npos) {
+            throw std::runtime_error("EIP not relocated");
+        }
+        if (output.find("Payload Version: 1") == std::string::npos) {
+            throw std::runtime_error("payload version not advanced");
+        }
+        
+        terminal.processCommand("vm stop " + vmId);
+        
+        std::cout << "✓ Payload swap test passed" << std::endl;
+        
+    } catch (const std::exception& e) {
+        std::cout << "✗ Payload swap test failed: " << e.what() << std::endl;
+    }
+    
+    std::remove("test_swap_old.bin");
+    std::remove("test_swap_new.bin");
+    std::remove("test_swap.reloc");
+}
+
 void AutoTestSuite::runStressTest() {
     std::cout << "\n--- Running Stress Test ---" << std::endl;
     
@@ -9,12 +9,30 @@
 #include <fstream>
 #include <sstream>
 #include <functional>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 #include "../kernel/CPUvm/baseVM.h"
 #include "../kernel/CPUvm/x86Vm.h"
 #include "../kernel/CPUvm/armVm.h"
 #include "../kernel/CPUvm/x64Vm.h"
 #include "../kernel/dispatch/scheduler.h"
 #include "../kernel/performance_monitor/performance_monitor.h"
+#include "../kernel/device/virtual_network.h"
+#include "../kernel/hypercall/hypercall.h"
+#include "../kernel/memory/shared_memory.h"
+#include "../kernel/security/operation_log.h"
+#include "../kernel/admin/admin_control.h"
+#include "../kernel/control/control_server.h"
+#include "../kernel/event/vm_event_bus.h"
+#include "../kernel/performance_monitor/status_watch.h"
+#include "../kernel/performance_monitor/stats_publisher.h"
+#include "../kernel/debug/gdb_server.h"
+#include "../kernel/fuzz/fuzzer.h"
+#include "../kernel/ctf/ctf_manager.h"
+#include "../kernel/payload/payload_entry.h"
+#include "../kernel/payload/payload_loader.h"
 
 /**
  * @brief 控制台命令结构体
@@ -34,6 +52,42 @@ struct S_VmInfo {
     std::string status;
     std::string payloadFile;
     std::shared_ptr<I_VmInterface> vmPtr;
+    std::shared_ptr<std::vector<uint8_t>> payloadData; // 载荷数据（VM只保存指针，由注册表持有）
+    uint64_t loadTicket;            // 加载中的载荷请求编号（0表示已装入）
+    std::string loadError;          // 状态为LOAD_FAILED时的原因
+
+    S_VmInfo() : id(0), loadTicket(0) {}
+};
+
+/**
+ * @brief 热替换换下的旧载荷
+ * @details VM在块边界换入新载荷之前仍在执行旧载荷；VM的载荷版本达到generation
+ *          （或VM已释放）后才回收
+ */
+struct S_RetiredPayload {
+    std::weak_ptr<I_VmInterface> vm;
+    uint64_t generation;
+    std::shared_ptr<std::vector<uint8_t>> payloadData;
+};
+
+/**
+ * @brief 脚本/批处理模式选项
+ */
+struct S_ScriptOptions {
+    bool echo;                  // 回显执行的命令
+    bool timing;                // 输出每条命令的耗时
+    bool stopOnError;           // 命令失败后终止脚本
+
+    S_ScriptOptions() : echo(true), timing(true), stopOnError(false) {}
+};
+
+/**
+ * @brief 脚本中以"&"结尾的异步命令
+ */
+struct S_AsyncCommand {
+    uint32_t id;                // 异步命令序号
+    uint32_t lineNumber;        // 所在脚本行
+    std::string line;           // 命令行（已去掉"&"）
 };
 
 /**
@@ -44,12 +98,40 @@ class ConsoleTerminal {
 private:
     bool isRunning;                             // 终端运行状态
     std::map<uint32_t, S_VmInfo> vmRegistry;    // VM注册表
+    std::vector<S_RetiredPayload> retiredPayloads; // 等待VM换入新载荷后回收的旧载荷
+    std::unique_ptr<OperationLog> operationLog; // 防篡改管理与安全事件日志
+    std::unique_ptr<ExceptionManager> exceptionManager; // VM故障处理（调度器时间片故障上报目标）
     std::unique_ptr<Scheduler> scheduler;       // 调度器实例
+    std::unique_ptr<AdminControlPlane> adminPlane; // 核0管理员控制面（强制终结/封禁/核心回收）
     std::unique_ptr<PerformanceMonitor> perfMonitor; // 性能监控器实例
+    std::unique_ptr<VirtualSwitch> vSwitch;     // VM间虚拟交换机
+    std::unique_ptr<HypercallTable> hypercalls; // 宿主服务表（所有VM共享）
+    std::unique_ptr<SharedMemoryManager> sharedMemory; // VM间共享内存区域
+    std::unique_ptr<VmEventBus> eventBus;       // VM事件总线（控制套接字订阅推送）
+    std::unique_ptr<StatusWatchSource> watchSource; // watch读取的VM列表与调度器快照（无锁）
+    std::unique_ptr<StatsPagePublisher> statsPublisher; // 共享内存统计页发布（外部监控进程读取）
+    std::unique_ptr<ControlServer> controlServer; // 本机控制套接字服务（首次启动时创建）
+    std::unique_ptr<GdbServer> gdbServer;       // gdb远程调试服务（首次启动时创建）
+    std::unique_ptr<Fuzzer> fuzzer;             // 最近一次模糊测试（fuzz report/export查看）
+    std::unique_ptr<CtfManager> ctfManager;     // CTF题目模板与选手实例
+    std::unique_ptr<PayloadLoader> payloadLoader; // 核1载荷加载流水线（vm create异步装入）
+    std::map<uint64_t, uint32_t> pendingLoads;  // 加载请求编号 -> 等待载荷的VM ID
     uint32_t nextVmId;                          // 下一个VM ID
     
     // 命令映射表
     std::map<std::string, std::function<void(const std::vector<std::string>&)>> commandMap;
+    std::mutex commandMutex;                    // 串行化命令对终端状态的访问（vm run执行阶段释放）
+    
+    // 脚本模式异步命令
+    S_ScriptOptions scriptOptions;              // 当前脚本选项
+    std::deque<S_AsyncCommand> asyncQueue;      // 待执行的异步命令
+    std::vector<std::thread> asyncWorkers;      // 异步命令执行线程（首次使用时启动）
+    std::mutex asyncMutex;                      // 保护异步命令队列与计数
+    std::condition_variable asyncCV;            // 通知执行线程
+    std::condition_variable asyncIdleCV;        // 通知wait屏障
+    uint32_t asyncOutstanding;                  // 已提交未完成的异步命令数
+    uint32_t asyncFailures;                     // 失败的异步命令数
+    bool asyncStopping;                         // 执行线程退出标志
     
 public:
     ConsoleTerminal();
@@ -86,6 +168,37 @@ public:
      */
     void processCommand(const std::string& input);
     
+    /**
+     * @brief 以脚本/批处理模式全速执行命令流
+     * @details 每行一条控制台命令，首个单词不是已注册命令的行（说明文字、标题等）跳过；
+     *          以"&"结尾的命令交给后台线程异步执行，脚本继续读取后续命令，
+     *          "wait"等待此前提交的全部异步命令完成；"exit"结束脚本
+     * @param input 命令流（脚本文件或标准输入）
+     * @param sourceName 命令来源名称（用于输出）
+     * @param options 脚本选项
+     * @return 失败的命令数
+     */
+    uint32_t runScript(std::istream& input, const std::string& sourceName,
+                       const S_ScriptOptions& options = S_ScriptOptions());
+    
+    /**
+     * @brief 启动本机控制套接字服务，远程请求映射到控制台命令执行
+     * @param socketPath 套接字路径
+     * @param error 失败原因
+     * @return bool 启动成功返回true
+     */
+    bool startControlServer(const std::string& socketPath, std::string& error);
+    
+    /**
+     * @brief 执行一条控制套接字请求（控制服务执行线程调用）
+     * @details 与控制台命令共用终端锁，命令输出写入output而不是标准输出
+     * @param opcode 操作码
+     * @param args 参数文本
+     * @param output 捕获的命令输出
+     * @return 响应状态码
+     */
+    ControlStatus executeControlRequest(ControlOpcode opcode, const std::string& args, std::string& output);
+    
 private:
     // 系统命令
     void cmdHelp(const std::vector<std::string>& args);
@@ -102,6 +215,9 @@ private:
     void cmdVmRun(const std::vector<std::string>& args);
     void cmdVmInfo(const std::vector<std::string>& args);
     void cmdVmDelete(const std::vector<std::string>& args);
+    void cmdVmSwap(const std::vector<std::string>& args);
+    void cmdVmPrefetch(const std::vector<std::string>& args);
+    void cmdVmLoader(const std::vector<std::string>& args);
     
     // 调度器命令
     void cmdSchedStart(const std::vector<std::string>& args);
@@ -115,13 +231,101 @@ private:
     void cmdPerfStart(const std::vector<std::string>& args);
     void cmdPerfStop(const std::vector<std::string>& args);
     void cmdPerfReport(const std::vector<std::string>& args);
+    void cmdPerfPublish(const std::vector<std::string>& args);
+    void cmdPerfUnpublish(const std::vector<std::string>& args);
+    void cmdPerfPage(const std::vector<std::string>& args);
+    
+    // 虚拟网络命令
+    void cmdNetAttach(const std::vector<std::string>& args);
+    void cmdNetSend(const std::vector<std::string>& args);
+    void cmdNetRecv(const std::vector<std::string>& args);
+    void cmdNetStats(const std::vector<std::string>& args);
+    
+    // 虚拟中断命令
+    void cmdIrqRaise(const std::vector<std::string>& args);
+    void cmdIrqConfig(const std::vector<std::string>& args);
+    void cmdIrqEntry(const std::vector<std::string>& args);
+    void cmdIrqMask(const std::vector<std::string>& args, bool maskVector);
+    void cmdIrqStats(const std::vector<std::string>& args);
+    
+    // 共享内存命令
+    void cmdShmCreate(const std::vector<std::string>& args);
+    void cmdShmDestroy(const std::vector<std::string>& args);
+    void cmdShmMap(const std::vector<std::string>& args);
+    void cmdShmUnmap(const std::vector<std::string>& args);
+    void cmdShmFormat(const std::vector<std::string>& args);
+    void cmdShmRing(const std::vector<std::string>& args);
+    void cmdShmList(const std::vector<std::string>& args);
+    
+    // 故障处理命令
+    void cmdExcPolicy(const std::vector<std::string>& args);
+    void cmdExcRate(const std::vector<std::string>& args);
+    void cmdExcRelease(const std::vector<std::string>& args);
+    void cmdExcStats(const std::vector<std::string>& args);
+    
+    // 操作日志命令
+    void cmdOplogStats(const std::vector<std::string>& args);
+    void cmdOplogVerify(const std::vector<std::string>& args);
+    
+    // 管理员命令
+    void cmdAdminSubmit(AdminCommandType type, const std::vector<std::string>& args);
+    void cmdAdminStats(const std::vector<std::string>& args);
+    
+    // 控制套接字命令
+    void cmdCtlStart(const std::vector<std::string>& args);
+    void cmdCtlStop(const std::vector<std::string>& args);
+    void cmdCtlStats(const std::vector<std::string>& args);
+    
+    // VM事件命令
+    void cmdEvents(const std::vector<std::string>& args);
+    
+    // 状态观察命令
+    void cmdWatch(const std::vector<std::string>& args);
+    
+    // 调试器命令
+    void cmdDebugStart(const std::vector<std::string>& args);
+    void cmdDebugStop(const std::vector<std::string>& args);
+    void cmdDebugStats(const std::vector<std::string>& args);
+    
+    // 指令跟踪命令
+    void cmdTraceStart(const std::vector<std::string>& args);
+    void cmdTraceStop(const std::vector<std::string>& args);
+    void cmdTraceDump(const std::vector<std::string>& args);
+    void cmdTraceStats(const std::vector<std::string>& args);
+    
+    // 模糊测试命令
+    void cmdFuzzRun(const std::vector<std::string>& args);
+    void cmdFuzzReport(const std::vector<std::string>& args);
+    void cmdFuzzExport(const std::vector<std::string>& args);
+    
+    // CTF实例管理命令
+    void cmdCtfTemplate(const std::vector<std::string>& args);
+    void cmdCtfDrop(const std::vector<std::string>& args);
+    void cmdCtfCreate(const std::vector<std::string>& args);
+    void cmdCtfReset(const std::vector<std::string>& args);
+    void cmdCtfDelete(const std::vector<std::string>& args);
+    void cmdCtfQuota(const std::vector<std::string>& args);
+    void cmdCtfList(const std::vector<std::string>& args);
+    
+    // 脚本模式辅助方法
+    bool executeTimed(const std::string& line, double& elapsedMs);
+    void submitAsyncCommand(const S_AsyncCommand& command);
+    void asyncWorkerLoop();
+    void waitAsyncCommands();
+    void stopAsyncWorkers();
     
     // 辅助方法
     std::vector<std::string> parseArguments(const std::string& input);
     void registerCommands();
     bool loadPayloadFromFile(const std::string& filename, std::vector<uint8_t>& payload);
     std::shared_ptr<I_VmInterface> createVmInstance(const std::string& type, uint32_t id);
+    void registerVm(const S_VmInfo& vmInfo);
+    void unregisterVm(std::map<uint32_t, S_VmInfo>::iterator it);
     void printVmInfo(const S_VmInfo& vmInfo);
+    void reclaimRetiredPayloads();
+    void completePayloadLoads();
+    bool awaitVmLoaded(uint32_t vmId);
+    bool loadRelocationFile(const std::string& filename, std::vector<std::pair<uint64_t, uint64_t>>& relocations);
     void showError(const std::string& error);
     void showSuccess(const std::string& message);
 };
@@ -156,6 +360,16 @@ public:
      */
     void testPerformanceMonitoring();
     
+    /**
+     * @brief 操作日志防篡改测试（篡改一个字节被拒绝，截断尾部可恢复）
+     */
+    void testOperationLogTamper();
+    
+    /**
+     * @brief 载荷热替换测试（带重定位表）
+     */
+    void testPayloadSwap();
+    
     /**
      * @brief 压力测试
      */
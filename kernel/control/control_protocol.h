@@ -0,0 +1,141 @@
+#ifndef CONTROL_PROTOCOL_H
+#define CONTROL_PROTOCOL_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 控制套接字协议（长度前缀二进制帧，按宿主字节序，只用于本机）
+ * @details 请求帧：S_ControlRequestHeader + argLength字节参数文本；
+ *          响应帧：S_ControlResponseHeader + outputLength字节命令输出。
+ *          两种帧头的length都是帧头之后（不含length字段本身）的字节数。
+ *          客户端可以不等响应连续发送多个请求（流水线），服务端按每个连接的请求顺序执行，
+ *          同一批到达的请求的响应合并为一次写入；响应通过requestId与请求对应。
+ *          SUBSCRIBE之后服务端随时推送status为EVENT的响应帧（requestId为订阅请求的序号），
+ *          载荷是若干条32字节的S_VmEvent记录（kernel/CPUvm/vmEvent.h）。
+ *          WATCH之后服务端按请求的间隔推送status为WATCH的响应帧，载荷是相对上一帧变化的
+ *          VM状态、核心归属与调度器计数（文本，每行一项，较长的更新按行拆成多帧）。
+ */
+
+static const uint32_t CONTROL_MAX_FRAME = 64 * 1024;       // 单帧上限（超过即断开连接）
+static const uint16_t CONTROL_FLAG_QUIET = 0x0001;         // 请求标志：响应不携带命令输出
+
+/**
+ * @brief 请求操作码，映射到控制台命令表中的命令
+ * @details 参数文本按控制台命令的参数格式书写，例如VM_CREATE的参数为"x86 x86_test.bin"；
+ *          COMMAND的参数是完整命令行；命令表中为nullptr的操作码由控制服务自身处理，不转给控制台。
+ *          新增操作码时需同步更新GetControlOpcodeCommand()的命令表
+ */
+enum class ControlOpcode : uint16_t {
+    COMMAND         = 0,    // 完整命令行
+    STATUS          = 1,    // status
+    VM_CREATE       = 2,    // vm create <type> <file>
+    VM_LIST         = 3,    // vm list
+    VM_START        = 4,    // vm start <id>
+    VM_STOP         = 5,    // vm stop <id>
+    VM_PAUSE        = 6,    // vm pause <id>
+    VM_RESUME       = 7,    // vm resume <id>
+    VM_RUN          = 8,    // vm run <id> <steps>
+    VM_INFO         = 9,    // vm info <id>
+    VM_DELETE       = 10,   // vm delete <id>
+    SCHED_ADD       = 11,   // sched add <id> <pri>
+    SCHED_BIND      = 12,   // sched bind <id> <core>
+    SCHED_UNBIND    = 13,   // sched unbind <id>
+    SCHED_STATS     = 14,   // sched stats
+    ADMIN_KILL      = 15,   // admin kill <id>
+    SUBSCRIBE       = 16,   // 订阅VM事件："<vmId|*> [halted|fault|limit|run|stopped|swap|all ...]"（服务端处理）
+    UNSUBSCRIBE     = 17,   // 取消本连接的事件订阅（服务端处理）
+    WATCH           = 18,   // 按间隔推送状态变化："[interval_ms]"（服务端处理）
+    UNWATCH         = 19,   // 停止本连接的状态推送（服务端处理）
+    COUNT
+};
+
+/**
+ * @brief 获取操作码对应的控制台命令前缀
+ */
+inline const char* GetControlOpcodeCommand(ControlOpcode opcode) {
+    static const char* const commands[] = {
+        "",
+        "status",
+        "vm create",
+        "vm list",
+        "vm start",
+        "vm stop",
+        "vm pause",
+        "vm resume",
+        "vm run",
+        "vm info",
+        "vm delete",
+        "sched add",
+        "sched bind",
+        "sched unbind",
+        "sched stats",
+        "admin kill",
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr
+    };
+    static_assert(sizeof(commands) / sizeof(commands[0]) == static_cast<size_t>(ControlOpcode::COUNT),
+                  "control command table out of sync with ControlOpcode");
+    uint16_t index = static_cast<uint16_t>(opcode);
+    return index < static_cast<uint16_t>(ControlOpcode::COUNT) ? commands[index] : nullptr;
+}
+
+/**
+ * @brief 响应状态码
+ */
+enum class ControlStatus : uint16_t {
+    OK              = 0,    // 命令执行成功
+    COMMAND_FAILED  = 1,    // 命令输出了错误
+    BAD_OPCODE      = 2,    // 未知操作码
+    REJECTED        = 3,    // 命令不允许远程执行（如exit）
+    EVENT           = 4,    // 订阅推送的VM事件（载荷为S_VmEvent数组）
+    WATCH           = 5,    // watch推送的状态变化（文本）
+    COUNT
+};
+
+/**
+ * @brief 获取响应状态码的显示名称
+ */
+inline const char* GetControlStatusName(ControlStatus status) {
+    static const char* const names[] = {
+        "OK",
+        "COMMAND_FAILED",
+        "BAD_OPCODE",
+        "REJECTED",
+        "EVENT",
+        "WATCH"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(ControlStatus::COUNT),
+                  "control status name table out of sync with ControlStatus");
+    uint16_t index = static_cast<uint16_t>(status);
+    return index < static_cast<uint16_t>(ControlStatus::COUNT) ? names[index] : "UNKNOWN";
+}
+
+/**
+ * @brief 请求帧头（12字节）
+ */
+struct S_ControlRequestHeader {
+    uint32_t length;        // 帧头之后的字节数（8 + 参数长度）
+    uint32_t requestId;     // 客户端自定的请求序号，原样带回
+    uint16_t opcode;        // ControlOpcode
+    uint16_t flags;         // CONTROL_FLAG_*
+};
+
+/**
+ * @brief 响应帧头（12字节）
+ */
+struct S_ControlResponseHeader {
+    uint32_t length;        // 帧头之后的字节数（8 + 输出长度）
+    uint32_t requestId;     // 对应请求的序号
+    uint16_t status;        // ControlStatus
+    uint16_t reserved;
+};
+
+static_assert(sizeof(S_ControlRequestHeader) == 12, "control request header must stay 12 bytes");
+static_assert(sizeof(S_ControlResponseHeader) == 12, "control response header must stay 12 bytes");
+
+static const uint32_t CONTROL_HEADER_BODY = 8;             // 帧头中length之后的字节数
+
+#endif // CONTROL_PROTOCOL_H
@@ -0,0 +1,758 @@
+#include "control_server.h"
+#include "../Cross_PlatformUnifiedMacro.h"
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+
+#ifdef PLATFORM_LINUX
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
+
+namespace {
+
+const uint64_t LISTEN_TAG = 0;      // epoll数据：监听套接字
+const uint64_t WAKE_TAG = 1;        // epoll数据：完成通知eventfd
+const uint64_t FIRST_CLIENT_ID = 2; // 连接标识从此开始（不复用，避免与已关闭连接的在途批次混淆）
+const uint64_t EVENT_TAG_BIT = 1ULL << 63; // epoll数据：连接标识 | 该位 表示该连接的事件订阅eventfd
+const uint64_t WATCH_TAG_BIT = 1ULL << 62; // epoll数据：连接标识 | 该位 表示该连接的watch timerfd
+const uint32_t MAX_WATCH_INTERVAL_MS = 60 * 1000; // watch最长推送间隔
+const size_t EVENTS_PER_FRAME = (CONTROL_MAX_FRAME - CONTROL_HEADER_BODY) / sizeof(S_VmEvent); // 单个事件帧最多事件数
+const int EPOLL_BATCH = 64;         // 单次epoll_wait最多处理的事件数
+const int LISTEN_BACKLOG = 128;     // 监听队列长度
+
+void appendFrame(std::vector<uint8_t>& out, uint32_t requestId, ControlStatus status,
+                 const void* data, size_t outputLength) {
+    if (outputLength > CONTROL_MAX_FRAME - CONTROL_HEADER_BODY) {
+        outputLength = CONTROL_MAX_FRAME - CONTROL_HEADER_BODY;
+    }
+    S_ControlResponseHeader header;
+    header.length = static_cast<uint32_t>(CONTROL_HEADER_BODY + outputLength);
+    header.requestId = requestId;
+    header.status = static_cast<uint16_t>(status);
+    header.reserved = 0;
+
+    size_t offset = out.size();
+    out.resize(offset + sizeof(header) + outputLength);
+    memcpy(&out[offset], &header, sizeof(header));
+    if (outputLength > 0) {
+        memcpy(&out[offset + sizeof(header)], data, outputLength);
+    }
+}
+
+void appendResponse(std::vector<uint8_t>& out, uint32_t requestId, ControlStatus status, const std::string& output) {
+    appendFrame(out, requestId, status, output.data(), output.size());
+}
+
+/**
+ * @brief 追加文本帧，超过单帧上限时在行边界拆成多帧
+ * @return 追加的帧数
+ */
+uint32_t appendTextFrames(std::vector<uint8_t>& out, uint32_t requestId, ControlStatus status, const std::string& text) {
+    const size_t limit = CONTROL_MAX_FRAME - CONTROL_HEADER_BODY;
+    uint32_t frames = 0;
+    size_t offset = 0;
+    while (offset < text.size()) {
+        size_t length = text.size() - offset;
+        if (length > limit) {
+            size_t lineEnd = text.rfind('\n', offset + limit - 1);
+            length = (lineEnd != std::string::npos && lineEnd >= offset) ? lineEnd + 1 - offset : limit;
+        }
+        appendFrame(out, requestId, status, text.data() + offset, length);
+        offset += length;
+        frames++;
+    }
+    return frames;
+}
+
+bool isServerRequest(const S_ControlRequest& request) {
+    return request.opcode == static_cast<uint16_t>(ControlOpcode::SUBSCRIBE) ||
+           request.opcode == static_cast<uint16_t>(ControlOpcode::UNSUBSCRIBE) ||
+           request.opcode == static_cast<uint16_t>(ControlOpcode::WATCH) ||
+           request.opcode == static_cast<uint16_t>(ControlOpcode::UNWATCH);
+}
+
+} // namespace
+
+ControlServer::ControlServer(const ControlHandler& requestHandler)
+    : handler(requestHandler), eventBus(nullptr), watchSource(nullptr), eventBuffer(EVENTS_PER_FRAME), listenFd(-1), epollFd(-1),
+      wakeFd(-1), isRunning(false), nextClientId(FIRST_CLIENT_ID), acceptedClients(0), rejectedClients(0),
+      activeClients(0), requestCount(0), batchCount(0), writeCount(0), protocolErrors(0),
+      activeSubscriptions(0), eventsSent(0), eventFrames(0), activeWatches(0), watchFrames(0), watchSkips(0) {}
+
+ControlServer::~ControlServer() {
+    stop();
+}
+
+void ControlServer::workerLoop() {
+    while (true) {
+        S_ControlBatch batch;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobCV.wait(lock, [this]() { return !isRunning || !jobQueue.empty(); });
+            if (!isRunning) {
+                return;
+            }
+            batch = std::move(jobQueue.front());
+            jobQueue.pop_front();
+        }
+
+        executeBatch(batch);
+        {
+            std::lock_guard<std::mutex> lock(completionMutex);
+            completions.push_back(std::move(batch));
+        }
+#ifdef PLATFORM_LINUX
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) < 0) {
+            // eventfd计数溢出之前事件循环必然已被唤醒，忽略
+        }
+#endif
+    }
+}
+
+void ControlServer::executeBatch(S_ControlBatch& batch) {
+    std::string output;
+    for (const auto& request : batch.requests) {
+        output.clear();
+        ControlStatus status = ControlStatus::BAD_OPCODE;
+        if (request.opcode < static_cast<uint16_t>(ControlOpcode::COUNT)) {
+            status = handler(static_cast<ControlOpcode>(request.opcode), request.args, output);
+        }
+        if (request.flags & CONTROL_FLAG_QUIET) {
+            output.clear();
+        }
+        appendResponse(batch.responses, request.requestId, status, output);
+    }
+    requestCount.fetch_add(batch.requests.size(), std::memory_order_relaxed);
+    batchCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string ControlServer::getStatistics() const {
+    uint64_t batches = batchCount.load(std::memory_order_relaxed);
+    uint64_t requests = requestCount.load(std::memory_order_relaxed);
+    std::ostringstream oss;
+    oss << "=== Control Server ===" << std::endl;
+    oss << "Socket: " << (isRunning ? path : std::string("(stopped)")) << std::endl;
+    oss << "Clients: " << activeClients.load(std::memory_order_relaxed) << " active, "
+        << acceptedClients.load(std::memory_order_relaxed) << " accepted, "
+        << rejectedClients.load(std::memory_order_relaxed) << " rejected (limit " << MAX_CLIENTS << ")" << std::endl;
+    oss << "Requests: " << requests << " in " << batches << " batches";
+    if (batches > 0) {
+        oss << " (" << static_cast<double>(requests) / batches << " per batch)";
+    }
+    oss << std::endl;
+    oss << "Response Writes: " << writeCount.load(std::memory_order_relaxed) << std::endl;
+    oss << "Protocol Errors: " << protocolErrors.load(std::memory_order_relaxed) << std::endl;
+    oss << "Event Subscriptions: " << activeSubscriptions.load(std::memory_order_relaxed) << ", "
+        << eventsSent.load(std::memory_order_relaxed) << " events in "
+        << eventFrames.load(std::memory_order_relaxed) << " frames" << std::endl;
+    oss << "Watches: " << activeWatches.load(std::memory_order_relaxed) << ", "
+        << watchFrames.load(std::memory_order_relaxed) << " frames, "
+        << watchSkips.load(std::memory_order_relaxed) << " skipped (backpressure)" << std::endl;
+    return oss.str();
+}
+
+#ifdef PLATFORM_LINUX
+
+bool ControlServer::start(const std::string& socketPath, std::string& error) {
+    if (isRunning) {
+        error = "control server already running on " + path;
+        return false;
+    }
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        error = "invalid socket path length";
+        return false;
+    }
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+    // 只替换旧的套接字文件，不删除同名的普通文件
+    struct stat fileInfo;
+    if (stat(socketPath.c_str(), &fileInfo) == 0) {
+        if (!S_ISSOCK(fileInfo.st_mode)) {
+            error = socketPath + " exists and is not a socket";
+            return false;
+        }
+        unlink(socketPath.c_str());
+    }
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0 ||
+        bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        chmod(socketPath.c_str(), S_IRUSR | S_IWUSR) != 0 ||
+        listen(listenFd, LISTEN_BACKLOG) != 0) {
+        error = std::string("failed to listen on ") + socketPath + ": " + strerror(errno);
+        if (listenFd >= 0) {
+            close(listenFd);
+            listenFd = -1;
+            unlink(socketPath.c_str());
+        }
+        return false;
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event listenEvent;
+    listenEvent.events = EPOLLIN;
+    listenEvent.data.u64 = LISTEN_TAG;
+    epoll_event wakeEvent;
+    wakeEvent.events = EPOLLIN;
+    wakeEvent.data.u64 = WAKE_TAG;
+    if (epollFd < 0 || wakeFd < 0 ||
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &listenEvent) != 0 ||
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &wakeEvent) != 0) {
+        error = std::string("failed to set up epoll: ") + strerror(errno);
+        if (epollFd >= 0) close(epollFd);
+        if (wakeFd >= 0) close(wakeFd);
+        close(listenFd);
+        epollFd = wakeFd = listenFd = -1;
+        unlink(socketPath.c_str());
+        return false;
+    }
+
+    path = socketPath;
+    isRunning = true;
+    for (uint32_t i = 0; i < WORKER_COUNT; i++) {
+        workers.push_back(std::thread(&ControlServer::workerLoop, this));
+    }
+    loopThread = std::thread(&ControlServer::eventLoop, this);
+    return true;
+}
+
+void ControlServer::stop() {
+    if (!isRunning) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        isRunning = false;
+    }
+    jobCV.notify_all();
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0) {
+        // 事件循环最迟在epoll_wait超时后退出
+    }
+    if (loopThread.joinable()) {
+        loopThread.join();
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    while (!clients.empty()) {
+        closeClient(clients.begin()->first);
+    }
+    jobQueue.clear();
+    completions.clear();
+    close(epollFd);
+    close(wakeFd);
+    close(listenFd);
+    epollFd = wakeFd = listenFd = -1;
+    unlink(path.c_str());
+}
+
+void ControlServer::eventLoop() {
+    epoll_event events[EPOLL_BATCH];
+    while (isRunning) {
+        int count = epoll_wait(epollFd, events, EPOLL_BATCH, 100);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (int i = 0; i < count && isRunning; i++) {
+            uint64_t tag = events[i].data.u64;
+            if (tag == LISTEN_TAG) {
+                acceptClients();
+                continue;
+            }
+            if (tag == WAKE_TAG) {
+                uint64_t value;
+                if (read(wakeFd, &value, sizeof(value)) < 0) {
+                    // 非阻塞eventfd没有计数时返回EAGAIN，无需处理
+                }
+                drainCompletions();
+                continue;
+            }
+
+            if (tag & WATCH_TAG_BIT) {
+                auto owner = clients.find(tag & ~WATCH_TAG_BIT);
+                if (owner != clients.end() && owner->second.watcher) {
+                    deliverWatch(owner->second);
+                    if (!flushClient(owner->second)) {
+                        closeClient(owner->first);
+                    } else {
+                        updateEvents(owner->first, owner->second);
+                    }
+                }
+                continue;
+            }
+
+            if (tag & EVENT_TAG_BIT) {
+                auto owner = clients.find(tag & ~EVENT_TAG_BIT);
+                if (owner != clients.end() && owner->second.subscription) {
+                    deliverEvents(owner->first, owner->second);
+                }
+                continue;
+            }
+
+            auto it = clients.find(tag);
+            if (it == clients.end()) {
+                continue;
+            }
+            S_ControlClient& client = it->second;
+            uint32_t ready = events[i].events;
+            // 对端完全关闭后无法再接收响应，直接断开
+            if (ready & (EPOLLHUP | EPOLLERR)) {
+                closeClient(tag);
+                continue;
+            }
+            if ((ready & EPOLLOUT) && !flushClient(client)) {
+                closeClient(tag);
+                continue;
+            }
+            if ((ready & EPOLLIN) && !readClient(client)) {
+                closeClient(tag);
+                continue;
+            }
+            dispatchBatch(tag, client);
+            updateEvents(tag, client);
+        }
+    }
+}
+
+void ControlServer::acceptClients() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return; // EAGAIN：本轮没有更多连接
+        }
+        if (clients.size() >= MAX_CLIENTS) {
+            close(fd);
+            rejectedClients.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        uint64_t clientId = nextClientId++;
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u64 = clientId;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            continue;
+        }
+        S_ControlClient& client = clients[clientId];
+        client.fd = fd;
+        client.events = EPOLLIN;
+        acceptedClients.fetch_add(1, std::memory_order_relaxed);
+        activeClients.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool ControlServer::readClient(S_ControlClient& client) {
+    uint8_t buffer[16 * 1024];
+    bool peerClosed = false;
+    while (true) {
+        ssize_t received = read(client.fd, buffer, sizeof(buffer));
+        if (received > 0) {
+            client.inBuffer.insert(client.inBuffer.end(), buffer, buffer + received);
+            continue;
+        }
+        if (received == 0) {
+            peerClosed = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+        break;
+    }
+
+    // 解析全部完整帧（客户端流水线发送的多个请求一次取出）
+    size_t offset = 0;
+    while (client.inBuffer.size() - offset >= sizeof(uint32_t)) {
+        uint32_t length;
+        memcpy(&length, &client.inBuffer[offset], sizeof(length));
+        if (length < CONTROL_HEADER_BODY || length > CONTROL_MAX_FRAME) {
+            protocolErrors.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (client.inBuffer.size() - offset - sizeof(uint32_t) < length) {
+            break;
+        }
+
+        S_ControlRequestHeader header;
+        memcpy(&header, &client.inBuffer[offset], sizeof(header));
+        S_ControlRequest request;
+        request.requestId = header.requestId;
+        request.opcode = header.opcode;
+        request.flags = header.flags;
+        request.args.assign(reinterpret_cast<const char*>(&client.inBuffer[offset + sizeof(header)]),
+                            length - CONTROL_HEADER_BODY);
+        client.pending.push_back(request);
+        offset += sizeof(uint32_t) + length;
+    }
+    client.inBuffer.erase(client.inBuffer.begin(), client.inBuffer.begin() + offset);
+
+    if (peerClosed) {
+        // 对端只关闭了写方向时仍执行已收到的请求并发回响应，全部发送后再断开
+        if (!client.inBuffer.empty()) {
+            protocolErrors.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (client.pending.empty() && !client.busy && client.outBuffer.empty() && !client.subscription &&
+            !client.watcher) {
+            return false;
+        }
+        client.peerClosed = true;
+    }
+    return true;
+}
+
+void ControlServer::dispatchBatch(uint64_t clientId, S_ControlClient& client) {
+    // 排在队首的订阅请求由事件循环直接处理，同一连接的请求仍按顺序生效
+    while (!client.busy && !client.pending.empty() && isServerRequest(client.pending.front())) {
+        handleServerRequest(clientId, client, client.pending.front());
+        client.pending.erase(client.pending.begin());
+    }
+    if (client.busy || client.pending.empty() || client.outBuffer.size() - client.outOffset >= MAX_PENDING_OUTPUT) {
+        return;
+    }
+
+    // 一批只包含下一个订阅请求之前的命令
+    size_t count = 0;
+    while (count < client.pending.size() && count < MAX_BATCH_REQUESTS && !isServerRequest(client.pending[count])) {
+        count++;
+    }
+    S_ControlBatch batch;
+    batch.clientId = clientId;
+    if (count == client.pending.size()) {
+        batch.requests.swap(client.pending);
+    } else {
+        batch.requests.assign(client.pending.begin(), client.pending.begin() + count);
+        client.pending.erase(client.pending.begin(), client.pending.begin() + count);
+    }
+    client.busy = true;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobQueue.push_back(std::move(batch));
+    }
+    jobCV.notify_one();
+}
+
+bool ControlServer::flushClient(S_ControlClient& client) {
+    while (client.outOffset < client.outBuffer.size()) {
+        ssize_t sent = send(client.fd, &client.outBuffer[client.outOffset],
+                            client.outBuffer.size() - client.outOffset, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        client.outOffset += static_cast<size_t>(sent);
+        writeCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    client.outBuffer.clear();
+    client.outOffset = 0;
+    return true;
+}
+
+void ControlServer::updateEvents(uint64_t clientId, S_ControlClient& client) {
+    // 订阅/watch方关闭写方向后仍接收推送，直到连接断开（写失败）
+    if (client.peerClosed && client.pending.empty() && !client.busy && client.outBuffer.empty() &&
+        !client.subscription && !client.watcher) {
+        closeClient(clientId);
+        return;
+    }
+
+    size_t unsent = client.outBuffer.size() - client.outOffset;
+    uint32_t desired = 0;
+    // 待发送数据过多时暂停读取，形成背压
+    if (!client.peerClosed && unsent < MAX_PENDING_OUTPUT) {
+        desired |= EPOLLIN;
+    }
+    if (unsent > 0) {
+        desired |= EPOLLOUT;
+    }
+    // 背压期间同样暂停推送事件，事件留在订阅的事件环中（环满后丢弃并计数）
+    if (client.subscription) {
+        uint32_t eventDesired = unsent < MAX_PENDING_OUTPUT ? static_cast<uint32_t>(EPOLLIN) : 0;
+        if (eventDesired != client.subscriptionEvents) {
+            epoll_event event;
+            event.events = eventDesired;
+            event.data.u64 = clientId | EVENT_TAG_BIT;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, client.subscription->getEventFd(), &event);
+            client.subscriptionEvents = eventDesired;
+        }
+    }
+    if (desired == client.events) {
+        return;
+    }
+    epoll_event event;
+    event.events = desired;
+    event.data.u64 = clientId;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &event);
+    client.events = desired;
+}
+
+void ControlServer::closeClient(uint64_t clientId) {
+    auto it = clients.find(clientId);
+    if (it == clients.end()) {
+        return;
+    }
+    unsubscribeClient(it->second);
+    unwatchClient(it->second);
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    clients.erase(it);
+    activeClients.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ControlServer::handleServerRequest(uint64_t clientId, S_ControlClient& client, const S_ControlRequest& request) {
+    requestCount.fetch_add(1, std::memory_order_relaxed);
+    if (request.opcode == static_cast<uint16_t>(ControlOpcode::WATCH) ||
+        request.opcode == static_cast<uint16_t>(ControlOpcode::UNWATCH)) {
+        handleWatchRequest(clientId, client, request);
+        return;
+    }
+    if (request.opcode == static_cast<uint16_t>(ControlOpcode::UNSUBSCRIBE)) {
+        bool subscribed = static_cast<bool>(client.subscription);
+        unsubscribeClient(client);
+        appendResponse(client.outBuffer, request.requestId, subscribed ? ControlStatus::OK : ControlStatus::COMMAND_FAILED,
+                       subscribed ? "Unsubscribed\n" : "Error: not subscribed\n");
+        return;
+    }
+
+    if (!eventBus) {
+        appendResponse(client.outBuffer, request.requestId, ControlStatus::REJECTED,
+                       "Error: VM events are not available on this server\n");
+        return;
+    }
+
+    // 参数："<vmId|*> [事件类型 ...]"
+    std::istringstream iss(request.args);
+    std::string target;
+    std::vector<std::string> names;
+    iss >> target;
+    for (std::string name; iss >> name;) {
+        names.push_back(name);
+    }
+    uint32_t mask = 0;
+    char* end = nullptr;
+    unsigned long vmId = (target.empty() || target == "*") ? 0 : strtoul(target.c_str(), &end, 10);
+    if ((end && *end != '\0') || !ParseVmEventMask(names, mask)) {
+        appendResponse(client.outBuffer, request.requestId, ControlStatus::COMMAND_FAILED,
+                       "Error: usage: <vmId|*> [halted|fault|limit|run|stopped|swap|all ...]\n");
+        return;
+    }
+
+    // 重复订阅时替换原订阅
+    unsubscribeClient(client);
+    std::shared_ptr<VmEventSubscription> subscription = eventBus->subscribe(mask, static_cast<uint32_t>(vmId));
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = clientId | EVENT_TAG_BIT;
+    if (!subscription || epoll_ctl(epollFd, EPOLL_CTL_ADD, subscription->getEventFd(), &event) != 0) {
+        eventBus->unsubscribe(subscription);
+        appendResponse(client.outBuffer, request.requestId, ControlStatus::COMMAND_FAILED,
+                       "Error: failed to create event subscription\n");
+        return;
+    }
+    client.subscription = subscription;
+    client.subscriptionRequestId = request.requestId;
+    client.subscriptionEvents = EPOLLIN;
+    activeSubscriptions.fetch_add(1, std::memory_order_relaxed);
+
+    std::ostringstream oss;
+    oss << "Subscribed to VM " << (vmId == 0 ? std::string("*") : std::to_string(vmId))
+        << " events (mask 0x" << std::hex << mask << std::dec << ")\n";
+    appendResponse(client.outBuffer, request.requestId, ControlStatus::OK, oss.str());
+}
+
+void ControlServer::unsubscribeClient(S_ControlClient& client) {
+    if (!client.subscription) {
+        return;
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, client.subscription->getEventFd(), nullptr);
+    if (eventBus) {
+        eventBus->unsubscribe(client.subscription);
+    }
+    client.subscription.reset();
+    client.subscriptionEvents = 0;
+    activeSubscriptions.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ControlServer::deliverEvents(uint64_t clientId, S_ControlClient& client) {
+    // 把事件环中已有的事件尽量合并成少数几帧，连同其他响应一次写出
+    while (client.outBuffer.size() - client.outOffset < MAX_PENDING_OUTPUT) {
+        size_t count = client.subscription->drain(eventBuffer.data(), EVENTS_PER_FRAME);
+        if (count == 0) {
+            break;
+        }
+        appendFrame(client.outBuffer, client.subscriptionRequestId, ControlStatus::EVENT,
+                    eventBuffer.data(), count * sizeof(S_VmEvent));
+        eventsSent.fetch_add(count, std::memory_order_relaxed);
+        eventFrames.fetch_add(1, std::memory_order_relaxed);
+        if (count < EVENTS_PER_FRAME) {
+            break;
+        }
+    }
+    if (!flushClient(client)) {
+        closeClient(clientId);
+        return;
+    }
+    updateEvents(clientId, client);
+}
+
+void ControlServer::handleWatchRequest(uint64_t clientId, S_ControlClient& client, const S_ControlRequest& request) {
+    if (request.opcode == static_cast<uint16_t>(ControlOpcode::UNWATCH)) {
+        bool watching = static_cast<bool>(client.watcher);
+        unwatchClient(client);
+        appendResponse(client.outBuffer, request.requestId, watching ? ControlStatus::OK : ControlStatus::COMMAND_FAILED,
+                       watching ? "Watch stopped\n" : "Error: not watching\n");
+        return;
+    }
+
+    if (!watchSource) {
+        appendResponse(client.outBuffer, request.requestId, ControlStatus::REJECTED,
+                       "Error: watch is not available on this server\n");
+        return;
+    }
+
+    // 参数："[interval_ms]"
+    std::istringstream iss(request.args);
+    std::string intervalText;
+    iss >> intervalText;
+    char* end = nullptr;
+    unsigned long interval = intervalText.empty() ? DEFAULT_WATCH_INTERVAL_MS : strtoul(intervalText.c_str(), &end, 10);
+    if ((end && *end != '\0') || interval < MIN_WATCH_INTERVAL_MS || interval > MAX_WATCH_INTERVAL_MS) {
+        appendResponse(client.outBuffer, request.requestId, ControlStatus::COMMAND_FAILED,
+                       "Error: usage: [interval_ms] (" + std::to_string(MIN_WATCH_INTERVAL_MS) + "-" +
+                           std::to_string(MAX_WATCH_INTERVAL_MS) + ")\n");
+        return;
+    }
+
+    // 重复watch时替换原watch（重新输出基线）
+    unwatchClient(client);
+    int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    itimerspec spec;
+    spec.it_interval.tv_sec = interval / 1000;
+    spec.it_interval.tv_nsec = static_cast<long>(interval % 1000) * 1000000L;
+    spec.it_value = spec.it_interval;
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = clientId | WATCH_TAG_BIT;
+    if (timerFd < 0 || timerfd_settime(timerFd, 0, &spec, nullptr) != 0 ||
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &event) != 0) {
+        if (timerFd >= 0) {
+            close(timerFd);
+        }
+        appendResponse(client.outBuffer, request.requestId, ControlStatus::COMMAND_FAILED,
+                       "Error: failed to create watch timer\n");
+        return;
+    }
+    client.watcher.reset(new StatusWatcher(*watchSource));
+    client.watchTimerFd = timerFd;
+    client.watchRequestId = request.requestId;
+    activeWatches.fetch_add(1, std::memory_order_relaxed);
+
+    appendResponse(client.outBuffer, request.requestId, ControlStatus::OK,
+                   "Watching every " + std::to_string(interval) + " ms\n");
+    // 紧接着推送基线
+    deliverWatch(client);
+}
+
+void ControlServer::unwatchClient(S_ControlClient& client) {
+    if (!client.watcher) {
+        return;
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, client.watchTimerFd, nullptr);
+    close(client.watchTimerFd);
+    client.watchTimerFd = -1;
+    client.watcher.reset();
+    activeWatches.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ControlServer::deliverWatch(S_ControlClient& client) {
+    if (client.watchTimerFd >= 0) {
+        uint64_t expirations = 0;
+        if (read(client.watchTimerFd, &expirations, sizeof(expirations)) < 0) {
+            // 非阻塞timerfd未到期时返回EAGAIN
+        }
+    }
+    // 背压期间不采集：观察者保留上次发送的状态，恢复后一次推送累积的差异
+    if (client.outBuffer.size() - client.outOffset >= MAX_PENDING_OUTPUT) {
+        watchSkips.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::string update = client.watcher->poll();
+    if (!update.empty()) {
+        uint32_t frames = appendTextFrames(client.outBuffer, client.watchRequestId, ControlStatus::WATCH, update);
+        watchFrames.fetch_add(frames, std::memory_order_relaxed);
+    }
+}
+
+void ControlServer::drainCompletions() {
+    std::vector<S_ControlBatch> finished;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        finished.swap(completions);
+    }
+
+    for (auto& batch : finished) {
+        auto it = clients.find(batch.clientId);
+        if (it == clients.end()) {
+            continue; // 连接已在执行期间断开
+        }
+        S_ControlClient& client = it->second;
+        client.outBuffer.insert(client.outBuffer.end(), batch.responses.begin(), batch.responses.end());
+        client.busy = false;
+
+        // 整批响应一次写出
+        if (!flushClient(client)) {
+            closeClient(batch.clientId);
+            continue;
+        }
+        dispatchBatch(batch.clientId, client);
+        updateEvents(batch.clientId, client);
+    }
+}
+
+#else
+
+bool ControlServer::start(const std::string& socketPath, std::string& error) {
+    (void)socketPath;
+    error = "control server requires Linux (epoll)";
+    return false;
+}
+
+void ControlServer::stop() {}
+void ControlServer::eventLoop() {}
+void ControlServer::acceptClients() {}
+bool ControlServer::readClient(S_ControlClient&) { return false; }
+void ControlServer::dispatchBatch(uint64_t, S_ControlClient&) {}
+bool ControlServer::flushClient(S_ControlClient&) { return false; }
+void ControlServer::updateEvents(uint64_t, S_ControlClient&) {}
+void ControlServer::closeClient(uint64_t) {}
+void ControlServer::drainCompletions() {}
+void ControlServer::handleServerRequest(uint64_t, S_ControlClient&, const S_ControlRequest&) {}
+void ControlServer::unsubscribeClient(S_ControlClient&) {}
+void ControlServer::deliverEvents(uint64_t, S_ControlClient&) {}
+void ControlServer::handleWatchRequest(uint64_t, S_ControlClient&, const S_ControlRequest&) {}
+void ControlServer::unwatchClient(S_ControlClient&) {}
+void ControlServer::deliverWatch(S_ControlClient&) {}
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef CONTROL_SERVER_H
+#define CONTROL_SERVER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include "control_protocol.h"
+#include "../event/vm_event_bus.h"
+#include "../performance_monitor/status_watch.h"
+
+/**
+ * @brief 控制请求处理函数
+ * @param opcode 操作码
+ * @param args 参数文本
+ * @param output 命令输出
+ * @return 响应状态码
+ */
+typedef std::function<ControlStatus(ControlOpcode opcode, const std::string& args, std::string& output)> ControlHandler;
+
+/**
+ * @brief 已解析的控制请求
+ */
+struct S_ControlRequest {
+    uint32_t requestId;     // 请求序号
+    uint16_t opcode;        // ControlOpcode
+    uint16_t flags;         // CONTROL_FLAG_*
+    std::string args;       // 参数文本
+
+    S_ControlRequest() : requestId(0), opcode(0), flags(0) {}
+};
+
+/**
+ * @brief 一批交给执行线程的请求及其合并后的响应
+ */
+struct S_ControlBatch {
+    uint64_t clientId;                      // 所属连接
+    std::vector<S_ControlRequest> requests; // 按到达顺序执行的请求
+    std::vector<uint8_t> responses;         // 合并后的响应帧
+
+    S_ControlBatch() : clientId(0) {}
+};
+
+/**
+ * @brief 控制连接状态（只由事件循环线程访问）
+ */
+struct S_ControlClient {
+    int fd;                                 // 连接套接字
+    std::vector<uint8_t> inBuffer;          // 未组成完整帧的接收数据
+    std::vector<S_ControlRequest> pending;  // 已解析、等待派发的请求
+    bool busy;                              // 有一批请求正在执行（同一连接的请求串行执行）
+    std::vector<uint8_t> outBuffer;         // 待发送的响应
+    size_t outOffset;                       // outBuffer中已发送的字节数
+    uint32_t events;                        // 当前注册的epoll事件
+    bool peerClosed;                        // 对端已关闭写方向（发送完剩余响应后断开）
+    std::shared_ptr<VmEventSubscription> subscription; // VM事件订阅（未订阅为空）
+    uint32_t subscriptionRequestId;         // 订阅请求序号（事件帧带回）
+    uint32_t subscriptionEvents;            // 订阅eventfd当前注册的epoll事件
+    std::unique_ptr<StatusWatcher> watcher; // 状态推送观察者（未watch为空）
+    int watchTimerFd;                       // 推送间隔timerfd
+    uint32_t watchRequestId;                // watch请求序号（推送帧带回）
+
+    S_ControlClient() : fd(-1), busy(false), outOffset(0), events(0), peerClosed(false),
+                        subscriptionRequestId(0), subscriptionEvents(0), watchTimerFd(-1), watchRequestId(0) {}
+};
+
+/**
+ * @brief 本机控制套接字服务器
+ * @details Unix域流套接字 + 单个epoll事件循环线程管理全部连接，不为连接创建线程。
+ *          事件循环把每个连接已到达的请求（流水线）整批交给固定数量的执行线程，
+ *          同一连接同时最多一批在执行，保证按请求顺序生效；不同连接的批次并行执行。
+ *          一批请求的响应合并为一次写入。客户端不读取响应、待发送数据超过上限时暂停读取该连接。
+ *          SUBSCRIBE/UNSUBSCRIBE由事件循环直接处理：订阅的eventfd加入同一个epoll集合，
+ *          可读时取出事件环中的全部事件合并为事件帧推送；连接背压期间暂停该eventfd。
+ *          WATCH同样由事件循环处理：每个watch连接一个timerfd，到期时读取无锁状态快照并只推送变化，
+ *          连接背压期间跳过本次推送（下一次推送相对上次已发送的内容，不丢失变化）。
+ *          只支持Linux（epoll/eventfd），其他平台start()返回失败。
+ */
+class ControlServer {
+public:
+    static const uint32_t WORKER_COUNT = 4;                 // 执行线程数
+    static const uint32_t MAX_CLIENTS = 1024;               // 最大连接数
+    static const uint32_t MAX_BATCH_REQUESTS = 256;         // 单批最多请求数
+    static const size_t MAX_PENDING_OUTPUT = 1024 * 1024;   // 单连接待发送响应上限（超过暂停读取）
+    static const uint32_t DEFAULT_WATCH_INTERVAL_MS = 1000; // watch默认推送间隔
+    static const uint32_t MIN_WATCH_INTERVAL_MS = 10;       // watch最短推送间隔
+
+private:
+    ControlHandler handler;                         // 请求处理函数
+    VmEventBus* eventBus;                           // VM事件总线（nullptr表示不支持订阅）
+    const StatusWatchSource* watchSource;           // watch数据来源（nullptr表示不支持watch）
+    std::vector<S_VmEvent> eventBuffer;             // 事件帧组装缓冲（事件循环线程独占）
+    std::string path;                               // 套接字路径
+    int listenFd;                                   // 监听套接字
+    int epollFd;                                    // epoll实例
+    int wakeFd;                                     // eventfd，执行线程完成一批后唤醒事件循环
+    std::atomic<bool> isRunning;                    // 服务运行状态
+    std::thread loopThread;                         // 事件循环线程
+    std::vector<std::thread> workers;               // 执行线程
+
+    std::deque<S_ControlBatch> jobQueue;            // 待执行批次
+    std::mutex jobMutex;                            // 保护jobQueue
+    std::condition_variable jobCV;                  // 通知执行线程
+    std::vector<S_ControlBatch> completions;        // 已执行完、待发送的批次
+    std::mutex completionMutex;                     // 保护completions
+
+    std::map<uint64_t, S_ControlClient> clients;    // 连接表（事件循环线程独占）
+    uint64_t nextClientId;                          // 下一个连接标识
+
+    std::atomic<uint64_t> acceptedClients;          // 累计接受的连接数
+    std::atomic<uint64_t> rejectedClients;          // 超过连接上限被拒绝的连接数
+    std::atomic<uint32_t> activeClients;            // 当前连接数
+    std::atomic<uint64_t> requestCount;             // 已执行的请求数
+    std::atomic<uint64_t> batchCount;               // 已执行的批次数
+    std::atomic<uint64_t> writeCount;               // 响应写入系统调用次数
+    std::atomic<uint64_t> protocolErrors;           // 因帧格式错误断开的连接数
+    std::atomic<uint32_t> activeSubscriptions;      // 当前事件订阅数
+    std::atomic<uint64_t> eventsSent;               // 推送的事件数
+    std::atomic<uint64_t> eventFrames;              // 推送的事件帧数
+    std::atomic<uint32_t> activeWatches;            // 当前watch连接数
+    std::atomic<uint64_t> watchFrames;              // 推送的watch帧数
+    std::atomic<uint64_t> watchSkips;               // 因背压跳过的推送次数
+
+    void eventLoop();
+    void workerLoop();
+    void acceptClients();
+    bool readClient(S_ControlClient& client);
+    void dispatchBatch(uint64_t clientId, S_ControlClient& client);
+    bool flushClient(S_ControlClient& client);
+    void updateEvents(uint64_t clientId, S_ControlClient& client);
+    void closeClient(uint64_t clientId);
+    void drainCompletions();
+    void executeBatch(S_ControlBatch& batch);
+    void handleServerRequest(uint64_t clientId, S_ControlClient& client, const S_ControlRequest& request);
+    void unsubscribeClient(S_ControlClient& client);
+    void deliverEvents(uint64_t clientId, S_ControlClient& client);
+    void handleWatchRequest(uint64_t clientId, S_ControlClient& client, const S_ControlRequest& request);
+    void unwatchClient(S_ControlClient& client);
+    void deliverWatch(S_ControlClient& client);
+
+public:
+    explicit ControlServer(const ControlHandler& requestHandler);
+    ~ControlServer();
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    /**
+     * @brief 设置VM事件总线（启动前调用），之后客户端可以用SUBSCRIBE订阅事件
+     */
+    void setEventBus(VmEventBus* bus) { eventBus = bus; }
+
+    /**
+     * @brief 设置watch数据来源（启动前调用），之后客户端可以用WATCH接收状态变化推送
+     */
+    void setWatchSource(const StatusWatchSource* source) { watchSource = source; }
+
+    /**
+     * @brief 在指定路径监听并启动事件循环与执行线程
+     * @param socketPath 套接字路径（已存在的旧套接字文件会被替换）
+     * @param error 失败原因
+     * @return bool 启动成功返回true
+     */
+    bool start(const std::string& socketPath, std::string& error);
+
+    /**
+     * @brief 停止服务，断开全部连接并删除套接字文件
+     */
+    void stop();
+
+    bool getRunningStatus() const { return isRunning.load(std::memory_order_acquire); }
+    const std::string& getPath() const { return path; }
+    std::string getStatistics() const;
+};
+
+#endif // CONTROL_SERVER_H
@@ -0,0 +1,229 @@
+#include "ctf_manager.h"
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+
+namespace {
+
+uint64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+CtfManager::CtfManager(CtfVmFactory vmFactory, uint32_t maxInstancesPerPlayer)
+    : factory(vmFactory), defaultMaxInstances(maxInstancesPerPlayer), nextTenantId(1),
+      createCount(0), createTotalNs(0), createMaxNs(0), resetCount(0), resetTotalNs(0), resetMaxNs(0),
+      quotaRejects(0) {}
+
+S_CtfPlayer& CtfManager::getOrAddPlayer(const std::string& player) {
+    auto it = players.find(player);
+    if (it != players.end()) {
+        return it->second;
+    }
+    S_CtfPlayer& entry = players[player];
+    entry.tenantId = nextTenantId++;
+    entry.maxInstances = defaultMaxInstances;
+    return entry;
+}
+
+bool CtfManager::createChallenge(const std::string& name, const std::string& type, const std::string& payloadFile,
+                                 const std::shared_ptr<std::vector<uint8_t>>& payload, I_VmInterface& source,
+                                 std::string& error) {
+    if (!source.getMemory().isAllocated() || source.getMemory().getSize() == 0) {
+        error = "VM " + std::to_string(source.getVmId()) + " has no guest memory";
+        return false;
+    }
+    // 捕获快照在锁外进行（复制整块私有内存）
+    std::shared_ptr<S_CtfChallenge> challenge = std::make_shared<S_CtfChallenge>();
+    challenge->name = name;
+    challenge->type = type;
+    challenge->payloadFile = payloadFile;
+    challenge->payload = payload;
+    challenge->sourceVmId = source.getVmId();
+    challenge->addressSpaceSize = static_cast<uint32_t>(source.getMemory().getAddressSpaceSize());
+    source.captureSnapshot(challenge->snapshot);
+    challenge->image = std::make_shared<const std::vector<uint8_t>>(challenge->snapshot.memory);
+
+    std::lock_guard<std::mutex> lock(managerMutex);
+    if (challenges.count(name)) {
+        error = "Challenge " + name + " already exists";
+        return false;
+    }
+    challenges[name] = challenge;
+    return true;
+}
+
+std::shared_ptr<const S_CtfChallenge> CtfManager::getChallenge(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(managerMutex);
+    auto it = challenges.find(name);
+    return it != challenges.end() ? it->second : nullptr;
+}
+
+bool CtfManager::removeChallenge(const std::string& name, std::string& error) {
+    std::lock_guard<std::mutex> lock(managerMutex);
+    auto it = challenges.find(name);
+    if (it == challenges.end()) {
+        error = "Challenge " + name + " not found";
+        return false;
+    }
+    if (it->second->instances > 0) {
+        error = "Challenge " + name + " still has " + std::to_string(it->second->instances) + " instances";
+        return false;
+    }
+    challenges.erase(it);
+    return true;
+}
+
+std::shared_ptr<I_VmInterface> CtfManager::createInstance(const std::string& challenge, const std::string& player,
+                                                          uint32_t vmId, uint64_t& createNs, std::string& error) {
+    uint64_t start = monotonicNs();
+    std::lock_guard<std::mutex> lock(managerMutex);
+    auto found = challenges.find(challenge);
+    if (found == challenges.end()) {
+        error = "Challenge " + challenge + " not found";
+        return nullptr;
+    }
+    const std::shared_ptr<S_CtfChallenge>& source = found->second;
+    S_CtfPlayer& quota = getOrAddPlayer(player);
+    if (quota.instances >= quota.maxInstances) {
+        quotaRejects++;
+        error = "Player " + player + " already has " + std::to_string(quota.instances) + " of " +
+                std::to_string(quota.maxInstances) + " instances";
+        return nullptr;
+    }
+
+    std::shared_ptr<I_VmInterface> vm = factory(source->type, vmId);
+    if (!vm) {
+        error = "Failed to create " + source->type + " VM";
+        return nullptr;
+    }
+    vm->setPayload(source->payload->data(), source->payload->size());
+    // 页表指向共享镜像，之后只恢复寄存器（dirtyPagesOnly，此时没有复制过的页）
+    if (!vm->getMemory().cloneFrom(source->image, GUEST_PERM_RW, source->addressSpaceSize) ||
+        !vm->restoreSnapshot(source->snapshot, true)) {
+        error = "Failed to clone challenge " + challenge;
+        return nullptr;
+    }
+
+    S_CtfInstance& instance = instances[vmId];
+    instance.vmId = vmId;
+    instance.player = player;
+    instance.challenge = challenge;
+    instance.vm = vm;
+    source->instances++;
+    quota.instances++;
+
+    createNs = monotonicNs() - start;
+    instance.createNs = createNs;
+    createCount++;
+    createTotalNs += createNs;
+    if (createNs > createMaxNs) {
+        createMaxNs = createNs;
+    }
+    return vm;
+}
+
+bool CtfManager::resetInstance(uint32_t vmId, uint64_t& resetNs, size_t& pages, std::string& error) {
+    uint64_t start = monotonicNs();
+    std::lock_guard<std::mutex> lock(managerMutex);
+    auto it = instances.find(vmId);
+    if (it == instances.end()) {
+        error = "VM " + std::to_string(vmId) + " is not a challenge instance";
+        return false;
+    }
+    S_CtfInstance& instance = it->second;
+    const S_CtfChallenge& source = *challenges[instance.challenge];
+    pages = instance.vm->getMemory().getDirtyPageCount();
+    if (!instance.vm->restoreSnapshot(source.snapshot, true)) {
+        error = "Failed to restore challenge " + instance.challenge;
+        return false;
+    }
+    instance.vm->releaseFaultHold();
+
+    resetNs = monotonicNs() - start;
+    instance.resets++;
+    instance.lastResetNs = resetNs;
+    instance.lastResetPages = pages;
+    resetCount++;
+    resetTotalNs += resetNs;
+    if (resetNs > resetMaxNs) {
+        resetMaxNs = resetNs;
+    }
+    return true;
+}
+
+bool CtfManager::removeInstance(uint32_t vmId) {
+    std::lock_guard<std::mutex> lock(managerMutex);
+    auto it = instances.find(vmId);
+    if (it == instances.end()) {
+        return false;
+    }
+    challenges[it->second.challenge]->instances--;
+    players[it->second.player].instances--;
+    instances.erase(it);
+    return true;
+}
+
+uint32_t CtfManager::setPlayerQuota(const std::string& player, uint32_t maxInstances, uint32_t slicesPerPeriod) {
+    std::lock_guard<std::mutex> lock(managerMutex);
+    S_CtfPlayer& quota = getOrAddPlayer(player);
+    quota.maxInstances = maxInstances;
+    quota.slicesPerPeriod = slicesPerPeriod;
+    return quota.tenantId;
+}
+
+uint32_t CtfManager::getTenantId(uint32_t vmId) const {
+    std::lock_guard<std::mutex> lock(managerMutex);
+    auto it = instances.find(vmId);
+    if (it == instances.end()) {
+        return 0;
+    }
+    auto player = players.find(it->second.player);
+    return player != players.end() ? player->second.tenantId : 0;
+}
+
+bool CtfManager::isInstance(uint32_t vmId) const {
+    std::lock_guard<std::mutex> lock(managerMutex);
+    return instances.count(vmId) != 0;
+}
+
+std::map<std::string, S_CtfPlayer> CtfManager::getPlayers() const {
+    std::lock_guard<std::mutex> lock(managerMutex);
+    return players;
+}
+
+std::string CtfManager::getReport() const {
+    std::lock_guard<std::mutex> lock(managerMutex);
+    std::ostringstream oss;
+    oss << "Challenges: " << challenges.size() << std::endl;
+    for (const auto& pair : challenges) {
+        const S_CtfChallenge& challenge = *pair.second;
+        oss << "  " << challenge.name << " (" << challenge.type << ", " << challenge.payloadFile << ", from VM "
+            << challenge.sourceVmId << "): " << challenge.image->size() / GuestMemory::PAGE_SIZE
+            << " shared pages, " << challenge.instances << " instances" << std::endl;
+    }
+    oss << "Instances: " << instances.size() << std::endl;
+    for (const auto& pair : instances) {
+        const S_CtfInstance& instance = pair.second;
+        oss << "  VM " << instance.vmId << ": " << instance.challenge << " for " << instance.player << ", "
+            << instance.vm->getMemory().getDirtyPageCount() << " private pages, " << instance.resets << " resets";
+        if (instance.resets > 0) {
+            oss << " (last " << instance.lastResetNs / 1000.0 << " us, " << instance.lastResetPages << " pages)";
+        }
+        oss << std::endl;
+    }
+    oss << std::fixed << std::setprecision(1);
+    oss << "Create: " << createCount;
+    if (createCount > 0) {
+        oss << ", avg " << createTotalNs / createCount / 1000.0 << " us, max " << createMaxNs / 1000.0 << " us";
+    }
+    oss << ", " << quotaRejects << " rejected by quota" << std::endl;
+    oss << "Reset: " << resetCount;
+    if (resetCount > 0) {
+        oss << ", avg " << resetTotalNs / resetCount / 1000.0 << " us, max " << resetMaxNs / 1000.0 << " us";
+    }
+    oss << std::endl;
+    return oss.str();
+}
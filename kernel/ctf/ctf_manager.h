@@ -0,0 +1,168 @@
+#ifndef CTF_MANAGER_H
+#define CTF_MANAGER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include "../CPUvm/baseVM.h"
+
+/**
+ * @brief 按架构与VM ID创建一台未分配内存的VM
+ */
+typedef std::function<std::shared_ptr<I_VmInterface>(const std::string& type, uint32_t vmId)> CtfVmFactory;
+
+/**
+ * @brief 题目模板：一道题目准备好的VM快照
+ * @details 私有内存内容另存为只读的共享镜像，该题目的所有实例以写时复制方式共享；
+ *          载荷同样由所有实例共享
+ */
+struct S_CtfChallenge {
+    std::string name;                               // 题目名
+    std::string type;                               // 架构（x86/arm/x64）
+    std::string payloadFile;                        // 载荷文件（显示用）
+    std::shared_ptr<std::vector<uint8_t>> payload;  // 载荷（实例只保存指针）
+    S_VmSnapshot snapshot;                          // 准备好的VM状态
+    std::shared_ptr<const std::vector<uint8_t>> image; // 私有内存共享镜像
+    uint32_t addressSpaceSize;                      // 客户机地址空间大小
+    uint32_t sourceVmId;                            // 制作模板的VM
+    uint32_t instances;                             // 现存实例数
+
+    S_CtfChallenge() : addressSpaceSize(0), sourceVmId(0), instances(0) {}
+};
+
+/**
+ * @brief 选手配额
+ * @details tenantId作为调度器的租户ID，选手所有实例共用调度器上的时间片配额
+ */
+struct S_CtfPlayer {
+    uint32_t tenantId;                              // 调度器租户ID
+    uint32_t maxInstances;                          // 同时存在的实例数上限
+    uint32_t slicesPerPeriod;                       // 每个调度器配额周期的时间片数（0表示不限）
+    uint32_t instances;                             // 现存实例数
+
+    S_CtfPlayer() : tenantId(0), maxInstances(0), slicesPerPeriod(0), instances(0) {}
+};
+
+/**
+ * @brief 题目实例（一台属于某个选手的VM）
+ */
+struct S_CtfInstance {
+    uint32_t vmId;                                  // VM ID
+    std::string player;                             // 所属选手
+    std::string challenge;                          // 题目名
+    std::shared_ptr<I_VmInterface> vm;              // VM
+    uint64_t createNs;                              // 创建耗时
+    uint64_t resets;                                // 复位次数
+    uint64_t lastResetNs;                           // 最近一次复位耗时
+    uint64_t lastResetPages;                        // 最近一次复位指回镜像的页数
+
+    S_CtfInstance() : vmId(0), createNs(0), resets(0), lastResetNs(0), lastResetPages(0) {}
+};
+
+/**
+ * @brief CTF多租户题目实例管理
+ * @details 模板由一台准备好的VM制作：捕获快照，私有内存另存为共享镜像。
+ *          创建实例只新建一台VM、挂接共享载荷、页表指向镜像（GuestMemory::cloneFrom），
+ *          再恢复模板快照的寄存器，不分配也不复制客户机内存；
+ *          实例第一次写某页时才复制该页，复位只把复制过的页指回镜像并恢复寄存器，
+ *          耗时与实例写过的页数成正比，与题目内存大小无关。
+ *          每个选手有同时存在的实例数上限与调度器时间片配额（由调度器按租户执行）。
+ *          只管理模板与实例的对应关系，VM的注册、调度与删除由调用方完成
+ */
+class CtfManager {
+private:
+    CtfVmFactory factory;
+    uint32_t defaultMaxInstances;                   // 新选手的实例数上限
+    uint32_t nextTenantId;                          // 下一个分配的租户ID
+
+    mutable std::mutex managerMutex;                // 保护以下所有成员
+    std::map<std::string, std::shared_ptr<S_CtfChallenge>> challenges; // 题目模板（实例持有引用）
+    std::map<std::string, S_CtfPlayer> players;     // 选手配额（第一次创建实例或设置配额时加入）
+    std::map<uint32_t, S_CtfInstance> instances;    // 实例（按VM ID索引）
+
+    uint64_t createCount;                           // 累计创建实例数
+    uint64_t createTotalNs;
+    uint64_t createMaxNs;
+    uint64_t resetCount;                            // 累计复位次数
+    uint64_t resetTotalNs;
+    uint64_t resetMaxNs;
+    uint64_t quotaRejects;                          // 超过实例数上限被拒绝的创建
+
+    S_CtfPlayer& getOrAddPlayer(const std::string& player);
+
+public:
+    CtfManager(CtfVmFactory vmFactory, uint32_t maxInstancesPerPlayer);
+
+    /**
+     * @brief 以VM当前状态制作题目模板
+     * @details 调用方需持有source的执行权（VmExecutionGuard）或保证其没有在执行
+     * @param payload 该VM的载荷（模板持有引用，实例共享）
+     * @return bool 题目已存在或VM未分配客户机内存时返回false
+     */
+    bool createChallenge(const std::string& name, const std::string& type, const std::string& payloadFile,
+                         const std::shared_ptr<std::vector<uint8_t>>& payload, I_VmInterface& source,
+                         std::string& error);
+
+    /**
+     * @brief 查找题目模板（模板只在没有实例时才会被删除）
+     * @return 题目不存在时返回nullptr
+     */
+    std::shared_ptr<const S_CtfChallenge> getChallenge(const std::string& name) const;
+
+    /**
+     * @brief 删除题目模板
+     * @return bool 题目不存在或仍有实例时返回false
+     */
+    bool removeChallenge(const std::string& name, std::string& error);
+
+    /**
+     * @brief 为选手创建题目实例（写时复制克隆模板）
+     * @param vmId 新VM的ID（由调用方分配）
+     * @param createNs 创建耗时（不含调用方的注册）
+     * @return 新VM，题目不存在或选手实例数已达上限时返回nullptr
+     */
+    std::shared_ptr<I_VmInterface> createInstance(const std::string& challenge, const std::string& player,
+                                                  uint32_t vmId, uint64_t& createNs, std::string& error);
+
+    /**
+     * @brief 把实例复位为模板状态
+     * @details 调用方需持有实例VM的执行权；故障策略留下的暂停/强制停止保持一并解除
+     * @param resetNs 复位耗时
+     * @param pages 指回镜像的页数（即上次复位后写过的页）
+     * @return bool 不是题目实例时返回false
+     */
+    bool resetInstance(uint32_t vmId, uint64_t& resetNs, size_t& pages, std::string& error);
+
+    /**
+     * @brief VM被删除时调用，释放实例占用的选手配额
+     * @return bool 不是题目实例时返回false
+     */
+    bool removeInstance(uint32_t vmId);
+
+    /**
+     * @brief 设置选手配额（选手不存在时加入）
+     * @return uint32_t 选手的调度器租户ID
+     */
+    uint32_t setPlayerQuota(const std::string& player, uint32_t maxInstances, uint32_t slicesPerPeriod);
+
+    /**
+     * @brief 实例所属选手的调度器租户ID
+     * @return uint32_t 不是题目实例时返回0
+     */
+    uint32_t getTenantId(uint32_t vmId) const;
+
+    bool isInstance(uint32_t vmId) const;
+
+    std::map<std::string, S_CtfPlayer> getPlayers() const;
+
+    /**
+     * @brief 题目与实例列表及创建/复位耗时（选手配额与用量由调用方结合调度器输出）
+     */
+    std::string getReport() const;
+};
+
+#endif // CTF_MANAGER_H
@@ -0,0 +1,788 @@
+#include "gdb_server.h"
+#include "../Cross_PlatformUnifiedMacro.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#ifdef PLATFORM_LINUX
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const int POLL_INTERVAL_MS = 100;   // 等待数据时检查停止标志的间隔
+const char INTERRUPT_BYTE = 0x03;   // gdb中断请求（Ctrl-C）
+
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+std::string toHex(const uint8_t* data, size_t length) {
+    std::string out;
+    out.reserve(length * 2);
+    for (size_t i = 0; i < length; i++) {
+        out += HEX_DIGITS[data[i] >> 4];
+        out += HEX_DIGITS[data[i] & 0xF];
+    }
+    return out;
+}
+
+std::string toHex(const std::string& text) {
+    return toHex(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool fromHex(const std::string& hex, std::vector<uint8_t>& out) {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    out.resize(hex.size() / 2);
+    for (size_t i = 0; i < out.size(); i++) {
+        int high = hexValue(hex[i * 2]);
+        int low = hexValue(hex[i * 2 + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        out[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return true;
+}
+
+/**
+ * @brief 解析十六进制数，pos前进到第一个非十六进制字符
+ */
+bool parseHexNumber(const std::string& text, size_t& pos, uint64_t& value) {
+    size_t begin = pos;
+    value = 0;
+    while (pos < text.size() && hexValue(text[pos]) >= 0 && pos - begin < 16) {
+        value = (value << 4) | static_cast<uint64_t>(hexValue(text[pos]));
+        pos++;
+    }
+    return pos > begin;
+}
+
+/**
+ * @brief 寄存器值按目标字节序（小端）编码，超过64位的部分补0
+ */
+std::string encodeRegister(uint64_t value, uint32_t bits) {
+    std::string out;
+    for (uint32_t i = 0; i < bits / 8; i++) {
+        uint8_t byte = i < 8 ? static_cast<uint8_t>(value >> (8 * i)) : 0;
+        out += HEX_DIGITS[byte >> 4];
+        out += HEX_DIGITS[byte & 0xF];
+    }
+    return out;
+}
+
+uint64_t decodeRegister(const uint8_t* data, uint32_t bits) {
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < bits / 8 && i < 8; i++) {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+const uint32_t GdbServer::CONTINUE_BATCH;
+const uint32_t GdbServer::ATTACH_TIMEOUT_MS;
+const size_t GdbServer::MAX_PACKET;
+
+GdbServer::GdbServer(const GdbVmResolver& vmResolver)
+    : resolver(vmResolver), defaultVmId(0), port(0), listenFd(-1), isRunning(false),
+      sessionCount(0), packetCount(0), breakpointHits(0), watchpointHits(0), attachedVmId(0),
+      snapshotInterval(ReverseHistory::DEFAULT_INTERVAL), reverseSteps(0), reverseContinues(0) {}
+
+GdbServer::~GdbServer() {
+    stop();
+}
+
+std::string GdbServer::getStatistics() const {
+    std::ostringstream oss;
+    oss << "=== GDB Server ===" << std::endl;
+    if (!isRunning) {
+        oss << "Not running" << std::endl;
+        return oss.str();
+    }
+    oss << "Listening: 127.0.0.1:" << port << std::endl;
+    oss << "Default VM: " << (defaultVmId ? std::to_string(defaultVmId) : std::string("(attach)")) << std::endl;
+    uint32_t attached = attachedVmId.load(std::memory_order_relaxed);
+    oss << "Attached VM: " << (attached ? std::to_string(attached) : std::string("none")) << std::endl;
+    oss << "Sessions: " << sessionCount.load(std::memory_order_relaxed) << std::endl;
+    oss << "Packets: " << packetCount.load(std::memory_order_relaxed) << std::endl;
+    oss << "Breakpoint Hits: " << breakpointHits.load(std::memory_order_relaxed) << std::endl;
+    oss << "Watchpoint Hits: " << watchpointHits.load(std::memory_order_relaxed) << std::endl;
+    oss << "Snapshot Interval: " << snapshotInterval.load(std::memory_order_relaxed) << " instructions" << std::endl;
+    oss << "Reverse Steps: " << reverseSteps.load(std::memory_order_relaxed)
+        << ", Reverse Continues: " << reverseContinues.load(std::memory_order_relaxed) << std::endl;
+    return oss.str();
+}
+
+std::string GdbServer::buildTargetXml(const I_VmInterface& vm) const {
+    const S_DebugTarget& target = vm.getDebugTarget();
+    std::ostringstream xml;
+    xml << "<?xml version=\"1.0\"?>\n<!DOCTYPE target SYSTEM \"gdb-target.dtd\">\n<target>\n"
+        << "<architecture>" << target.architecture << "</architecture>\n"
+        << "<feature name=\"" << target.feature << "\">\n";
+    for (uint32_t i = 0; i < target.registerCount; i++) {
+        const S_DebugRegisterInfo& reg = target.registers[i];
+        xml << "<reg name=\"" << reg.name << "\" bitsize=\"" << reg.bits << "\" type=\"" << reg.type
+            << "\" regnum=\"" << i << "\"/>\n";
+    }
+    xml << "</feature>\n</target>\n";
+    return xml.str();
+}
+
+std::string GdbServer::stopReply(const S_GdbSession& session, DebugStopReason reason) const {
+    if (!session.vm || reason == DebugStopReason::EXITED) {
+        return "W00";
+    }
+    char buffer[64];
+    uint32_t address = 0;
+    WatchKind kind = WatchKind::WRITE;
+    if (reason == DebugStopReason::WATCHPOINT && session.vm->takeWatchHit(address, kind)) {
+        static const char* const stopNames[] = { "watch", "rwatch", "awatch" };
+        std::snprintf(buffer, sizeof(buffer), "T05thread:%x;%s:%x;", session.vm->getVmId(),
+                      stopNames[static_cast<uint8_t>(kind)], address);
+        return buffer;
+    }
+    std::snprintf(buffer, sizeof(buffer), "T05thread:%x;", session.vm->getVmId());
+    return buffer;
+}
+
+#ifdef PLATFORM_LINUX
+
+bool GdbServer::start(uint16_t listenPort, uint32_t vmId, std::string& error) {
+    if (isRunning) {
+        error = "already listening on port " + std::to_string(port);
+        return false;
+    }
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        error = "socket failed";
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(listenPort);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd, 1) != 0) {
+        error = std::string("cannot listen on port ") + std::to_string(listenPort) + ": " + std::strerror(errno);
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    port = listenPort;
+    defaultVmId = vmId;
+    isRunning = true;
+    serverThread = std::thread(&GdbServer::serveLoop, this);
+    return true;
+}
+
+void GdbServer::stop() {
+    if (!isRunning) {
+        return;
+    }
+    isRunning = false;
+    if (serverThread.joinable()) {
+        serverThread.join();
+    }
+    close(listenFd);
+    listenFd = -1;
+}
+
+void GdbServer::serveLoop() {
+    while (isRunning) {
+        pollfd pfd = { listenFd, POLLIN, 0 };
+        if (poll(&pfd, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        sessionCount.fetch_add(1, std::memory_order_relaxed);
+        serveClient(fd);
+        close(fd);
+    }
+}
+
+void GdbServer::serveClient(int fd) {
+    S_GdbSession session;
+    session.fd = fd;
+    if (defaultVmId != 0) {
+        attachVm(session, defaultVmId);
+    }
+
+    std::string packet;
+    while (isRunning && readPacket(session, packet)) {
+        packetCount.fetch_add(1, std::memory_order_relaxed);
+        bool closeSession = false;
+        std::string reply = handlePacket(session, packet, closeSession);
+        if (!sendPacket(session, reply) || closeSession) {
+            break;
+        }
+    }
+    detachVm(session);
+}
+
+bool GdbServer::readPacket(S_GdbSession& session, std::string& packet) {
+    while (isRunning) {
+        // 缓冲中找完整的包：$data#xx，之前的确认字符与中断请求（已停止时）直接丢弃
+        size_t start = session.inBuffer.find('$');
+        if (start != std::string::npos) {
+            size_t end = session.inBuffer.find('#', start);
+            if (end != std::string::npos && end + 2 < session.inBuffer.size()) {
+                packet = session.inBuffer.substr(start + 1, end - start - 1);
+                int high = hexValue(session.inBuffer[end + 1]);
+                int low = hexValue(session.inBuffer[end + 2]);
+                session.inBuffer.erase(0, end + 3);
+                uint8_t sum = 0;
+                for (char c : packet) {
+                    sum = static_cast<uint8_t>(sum + static_cast<uint8_t>(c));
+                }
+                bool valid = high >= 0 && low >= 0 && sum == ((high << 4) | low);
+                if (!session.noAck && send(session.fd, valid ? "+" : "-", 1, MSG_NOSIGNAL) != 1) {
+                    return false;
+                }
+                if (valid) {
+                    return true;
+                }
+                continue;
+            }
+            if (session.inBuffer.size() - start > MAX_PACKET) {
+                return false;
+            }
+        } else {
+            session.inBuffer.clear();
+        }
+
+        pollfd pfd = { session.fd, POLLIN, 0 };
+        int ready = poll(&pfd, 1, POLL_INTERVAL_MS);
+        if (ready == 0 || (ready < 0 && errno == EINTR)) {
+            continue;
+        }
+        char buffer[4096];
+        ssize_t received = recv(session.fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            return false;
+        }
+        session.inBuffer.append(buffer, static_cast<size_t>(received));
+    }
+    return false;
+}
+
+bool GdbServer::sendPacket(S_GdbSession& session, const std::string& payload) {
+    uint8_t sum = 0;
+    for (char c : payload) {
+        sum = static_cast<uint8_t>(sum + static_cast<uint8_t>(c));
+    }
+    std::string frame = "$" + payload + "#" + HEX_DIGITS[sum >> 4] + HEX_DIGITS[sum & 0xF];
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        ssize_t n = send(session.fd, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    // 确认模式下的"+"/"-"由readPacket跳过；重传请求不处理（本机连接不会损坏数据）
+    return true;
+}
+
+std::string GdbServer::attachVm(S_GdbSession& session, uint32_t vmId) {
+    detachVm(session);
+    std::shared_ptr<I_VmInterface> vm = resolver(vmId);
+    if (!vm) {
+        return "E01";
+    }
+
+    // 等待当前执行者（调度器时间片、vm run）释放执行权，之后一直持有到解除挂接
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ATTACH_TIMEOUT_MS);
+    while (!vm->claimExecution()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return "E02";
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    vm->debugAttach();
+    session.vm = vm;
+    session.history.reset(new ReverseHistory(snapshotInterval.load(std::memory_order_relaxed)));
+    session.history->reset(*vm);
+    attachedVmId.store(vmId, std::memory_order_relaxed);
+    return stopReply(session, DebugStopReason::STEP);
+}
+
+void GdbServer::detachVm(S_GdbSession& session) {
+    if (!session.vm) {
+        return;
+    }
+    session.vm->debugDetach();
+    session.vm->releaseExecution();
+    session.vm.reset();
+    session.history.reset();
+    attachedVmId.store(0, std::memory_order_relaxed);
+}
+
+std::string GdbServer::resumeVm(S_GdbSession& session, bool step) {
+    if (!session.vm) {
+        return "E01";
+    }
+    I_VmInterface& vm = *session.vm;
+    if (step) {
+        DebugStopReason reason = vm.debugRun(1);
+        session.history->record(vm);
+        if (reason == DebugStopReason::BREAKPOINT) {
+            breakpointHits.fetch_add(1, std::memory_order_relaxed);
+        } else if (reason == DebugStopReason::WATCHPOINT) {
+            watchpointHits.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::string reply = stopReply(session, reason);
+        if (reason == DebugStopReason::EXITED) {
+            detachVm(session);
+        }
+        return reply;
+    }
+
+    while (isRunning) {
+        // 每批不越过下一个快照点，到达时保存快照
+        DebugStopReason reason = vm.debugRun(session.history->getForwardBudget(vm, CONTINUE_BATCH));
+        session.history->record(vm);
+        if (reason == DebugStopReason::BREAKPOINT || reason == DebugStopReason::WATCHPOINT) {
+            (reason == DebugStopReason::BREAKPOINT ? breakpointHits : watchpointHits).fetch_add(1, std::memory_order_relaxed);
+            return stopReply(session, reason);
+        }
+        if (reason == DebugStopReason::EXITED) {
+            std::string reply = stopReply(session, reason);
+            detachVm(session);
+            return reply;
+        }
+        if (reason == DebugStopReason::HALTED && !vm.advanceIdleTime()) {
+            // 停机等待外部中断（设备、共享内存门铃），稍后再试
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // 两批之间检查gdb的中断请求（Ctrl-C），中断后停在当前指令
+        pollfd pfd = { session.fd, POLLIN, 0 };
+        if (poll(&pfd, 1, 0) > 0) {
+            char buffer[256];
+            ssize_t received = recv(session.fd, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                return std::string();
+            }
+            std::string data(buffer, static_cast<size_t>(received));
+            size_t interrupt = data.find(INTERRUPT_BYTE);
+            if (interrupt != std::string::npos) {
+                session.inBuffer.append(data.substr(interrupt + 1));
+                char reply[32];
+                std::snprintf(reply, sizeof(reply), "T02thread:%x;", vm.getVmId());
+                return reply;
+            }
+            session.inBuffer.append(data);
+        }
+    }
+    return std::string();
+}
+
+std::string GdbServer::reverseVm(S_GdbSession& session, bool step) {
+    if (!session.vm) {
+        return "E01";
+    }
+    S_ReverseResult result = step ? session.history->reverseStep(*session.vm)
+                                  : session.history->reverseContinue(*session.vm);
+    (step ? reverseSteps : reverseContinues).fetch_add(1, std::memory_order_relaxed);
+    if (result.reason == DebugStopReason::BREAKPOINT) {
+        breakpointHits.fetch_add(1, std::memory_order_relaxed);
+    } else if (result.reason == DebugStopReason::WATCHPOINT) {
+        watchpointHits.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::string reply = stopReply(session, result.reason);
+    if (result.reachedBegin) {
+        // 已到历史起点：gdb据此报告"No more reverse-execution history"
+        reply += "replaylog:begin;";
+    }
+    return reply;
+}
+
+#else
+
+bool GdbServer::start(uint16_t, uint32_t, std::string& error) {
+    error = "gdb server requires Linux";
+    return false;
+}
+
+void GdbServer::stop() {}
+void GdbServer::serveLoop() {}
+void GdbServer::serveClient(int) {}
+bool GdbServer::readPacket(S_GdbSession&, std::string&) { return false; }
+bool GdbServer::sendPacket(S_GdbSession&, const std::string&) { return false; }
+std::string GdbServer::attachVm(S_GdbSession&, uint32_t) { return "E01"; }
+void GdbServer::detachVm(S_GdbSession&) {}
+std::string GdbServer::resumeVm(S_GdbSession&, bool) { return "E01"; }
+std::string GdbServer::reverseVm(S_GdbSession&, bool) { return "E01"; }
+
+#endif
+
+std::string GdbServer::handlePacket(S_GdbSession& session, const std::string& packet, bool& closeSession) {
+    if (packet.empty()) {
+        return std::string();
+    }
+    char kind = packet[0];
+    I_VmInterface* vm = session.vm.get();
+
+    switch (kind) {
+        case '?':
+            return stopReply(session, DebugStopReason::STEP);
+
+        case '!':
+            return "OK";
+
+        case 'q':
+        case 'Q':
+            return handleQuery(session, packet);
+
+        case 'H':
+        case 'T':
+            return vm ? "OK" : "E01";
+
+        case 'g': {
+            if (!vm) {
+                return "E01";
+            }
+            const S_DebugTarget& target = vm->getDebugTarget();
+            std::string out;
+            for (uint32_t i = 0; i < target.registerCount; i++) {
+                out += encodeRegister(vm->readDebugRegister(i), target.registers[i].bits);
+            }
+            return out;
+        }
+
+        case 'G': {
+            std::vector<uint8_t> data;
+            if (!vm || !fromHex(packet.substr(1), data)) {
+                return "E01";
+            }
+            const S_DebugTarget& target = vm->getDebugTarget();
+            size_t offset = 0;
+            for (uint32_t i = 0; i < target.registerCount && offset + target.registers[i].bits / 8 <= data.size(); i++) {
+                vm->writeDebugRegister(i, decodeRegister(data.data() + offset, target.registers[i].bits));
+                offset += target.registers[i].bits / 8;
+            }
+            session.history->invalidateFuture(*vm);
+            return "OK";
+        }
+
+        case 'p': {
+            size_t pos = 1;
+            uint64_t index = 0;
+            if (!vm || !parseHexNumber(packet, pos, index) || index >= vm->getDebugTarget().registerCount) {
+                return "E01";
+            }
+            return encodeRegister(vm->readDebugRegister(static_cast<uint32_t>(index)),
+                                  vm->getDebugTarget().registers[index].bits);
+        }
+
+        case 'P': {
+            size_t pos = 1;
+            uint64_t index = 0;
+            std::vector<uint8_t> data;
+            if (!vm || !parseHexNumber(packet, pos, index) || pos >= packet.size() || packet[pos] != '=' ||
+                index >= vm->getDebugTarget().registerCount || !fromHex(packet.substr(pos + 1), data) ||
+                data.size() < vm->getDebugTarget().registers[index].bits / 8) {
+                return "E01";
+            }
+            vm->writeDebugRegister(static_cast<uint32_t>(index),
+                                   decodeRegister(data.data(), vm->getDebugTarget().registers[index].bits));
+            session.history->invalidateFuture(*vm);
+            return "OK";
+        }
+
+        case 'm': {
+            size_t pos = 1;
+            uint64_t address = 0;
+            uint64_t length = 0;
+            if (!vm || !parseHexNumber(packet, pos, address) || pos >= packet.size() || packet[pos++] != ',' ||
+                !parseHexNumber(packet, pos, length) || length > MAX_PACKET / 2) {
+                return "E01";
+            }
+            // 逐字节读取，返回从起始地址开始可读的部分（调试器访问不触发观察点）
+            std::vector<uint8_t> data;
+            for (uint64_t i = 0; i < length && address + i <= 0xFFFFFFFFULL; i++) {
+                uint8_t byte = 0;
+                if (!vm->getMemory().peek(static_cast<uint32_t>(address + i), &byte, 1)) {
+                    break;
+                }
+                data.push_back(byte);
+            }
+            return data.empty() && length > 0 ? "E14" : toHex(data.data(), data.size());
+        }
+
+        case 'M': {
+            size_t pos = 1;
+            uint64_t address = 0;
+            uint64_t length = 0;
+            std::vector<uint8_t> data;
+            size_t colon = packet.find(':');
+            if (!vm || colon == std::string::npos || !parseHexNumber(packet, pos, address) || packet[pos++] != ',' ||
+                !parseHexNumber(packet, pos, length) || !fromHex(packet.substr(colon + 1), data) ||
+                data.size() != length || address + length > 0x100000000ULL) {
+                return "E01";
+            }
+            if (length > 0 && !vm->getMemory().poke(static_cast<uint32_t>(address), data.data(),
+                                                     static_cast<uint32_t>(length))) {
+                return "E14";
+            }
+            session.history->invalidateFuture(*vm);
+            return "OK";
+        }
+
+        case 'Z':
+        case 'z': {
+            // 软件/硬件断点都写成陷阱指令；2/3/4为写/读/访问观察点（kind字段是字节数）
+            if (packet.size() < 2 || packet[1] < '0' || packet[1] > '4') {
+                return std::string();
+            }
+            size_t pos = 3;
+            uint64_t address = 0;
+            uint64_t length = 0;
+            if (!vm || packet.size() < 4 || !parseHexNumber(packet, pos, address)) {
+                return "E01";
+            }
+            if (packet[1] <= '1') {
+                bool ok = (kind == 'Z') ? vm->insertBreakpoint(address) : vm->removeBreakpoint(address);
+                return ok ? "OK" : "E01";
+            }
+            if (pos >= packet.size() || packet[pos++] != ',' || !parseHexNumber(packet, pos, length) ||
+                address + length > 0x100000000ULL) {
+                return "E01";
+            }
+            WatchKind watchKind = static_cast<WatchKind>(packet[1] - '2');
+            bool ok = (kind == 'Z')
+                ? vm->insertWatchpoint(static_cast<uint32_t>(address), static_cast<uint32_t>(length), watchKind)
+                : vm->removeWatchpoint(static_cast<uint32_t>(address), static_cast<uint32_t>(length), watchKind);
+            return ok ? "OK" : "E01";
+        }
+
+        case 'c':
+        case 's': {
+            if (packet.size() > 1 && vm) {
+                size_t pos = 1;
+                uint64_t address = 0;
+                if (parseHexNumber(packet, pos, address)) {
+                    vm->setProgramCounter(address);
+                    session.history->invalidateFuture(*vm);
+                }
+            }
+            return resumeVm(session, kind == 's');
+        }
+
+        case 'b':
+            // 反向执行：bs=反向单步，bc=反向继续
+            if (packet == "bs" || packet == "bc") {
+                return reverseVm(session, packet == "bs");
+            }
+            return std::string();
+
+        case 'v': {
+            if (packet == "vCont?") {
+                return "vCont;c;s";
+            }
+            if (packet.compare(0, 6, "vCont;") == 0 && packet.size() > 6) {
+                // 只有一个线程：取第一个动作
+                char action = packet[6];
+                if (action == 'c' || action == 'C' || action == 's' || action == 'S') {
+                    return resumeVm(session, action == 's' || action == 'S');
+                }
+                return "E01";
+            }
+            if (packet.compare(0, 8, "vAttach;") == 0) {
+                size_t pos = 8;
+                uint64_t vmId = 0;
+                if (!parseHexNumber(packet, pos, vmId) || vmId == 0 || vmId > 0xFFFFFFFFULL) {
+                    return "E01";
+                }
+                return attachVm(session, static_cast<uint32_t>(vmId));
+            }
+            if (packet.compare(0, 6, "vKill;") == 0) {
+                if (vm) {
+                    vm->forceStop();
+                }
+                detachVm(session);
+                return "OK";
+            }
+            return std::string();
+        }
+
+        case 'D':
+            detachVm(session);
+            return "OK";
+
+        case 'k':
+            // 结束调试会话：停止VM并断开（gdb不等待回复）
+            if (vm) {
+                vm->forceStop();
+            }
+            detachVm(session);
+            closeSession = true;
+            return "OK";
+
+        default:
+            return std::string();
+    }
+}
+
+std::string GdbServer::handleQuery(S_GdbSession& session, const std::string& packet) {
+    I_VmInterface* vm = session.vm.get();
+    if (packet.compare(0, 10, "qSupported") == 0) {
+        return "PacketSize=" + std::to_string(MAX_PACKET) + ";qXfer:features:read+;QStartNoAckMode+;vContSupported+;ReverseStep+;ReverseContinue+";
+    }
+    if (packet == "QStartNoAckMode") {
+        // 回复本包时仍需确认，之后的包不再确认
+        session.noAck = true;
+        return "OK";
+    }
+    if (packet == "qAttached") {
+        return "1";
+    }
+    if (packet == "qC") {
+        if (!vm) {
+            return std::string();
+        }
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "QC%x", vm->getVmId());
+        return buffer;
+    }
+    if (packet == "qfThreadInfo") {
+        if (!vm) {
+            return "l";
+        }
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "m%x", vm->getVmId());
+        return buffer;
+    }
+    if (packet == "qsThreadInfo") {
+        return "l";
+    }
+    if (packet.compare(0, 8, "qSymbol:") == 0) {
+        return "OK";
+    }
+    if (packet.compare(0, 31, "qXfer:features:read:target.xml:") == 0) {
+        if (!vm) {
+            return "E01";
+        }
+        size_t pos = 31;
+        uint64_t offset = 0;
+        uint64_t length = 0;
+        if (!parseHexNumber(packet, pos, offset) || pos >= packet.size() || packet[pos++] != ',' ||
+            !parseHexNumber(packet, pos, length)) {
+            return "E01";
+        }
+        std::string xml = buildTargetXml(*vm);
+        if (offset >= xml.size()) {
+            return "l";
+        }
+        std::string chunk = xml.substr(static_cast<size_t>(offset), static_cast<size_t>(length));
+        return (offset + chunk.size() >= xml.size() ? "l" : "m") + chunk;
+    }
+    if (packet.compare(0, 6, "qRcmd,") == 0) {
+        std::vector<uint8_t> command;
+        if (!fromHex(packet.substr(6), command)) {
+            return "E01";
+        }
+        return toHex(handleMonitor(session, std::string(command.begin(), command.end())));
+    }
+    return std::string();
+}
+
+std::string GdbServer::handleMonitor(S_GdbSession& session, const std::string& command) {
+    I_VmInterface* vm = session.vm.get();
+    std::istringstream input(command);
+    std::string verb;
+    input >> verb;
+    std::ostringstream out;
+
+    if (!vm) {
+        out << "No VM attached (use: attach <vm id>)" << std::endl;
+    } else if (verb == "info") {
+        std::vector<uint64_t> breakpoints;
+        vm->listBreakpoints(breakpoints);
+        out << "VM " << vm->getVmId() << " (" << vm->getDebugTarget().architecture << ")"
+            << (vm->getRunningStatus() ? " running" : " stopped") << (vm->isHalted() ? ", halted" : "")
+            << ", pc 0x" << std::hex << vm->getProgramCounter() << std::dec
+            << ", instructions " << vm->getResourceUsage() << ", payload " << vm->getPayloadSize() << " bytes"
+            << std::endl;
+        out << "Breakpoints:";
+        for (uint64_t pc : breakpoints) {
+            out << " 0x" << std::hex << pc << std::dec;
+        }
+        out << (breakpoints.empty() ? " none" : "") << std::endl;
+        std::vector<S_Watchpoint> watchpoints;
+        vm->listWatchpoints(watchpoints);
+        out << "Watchpoints:";
+        for (const S_Watchpoint& watchpoint : watchpoints) {
+            out << " " << GetWatchKindName(watchpoint.kind) << " 0x" << std::hex << watchpoint.address << std::dec
+                << "+" << watchpoint.length;
+        }
+        uint64_t slowChecks = 0;
+        uint64_t hits = 0;
+        vm->getWatchStatistics(slowChecks, hits);
+        out << (watchpoints.empty() ? " none" : "") << " (watched pages " << vm->getMemory().getWatchedPageCount()
+            << ", slow-path checks " << slowChecks << ", hits " << hits << ")" << std::endl;
+    } else if (verb == "code") {
+        // 查看原载荷（不含陷阱指令）：code <地址> [字节数]
+        uint64_t address = 0;
+        uint64_t length = 16;
+        std::string addressText;
+        std::string lengthText;
+        input >> addressText >> lengthText;
+        address = std::strtoull(addressText.c_str(), nullptr, 0);
+        if (!lengthText.empty()) {
+            length = std::strtoull(lengthText.c_str(), nullptr, 0);
+        }
+        const uint8_t* code = vm->getOriginalCode();
+        size_t size = vm->getPayloadSize();
+        if (!code || address >= size) {
+            out << "Address outside payload (" << size << " bytes)" << std::endl;
+        } else {
+            size_t end = static_cast<size_t>(std::min<uint64_t>(size, address + length));
+            out << "0x" << std::hex << address << ": " << toHex(code + address, end - address) << std::dec << std::endl;
+        }
+    } else if (verb == "history") {
+        // 查看反向执行历史，history <指令数>调整本会话的快照间隔
+        std::string intervalText;
+        input >> intervalText;
+        if (!intervalText.empty()) {
+            uint32_t interval = static_cast<uint32_t>(std::strtoul(intervalText.c_str(), nullptr, 0));
+            session.history->setInterval(interval);
+            setSnapshotInterval(interval);
+        }
+        out << session.history->getStatistics();
+    } else {
+        out << "Commands: info, code <addr> [len], history [interval]" << std::endl;
+    }
+    return out.str();
+}
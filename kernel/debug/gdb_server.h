@@ -0,0 +1,113 @@
+#ifndef GDB_SERVER_H
+#define GDB_SERVER_H
+
+#include <cstdint>
+#include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include "../CPUvm/baseVM.h"
+#include "reverse_history.h"
+
+/**
+ * @brief 按VM ID查找VM（调试器挂接时调用，找不到返回nullptr）
+ */
+typedef std::function<std::shared_ptr<I_VmInterface>(uint32_t vmId)> GdbVmResolver;
+
+/**
+ * @brief 一个gdb会话挂接的VM
+ */
+struct S_GdbSession {
+    int fd;                                     // 连接
+    std::shared_ptr<I_VmInterface> vm;          // 挂接的VM（未挂接为空）
+    bool noAck;                                 // 已进入无确认模式
+    std::string inBuffer;                       // 未组成完整包的接收数据
+    std::unique_ptr<ReverseHistory> history;    // 反向执行历史（挂接期间存在）
+
+    S_GdbSession() : fd(-1), noAck(false) {}
+};
+
+/**
+ * @brief gdb远程串行协议（RSP）调试服务
+ * @details 只监听本机回环地址，一次服务一个gdb连接（target remote / target extended-remote）。
+ *          挂接VM时调试器取得VM执行权并一直持有：调度器与vm run跳过该VM，
+ *          continue/step由服务线程自己执行VM（见I_VmInterface::debugRun），解除挂接时释放。
+ *          断点（Z0/Z1）写入VM载荷副本中的陷阱指令，未挂接的VM不受影响；
+ *          观察点（Z2/Z3/Z4）去掉所在客户机内存页的对应权限，只有访问这些页时才检查精确区间。
+ *          寄存器按VM的gdb目标描述编号（qXfer:features:read提供target.xml），
+ *          内存读写（m/M）访问VM的客户机数据内存（不触发观察点），载荷可用"monitor code"查看。
+ *          extended-remote模式下可以用"attach <VM ID>"挂接任意VM。
+ *          正向执行时按快照间隔保存VM快照，支持反向单步/反向继续（bs/bc包，gdb的reverse-stepi/
+ *          reverse-continue），见ReverseHistory；间隔可用"monitor history <指令数>"调整。
+ *          只支持Linux，其他平台start()返回失败。
+ */
+class GdbServer {
+public:
+    static const uint32_t CONTINUE_BATCH = 4096;    // continue时每批执行的指令数（两批之间检查中断请求）
+    static const uint32_t ATTACH_TIMEOUT_MS = 2000; // 等待VM当前执行者释放执行权的时间
+    static const size_t MAX_PACKET = 16384;         // 最大包长
+
+private:
+    GdbVmResolver resolver;                         // VM查找
+    uint32_t defaultVmId;                           // 连接后自动挂接的VM（0表示等待attach）
+    uint16_t port;                                  // 监听端口
+    int listenFd;                                   // 监听套接字
+    std::atomic<bool> isRunning;                    // 服务运行状态
+    std::thread serverThread;                       // 服务线程
+
+    std::atomic<uint64_t> sessionCount;             // 累计gdb连接数
+    std::atomic<uint64_t> packetCount;              // 已处理的包数
+    std::atomic<uint64_t> breakpointHits;           // 断点命中次数
+    std::atomic<uint64_t> watchpointHits;           // 观察点命中次数
+    std::atomic<uint32_t> attachedVmId;             // 当前挂接的VM（0表示没有）
+    std::atomic<uint32_t> snapshotInterval;         // 新会话的反向执行快照间隔
+    std::atomic<uint64_t> reverseSteps;             // 反向单步次数
+    std::atomic<uint64_t> reverseContinues;         // 反向继续次数
+
+    void serveLoop();
+    void serveClient(int fd);
+    bool readPacket(S_GdbSession& session, std::string& packet);
+    bool sendPacket(S_GdbSession& session, const std::string& payload);
+    std::string handlePacket(S_GdbSession& session, const std::string& packet, bool& closeSession);
+    std::string handleQuery(S_GdbSession& session, const std::string& packet);
+    std::string handleMonitor(S_GdbSession& session, const std::string& command);
+    std::string attachVm(S_GdbSession& session, uint32_t vmId);
+    void detachVm(S_GdbSession& session);
+    std::string resumeVm(S_GdbSession& session, bool step);
+    std::string reverseVm(S_GdbSession& session, bool step);
+    std::string stopReply(const S_GdbSession& session, DebugStopReason reason) const;
+    std::string buildTargetXml(const I_VmInterface& vm) const;
+
+public:
+    explicit GdbServer(const GdbVmResolver& vmResolver);
+    ~GdbServer();
+    GdbServer(const GdbServer&) = delete;
+    GdbServer& operator=(const GdbServer&) = delete;
+
+    /**
+     * @brief 在127.0.0.1:listenPort监听并启动服务线程
+     * @param listenPort 端口
+     * @param vmId gdb连接后自动挂接的VM（0表示由extended-remote的attach指定）
+     * @param error 失败原因
+     */
+    bool start(uint16_t listenPort, uint32_t vmId, std::string& error);
+
+    /**
+     * @brief 停止服务，断开当前gdb连接并解除挂接
+     */
+    void stop();
+
+    /**
+     * @brief 设置反向执行的快照间隔（指令数，之后挂接的会话生效）
+     * @details 间隔越小反向单步需要重放的指令越少，保存的快照越多
+     */
+    void setSnapshotInterval(uint32_t interval) { snapshotInterval.store(interval ? interval : 1, std::memory_order_relaxed); }
+    uint32_t getSnapshotInterval() const { return snapshotInterval.load(std::memory_order_relaxed); }
+
+    bool getRunningStatus() const { return isRunning.load(std::memory_order_acquire); }
+    uint16_t getPort() const { return port; }
+    std::string getStatistics() const;
+};
+
+#endif // GDB_SERVER_H
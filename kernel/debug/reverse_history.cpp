@@ -0,0 +1,159 @@
+#include "reverse_history.h"
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+const uint32_t ReverseHistory::DEFAULT_INTERVAL;
+const size_t ReverseHistory::MAX_CHECKPOINTS;
+
+ReverseHistory::ReverseHistory(uint32_t snapshotInterval)
+    : interval(snapshotInterval ? snapshotInterval : 1), replayedInstructions(0), droppedCheckpoints(0) {}
+
+void ReverseHistory::reset(I_VmInterface& vm) {
+    checkpoints.clear();
+    checkpoints.push_back(S_HistoryCheckpoint());
+    checkpoints.back().position = getPosition(vm);
+    vm.captureSnapshot(checkpoints.back().snapshot);
+}
+
+size_t ReverseHistory::findCheckpoint(uint64_t position) const {
+    size_t found = checkpoints.size();
+    for (size_t i = 0; i < checkpoints.size() && checkpoints[i].position <= position; i++) {
+        found = i;
+    }
+    return found;
+}
+
+uint32_t ReverseHistory::getForwardBudget(I_VmInterface& vm, uint32_t maxInstructions) const {
+    if (checkpoints.empty()) {
+        return maxInstructions;
+    }
+    uint64_t position = getPosition(vm);
+    uint64_t next = checkpoints.back().position + interval;
+    if (position >= next) {
+        return maxInstructions;
+    }
+    return static_cast<uint32_t>(std::min<uint64_t>(maxInstructions, next - position));
+}
+
+void ReverseHistory::record(I_VmInterface& vm) {
+    uint64_t position = getPosition(vm);
+    if (!vm.getRunningStatus() || (!checkpoints.empty() && position < checkpoints.back().position + interval)) {
+        return;
+    }
+    checkpoints.push_back(S_HistoryCheckpoint());
+    checkpoints.back().position = position;
+    vm.captureSnapshot(checkpoints.back().snapshot);
+    if (checkpoints.size() > MAX_CHECKPOINTS) {
+        checkpoints.pop_front();
+        droppedCheckpoints++;
+    }
+}
+
+void ReverseHistory::invalidateFuture(I_VmInterface& vm) {
+    uint64_t position = getPosition(vm);
+    while (!checkpoints.empty() && checkpoints.back().position >= position) {
+        checkpoints.pop_back();
+    }
+    // 修改后的状态作为新的检查点，之后的重放从这里开始
+    checkpoints.push_back(S_HistoryCheckpoint());
+    checkpoints.back().position = position;
+    vm.captureSnapshot(checkpoints.back().snapshot);
+}
+
+uint64_t ReverseHistory::replay(I_VmInterface& vm, size_t index, uint64_t target,
+                               std::vector<std::pair<uint64_t, DebugStopReason>>* hits) {
+    if (!vm.restoreSnapshot(checkpoints[index].snapshot)) {
+        return getPosition(vm);
+    }
+    uint64_t position = getPosition(vm);
+    while (position < target) {
+        uint64_t remaining = std::min<uint64_t>(target - position, UINT32_MAX);
+        DebugStopReason reason = vm.debugRun(static_cast<uint32_t>(remaining));
+        uint64_t reached = getPosition(vm);
+        replayedInstructions += reached - position;
+        position = reached;
+        if (reason == DebugStopReason::BREAKPOINT || reason == DebugStopReason::WATCHPOINT) {
+            // 停在断点或观察点上：记录后继续，下一次debugRun越过断点
+            if (hits && position < target) {
+                hits->push_back(std::make_pair(position, reason));
+            }
+            continue;
+        }
+        if (reason == DebugStopReason::EXITED ||
+            (reason == DebugStopReason::HALTED && !vm.advanceIdleTime())) {
+            break;
+        }
+    }
+    return position;
+}
+
+S_ReverseResult ReverseHistory::reverseStep(I_VmInterface& vm) {
+    S_ReverseResult result;
+    uint64_t current = getPosition(vm);
+    if (checkpoints.empty() || current <= checkpoints.front().position) {
+        result.reachedBegin = true;
+        return result;
+    }
+    uint64_t before = replayedInstructions;
+    replay(vm, findCheckpoint(current - 1), current - 1, nullptr);
+    result.replayed = replayedInstructions - before;
+    return result;
+}
+
+S_ReverseResult ReverseHistory::reverseContinue(I_VmInterface& vm) {
+    S_ReverseResult result;
+    uint64_t end = getPosition(vm);
+    if (checkpoints.empty() || end <= checkpoints.front().position) {
+        result.reachedBegin = true;
+        return result;
+    }
+    std::vector<uint64_t> breakpoints;
+    vm.listBreakpoints(breakpoints);
+    uint64_t before = replayedInstructions;
+
+    // 从当前位置所在的区间开始逐个区间向前找：重放区间，取区间内最后一次断点/观察点命中
+    size_t index = findCheckpoint(end - 1);
+    while (true) {
+        std::vector<std::pair<uint64_t, DebugStopReason>> hits;
+        uint64_t start = checkpoints[index].position;
+        if (vm.restoreSnapshot(checkpoints[index].snapshot) && !vm.isHalted() &&
+            std::binary_search(breakpoints.begin(), breakpoints.end(), vm.getProgramCounter())) {
+            // 区间起点就停在断点上（replay从断点处开始时会越过它）
+            hits.push_back(std::make_pair(start, DebugStopReason::BREAKPOINT));
+        }
+        replay(vm, index, end, &hits);
+        if (!hits.empty()) {
+            replay(vm, index, hits.back().first, nullptr);
+            result.reason = hits.back().second;
+            break;
+        }
+        if (index == 0) {
+            replay(vm, 0, start, nullptr);
+            result.reachedBegin = true;
+            break;
+        }
+        end = start;
+        index--;
+    }
+    result.replayed = replayedInstructions - before;
+    return result;
+}
+
+std::string ReverseHistory::getStatistics() const {
+    size_t bytes = 0;
+    for (const S_HistoryCheckpoint& checkpoint : checkpoints) {
+        bytes += checkpoint.snapshot.memory.size() + checkpoint.snapshot.context.stack.size() * sizeof(uint32_t) +
+                 checkpoint.snapshot.archState.size() * sizeof(uint64_t) + sizeof(S_HistoryCheckpoint);
+    }
+    std::ostringstream oss;
+    oss << "Snapshot Interval: " << interval << " instructions" << std::endl;
+    oss << "Checkpoints: " << checkpoints.size() << "/" << MAX_CHECKPOINTS << " (" << bytes << " bytes";
+    if (!checkpoints.empty()) {
+        oss << ", positions " << checkpoints.front().position << ".." << checkpoints.back().position;
+    }
+    oss << ")" << std::endl;
+    oss << "Dropped Checkpoints: " << droppedCheckpoints << std::endl;
+    oss << "Replayed Instructions: " << replayedInstructions << std::endl;
+    return oss.str();
+}
@@ -0,0 +1,109 @@
+#ifndef REVERSE_HISTORY_H
+#define REVERSE_HISTORY_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include <utility>
+#include "../CPUvm/baseVM.h"
+
+/**
+ * @brief 执行历史中的一个检查点
+ */
+struct S_HistoryCheckpoint {
+    uint64_t position;          // 快照时的已执行指令数
+    S_VmSnapshot snapshot;      // VM状态
+};
+
+/**
+ * @brief 反向执行结果
+ */
+struct S_ReverseResult {
+    DebugStopReason reason;     // STEP（反向单步完成）或BREAKPOINT/WATCHPOINT（反向继续停在断点或观察点）
+    bool reachedBegin;          // 已回到最早的检查点，不能再后退
+    uint64_t replayed;          // 本次重放执行的指令数
+
+    S_ReverseResult() : reason(DebugStopReason::STEP), reachedBegin(false), replayed(0) {}
+};
+
+/**
+ * @brief 调试器的反向执行历史（周期快照 + 确定性重放）
+ * @details 正向执行时每隔interval条指令保存一个快照；反向单步/反向继续恢复目标位置之前
+ *          最近的快照，再用debugRun向前重放到目标指令数。位置以VM的已执行指令数表示：
+ *          VM执行只由自身状态与虚拟定时器决定，debugRun逐条投递中断，重放结果与原执行一致。
+ *          设备、共享内存门铃等外部中断不记录，这类中断参与的区间重放后可能与原执行不同；
+ *          宿主时间服务在挂接期间返回虚拟时间，不影响重放。
+ *          interval越小反向单步越快、快照越多；快照数超过上限时丢弃最早的快照。
+ *          调用方需持有VM执行权（调试器挂接期间一直持有）。
+ */
+class ReverseHistory {
+public:
+    static const uint32_t DEFAULT_INTERVAL = 1000;  // 默认快照间隔（指令数）
+    static const size_t MAX_CHECKPOINTS = 256;      // 保留的快照数上限
+
+private:
+    std::deque<S_HistoryCheckpoint> checkpoints;    // 按位置升序
+    uint32_t interval;                              // 快照间隔
+    uint64_t replayedInstructions;                  // 累计重放指令数
+    uint64_t droppedCheckpoints;                    // 因超过上限丢弃的快照数
+
+    static uint64_t getPosition(I_VmInterface& vm) { return vm.getResourceUsage(); }
+
+    /**
+     * @brief 位置不超过position的最后一个快照（没有时返回checkpoints.size()）
+     */
+    size_t findCheckpoint(uint64_t position) const;
+
+    /**
+     * @brief 从第index个快照向前重放到target（途经断点照常越过）
+     * @param hits 不为空时记录途经的断点/观察点命中位置与原因（不含target）
+     * @return uint64_t 重放结束时的位置（VM停止或停机无法前进时小于target）
+     */
+    uint64_t replay(I_VmInterface& vm, size_t index, uint64_t target,
+                    std::vector<std::pair<uint64_t, DebugStopReason>>* hits);
+
+public:
+    explicit ReverseHistory(uint32_t snapshotInterval = DEFAULT_INTERVAL);
+
+    /**
+     * @brief 清空历史并在当前位置保存第一个快照（挂接VM时调用）
+     */
+    void reset(I_VmInterface& vm);
+
+    /**
+     * @brief 修改快照间隔（已保存的快照保留）
+     */
+    void setInterval(uint32_t snapshotInterval) { interval = snapshotInterval ? snapshotInterval : 1; }
+    uint32_t getInterval() const { return interval; }
+
+    /**
+     * @brief 正向执行时本批最多执行的指令数：不越过下一个快照点
+     */
+    uint32_t getForwardBudget(I_VmInterface& vm, uint32_t maxInstructions) const;
+
+    /**
+     * @brief 正向执行一批之后调用：到达快照点时保存快照
+     */
+    void record(I_VmInterface& vm);
+
+    /**
+     * @brief 调试器修改了寄存器或内存：丢弃当前位置之后的快照（它们记录的是修改前的执行）
+     */
+    void invalidateFuture(I_VmInterface& vm);
+
+    /**
+     * @brief 反向单步：回到上一条指令执行前
+     */
+    S_ReverseResult reverseStep(I_VmInterface& vm);
+
+    /**
+     * @brief 反向继续：回到当前位置之前最近一次断点/观察点命中，没有时回到最早的快照
+     */
+    S_ReverseResult reverseContinue(I_VmInterface& vm);
+
+    size_t getCheckpointCount() const { return checkpoints.size(); }
+    std::string getStatistics() const;
+};
+
+#endif // REVERSE_HISTORY_H
@@ -0,0 +1,248 @@
+#ifndef INTERRUPT_CONTROLLER_H
+#define INTERRUPT_CONTROLLER_H
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+
+// 约定的设备中断向量
+static const uint32_t IRQ_VECTOR_TIMER = 0;        // 虚拟定时器
+static const uint32_t IRQ_VECTOR_NET_RX = 1;       // 虚拟网卡接收
+static const uint32_t IRQ_VECTOR_DOORBELL = 2;     // 共享内存门铃
+
+/**
+ * @brief 停机VM唤醒接口（由调度器实现）
+ */
+class I_InterruptWakeupTarget {
+public:
+    virtual ~I_InterruptWakeupTarget() = default;
+    virtual void notifyVmWakeup() = 0;
+};
+
+/**
+ * @brief 单个中断源的合并配置与累计状态
+ */
+struct S_IrqCoalesceState {
+    uint32_t threshold;                 // 累计多少次触发才置位（1表示不合并）
+    uint32_t maxDelayUs;                // 首次触发后最长延迟（0表示只按次数）
+    std::atomic<uint32_t> accumulated;  // 尚未置位的触发次数
+    std::atomic<uint64_t> firstRaiseNs; // 首次未置位触发的时间
+
+    S_IrqCoalesceState() : threshold(1), maxDelayUs(0), accumulated(0), firstRaiseNs(0) {}
+};
+
+/**
+ * @brief 每VM一个的虚拟中断控制器
+ * @details 用64位pending/masked位图表示64个向量，设备与定时器在任意线程通过
+ *          fetch_or无锁置位；VM在时间片（块）边界调用acknowledge()按优先级取出
+ *          最高优先级的向量并原子清除。每个向量可配置合并阈值，用于抑制中断风暴。
+ *          VM停机等待（HLT）时置位会调用唤醒钩子，由调度器重新调度该VM。
+ */
+class VirtualInterruptController {
+public:
+    static const uint32_t MAX_VECTORS = 64;         // 向量数
+    static const uint32_t PRIORITY_LEVELS = 4;      // 优先级数（0最高）
+    static const uint32_t NO_ENTRY = 0xFFFFFFFF;    // 未注册处理入口
+
+private:
+    std::atomic<uint64_t> pending;                  // 待处理位图
+    std::atomic<uint64_t> masked;                   // 屏蔽位图
+    uint64_t levelMasks[PRIORITY_LEVELS];           // 每个优先级包含的向量位图
+    uint32_t vectorEntry[MAX_VECTORS];              // 每个向量的客户机处理入口
+    S_IrqCoalesceState coalesce[MAX_VECTORS];       // 每个向量的合并状态
+    std::atomic<bool> hasCoalescing;                // 是否有向量启用了延迟合并
+    const std::atomic<bool>* haltedFlag;            // 所属VM的停机标志
+    std::atomic<I_InterruptWakeupTarget*> wakeupTarget; // 停机VM的唤醒目标（调度器设置）
+
+    std::atomic<uint64_t> raisedCount;              // 累计触发次数
+    std::atomic<uint64_t> coalescedCount;           // 被合并吸收的触发次数
+    std::atomic<uint64_t> deliveredCount;           // 累计投递次数
+
+    static uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void wakeIfHalted() {
+        if (haltedFlag && haltedFlag->load(std::memory_order_acquire)) {
+            I_InterruptWakeupTarget* target = wakeupTarget.load(std::memory_order_acquire);
+            if (target) {
+                target->notifyVmWakeup();
+            }
+        }
+    }
+
+    void setPending(uint32_t vector) {
+        uint64_t bit = 1ULL << vector;
+        uint64_t previous = pending.fetch_or(bit, std::memory_order_acq_rel);
+        if (!(previous & bit) && !(masked.load(std::memory_order_relaxed) & bit)) {
+            wakeIfHalted();
+        }
+    }
+
+public:
+    explicit VirtualInterruptController(const std::atomic<bool>* halted = nullptr)
+        : pending(0), masked(0), hasCoalescing(false), haltedFlag(halted), wakeupTarget(nullptr),
+          raisedCount(0), coalescedCount(0), deliveredCount(0) {
+        for (uint32_t level = 0; level < PRIORITY_LEVELS; level++) {
+            levelMasks[level] = 0;
+        }
+        // 默认所有向量处于最低优先级
+        levelMasks[PRIORITY_LEVELS - 1] = ~0ULL;
+        for (uint32_t i = 0; i < MAX_VECTORS; i++) {
+            vectorEntry[i] = NO_ENTRY;
+        }
+    }
+
+    VirtualInterruptController(const VirtualInterruptController&) = delete;
+    VirtualInterruptController& operator=(const VirtualInterruptController&) = delete;
+
+    /**
+     * @brief 触发中断（任意线程，无锁）
+     * @param vector 向量号
+     */
+    void raise(uint32_t vector) {
+        if (vector >= MAX_VECTORS) {
+            return;
+        }
+        raisedCount.fetch_add(1, std::memory_order_relaxed);
+
+        S_IrqCoalesceState& state = coalesce[vector];
+        if (state.threshold <= 1) {
+            setPending(vector);
+            return;
+        }
+
+        uint32_t count = state.accumulated.fetch_add(1, std::memory_order_acq_rel) + 1;
+        if (count == 1) {
+            state.firstRaiseNs.store(nowNs(), std::memory_order_release);
+        }
+        bool delayReached = state.maxDelayUs != 0 &&
+            nowNs() - state.firstRaiseNs.load(std::memory_order_acquire) >=
+                static_cast<uint64_t>(state.maxDelayUs) * 1000;
+        if (count < state.threshold && !delayReached) {
+            coalescedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // 只有把累计值清零的线程负责置位
+        if (state.accumulated.exchange(0, std::memory_order_acq_rel) != 0) {
+            setPending(vector);
+        }
+    }
+
+    /**
+     * @brief 冲刷已超过最长延迟的合并中断（调度器节拍调用）
+     */
+    void flushExpired() {
+        if (!hasCoalescing.load(std::memory_order_relaxed)) {
+            return;
+        }
+        uint64_t now = nowNs();
+        for (uint32_t vector = 0; vector < MAX_VECTORS; vector++) {
+            S_IrqCoalesceState& state = coalesce[vector];
+            if (state.maxDelayUs == 0 || state.accumulated.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            if (now - state.firstRaiseNs.load(std::memory_order_acquire) >=
+                    static_cast<uint64_t>(state.maxDelayUs) * 1000 &&
+                state.accumulated.exchange(0, std::memory_order_acq_rel) != 0) {
+                setPending(vector);
+            }
+        }
+    }
+
+    /**
+     * @brief 是否存在可投递（已置位且未屏蔽）的中断
+     */
+    bool hasDeliverable() const {
+        return (pending.load(std::memory_order_acquire) & ~masked.load(std::memory_order_relaxed)) != 0;
+    }
+
+    /**
+     * @brief 取出并清除最高优先级的可投递向量（VM线程在块边界调用）
+     * @return 向量号，无可投递中断返回-1
+     */
+    int acknowledge() {
+        uint64_t deliverable = pending.load(std::memory_order_acquire) & ~masked.load(std::memory_order_relaxed);
+        if (!deliverable) {
+            return -1;
+        }
+        for (uint32_t level = 0; level < PRIORITY_LEVELS; level++) {
+            uint64_t candidates = deliverable & levelMasks[level];
+            if (candidates) {
+                uint32_t vector = static_cast<uint32_t>(__builtin_ctzll(candidates));
+                pending.fetch_and(~(1ULL << vector), std::memory_order_acq_rel);
+                deliveredCount.fetch_add(1, std::memory_order_relaxed);
+                return static_cast<int>(vector);
+            }
+        }
+        return -1;
+    }
+
+    void mask(uint32_t vector) {
+        if (vector < MAX_VECTORS) {
+            masked.fetch_or(1ULL << vector, std::memory_order_acq_rel);
+        }
+    }
+
+    void unmask(uint32_t vector) {
+        if (vector < MAX_VECTORS) {
+            masked.fetch_and(~(1ULL << vector), std::memory_order_acq_rel);
+            if (pending.load(std::memory_order_acquire) & (1ULL << vector)) {
+                wakeIfHalted();
+            }
+        }
+    }
+
+    /**
+     * @brief 设置向量优先级（配置路径，VM运行前调用）
+     */
+    void setPriority(uint32_t vector, uint32_t level) {
+        if (vector >= MAX_VECTORS || level >= PRIORITY_LEVELS) {
+            return;
+        }
+        for (uint32_t i = 0; i < PRIORITY_LEVELS; i++) {
+            levelMasks[i] &= ~(1ULL << vector);
+        }
+        levelMasks[level] |= 1ULL << vector;
+    }
+
+    /**
+     * @brief 设置向量合并参数（配置路径）
+     * @param threshold 累计次数阈值
+     * @param maxDelayUs 最长延迟（微秒）
+     */
+    void setCoalescing(uint32_t vector, uint32_t threshold, uint32_t maxDelayUs) {
+        if (vector >= MAX_VECTORS) {
+            return;
+        }
+        coalesce[vector].threshold = threshold == 0 ? 1 : threshold;
+        coalesce[vector].maxDelayUs = maxDelayUs;
+        if (maxDelayUs != 0) {
+            hasCoalescing.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    void setVectorEntry(uint32_t vector, uint32_t entryPc) {
+        if (vector < MAX_VECTORS) {
+            vectorEntry[vector] = entryPc;
+        }
+    }
+
+    uint32_t getVectorEntry(uint32_t vector) const {
+        return vector < MAX_VECTORS ? vectorEntry[vector] : NO_ENTRY;
+    }
+
+    void setWakeupTarget(I_InterruptWakeupTarget* target) {
+        wakeupTarget.store(target, std::memory_order_release);
+    }
+
+    uint64_t getPendingBitmap() const { return pending.load(std::memory_order_acquire); }
+    uint64_t getMaskedBitmap() const { return masked.load(std::memory_order_acquire); }
+    uint64_t getRaisedCount() const { return raisedCount.load(std::memory_order_relaxed); }
+    uint64_t getCoalescedCount() const { return coalescedCount.load(std::memory_order_relaxed); }
+    uint64_t getDeliveredCount() const { return deliveredCount.load(std::memory_order_relaxed); }
+};
+
+#endif // INTERRUPT_CONTROLLER_H
@@ -0,0 +1,351 @@
+#include "virtual_network.h"
+#include "../Cross_PlatformUnifiedMacro.h"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+uint64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+VirtualNic::VirtualNic(uint32_t macAddr, GuestMemory& guestMemory)
+    : mac(macAddr), memory(guestMemory),
+      txRing(RING_SIZE), rxFreeRing(RING_SIZE), rxRing(RING_SIZE),
+      txSubmitted(0), txCompleted(0),
+      coalescePackets(1), coalesceUs(0), pendingNotify(0), firstPendingNs(0),
+      rxPackets(0), rxBytes(0), rxDropped(0), txBytes(0), interrupts(0) {}
+
+bool VirtualNic::transmit(uint32_t guestAddr, uint32_t length, uint32_t dstMac) {
+    if (length == 0 || length > MTU) {
+        return false;
+    }
+    // 提交时即校验读权限，交换机线程只做拷贝
+    if (!memory.checkAccess(guestAddr, length, GUEST_PERM_READ)) {
+        return false;
+    }
+
+    S_NetPacketDesc desc;
+    desc.srcMac = mac;
+    desc.dstMac = dstMac;
+    desc.guestAddr = guestAddr;
+    desc.length = length;
+    desc.timestampNs = monotonicNs();
+
+    if (!txRing.tryPush(desc)) {
+        return false;
+    }
+    txSubmitted.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+bool VirtualNic::postRxBuffer(uint32_t guestAddr) {
+    if (!memory.checkAccess(guestAddr, MTU, GUEST_PERM_WRITE)) {
+        return false;
+    }
+    return rxFreeRing.tryPush(guestAddr);
+}
+
+size_t VirtualNic::receive(S_NetPacketDesc* out, size_t maxCount) {
+    return rxRing.popBatch(out, maxCount);
+}
+
+void VirtualNic::setCoalescing(uint32_t packets, uint32_t usec) {
+    coalescePackets = packets == 0 ? 1 : packets;
+    coalesceUs = usec;
+}
+
+void VirtualNic::setRxNotifier(const std::function<void(uint32_t)>& notifier) {
+    rxNotifier = notifier;
+}
+
+S_NicStats VirtualNic::getStats() const {
+    S_NicStats stats;
+    stats.txPackets = txCompleted.load(std::memory_order_relaxed);
+    stats.txBytes = txBytes.load(std::memory_order_relaxed);
+    stats.rxPackets = rxPackets.load(std::memory_order_relaxed);
+    stats.rxBytes = rxBytes.load(std::memory_order_relaxed);
+    stats.rxDropped = rxDropped.load(std::memory_order_relaxed);
+    stats.interrupts = interrupts.load(std::memory_order_relaxed);
+    return stats;
+}
+
+VirtualSwitch::VirtualSwitch()
+    : isRunning(false), forwardedPackets(0), floodedPackets(0), passEpoch(0) {
+    for (uint32_t i = 0; i < MAX_PORTS; i++) {
+        ports[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+VirtualSwitch::~VirtualSwitch() {
+    stop();
+}
+
+int VirtualSwitch::findPortIndexLocked(uint32_t mac) const {
+    for (uint32_t i = 0; i < MAX_PORTS; i++) {
+        VirtualNic* nic = ports[i].load(std::memory_order_relaxed);
+        if (nic && nic->mac == mac) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool VirtualSwitch::attach(const std::shared_ptr<VirtualNic>& nic) {
+    if (!nic || nic->mac == VirtualNic::BROADCAST_MAC) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(controlMutex);
+    if (findPortIndexLocked(nic->mac) != -1) {
+        std::cerr << "MAC " << nic->mac << " already attached" << std::endl;
+        return false;
+    }
+
+    for (uint32_t i = 0; i < MAX_PORTS; i++) {
+        if (!ports[i].load(std::memory_order_relaxed)) {
+            owners.push_back(nic);
+            ports[i].store(nic.get(), std::memory_order_release);
+            return true;
+        }
+    }
+
+    std::cerr << "Virtual switch has no free port" << std::endl;
+    return false;
+}
+
+bool VirtualSwitch::detach(uint32_t mac) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    int index = findPortIndexLocked(mac);
+    if (index == -1) {
+        return false;
+    }
+
+    ports[index].store(nullptr, std::memory_order_seq_cst);
+    
+    // 等待可能仍持有旧端口快照的转发轮结束
+    if (isRunning) {
+        uint64_t target = passEpoch.load(std::memory_order_seq_cst) + 2;
+        while (isRunning && passEpoch.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield();
+        }
+    }
+    
+    for (auto it = owners.begin(); it != owners.end(); ++it) {
+        if ((*it)->mac == mac) {
+            owners.erase(it);
+            break;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<VirtualNic> VirtualSwitch::findNic(uint32_t mac) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    for (const auto& nic : owners) {
+        if (nic->mac == mac) {
+            return nic;
+        }
+    }
+    return nullptr;
+}
+
+void VirtualSwitch::start(int coreId) {
+    if (isRunning) {
+        return;
+    }
+    isRunning = true;
+    switchThread = std::thread(&VirtualSwitch::switchLoop, this, coreId);
+}
+
+void VirtualSwitch::stop() {
+    if (!isRunning) {
+        return;
+    }
+    isRunning = false;
+    if (switchThread.joinable()) {
+        switchThread.join();
+    }
+}
+
+bool VirtualSwitch::deliver(VirtualNic& src, VirtualNic& dst, const S_NetPacketDesc& desc, uint64_t nowNs) {
+    // 空闲缓冲环的生产者只能是VM线程，取出的缓冲无法归还；
+    // 因此先确认接收环有空位（交换机是其唯一生产者）且发送数据可读，再取空闲缓冲
+    if (dst.rxRing.sizeApprox() >= dst.rxRing.capacity()) {
+        dst.rxDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    const uint8_t* from = src.memory.translate(desc.guestAddr, desc.length, GUEST_PERM_READ);
+    if (!from) {
+        // 读权限在提交后被收回
+        dst.rxDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint32_t rxAddr = 0;
+    if (!dst.rxFreeRing.tryPop(rxAddr)) {
+        dst.rxDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    uint8_t* to = dst.memory.translate(rxAddr, desc.length, GUEST_PERM_WRITE);
+    if (!to) {
+        // 接收缓冲的写权限在投递后被收回，缓冲作废
+        dst.rxDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // 唯一一次数据拷贝：发送端客户机内存 -> 接收端客户机内存
+    std::memcpy(to, from, desc.length);
+
+    S_NetPacketDesc rxDesc = desc;
+    rxDesc.guestAddr = rxAddr;
+    if (!dst.rxRing.tryPush(rxDesc)) {
+        // 上面已确认有空位，消费者只会腾出空间
+        dst.rxDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    dst.rxPackets.fetch_add(1, std::memory_order_relaxed);
+    dst.rxBytes.fetch_add(desc.length, std::memory_order_relaxed);
+    if (dst.pendingNotify == 0) {
+        dst.firstPendingNs = nowNs;
+    }
+    dst.pendingNotify++;
+    return true;
+}
+
+void VirtualSwitch::flushNotifications(VirtualNic& nic, uint64_t nowNs, bool force) {
+    if (nic.pendingNotify == 0) {
+        return;
+    }
+
+    bool countReached = nic.pendingNotify >= nic.coalescePackets;
+    bool timeReached = nic.coalesceUs != 0 &&
+                       nowNs - nic.firstPendingNs >= static_cast<uint64_t>(nic.coalesceUs) * 1000;
+    if (!force && !countReached && !timeReached) {
+        return;
+    }
+
+    uint32_t count = nic.pendingNotify;
+    nic.pendingNotify = 0;
+    nic.interrupts.fetch_add(1, std::memory_order_relaxed);
+    if (nic.rxNotifier) {
+        nic.rxNotifier(count);
+    }
+}
+
+size_t VirtualSwitch::pollOnce() {
+    S_NetPacketDesc batch[BATCH_SIZE];
+    VirtualNic* snapshot[MAX_PORTS];
+    uint32_t portCount = 0;
+    size_t forwarded = 0;
+    uint64_t nowNs = monotonicNs();
+
+    for (uint32_t i = 0; i < MAX_PORTS; i++) {
+        VirtualNic* nic = ports[i].load(std::memory_order_acquire);
+        if (nic) {
+            snapshot[portCount++] = nic;
+        }
+    }
+
+    for (uint32_t p = 0; p < portCount; p++) {
+        VirtualNic& src = *snapshot[p];
+        size_t n = src.txRing.popBatch(batch, BATCH_SIZE);
+        if (n == 0) {
+            continue;
+        }
+
+        uint64_t bytes = 0;
+        for (size_t k = 0; k < n; k++) {
+            const S_NetPacketDesc& desc = batch[k];
+            bytes += desc.length;
+
+            if (desc.dstMac == VirtualNic::BROADCAST_MAC) {
+                for (uint32_t q = 0; q < portCount; q++) {
+                    if (q != p) {
+                        deliver(src, *snapshot[q], desc, nowNs);
+                    }
+                }
+                floodedPackets.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                for (uint32_t q = 0; q < portCount; q++) {
+                    if (snapshot[q]->mac == desc.dstMac) {
+                        deliver(src, *snapshot[q], desc, nowNs);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // 整批完成后一次性发布发送完成序号
+        src.txBytes.fetch_add(bytes, std::memory_order_relaxed);
+        src.txCompleted.fetch_add(n, std::memory_order_release);
+        forwarded += n;
+    }
+
+    for (uint32_t p = 0; p < portCount; p++) {
+        flushNotifications(*snapshot[p], nowNs, false);
+    }
+
+    if (forwarded > 0) {
+        forwardedPackets.fetch_add(forwarded, std::memory_order_relaxed);
+    }
+    passEpoch.fetch_add(1, std::memory_order_release);
+    return forwarded;
+}
+
+void VirtualSwitch::switchLoop(int coreId) {
+    if (coreId >= 0 && SetThreadCPUAffinity(coreId) != 0) {
+        std::cerr << "Warning: Failed to set virtual switch affinity to core " << coreId << std::endl;
+    }
+
+    // 空闲时逐步退避：先自旋让出，再短暂休眠
+    uint32_t idleRounds = 0;
+    while (isRunning) {
+        if (pollOnce() > 0) {
+            idleRounds = 0;
+            continue;
+        }
+
+        idleRounds++;
+        if (idleRounds < 64) {
+            std::this_thread::yield();
+        } else {
+            // 休眠前强制冲刷延迟合并的通知，避免通知被无限期挂起
+            uint64_t nowNs = monotonicNs();
+            for (uint32_t i = 0; i < MAX_PORTS; i++) {
+                VirtualNic* nic = ports[i].load(std::memory_order_acquire);
+                if (nic) {
+                    flushNotifications(*nic, nowNs, true);
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+std::string VirtualSwitch::getStatistics() {
+    std::lock_guard<std::mutex> lock(controlMutex);
+
+    std::ostringstream oss;
+    oss << "=== Virtual Switch Statistics ===" << std::endl;
+    oss << "Running: " << (isRunning ? "YES" : "NO") << std::endl;
+    oss << "Ports: " << owners.size() << "/" << MAX_PORTS << std::endl;
+    oss << "Forwarded Packets: " << forwardedPackets.load() << std::endl;
+    oss << "Broadcast Packets: " << floodedPackets.load() << std::endl;
+
+    for (const auto& nic : owners) {
+        S_NicStats stats = nic->getStats();
+        oss << "  NIC " << nic->getMac()
+            << ": tx " << stats.txPackets << " pkts/" << stats.txBytes << " B"
+            << ", rx " << stats.rxPackets << " pkts/" << stats.rxBytes << " B"
+            << ", dropped " << stats.rxDropped
+            << ", irqs " << stats.interrupts << std::endl;
+    }
+    return oss.str();
+}
@@ -0,0 +1,209 @@
+#ifndef VIRTUAL_NETWORK_H
+#define VIRTUAL_NETWORK_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include <string>
+#include "../common/lockfree_ring.h"
+#include "../memory/guest_memory.h"
+
+/**
+ * @brief 网络包描述符，只描述客户机内存中的数据，不携带数据本身
+ */
+struct S_NetPacketDesc {
+    uint32_t srcMac;        // 源MAC（发送端网卡地址）
+    uint32_t dstMac;        // 目的MAC（0xFFFFFFFF为广播）
+    uint32_t guestAddr;     // 数据在所属VM客户机内存中的地址
+    uint32_t length;        // 数据长度
+    uint64_t timestampNs;   // 发送时间戳（纳秒，单调时钟）
+
+    S_NetPacketDesc() : srcMac(0), dstMac(0), guestAddr(0), length(0), timestampNs(0) {}
+};
+
+/**
+ * @brief 虚拟网卡统计信息快照
+ */
+struct S_NicStats {
+    uint64_t txPackets;     // 已发送包数
+    uint64_t txBytes;       // 已发送字节数
+    uint64_t rxPackets;     // 已接收包数
+    uint64_t rxBytes;       // 已接收字节数
+    uint64_t rxDropped;     // 因无接收缓冲或接收环满而丢弃的包数
+    uint64_t interrupts;    // 合并后实际发出的接收通知次数
+
+    S_NicStats() : txPackets(0), txBytes(0), rxPackets(0), rxBytes(0),
+                   rxDropped(0), interrupts(0) {}
+};
+
+/**
+ * @brief 每VM一块的虚拟网卡
+ * @details 三条SPSC环：
+ *          - txRing：VM线程生产，交换机线程消费；
+ *          - rxFreeRing：VM线程投递空闲接收缓冲地址，交换机线程消费（交换机从不回填，
+ *            投递失败时先检查接收环空位与发送端权限，再取缓冲）；
+ *          - rxRing：交换机线程把已填充的缓冲描述符交还给VM线程。
+ *          数据由交换机直接从发送端客户机内存拷贝到接收端投递的缓冲，全程仅一次拷贝。
+ *          发送缓冲在getTxCompleted()越过对应序号前不得被客户机复用。
+ */
+class VirtualNic {
+public:
+    static const uint32_t MTU = 2048;                   // 单个接收缓冲大小
+    static const uint32_t BROADCAST_MAC = 0xFFFFFFFF;   // 广播地址
+    static const size_t RING_SIZE = 1024;               // 环容量
+
+private:
+    friend class VirtualSwitch;
+
+    uint32_t mac;                           // 网卡地址（默认为VM ID）
+    GuestMemory& memory;                    // 所属VM的客户机内存
+
+    SpscRing<S_NetPacketDesc> txRing;       // 发送环
+    SpscRing<uint32_t> rxFreeRing;          // 空闲接收缓冲环
+    SpscRing<S_NetPacketDesc> rxRing;       // 接收完成环
+
+    std::atomic<uint64_t> txSubmitted;      // 已提交发送数（VM线程写）
+    std::atomic<uint64_t> txCompleted;      // 已完成发送数（交换机线程写）
+
+    // 以下字段只由交换机线程访问
+    uint32_t coalescePackets;               // 累计多少个包触发一次通知
+    uint32_t coalesceUs;                    // 最长等待多少微秒触发通知
+    uint32_t pendingNotify;                 // 尚未通知的已投递包数
+    uint64_t firstPendingNs;                // 第一个未通知包的投递时间
+    std::function<void(uint32_t)> rxNotifier; // 接收通知回调（参数为本次合并的包数）
+
+    std::atomic<uint64_t> rxPackets;
+    std::atomic<uint64_t> rxBytes;
+    std::atomic<uint64_t> rxDropped;
+    std::atomic<uint64_t> txBytes;
+    std::atomic<uint64_t> interrupts;
+
+public:
+    /**
+     * @brief 构造函数
+     * @param macAddr 网卡地址
+     * @param guestMemory 所属VM的客户机内存
+     */
+    VirtualNic(uint32_t macAddr, GuestMemory& guestMemory);
+
+    VirtualNic(const VirtualNic&) = delete;
+    VirtualNic& operator=(const VirtualNic&) = delete;
+
+    /**
+     * @brief 提交一个发送请求（VM线程调用）
+     * @param guestAddr 数据在客户机内存中的地址
+     * @param length 数据长度（不超过MTU）
+     * @param dstMac 目的地址
+     * @return bool 权限校验失败或发送环满返回false
+     */
+    bool transmit(uint32_t guestAddr, uint32_t length, uint32_t dstMac);
+
+    /**
+     * @brief 投递一个空闲接收缓冲（VM线程调用）
+     * @param guestAddr 缓冲地址，需可写且至少MTU字节
+     */
+    bool postRxBuffer(uint32_t guestAddr);
+
+    /**
+     * @brief 批量取出已接收的包（VM线程调用）
+     * @return 取出的包数
+     */
+    size_t receive(S_NetPacketDesc* out, size_t maxCount);
+
+    /**
+     * @brief 设置中断合并参数（需在交换机运行前或挂接时设置）
+     * @param packets 累计包数阈值（至少为1）
+     * @param usec 最长延迟（微秒，0表示只按包数合并）
+     */
+    void setCoalescing(uint32_t packets, uint32_t usec);
+
+    /**
+     * @brief 设置接收通知回调，在交换机线程中调用
+     */
+    void setRxNotifier(const std::function<void(uint32_t)>& notifier);
+
+    uint32_t getMac() const { return mac; }
+    uint64_t getTxSubmitted() const { return txSubmitted.load(std::memory_order_acquire); }
+    uint64_t getTxCompleted() const { return txCompleted.load(std::memory_order_acquire); }
+    S_NicStats getStats() const;
+};
+
+/**
+ * @brief 进程内二层虚拟交换机
+ * @details 单个转发线程（默认绑定核1，即外设虚拟核）轮询所有端口的发送环，
+ *          按目的MAC查表转发；每个端口每轮最多处理BATCH_SIZE个包，
+ *          一轮结束后再统一评估中断合并，从而摊薄唤醒开销。
+ *          端口数组只在控制路径上加锁修改，转发线程通过原子指针无锁读取。
+ */
+class VirtualSwitch {
+public:
+    static const uint32_t MAX_PORTS = 64;       // 最大端口数
+    static const size_t BATCH_SIZE = 32;        // 每端口每轮最大转发包数
+
+private:
+    std::atomic<VirtualNic*> ports[MAX_PORTS];          // 端口表（转发线程无锁读取）
+    std::vector<std::shared_ptr<VirtualNic>> owners;     // 端口所有权（控制路径）
+    std::mutex controlMutex;                            // 挂接/摘除互斥锁
+    std::atomic<bool> isRunning;                        // 转发线程运行状态
+    std::thread switchThread;                           // 转发线程
+    std::atomic<uint64_t> forwardedPackets;             // 累计转发包数
+    std::atomic<uint64_t> floodedPackets;               // 累计广播包数
+    std::atomic<uint64_t> passEpoch;                    // 已完成的转发轮数（摘除端口时用于等待静默）
+
+    int findPortIndexLocked(uint32_t mac) const;
+    bool deliver(VirtualNic& src, VirtualNic& dst, const S_NetPacketDesc& desc, uint64_t nowNs);
+    void flushNotifications(VirtualNic& nic, uint64_t nowNs, bool force);
+    void switchLoop(int coreId);
+
+public:
+    VirtualSwitch();
+    ~VirtualSwitch();
+
+    /**
+     * @brief 挂接一块网卡
+     * @return bool 端口已满或MAC重复返回false
+     */
+    bool attach(const std::shared_ptr<VirtualNic>& nic);
+
+    /**
+     * @brief 摘除网卡
+     * @details 转发线程运行时会等待当前转发轮结束后才释放网卡，
+     *          因此返回后可以安全销毁网卡所引用的客户机内存
+     */
+    bool detach(uint32_t mac);
+
+    /**
+     * @brief 按MAC查找网卡
+     */
+    std::shared_ptr<VirtualNic> findNic(uint32_t mac);
+
+    /**
+     * @brief 启动转发线程
+     * @param coreId 绑定的核心，-1表示不绑定
+     */
+    void start(int coreId = 1);
+
+    /**
+     * @brief 停止转发线程
+     */
+    void stop();
+
+    /**
+     * @brief 执行一轮转发（未启动转发线程时可由调用者驱动）
+     * @return 本轮转发的包数
+     */
+    size_t pollOnce();
+
+    bool getRunningStatus() const { return isRunning; }
+
+    /**
+     * @brief 获取交换机统计信息
+     */
+    std::string getStatistics();
+};
+
+#endif // VIRTUAL_NETWORK_H
@@ -0,0 +1,75 @@
+#ifndef VIRTUAL_TIMER_H
+#define VIRTUAL_TIMER_H
+
+#include <cstdint>
+
+/**
+ * @brief 虚拟定时器工作模式（客户机编程时传入的mode值）
+ */
+enum class VirtualTimerMode : uint32_t {
+    DISABLED    = 0,    // 停止
+    ONE_SHOT    = 1,    // 到期触发一次后停止
+    PERIODIC    = 2     // 按间隔周期触发
+};
+
+/**
+ * @brief 每VM一个的虚拟定时器
+ * @details 以VM虚拟时间（tick）计时：运行时1条指令为1 tick，停机等待期间由调度器
+ *          把虚拟时间直接推进到截止时间。因此同一载荷每次运行看到的时间与中断时刻
+ *          完全一致，与宿主负载无关。定时器只在VM线程（块边界）与调度线程（VM停机时）
+ *          访问，两者不会同时发生，无需加锁。
+ */
+class VirtualTimer {
+private:
+    VirtualTimerMode mode;      // 当前模式
+    uint64_t interval;          // 间隔（tick）
+    uint64_t deadline;          // 下次到期的虚拟时间
+    uint64_t firedCount;        // 累计到期次数
+
+public:
+    VirtualTimer() : mode(VirtualTimerMode::DISABLED), interval(0), deadline(0), firedCount(0) {}
+
+    /**
+     * @brief 编程定时器
+     * @param newMode 模式（非法值视为停止）
+     * @param ticks 间隔，0表示停止；截止时间超出虚拟时间范围时同样视为停止（永不到期）
+     * @param now 当前虚拟时间
+     */
+    void program(uint32_t newMode, uint64_t ticks, uint64_t now) {
+        if (ticks == 0 || ticks > UINT64_MAX - now || newMode > static_cast<uint32_t>(VirtualTimerMode::PERIODIC)) {
+            mode = VirtualTimerMode::DISABLED;
+            return;
+        }
+        mode = static_cast<VirtualTimerMode>(newMode);
+        interval = ticks;
+        deadline = now + ticks;
+    }
+
+    bool isArmed() const { return mode != VirtualTimerMode::DISABLED; }
+    VirtualTimerMode getMode() const { return mode; }
+    uint64_t getDeadline() const { return deadline; }
+    uint64_t getFiredCount() const { return firedCount; }
+
+    /**
+     * @brief 检查是否到期，到期时按模式重装或停止
+     * @param now 当前虚拟时间
+     * @return bool 本次检查到期返回true（多个周期合并为一次）
+     */
+    bool poll(uint64_t now) {
+        if (mode == VirtualTimerMode::DISABLED || now < deadline) {
+            return false;
+        }
+        firedCount++;
+        uint64_t periods = (now - deadline) / interval + 1;
+        if (mode == VirtualTimerMode::PERIODIC && periods <= (UINT64_MAX - deadline) / interval) {
+            // 跳过已错过的周期，保持相位不变
+            deadline += periods * interval;
+        } else {
+            // 单次定时器；或下次到期超出虚拟时间范围，回绕后同一时刻的每次检查都会到期
+            mode = VirtualTimerMode::DISABLED;
+        }
+        return true;
+    }
+};
+
+#endif // VIRTUAL_TIMER_H
@@ -1,54 +1,295 @@
 #include "exception_handler.h"
+#include "../security/operation_log.h"
+#include "../Cross_PlatformUnifiedMacro.h"
 #include <iostream>
-#include <stdexcept>
+#include <sstream>
+#include <chrono>
 
-ExceptionManager::ExceptionManager() : exceptionCount(0) {}
+namespace {
+
+uint64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+ExceptionManager::ExceptionManager()
+    : faultQueue(FAULT_QUEUE_CAPACITY), isRunning(false), exceptionCount(0), droppedFaults(0),
+      processedFaults(0), loggedFaults(0), suppressedFaults(0),
+      rateBurst(DEFAULT_RATE_BURST), ratePerSec(DEFAULT_RATE_PER_SEC), windowMs(DEFAULT_WINDOW_MS),
+      operationLog(nullptr) {
+    for (size_t i = 0; i < static_cast<size_t>(VmControlAction::COUNT); i++) {
+        actionCounts[i] = 0;
+    }
+    for (size_t i = 0; i < static_cast<size_t>(VmFaultCode::COUNT); i++) {
+        policies[i].store(static_cast<uint8_t>(VmControlAction::NONE), std::memory_order_relaxed);
+    }
+    // 默认策略：访存越界暂停，无效指令隔离，其余只记录
+    setPolicy(VmFaultCode::MEMORY_ACCESS_VIOLATION, VmControlAction::PAUSE);
+    setPolicy(VmFaultCode::INVALID_INSTRUCTION, VmControlAction::QUARANTINE);
+}
+
+ExceptionManager::~ExceptionManager() {
+    stop();
+}
+
+void ExceptionManager::start(int coreId) {
+    if (isRunning) {
+        return;
+    }
+    isRunning = true;
+    handlerThread = std::thread(&ExceptionManager::handlerLoop, this, coreId);
+}
+
+void ExceptionManager::stop() {
+    if (!isRunning) {
+        return;
+    }
+    isRunning = false;
+    if (handlerThread.joinable()) {
+        handlerThread.join();
+    }
+}
+
+void ExceptionManager::handlerLoop(int coreId) {
+    if (coreId >= 0 && SetThreadCPUAffinity(coreId) != 0) {
+        std::cerr << "Warning: Failed to set exception handler affinity to core " << coreId << std::endl;
+    }
+
+    // 空闲时逐步退避：先自旋让出，再短暂休眠
+    uint32_t idleRounds = 0;
+    S_VmFault fault;
+    while (isRunning) {
+        if (faultQueue.tryPop(fault)) {
+            processFault(fault, monotonicNs());
+            idleRounds = 0;
+            continue;
+        }
+
+        idleRounds++;
+        if (idleRounds < 64) {
+            std::this_thread::yield();
+        } else {
+            flushWindows(monotonicNs(), false);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    // 退出前处理完剩余故障并输出未结束窗口的汇总
+    while (faultQueue.tryPop(fault)) {
+        processFault(fault, monotonicNs());
+    }
+    flushWindows(monotonicNs(), true);
+}
+
+bool ExceptionManager::handleVmFault(const S_VmFault& fault) {
+    size_t index = static_cast<size_t>(fault.code);
+    if (fault.code == VmFaultCode::NONE || index >= static_cast<size_t>(VmFaultCode::COUNT)) {
+        return true;
+    }
+
+    exceptionCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (!isRunning.load(std::memory_order_acquire)) {
+        processFault(fault, monotonicNs());
+        return true;
+    }
+    if (!faultQueue.tryPush(fault)) {
+        droppedFaults.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
 
 void ExceptionManager::handleVmException(uint32_t vmId, const std::string& exceptionType) {
-    exceptionCount++;
-    std::cout << "Exception occurred in VM " << vmId 
-              << ": " << exceptionType << std::endl;
-    
-    // 记录异常日志
-    logException(vmId, exceptionType);
-    
-    // 根据异常类型采取不同措施
-    if (exceptionType == "MEMORY_ACCESS_VIOLATION") {
-        handleMemoryViolation(vmId);
-    } else if (exceptionType == "RESOURCE_TIMEOUT") {
-        handleResourceTimeout(vmId);
-    } else if (exceptionType == "INVALID_INSTRUCTION") {
-        handleInvalidInstruction(vmId);
+    S_VmFault fault;
+    fault.vmId = vmId;
+    for (uint8_t i = 1; i < static_cast<uint8_t>(VmFaultCode::COUNT); i++) {
+        if (exceptionType == GetVmFaultName(static_cast<VmFaultCode>(i))) {
+            fault.code = static_cast<VmFaultCode>(i);
+            break;
+        }
+    }
+
+    if (fault.code == VmFaultCode::NONE) {
+        exceptionCount.fetch_add(1, std::memory_order_relaxed);
+        std::cout << "[EXCEPTION_LOG] VM:" << vmId << " Type:" << exceptionType
+                  << " (unclassified)" << std::endl;
+        return;
+    }
+    handleVmFault(fault);
+}
+
+void ExceptionManager::processFault(const S_VmFault& fault, uint64_t nowNs) {
+    VmControlAction action = getPolicy(fault.code);
+    bool shouldLog = false;
+    {
+        std::lock_guard<std::mutex> lock(processMutex);
+        processedFaults++;
+        actionCounts[static_cast<size_t>(action)]++;
+
+        // 令牌桶：首次出现的VM拿到满桶
+        S_FaultRateState& state = rateStates[fault.vmId];
+        uint32_t burst = rateBurst.load(std::memory_order_relaxed);
+        if (state.lastRefillNs == 0) {
+            state.tokens = burst;
+        } else {
+            double elapsedSec = static_cast<double>(nowNs - state.lastRefillNs) / 1e9;
+            state.tokens += elapsedSec * ratePerSec.load(std::memory_order_relaxed);
+            if (state.tokens > burst) {
+                state.tokens = burst;
+            }
+        }
+        state.lastRefillNs = nowNs;
+
+        if (state.tokens >= 1.0) {
+            state.tokens -= 1.0;
+            loggedFaults++;
+            shouldLog = true;
+        } else {
+            if (state.windowStartNs == 0) {
+                state.windowStartNs = nowNs;
+            }
+            state.suppressed[static_cast<size_t>(fault.code)]++;
+            suppressedFaults++;
+        }
+    }
+
+    if (shouldLog) {
+        logException(fault, action);
+    }
+    // 策略动作不受日志限流影响
+    applyPolicy(fault, action);
+}
+
+void ExceptionManager::flushWindows(uint64_t nowNs, bool force) {
+    std::lock_guard<std::mutex> lock(processMutex);
+    uint64_t window = static_cast<uint64_t>(windowMs.load(std::memory_order_relaxed));
+    for (auto& pair : rateStates) {
+        S_FaultRateState& state = pair.second;
+        if (state.windowStartNs == 0 || (!force && nowNs - state.windowStartNs < window * 1000000ULL)) {
+            continue;
+        }
+        uint64_t elapsedMs = (nowNs - state.windowStartNs) / 1000000ULL;
+        for (size_t i = 0; i < static_cast<size_t>(VmFaultCode::COUNT); i++) {
+            if (state.suppressed[i] == 0) {
+                continue;
+            }
+            std::cout << "[EXCEPTION_LOG] VM:" << pair.first << " " << state.suppressed[i]
+                      << " faults of type " << GetVmFaultName(static_cast<VmFaultCode>(i))
+                      << " in window " << elapsedMs << "ms (rate limited)" << std::endl;
+            state.suppressed[i] = 0;
+        }
+        state.windowStartNs = 0;
     }
 }
 
-void ExceptionManager::handleMemoryViolation(uint32_t vmId) {
-    std::cout << "Handling memory violation for VM " << vmId << std::endl;
-    // 实际项目中会暂停VM并记录详细信息
+void ExceptionManager::applyPolicy(const S_VmFault& fault, VmControlAction action) {
+    if (action == VmControlAction::NONE) {
+        return;
+    }
+    std::shared_ptr<I_VmInterface> vm;
+    {
+        std::lock_guard<std::mutex> lock(vmMutex);
+        auto it = vmTable.find(fault.vmId);
+        if (it != vmTable.end()) {
+            vm = it->second.lock();
+        }
+    }
+    // 只有提高了VM控制级别的请求才写审计日志，故障风暴中重复的同级请求不记录
+    if (vm && vm->requestControl(action)) {
+        OperationLog* log = operationLog.load(std::memory_order_acquire);
+        if (log) {
+            log->append(OpLogEvent::FAULT_ACTION, fault.vmId,
+                        std::string(GetVmFaultName(fault.code)) + " -> " + GetVmControlName(action));
+        }
+    }
 }
 
-void ExceptionManager::handleResourceTimeout(uint32_t vmId) {
-    std::cout << "Handling resource timeout for VM " << vmId << std::endl;
-    // 实际项目中会检查资源使用情况并可能终止VM
+void ExceptionManager::attachVm(const std::shared_ptr<I_VmInterface>& vm) {
+    if (!vm) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(vmMutex);
+    vmTable[vm->getVmId()] = vm;
 }
 
-void ExceptionManager::handleInvalidInstruction(uint32_t vmId) {
-    std::cout << "Handling invalid instruction for VM " << vmId << std::endl;
-    // 实际项目中会记录无效指令并可能暂停VM
+void ExceptionManager::detachVm(uint32_t vmId) {
+    std::lock_guard<std::mutex> lock(vmMutex);
+    vmTable.erase(vmId);
 }
 
-void ExceptionManager::logException(uint32_t vmId, const std::string& exceptionType) {
+void ExceptionManager::setOperationLog(OperationLog* log) {
+    operationLog.store(log, std::memory_order_release);
+}
+
+void ExceptionManager::setPolicy(VmFaultCode code, VmControlAction action) {
+    size_t index = static_cast<size_t>(code);
+    if (code == VmFaultCode::NONE || index >= static_cast<size_t>(VmFaultCode::COUNT) ||
+        action >= VmControlAction::COUNT) {
+        return;
+    }
+    policies[index].store(static_cast<uint8_t>(action), std::memory_order_relaxed);
+}
+
+VmControlAction ExceptionManager::getPolicy(VmFaultCode code) const {
+    size_t index = static_cast<size_t>(code);
+    if (index >= static_cast<size_t>(VmFaultCode::COUNT)) {
+        return VmControlAction::NONE;
+    }
+    return static_cast<VmControlAction>(policies[index].load(std::memory_order_relaxed));
+}
+
+void ExceptionManager::setRateLimit(uint32_t burst, uint32_t perSec, uint32_t window) {
+    rateBurst.store(burst > 0 ? burst : 1, std::memory_order_relaxed);
+    ratePerSec.store(perSec, std::memory_order_relaxed);
+    windowMs.store(window > 0 ? window : 1, std::memory_order_relaxed);
+}
+
+void ExceptionManager::logException(const S_VmFault& fault, VmControlAction action) {
     // 简单的日志记录 - 实际项目中会写入日志文件
-    std::cout << "[EXCEPTION_LOG] VM:" << vmId 
-              << " Type:" << exceptionType 
-              << " Count:" << exceptionCount << std::endl;
+    std::cout << "[EXCEPTION_LOG] VM:" << fault.vmId
+              << " Type:" << GetVmFaultName(fault.code)
+              << " PC:0x" << std::hex << fault.pc << std::dec
+              << " VTime:" << fault.virtualTime
+              << " Detail:" << fault.detail
+              << " Action:" << GetVmControlName(action) << std::endl;
 }
 
 uint32_t ExceptionManager::getExceptionCount() const {
-    return exceptionCount;
+    return exceptionCount.load(std::memory_order_relaxed);
 }
 
 void ExceptionManager::resetExceptionCount() {
-    exceptionCount = 0;
+    exceptionCount.store(0, std::memory_order_relaxed);
     std::cout << "Exception count reset" << std::endl;
-}
\ No newline at end of file
+}
+
+std::string ExceptionManager::getStatistics() const {
+    std::ostringstream oss;
+    oss << "=== Exception Pipeline ===" << std::endl;
+    oss << "Handler Thread: " << (isRunning ? "RUNNING" : "STOPPED") << std::endl;
+    oss << "Reported: " << exceptionCount.load(std::memory_order_relaxed) << std::endl;
+    oss << "Dropped (queue full): " << droppedFaults.load(std::memory_order_relaxed) << std::endl;
+    oss << "Queue Depth: " << faultQueue.sizeApprox() << "/" << faultQueue.capacity() << std::endl;
+    oss << "Rate Limit: burst " << rateBurst.load(std::memory_order_relaxed)
+        << ", " << ratePerSec.load(std::memory_order_relaxed) << "/s, window "
+        << windowMs.load(std::memory_order_relaxed) << "ms" << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(processMutex);
+        oss << "Processed: " << processedFaults << " (logged " << loggedFaults
+            << ", rate limited " << suppressedFaults << ")" << std::endl;
+        oss << "Actions:";
+        for (size_t i = 1; i < static_cast<size_t>(VmControlAction::COUNT); i++) {
+            oss << " " << GetVmControlName(static_cast<VmControlAction>(i)) << "=" << actionCounts[i];
+        }
+        oss << std::endl;
+    }
+    oss << "Policies:" << std::endl;
+    for (size_t i = 1; i < static_cast<size_t>(VmFaultCode::COUNT); i++) {
+        oss << "  " << GetVmFaultName(static_cast<VmFaultCode>(i)) << " -> "
+            << GetVmControlName(getPolicy(static_cast<VmFaultCode>(i))) << std::endl;
+    }
+    return oss.str();
+}
@@ -3,53 +3,146 @@
 
 #include <cstdint>
 #include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include "../CPUvm/baseVM.h"
+#include "../common/lockfree_ring.h"
+
+class OperationLog;
+
+/**
+ * @brief 单个VM的故障限流与聚合状态（仅处理线程访问）
+ * @details 令牌桶控制逐条日志的速率，超出速率的故障按类型计数，
+ *          窗口结束时汇总为一行"N faults of type T in window W"
+ */
+struct S_FaultRateState {
+    double tokens;                                              // 当前令牌数
+    uint64_t lastRefillNs;                                      // 上次补充令牌的时间
+    uint64_t windowStartNs;                                     // 聚合窗口起点（0表示无被限流故障）
+    uint32_t suppressed[static_cast<size_t>(VmFaultCode::COUNT)]; // 窗口内按类型被限流的故障数
+
+    S_FaultRateState() : tokens(0), lastRefillNs(0), windowStartNs(0) {
+        for (size_t i = 0; i < static_cast<size_t>(VmFaultCode::COUNT); i++) {
+            suppressed[i] = 0;
+        }
+    }
+};
 
 /**
  * @brief 异常管理器类，处理VM运行时的各种异常情况
- * @details 包括内存越界、资源超时、无效指令等异常的检测和处理
+ * @details 故障由工作线程无锁投递到MPSC队列后立即返回，处理线程（默认绑定核心1）
+ *          负责限流、记录日志并按故障码查表执行策略动作。策略动作只向VM登记请求，
+ *          由VM在下一个时间片边界自行暂停/停止/隔离，不阻塞发生故障的工作线程。
+ *          处理线程未启动时故障在调用线程上同步处理。
  */
 class ExceptionManager {
+public:
+    static const uint32_t FAULT_QUEUE_CAPACITY = 1024;     // 故障队列容量
+    static const int DEFAULT_HANDLER_CORE = 1;              // 处理线程默认绑定的核心
+    static const uint32_t DEFAULT_RATE_BURST = 10;          // 每VM令牌桶容量（条）
+    static const uint32_t DEFAULT_RATE_PER_SEC = 5;         // 每VM令牌补充速率（条/秒）
+    static const uint32_t DEFAULT_WINDOW_MS = 1000;         // 被限流故障的聚合窗口
+
 private:
-    uint32_t exceptionCount;    // 异常计数器
-    
+    MpscRing<S_VmFault> faultQueue;                         // 待处理故障
+    std::atomic<bool> isRunning;                            // 处理线程运行状态
+    std::thread handlerThread;                              // 处理线程
+
+    std::atomic<uint32_t> exceptionCount;                   // 已上报的故障数
+    std::atomic<uint64_t> droppedFaults;                    // 队列满丢弃的故障数
+    uint64_t processedFaults;                               // 已处理的故障数
+    uint64_t loggedFaults;                                  // 逐条记录的故障数
+    uint64_t suppressedFaults;                              // 被限流聚合的故障数
+    uint64_t actionCounts[static_cast<size_t>(VmControlAction::COUNT)]; // 按动作统计的策略执行次数
+
+    std::atomic<uint8_t> policies[static_cast<size_t>(VmFaultCode::COUNT)]; // 按故障码索引的策略（VmControlAction）
+    std::atomic<uint32_t> rateBurst;                        // 令牌桶容量
+    std::atomic<uint32_t> ratePerSec;                       // 令牌补充速率
+    std::atomic<uint32_t> windowMs;                         // 聚合窗口
+
+    std::map<uint32_t, S_FaultRateState> rateStates;        // 按VM的限流状态
+    mutable std::mutex processMutex;                        // 保护限流状态与处理统计
+
+    std::map<uint32_t, std::weak_ptr<I_VmInterface>> vmTable; // 策略动作的目标VM
+    mutable std::mutex vmMutex;                             // 保护vmTable
+
+    std::atomic<OperationLog*> operationLog;                // 策略动作的审计日志（可为空）
+
+    void handlerLoop(int coreId);
+    void processFault(const S_VmFault& fault, uint64_t nowNs);
+    void flushWindows(uint64_t nowNs, bool force);
+    void applyPolicy(const S_VmFault& fault, VmControlAction action);
+
 public:
     ExceptionManager();
-    
+    ~ExceptionManager();
+    ExceptionManager(const ExceptionManager&) = delete;
+    ExceptionManager& operator=(const ExceptionManager&) = delete;
+
+    /**
+     * @brief 启动故障处理线程
+     * @param coreId 绑定的核心，-1表示不绑定
+     */
+    void start(int coreId = DEFAULT_HANDLER_CORE);
+
+    /**
+     * @brief 停止处理线程（先处理完队列中剩余的故障）
+     */
+    void stop();
+
     /**
-     * @brief 处理VM异常
+     * @brief 上报VM故障（任意线程，无锁，不等待处理完成）
+     * @param fault 故障记录（通常来自I_VmInterface::getLastFault()）
+     * @return bool 队列已满、故障被丢弃时返回false
+     */
+    bool handleVmFault(const S_VmFault& fault);
+
+    /**
+     * @brief 处理VM异常（按名称上报的旧接口，名称先转换为故障码再上报）
      * @param vmId 发生异常的VM标识符
      * @param exceptionType 异常类型
      */
     void handleVmException(uint32_t vmId, const std::string& exceptionType);
-    
+
     /**
-     * @brief 处理内存越界异常
-     * @param vmId VM标识符
+     * @brief 登记/注销策略动作的目标VM
      */
-    void handleMemoryViolation(uint32_t vmId);
-    
+    void attachVm(const std::shared_ptr<I_VmInterface>& vm);
+    void detachVm(uint32_t vmId);
+
+    /**
+     * @brief 设置审计日志，暂停/终止/隔离VM的策略动作写入防篡改操作日志
+     */
+    void setOperationLog(OperationLog* log);
+
     /**
-     * @brief 处理资源超时异常
-     * @param vmId VM标识符
+     * @brief 设置故障码对应的策略动作
      */
-    void handleResourceTimeout(uint32_t vmId);
-    
+    void setPolicy(VmFaultCode code, VmControlAction action);
+    VmControlAction getPolicy(VmFaultCode code) const;
+
     /**
-     * @brief 处理无效指令异常
-     * @param vmId VM标识符
+     * @brief 设置每VM日志限流参数
+     * @param burst 令牌桶容量
+     * @param perSec 每秒补充的令牌数
+     * @param window 被限流故障的聚合窗口（毫秒）
      */
-    void handleInvalidInstruction(uint32_t vmId);
-    
+    void setRateLimit(uint32_t burst, uint32_t perSec, uint32_t window);
+
     /**
      * @brief 记录异常日志
-     * @param vmId VM标识符
-     * @param exceptionType 异常类型
+     * @param fault 故障记录
+     * @param action 本次执行的策略动作
      */
-    void logException(uint32_t vmId, const std::string& exceptionType);
-    
+    void logException(const S_VmFault& fault, VmControlAction action);
+
     // Getter方法
     uint32_t getExceptionCount() const;
     void resetExceptionCount();
+    std::string getStatistics() const;
 };
 
-#endif // EXCEPTION_HANDLER_H
\ No newline at end of file
+#endif // EXCEPTION_HANDLER_H
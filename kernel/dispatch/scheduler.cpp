@@ -4,10 +4,30 @@
 #include <chrono>
 #include <sstream>
 
-Scheduler::Scheduler() : isRunning(false), totalCores(0), vmCoreCount(0) {}
+Scheduler::Scheduler() : isRunning(false), totalCores(0), vmCoreCount(0), wakeupRequests(0),
+                         timerFastForwards(0), exceptionManager(nullptr), sliceFaults(0),
+                         reclaimRequests(0), reclaimCompleted(0), coreReclaims(0),
+                         slicesExecuted(0), sliceTotalNs(0), sliceMaxNs(0), tenantThrottles(0) {
+    for (auto& bucket : sliceBuckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
 
 Scheduler::~Scheduler() {
     stop();
+    
+    // 调度器未启动过时stop()直接返回，这里同样摘除唤醒钩子
+    for (auto& binding : staticBindings) {
+        if (binding.vmPtr) {
+            binding.vmPtr->getInterruptController().setWakeupTarget(nullptr);
+        }
+    }
+    while (!dynamicQueue.empty()) {
+        if (dynamicQueue.front().vmPtr) {
+            dynamicQueue.front().vmPtr->getInterruptController().setWakeupTarget(nullptr);
+        }
+        dynamicQueue.pop();
+    }
 }
 
 bool Scheduler::initialize() {
@@ -29,6 +49,11 @@ bool Scheduler::initialize() {
         corePool[i].isActive = false;
     }
     
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        publishSnapshot();
+    }
+    
     std::cout << "Scheduler initialized: " << vmCoreCount 
               << " cores available for VM scheduling (cores " 
               << CORE_START_INDEX << "-" << (CORE_START_INDEX + vmCoreCount - 1) << ")" << std::endl;
@@ -59,17 +84,23 @@ void Scheduler::stop() {
         schedulerThread.join();
     }
     
-    // 停止所有VM
+    // 停止所有VM，并摘除指向本调度器的唤醒钩子
     for (auto& binding : staticBindings) {
-        if (binding.vmPtr && binding.vmPtr->getRunningStatus()) {
-            binding.vmPtr->stop();
+        if (binding.vmPtr) {
+            binding.vmPtr->getInterruptController().setWakeupTarget(nullptr);
+            if (binding.vmPtr->getRunningStatus()) {
+                binding.vmPtr->stop();
+            }
         }
     }
     
     while (!dynamicQueue.empty()) {
         auto vmInfo = dynamicQueue.front();
-        if (vmInfo.vmPtr && vmInfo.vmPtr->getRunningStatus()) {
-            vmInfo.vmPtr->stop();
+        if (vmInfo.vmPtr) {
+            vmInfo.vmPtr->getInterruptController().setWakeupTarget(nullptr);
+            if (vmInfo.vmPtr->getRunningStatus()) {
+                vmInfo.vmPtr->stop();
+            }
         }
         dynamicQueue.pop();
     }
@@ -77,7 +108,7 @@ void Scheduler::stop() {
     std::cout << "Scheduler stopped" << std::endl;
 }
 
-bool Scheduler::addVm(std::shared_ptr<X86Vm> vm, uint32_t priority) {
+bool Scheduler::addVm(std::shared_ptr<I_VmInterface> vm, uint32_t priority, uint32_t tenantId) {
     if (!vm) {
         return false;
     }
@@ -91,14 +122,99 @@ bool Scheduler::addVm(std::shared_ptr<X86Vm> vm, uint32_t priority) {
     vmInfo.lastExecutionTime = 0;
     vmInfo.isStaticBound = false;
     vmInfo.boundCoreId = 0;
+    vmInfo.tenantId = tenantId;
     
+    vm->getInterruptController().setWakeupTarget(this);
     dynamicQueue.push(vmInfo);
+    publishSnapshot();
     std::cout << "VM " << vmInfo.vmId << " added to dynamic scheduling queue" << std::endl;
     
     scheduleCV.notify_one();
     return true;
 }
 
+bool Scheduler::removeVm(uint32_t vmId) {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    
+    bool found = false;
+    std::queue<S_VmScheduleInfo> tempQueue;
+    while (!dynamicQueue.empty()) {
+        S_VmScheduleInfo vmInfo = dynamicQueue.front();
+        dynamicQueue.pop();
+        if (vmInfo.vmId == vmId) {
+            if (vmInfo.vmPtr) {
+                vmInfo.vmPtr->getInterruptController().setWakeupTarget(nullptr);
+            }
+            found = true;
+        } else {
+            tempQueue.push(vmInfo);
+        }
+    }
+    dynamicQueue = tempQueue;
+    
+    for (auto it = staticBindings.begin(); it != staticBindings.end(); ++it) {
+        if (it->vmId == vmId) {
+            if (it->vmPtr) {
+                it->vmPtr->getInterruptController().setWakeupTarget(nullptr);
+            }
+            releaseCoreLock(it->boundCoreId);
+            staticBindings.erase(it);
+            found = true;
+            break;
+        }
+    }
+    if (found) {
+        publishSnapshot();
+    }
+    return found;
+}
+
+void Scheduler::setTenantQuota(uint32_t tenantId, uint32_t slicesPerPeriod) {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    S_TenantQuota& quota = tenantQuotas[tenantId];
+    quota.slicesPerPeriod = slicesPerPeriod;
+}
+
+bool Scheduler::getTenantQuota(uint32_t tenantId, S_TenantQuota& quota) const {
+    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(schedulerMutex));
+    auto it = tenantQuotas.find(tenantId);
+    if (it == tenantQuotas.end()) {
+        return false;
+    }
+    quota = it->second;
+    return true;
+}
+
+bool Scheduler::chargeTenant(uint32_t tenantId) {
+    if (tenantId == 0) {
+        return true;
+    }
+    auto it = tenantQuotas.find(tenantId);
+    if (it == tenantQuotas.end()) {
+        return true;
+    }
+    S_TenantQuota& quota = it->second;
+    uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (now - quota.periodStartMs >= TENANT_PERIOD_MS) {
+        quota.periodStartMs = now;
+        quota.usedSlices = 0;
+    }
+    if (quota.slicesPerPeriod != 0 && quota.usedSlices >= quota.slicesPerPeriod) {
+        quota.throttled++;
+        tenantThrottles++;
+        return false;
+    }
+    quota.usedSlices++;
+    quota.totalSlices++;
+    return true;
+}
+
+void Scheduler::notifyVmWakeup() {
+    wakeupRequests.fetch_add(1, std::memory_order_release);
+    scheduleCV.notify_one();
+}
+
 bool Scheduler::applyStaticCore(uint32_t vmId, uint32_t coreId) {
     // 检查核心ID合法性
     if (coreId < CORE_START_INDEX || coreId >= totalCores) {
@@ -161,6 +277,7 @@ bool Scheduler::applyStaticCore(uint32_t vmId, uint32_t coreId) {
     // 锁定核心
     corePool[poolIndex].lockStatus = GilLockStatus::LOCKED;
     corePool[poolIndex].boundVmId = vmId;
+    publishSnapshot();
     
     std::cout << "VM " << vmId << " statically bound to core " << coreId << std::endl;
     return true;
@@ -193,11 +310,62 @@ bool Scheduler::releaseStaticCore(uint32_t vmId) {
     
     // 移除静态绑定
     staticBindings.erase(it);
+    publishSnapshot();
     
     std::cout << "VM " << vmId << " released from core " << coreId << std::endl;
     return true;
 }
 
+bool Scheduler::requestCoreReclaim(uint32_t coreId) {
+    if (coreId < CORE_START_INDEX || coreId >= totalCores || coreId >= 64) {
+        return false;
+    }
+    reclaimRequests.fetch_or(1ULL << coreId, std::memory_order_release);
+    notifyVmWakeup();
+    return true;
+}
+
+bool Scheduler::consumeReclaimCompletion(uint32_t coreId) {
+    if (coreId >= 64) {
+        return false;
+    }
+    uint64_t bit = 1ULL << coreId;
+    return (reclaimCompleted.fetch_and(~bit, std::memory_order_acq_rel) & bit) != 0;
+}
+
+void Scheduler::processCoreReclaims() {
+    uint64_t requests = reclaimRequests.exchange(0, std::memory_order_acquire);
+    if (requests == 0) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    for (auto it = staticBindings.begin(); it != staticBindings.end();) {
+        // 回收位图只覆盖前64个核心，更高编号的核心不会被请求回收
+        if (it->boundCoreId >= 64 || !(requests & (1ULL << it->boundCoreId))) {
+            ++it;
+            continue;
+        }
+        
+        // 调度线程是静态绑定VM的执行者，此时VM空闲，直接执行强制停止
+        if (it->vmPtr) {
+            it->vmPtr->requestControl(VmControlAction::KILL);
+            it->vmPtr->applyControlIfIdle();
+            it->vmPtr->getInterruptController().setWakeupTarget(nullptr);
+        }
+        uint32_t poolIndex = it->boundCoreId - CORE_START_INDEX;
+        corePool[poolIndex].lockStatus = GilLockStatus::UNLOCKED;
+        corePool[poolIndex].boundVmId = 0;
+        std::cout << "Core " << it->boundCoreId << " reclaimed from VM " << it->vmId << std::endl;
+        it = staticBindings.erase(it);
+        coreReclaims++;
+    }
+    publishSnapshot();
+    
+    // 未绑定的核心同样视为回收完成
+    reclaimCompleted.fetch_or(requests, std::memory_order_release);
+}
+
 S_CoreStatus Scheduler::getCoreStatus(uint32_t coreId) const {
     if (coreId < CORE_START_INDEX || coreId >= totalCores) {
         return S_CoreStatus(); // 返回默认状态
@@ -209,39 +377,108 @@ S_CoreStatus Scheduler::getCoreStatus(uint32_t coreId) const {
 }
 
 std::string Scheduler::getStatistics() const {
-    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(schedulerMutex));
+    // 只读取顺序锁快照与直方图计数，不获取调度器锁
+    S_SchedulerSnapshot current = getSnapshot();
+    S_SliceHistogram histogram = getSliceHistogram();
     
     std::ostringstream oss;
     oss << "=== Scheduler Statistics ===" << std::endl;
     oss << "Total Cores: " << totalCores << std::endl;
-    oss << "VM Cores Available: " << vmCoreCount << std::endl;
-    oss << "Static Bindings: " << staticBindings.size() << std::endl;
-    oss << "Dynamic Queue Size: " << dynamicQueue.size() << std::endl;
+    oss << "VM Cores Available: " << current.counters.vmCores << std::endl;
+    oss << "Static Bindings: " << current.counters.staticBindings << std::endl;
+    oss << "Dynamic Queue Size: " << current.counters.queuedVms << std::endl;
+    oss << "Timer Fast-Forwards: " << current.counters.timerFastForwards << std::endl;
+    oss << "Slice Faults: " << current.counters.sliceFaults << std::endl;
+    oss << "Core Reclaims: " << current.counters.coreReclaims << std::endl;
+    oss << "Slices Executed: " << current.counters.slicesExecuted << std::endl;
+    oss << "Tenant Throttles: " << current.counters.tenantThrottles << std::endl;
+    if (histogram.count > 0) {
+        oss << "Slice Time: avg " << (histogram.totalNs / histogram.count) << " ns, p50 <= "
+            << histogram.percentileNs(0.5) << " ns, p99 <= " << histogram.percentileNs(0.99)
+            << " ns, max " << histogram.maxNs << " ns" << std::endl;
+    }
     oss << "Core Status:" << std::endl;
     
-    for (uint32_t i = 0; i < vmCoreCount; i++) {
-        const auto& core = corePool[i];
-        oss << "  Core " << core.coreId << ": ";
-        oss << (core.lockStatus == GilLockStatus::LOCKED ? "LOCKED" : "FREE");
-        if (core.lockStatus == GilLockStatus::LOCKED) {
-            oss << " (VM " << core.boundVmId << ")";
+    for (uint32_t i = 0; i < current.coreCount; i++) {
+        oss << "  Core " << (current.firstCoreId + i) << ": ";
+        if (current.coreOwners[i] != 0) {
+            oss << "LOCKED (VM " << current.coreOwners[i] << ")";
+        } else {
+            oss << "FREE";
         }
         oss << std::endl;
     }
+    if (current.counters.vmCores > current.coreCount) {
+        oss << "  (" << (current.counters.vmCores - current.coreCount) << " more cores not shown)" << std::endl;
+    }
     
     return oss.str();
 }
 
+S_SchedulerCounters Scheduler::getCounters() const {
+    return getSnapshot().counters;
+}
+
+S_SchedulerSnapshot Scheduler::getSnapshot() const {
+    S_SchedulerSnapshot result = snapshot.load();
+    result.counters.running = isRunning.load();
+    return result;
+}
+
+S_SliceHistogram Scheduler::getSliceHistogram() const {
+    S_SliceHistogram histogram;
+    for (uint32_t i = 0; i < SLICE_HISTOGRAM_BUCKETS; i++) {
+        histogram.buckets[i] = sliceBuckets[i].load(std::memory_order_relaxed);
+        histogram.count += histogram.buckets[i];
+    }
+    histogram.totalNs = sliceTotalNs.load(std::memory_order_relaxed);
+    histogram.maxNs = sliceMaxNs.load(std::memory_order_relaxed);
+    return histogram;
+}
+
+void Scheduler::recordSliceTime(uint64_t elapsedNs) {
+    // 只有调度线程写入，load+store即可，不需要原子读改写
+    uint32_t bucket = 0;
+    while (bucket + 1 < SLICE_HISTOGRAM_BUCKETS && (elapsedNs >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+    sliceBuckets[bucket].store(sliceBuckets[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sliceTotalNs.store(sliceTotalNs.load(std::memory_order_relaxed) + elapsedNs, std::memory_order_relaxed);
+    if (elapsedNs > sliceMaxNs.load(std::memory_order_relaxed)) {
+        sliceMaxNs.store(elapsedNs, std::memory_order_relaxed);
+    }
+}
+
+void Scheduler::publishSnapshot() {
+    S_SchedulerSnapshot next;
+    next.counters.vmCores = vmCoreCount;
+    next.counters.staticBindings = static_cast<uint32_t>(staticBindings.size());
+    next.counters.queuedVms = static_cast<uint32_t>(dynamicQueue.size());
+    next.counters.timerFastForwards = timerFastForwards;
+    next.counters.sliceFaults = sliceFaults;
+    next.counters.coreReclaims = coreReclaims;
+    next.counters.slicesExecuted = slicesExecuted;
+    next.counters.tenantThrottles = tenantThrottles;
+    next.firstCoreId = CORE_START_INDEX;
+    next.coreCount = std::min(vmCoreCount, SCHED_SNAPSHOT_MAX_CORES);
+    for (uint32_t i = 0; i < next.coreCount; i++) {
+        next.coreOwners[i] = corePool[i].lockStatus == GilLockStatus::LOCKED ? corePool[i].boundVmId : 0;
+    }
+    snapshot.store(next);
+}
+
 void Scheduler::schedulerLoop() {
     while (isRunning) {
         {
             std::unique_lock<std::mutex> lock(schedulerMutex);
             scheduleCV.wait_for(lock, std::chrono::milliseconds(TIME_SLICE_MS),
-                               [this] { return !isRunning; });
+                               [this] { return !isRunning || wakeupRequests.load() != 0; });
         }
+        wakeupRequests.store(0, std::memory_order_relaxed);
         
         if (!isRunning) break;
         
+        processCoreReclaims();
         executeStaticBindings();
         executeDynamicScheduling();
         checkTimeoutVms();
@@ -256,8 +493,10 @@ void Scheduler::executeDynamicScheduling() {
     }
     
     // 按优先级排序（简单实现：优先级数字小的优先）
+    // 取出整个队列，执行后再依次放回
     std::vector<S_VmScheduleInfo> sortedVms;
-    std::queue<S_VmScheduleInfo> tempQueue = dynamicQueue;
+    std::queue<S_VmScheduleInfo> tempQueue;
+    tempQueue.swap(dynamicQueue);
     
     while (!tempQueue.empty()) {
         sortedVms.push_back(tempQueue.front());
@@ -271,7 +510,10 @@ void Scheduler::executeDynamicScheduling() {
     
     // 执行动态调度
     for (auto& vmInfo : sortedVms) {
-        if (!isRunning) break;
+        if (!isRunning || !isVmRunnable(vmInfo)) {
+            dynamicQueue.push(vmInfo);
+            continue;
+        }
         
         int coreId = getAvailableCore();
         if (coreId == -1) {
@@ -280,11 +522,18 @@ void Scheduler::executeDynamicScheduling() {
             continue;
         }
         
+        // 租户本周期配额已用完：留在队列中，下一周期再执行
+        if (!chargeTenant(vmInfo.tenantId)) {
+            dynamicQueue.push(vmInfo);
+            continue;
+        }
+        
         uint32_t poolIndex = coreId - CORE_START_INDEX;
         
         // 绑定核心
         corePool[poolIndex].lockStatus = GilLockStatus::LOCKED;
         corePool[poolIndex].boundVmId = vmInfo.vmId;
+        publishSnapshot();
         
         // 设置线程亲和性
         if (SetThreadCPUAffinity(coreId) != 0) {
@@ -292,20 +541,14 @@ void Scheduler::executeDynamicScheduling() {
         }
         
         // 执行VM时间片
-        if (vmInfo.vmPtr) {
-            if (!vmInfo.vmPtr->getRunningStatus()) {
-                vmInfo.vmPtr->start();
-            }
-            vmInfo.vmPtr->runOneSlice();
-            vmInfo.lastExecutionTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now().time_since_epoch()).count();
-        }
+        runVmSlice(vmInfo);
         
         // 释放核心
         releaseCoreLock(coreId);
         
         // 放回队列末尾
         dynamicQueue.push(vmInfo);
+        publishSnapshot();
     }
 }
 
@@ -324,23 +567,91 @@ void Scheduler::executeStaticBindings() {
             continue;
         }
         
+        if (!isVmRunnable(binding) || !chargeTenant(binding.tenantId)) {
+            continue;
+        }
+        
         // 设置线程亲和性
         if (SetThreadCPUAffinity(coreId) != 0) {
             std::cerr << "Warning: Failed to set thread affinity to core " << coreId << std::endl;
         }
         
         // 执行VM时间片
-        if (binding.vmPtr) {
-            if (!binding.vmPtr->getRunningStatus()) {
-                binding.vmPtr->start();
-            }
-            binding.vmPtr->runOneSlice();
-            binding.lastExecutionTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now().time_since_epoch()).count();
+        runVmSlice(binding);
+    }
+    publishSnapshot();
+}
+
+void Scheduler::setExceptionManager(ExceptionManager* manager) {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    exceptionManager = manager;
+}
+
+void Scheduler::runVmSlice(S_VmScheduleInfo& vmInfo) {
+    if (!vmInfo.vmPtr) {
+        return;
+    }
+    
+    auto sliceStart = std::chrono::steady_clock::now();
+    VmFaultCode fault = VmFaultCode::NONE;
+    if (!vmInfo.vmPtr->getRunningStatus()) {
+        // 启动同样需要执行权；runOneSlice自行获取执行权，这里的声明在其之前释放
+        VmExecutionGuard guard(*vmInfo.vmPtr);
+        if (!guard.owns()) {
+            return;
+        }
+        fault = vmInfo.vmPtr->start();
+    }
+    if (fault == VmFaultCode::NONE) {
+        fault = vmInfo.vmPtr->runOneSlice();
+    }
+    vmInfo.vmPtr->publishStatus();
+    auto sliceEnd = std::chrono::steady_clock::now();
+    recordSliceTime(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(sliceEnd - sliceStart).count()));
+    vmInfo.lastExecutionTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        sliceEnd.time_since_epoch()).count();
+    slicesExecuted++;
+    
+    if (fault != VmFaultCode::NONE) {
+        sliceFaults++;
+        if (exceptionManager) {
+            exceptionManager->handleVmFault(vmInfo.vmPtr->getLastFault());
         }
     }
 }
 
+bool Scheduler::isVmRunnable(const S_VmScheduleInfo& vmInfo) {
+    if (!vmInfo.vmPtr) {
+        return false;
+    }
+    // 停机中的VM没有时间片边界，控制请求在此生效，保证在一个调度节拍内完成
+    if (vmInfo.vmPtr->hasPendingControl()) {
+        vmInfo.vmPtr->applyControlIfIdle();
+    }
+    // 被故障策略或管理员终端暂停、停止、隔离、封禁的VM不再自动启动
+    if (vmInfo.vmPtr->getControlHold() != VmControlAction::NONE) {
+        return false;
+    }
+    // 载荷已执行完的VM停在末尾，等待手动启动，不再每个节拍重新启动
+    if (vmInfo.vmPtr->hasExited()) {
+        return false;
+    }
+    // 调试器、vm run、模糊测试等持有执行权时跳过：既不推进虚拟时间，也不安排时间片
+    VmExecutionGuard guard(*vmInfo.vmPtr);
+    if (!guard.owns()) {
+        return false;
+    }
+    VirtualInterruptController& controller = vmInfo.vmPtr->getInterruptController();
+    controller.flushExpired();
+    
+    // 定时器处理：停机等待定时器的VM直接把虚拟时间推进到截止点并触发定时器中断
+    if (vmInfo.vmPtr->advanceIdleTime()) {
+        timerFastForwards++;
+    }
+    return !vmInfo.vmPtr->isHalted() || controller.hasDeliverable();
+}
+
 int Scheduler::getAvailableCore() {
     for (uint32_t i = 0; i < vmCoreCount; i++) {
         if (corePool[i].lockStatus == GilLockStatus::UNLOCKED) {
@@ -372,6 +683,10 @@ void Scheduler::checkTimeoutVms() {
     
     // 检查静态绑定VM
     for (auto& binding : staticBindings) {
+        // 停机等待中断的VM不执行是正常的
+        if (binding.vmPtr && binding.vmPtr->isHalted()) {
+            continue;
+        }
         if (currentTime - binding.lastExecutionTime > TIMEOUT_THRESHOLD) {
             std::cout << "Warning: VM " << binding.vmId << " may be timeout" << std::endl;
             // 实际项目中可以采取暂停、重启或其他措施
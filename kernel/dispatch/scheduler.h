@@ -4,12 +4,15 @@
 #include <cstdint>
 #include <vector>
 #include <queue>
+#include <map>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
 #include <atomic>
 #include "../Cross_PlatformUnifiedMacro.h"
-#include "../CPUvm/x86Vm.h"
+#include "../CPUvm/baseVM.h"
+#include "../common/seqlock.h"
+#include "exception_handler.h"
 
 /**
  * @brief GIL锁状态枚举
@@ -53,24 +56,116 @@ struct S_CoreStatus {
  */
 struct S_VmScheduleInfo {
     uint32_t vmId;                      // VM ID
-    std::shared_ptr<X86Vm> vmPtr;       // VM智能指针
+    std::shared_ptr<I_VmInterface> vmPtr; // VM智能指针
     uint32_t priority;                  // 优先级（数值越小优先级越高）
     uint64_t lastExecutionTime;         // 上次执行时间戳
     bool isStaticBound;                 // 是否静态绑定核心
     uint32_t boundCoreId;               // 绑定的核心ID
+    uint32_t tenantId;                  // 所属租户（0表示不受租户配额限制）
     
     S_VmScheduleInfo() : vmId(0), priority(10), lastExecutionTime(0), 
-                        isStaticBound(false), boundCoreId(0) {}
+                        isStaticBound(false), boundCoreId(0), tenantId(0) {}
+};
+
+/**
+ * @brief 租户时间片配额（同一租户的所有VM共用）
+ * @details 每个配额周期内租户最多执行slicesPerPeriod个时间片，用完后本周期内其VM留在队列中跳过
+ */
+struct S_TenantQuota {
+    uint32_t slicesPerPeriod;           // 每周期时间片上限（0表示不限）
+    uint32_t usedSlices;                // 本周期已执行的时间片数
+    uint64_t periodStartMs;             // 本周期开始时间
+    uint64_t totalSlices;               // 累计执行的时间片数
+    uint64_t throttled;                 // 因配额用完被跳过的次数
+    
+    S_TenantQuota() : slicesPerPeriod(0), usedSlices(0), periodStartMs(0), totalSlices(0), throttled(0) {}
+};
+
+/**
+ * @brief 调度器计数快照（供程序读取，getStatistics()的结构化版本）
+ */
+struct S_SchedulerCounters {
+    bool running;                       // 调度器运行状态
+    uint32_t vmCores;                   // VM可用核心数
+    uint32_t staticBindings;            // 静态绑定数
+    uint32_t queuedVms;                 // 动态调度队列长度
+    uint64_t timerFastForwards;         // 停机VM定时器快进次数
+    uint64_t sliceFaults;               // 时间片故障次数
+    uint64_t coreReclaims;              // 核心回收次数
+    uint64_t slicesExecuted;            // 已执行的时间片数
+    uint64_t tenantThrottles;           // 租户配额用完跳过VM的次数
+    
+    S_SchedulerCounters() : running(false), vmCores(0), staticBindings(0), queuedVms(0),
+                            timerFastForwards(0), sliceFaults(0), coreReclaims(0), slicesExecuted(0),
+                            tenantThrottles(0) {}
+};
+
+static const uint32_t SCHED_SNAPSHOT_MAX_CORES = 64;   // 快照记录的VM核心数上限
+static const uint32_t SLICE_HISTOGRAM_BUCKETS = 32;    // 时间片耗时直方图桶数（按2的幂分桶）
+
+/**
+ * @brief 时间片耗时直方图
+ * @details 桶i统计耗时在[2^i, 2^(i+1))纳秒内的时间片（桶0含0），最后一个桶包含更长的时间片
+ */
+struct S_SliceHistogram {
+    uint64_t count;                                 // 时间片数
+    uint64_t totalNs;                               // 总耗时
+    uint64_t maxNs;                                 // 最长耗时
+    uint64_t buckets[SLICE_HISTOGRAM_BUCKETS];      // 各桶计数
+    
+    S_SliceHistogram() : count(0), totalNs(0), maxNs(0) {
+        for (uint32_t i = 0; i < SLICE_HISTOGRAM_BUCKETS; i++) {
+            buckets[i] = 0;
+        }
+    }
+    
+    /**
+     * @brief 估算分位数（返回所在桶的上界）
+     * @param fraction 分位（0~1）
+     */
+    uint64_t percentileNs(double fraction) const {
+        if (count == 0) {
+            return 0;
+        }
+        uint64_t target = static_cast<uint64_t>(fraction * static_cast<double>(count));
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < SLICE_HISTOGRAM_BUCKETS; i++) {
+            seen += buckets[i];
+            if (seen > target) {
+                return i + 1 < SLICE_HISTOGRAM_BUCKETS ? (1ULL << (i + 1)) : maxNs;
+            }
+        }
+        return maxNs;
+    }
+};
+
+/**
+ * @brief 调度器状态快照（顺序锁发布，读取方无锁）
+ * @details 调度线程在核心归属或计数变化时发布，status/watch等观察方读取时不获取调度器锁，
+ *          不会与调度争用
+ */
+struct S_SchedulerSnapshot {
+    S_SchedulerCounters counters;       // 计数（running字段读取时取实时值）
+    uint32_t firstCoreId;               // coreOwners[0]对应的核心ID
+    uint32_t coreCount;                 // 有效的coreOwners项数
+    uint32_t coreOwners[SCHED_SNAPSHOT_MAX_CORES]; // 各VM核心当前绑定的VM（0表示空闲）
+    
+    S_SchedulerSnapshot() : firstCoreId(0), coreCount(0) {
+        for (uint32_t i = 0; i < SCHED_SNAPSHOT_MAX_CORES; i++) {
+            coreOwners[i] = 0;
+        }
+    }
 };
 
 /**
  * @brief 调度器类，负责VM的调度和核心管理
  * @details 实现GIL式核锁保护和时间片调度机制
  */
-class Scheduler {
+class Scheduler : public I_InterruptWakeupTarget {
 private:
     static const uint32_t TIME_SLICE_MS = 10;       // 时间片大小（毫秒）
     static const uint32_t CORE_START_INDEX = 2;     // VM可用核心起始索引
+    static const uint32_t TENANT_PERIOD_MS = 1000;  // 租户配额周期（毫秒）
     
     std::vector<S_CoreStatus> corePool;             // 核心池
     std::queue<S_VmScheduleInfo> dynamicQueue;      // 动态调度队列
@@ -81,6 +176,20 @@ private:
     std::thread schedulerThread;                    // 调度器线程
     uint32_t totalCores;                            // 总核心数
     uint32_t vmCoreCount;                           // VM可用核心数
+    std::atomic<uint32_t> wakeupRequests;           // 未处理的停机VM唤醒请求
+    uint64_t timerFastForwards;                     // 停机VM虚拟时间推进到定时器截止点的次数
+    ExceptionManager* exceptionManager;             // 时间片故障上报目标（可为空）
+    uint64_t sliceFaults;                           // 时间片返回的故障次数
+    std::atomic<uint64_t> reclaimRequests;          // 待回收核心位图（管理员终端无锁置位）
+    std::atomic<uint64_t> reclaimCompleted;         // 已完成回收的核心位图（管理员终端确认后清除）
+    uint64_t coreReclaims;                          // 已回收的核心次数
+    uint64_t slicesExecuted;                        // 已执行的时间片数
+    SeqLock<S_SchedulerSnapshot> snapshot;          // 观察方读取的状态快照（持有调度器锁时发布）
+    std::atomic<uint64_t> sliceBuckets[SLICE_HISTOGRAM_BUCKETS]; // 时间片耗时直方图（调度线程独写）
+    std::atomic<uint64_t> sliceTotalNs;             // 时间片总耗时
+    std::atomic<uint64_t> sliceMaxNs;               // 最长时间片耗时
+    std::map<uint32_t, S_TenantQuota> tenantQuotas; // 租户配额（按租户ID索引，持有调度器锁访问）
+    uint64_t tenantThrottles;                       // 租户配额用完跳过VM的次数
     
 public:
     Scheduler();
@@ -106,9 +215,42 @@ public:
      * @brief 添加VM到调度器
      * @param vm VM智能指针
      * @param priority 优先级
+     * @param tenantId 所属租户（0表示不受租户配额限制）
      * @return bool 添加成功返回true
      */
-    bool addVm(std::shared_ptr<X86Vm> vm, uint32_t priority = 10);
+    bool addVm(std::shared_ptr<I_VmInterface> vm, uint32_t priority = 10, uint32_t tenantId = 0);
+    
+    /**
+     * @brief 从调度器移除VM（动态队列或静态绑定），释放其核心
+     * @details 等待正在进行的一轮调度结束后移除，返回后调度器不再执行该VM
+     * @return bool VM不在调度器中返回false
+     */
+    bool removeVm(uint32_t vmId);
+    
+    /**
+     * @brief 设置租户每个配额周期（TENANT_PERIOD_MS）可执行的时间片数
+     * @param tenantId 租户ID（非0）
+     * @param slicesPerPeriod 时间片上限，0表示不限
+     */
+    void setTenantQuota(uint32_t tenantId, uint32_t slicesPerPeriod);
+    
+    /**
+     * @brief 查询租户配额与用量
+     * @return bool 租户从未设置过配额时返回false
+     */
+    bool getTenantQuota(uint32_t tenantId, S_TenantQuota& quota) const;
+    
+    /**
+     * @brief 通知调度器有停机VM收到中断（中断控制器唤醒钩子调用，无锁）
+     * @details 调度线程立即开始下一轮调度，而不必等到时间片节拍
+     */
+    void notifyVmWakeup() override;
+    
+    /**
+     * @brief 设置时间片故障的上报目标
+     * @param manager 异常管理器，传nullptr则只计数不上报
+     */
+    void setExceptionManager(ExceptionManager* manager);
     
     /**
      * @brief 申请静态核心绑定
@@ -125,6 +267,20 @@ public:
      */
     bool releaseStaticCore(uint32_t vmId);
     
+    /**
+     * @brief 请求回收核心（管理员终端调用，无锁）
+     * @details 调度线程在下一个调度节拍开始时强制停止绑定在该核心上的VM并解除绑定
+     * @param coreId 核心ID（小于64）
+     * @return bool 核心ID不在VM核池内返回false
+     */
+    bool requestCoreReclaim(uint32_t coreId);
+    
+    /**
+     * @brief 查询并清除核心回收完成标志
+     * @return bool 核心回收已完成返回true
+     */
+    bool consumeReclaimCompletion(uint32_t coreId);
+    
     /**
      * @brief 获取核心状态
      * @param coreId 核心ID
@@ -138,12 +294,35 @@ public:
      */
     std::string getStatistics() const;
     
+    /**
+     * @brief 获取调度器计数（读取顺序锁快照，不获取调度器锁）
+     * @return S_SchedulerCounters 计数快照
+     */
+    S_SchedulerCounters getCounters() const;
+    
+    /**
+     * @brief 获取核心归属与计数快照（不获取调度器锁）
+     * @return S_SchedulerSnapshot 状态快照
+     */
+    S_SchedulerSnapshot getSnapshot() const;
+    
+    /**
+     * @brief 获取时间片耗时直方图（不获取调度器锁，各计数分别读取）
+     * @return S_SliceHistogram 直方图
+     */
+    S_SliceHistogram getSliceHistogram() const;
+    
 private:
     /**
      * @brief 调度器主循环
      */
     void schedulerLoop();
     
+    /**
+     * @brief 处理管理员终端的核心回收请求
+     */
+    void processCoreReclaims();
+    
     /**
      * @brief 执行动态调度
      */
@@ -170,6 +349,35 @@ private:
      * @brief 检查并处理超时VM
      */
     void checkTimeoutVms();
+    
+    /**
+     * @brief 判断VM本轮是否需要占用核心
+     * @details 先冲刷到期的合并中断并处理停机VM的定时器，
+     *          仍停机且无可投递中断的VM跳过
+     */
+    bool isVmRunnable(const S_VmScheduleInfo& vmInfo);
+    
+    /**
+     * @brief 为VM所属租户扣除一个时间片（调用方持有调度器锁）
+     * @return bool 租户本周期配额已用完返回false，VM本轮跳过
+     */
+    bool chargeTenant(uint32_t tenantId);
+    
+    /**
+     * @brief 记录一个时间片的耗时（调度线程调用）
+     */
+    void recordSliceTime(uint64_t elapsedNs);
+    
+    /**
+     * @brief 执行VM的一个时间片并上报返回的故障码
+     * @param vmInfo VM调度信息
+     */
+    void runVmSlice(S_VmScheduleInfo& vmInfo);
+    
+    /**
+     * @brief 发布状态快照（调用方持有调度器锁，保证只有一个写者）
+     */
+    void publishSnapshot();
 };
 
 #endif // SCHEDULER_H
\ No newline at end of file
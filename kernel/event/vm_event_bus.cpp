@@ -0,0 +1,180 @@
+#include "vm_event_bus.h"
+#include "../Cross_PlatformUnifiedMacro.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+#ifdef PLATFORM_LINUX
+#include <sys/eventfd.h>
+#endif
+
+const size_t VmEventBus::DEFAULT_CAPACITY;
+
+VmEventSubscription::VmEventSubscription(uint32_t mask, uint32_t vmId, size_t capacity)
+    : ring(capacity), eventFd(-1), typeMask(mask), vmFilter(vmId), notifyPending(false),
+      delivered(0), dropped(0) {
+#ifdef PLATFORM_LINUX
+    eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+}
+
+VmEventSubscription::~VmEventSubscription() {
+#ifdef PLATFORM_LINUX
+    if (eventFd >= 0) {
+        close(eventFd);
+    }
+#endif
+}
+
+void VmEventSubscription::notify() {
+#ifdef PLATFORM_LINUX
+    uint64_t one = 1;
+    if (eventFd >= 0 && write(eventFd, &one, sizeof(one)) < 0) {
+        // 计数溢出之前消费方必然已被唤醒，忽略
+    }
+#endif
+}
+
+void VmEventSubscription::push(const S_VmEvent& event) {
+    if (!ring.tryPush(event)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    delivered.fetch_add(1, std::memory_order_relaxed);
+    // 只有第一个把通知置位的发布方写eventfd
+    if (!notifyPending.exchange(true, std::memory_order_acq_rel)) {
+        notify();
+    }
+}
+
+size_t VmEventSubscription::drain(S_VmEvent* out, size_t maxCount) {
+#ifdef PLATFORM_LINUX
+    // 顺序：清eventfd计数 -> 清通知标志 -> 取事件。清标志之后完成的发布会重新写eventfd，
+    // 清标志之前已置位的发布方的事件在取事件时可见，不会丢失唤醒
+    uint64_t value = 0;
+    if (eventFd >= 0 && read(eventFd, &value, sizeof(value)) < 0) {
+        // 非阻塞eventfd没有计数时返回EAGAIN
+    }
+#endif
+    notifyPending.exchange(false, std::memory_order_acq_rel);
+
+    size_t count = 0;
+    while (count < maxCount && ring.tryPop(out[count])) {
+        count++;
+    }
+    if (!ring.empty() && !notifyPending.exchange(true, std::memory_order_acq_rel)) {
+        notify();
+    }
+    return count;
+}
+
+VmEventBus::VmEventBus()
+    : subscribers(std::make_shared<const SubscriberList>()), subscriberCount(0), publishedCount(0) {
+    for (auto& count : typeCounts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::shared_ptr<VmEventSubscription> VmEventBus::subscribe(uint32_t typeMask, uint32_t vmId, size_t capacity) {
+    std::shared_ptr<VmEventSubscription> subscription =
+        std::make_shared<VmEventSubscription>(typeMask & VM_EVENT_MASK_ALL, vmId, capacity);
+#ifdef PLATFORM_LINUX
+    if (subscription->getEventFd() < 0) {
+        return nullptr;
+    }
+#endif
+
+    std::lock_guard<std::mutex> lock(subscribeMutex);
+    std::shared_ptr<const SubscriberList> current = std::atomic_load(&subscribers);
+    std::shared_ptr<SubscriberList> updated = std::make_shared<SubscriberList>(*current);
+    updated->push_back(subscription);
+    std::atomic_store(&subscribers, std::shared_ptr<const SubscriberList>(updated));
+    subscriberCount.store(static_cast<uint32_t>(updated->size()), std::memory_order_release);
+    return subscription;
+}
+
+void VmEventBus::unsubscribe(const std::shared_ptr<VmEventSubscription>& subscription) {
+    if (!subscription) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(subscribeMutex);
+    std::shared_ptr<const SubscriberList> current = std::atomic_load(&subscribers);
+    std::shared_ptr<SubscriberList> updated = std::make_shared<SubscriberList>(*current);
+    updated->erase(std::remove(updated->begin(), updated->end(), subscription), updated->end());
+    std::atomic_store(&subscribers, std::shared_ptr<const SubscriberList>(updated));
+    subscriberCount.store(static_cast<uint32_t>(updated->size()), std::memory_order_release);
+}
+
+void VmEventBus::onVmEvent(const S_VmEvent& event) {
+    publishedCount.fetch_add(1, std::memory_order_relaxed);
+    if (event.type < static_cast<uint16_t>(VmEventType::COUNT)) {
+        typeCounts[event.type].fetch_add(1, std::memory_order_relaxed);
+    }
+    if (subscriberCount.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+    std::shared_ptr<const SubscriberList> current = std::atomic_load(&subscribers);
+    for (const auto& subscription : *current) {
+        if (subscription->matches(event)) {
+            subscription->push(event);
+        }
+    }
+}
+
+std::string VmEventBus::getStatistics() const {
+    std::shared_ptr<const SubscriberList> current = std::atomic_load(&subscribers);
+    std::ostringstream oss;
+    oss << "=== VM Event Bus ===" << std::endl;
+    oss << "Published: " << publishedCount.load(std::memory_order_relaxed) << std::endl;
+    for (size_t i = 0; i < static_cast<size_t>(VmEventType::COUNT); i++) {
+        oss << "  " << GetVmEventName(static_cast<VmEventType>(i)) << ": "
+            << typeCounts[i].load(std::memory_order_relaxed) << std::endl;
+    }
+    oss << "Subscribers: " << current->size() << std::endl;
+    for (const auto& subscription : *current) {
+        oss << "  mask 0x" << std::hex << subscription->getTypeMask() << std::dec
+            << " vm " << (subscription->getVmFilter() == 0 ? std::string("*")
+                                                            : std::to_string(subscription->getVmFilter()))
+            << " delivered " << subscription->getDelivered()
+            << " dropped " << subscription->getDropped() << std::endl;
+    }
+    return oss.str();
+}
+
+bool ParseVmEventMask(const std::vector<std::string>& names, uint32_t& mask) {
+    static const struct {
+        const char* name;
+        uint32_t mask;
+    } aliases[] = {
+        { "all", VM_EVENT_MASK_ALL },
+        { "halted", 1u << static_cast<uint32_t>(VmEventType::HALTED) },
+        { "fault", 1u << static_cast<uint32_t>(VmEventType::FAULT) },
+        { "limit", 1u << static_cast<uint32_t>(VmEventType::RESOURCE_LIMIT) },
+        { "run", 1u << static_cast<uint32_t>(VmEventType::RUN_COMPLETE) },
+        { "stopped", 1u << static_cast<uint32_t>(VmEventType::STOPPED) },
+        { "swap", 1u << static_cast<uint32_t>(VmEventType::PAYLOAD_SWAPPED) }
+    };
+
+    if (names.empty()) {
+        mask = VM_EVENT_MASK_ALL;
+        return true;
+    }
+    mask = 0;
+    for (const auto& name : names) {
+        std::string lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        bool found = false;
+        for (const auto& alias : aliases) {
+            if (lower == alias.name) {
+                mask |= alias.mask;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,116 @@
+#ifndef VM_EVENT_BUS_H
+#define VM_EVENT_BUS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include "../CPUvm/vmEvent.h"
+#include "../common/lockfree_ring.h"
+
+/**
+ * @brief 一个事件订阅：无锁事件环 + 通知eventfd
+ * @details 任意线程发布（MPSC），只允许一个消费线程调用drain()。
+ *          环从空变为非空时才写eventfd，消费方取空之前不会重复通知，
+ *          大量事件集中到达时每批只有一次系统调用。环满时新事件丢弃并计数。
+ *          eventfd只在Linux上可用，其他平台getEventFd()返回-1，只能轮询drain()。
+ */
+class VmEventSubscription {
+private:
+    MpscRing<S_VmEvent> ring;           // 事件环
+    int eventFd;                        // 通知eventfd（-1表示不支持）
+    uint32_t typeMask;                  // 订阅的事件类型（VmEventMask组合）
+    uint32_t vmFilter;                  // 只接收该VM的事件（0表示全部）
+    std::atomic<bool> notifyPending;    // 已写eventfd、消费方尚未取走
+    std::atomic<uint64_t> delivered;    // 放入环的事件数
+    std::atomic<uint64_t> dropped;      // 环满丢弃的事件数
+
+    void notify();
+
+public:
+    VmEventSubscription(uint32_t mask, uint32_t vmId, size_t capacity);
+    ~VmEventSubscription();
+    VmEventSubscription(const VmEventSubscription&) = delete;
+    VmEventSubscription& operator=(const VmEventSubscription&) = delete;
+
+    bool matches(const S_VmEvent& event) const {
+        return event.type < static_cast<uint16_t>(VmEventType::COUNT) && (typeMask & (1u << event.type)) != 0 &&
+               (vmFilter == 0 || vmFilter == event.vmId);
+    }
+
+    /**
+     * @brief 放入事件（发布线程调用）
+     */
+    void push(const S_VmEvent& event);
+
+    /**
+     * @brief 取出事件（消费线程调用）
+     * @details 先清除通知再取事件；本次没有取完时重新置位通知
+     * @return 取出的事件数
+     */
+    size_t drain(S_VmEvent* out, size_t maxCount);
+
+    int getEventFd() const { return eventFd; }
+    uint32_t getTypeMask() const { return typeMask; }
+    uint32_t getVmFilter() const { return vmFilter; }
+    uint64_t getDelivered() const { return delivered.load(std::memory_order_relaxed); }
+    uint64_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief VM事件总线
+ * @details VM通过I_VmEventSink接口发布停机/故障/资源限制/运行结束/停止事件，总线按订阅的
+ *          类型与VM过滤后放入各订阅的事件环。订阅表写时复制：发布路径只原子读取一次
+ *          表指针，不加锁；没有订阅时直接返回。订阅方把eventfd加入自己的epoll循环，
+ *          不需要轮询线程。
+ */
+class VmEventBus : public I_VmEventSink {
+public:
+    static const size_t DEFAULT_CAPACITY = 4096;    // 默认事件环容量
+
+private:
+    typedef std::vector<std::shared_ptr<VmEventSubscription>> SubscriberList;
+
+    std::shared_ptr<const SubscriberList> subscribers; // 当前订阅表（std::atomic_load/atomic_store访问）
+    std::mutex subscribeMutex;                      // 串行化订阅表修改
+    std::atomic<uint32_t> subscriberCount;          // 订阅数（发布路径快速判断）
+    std::atomic<uint64_t> publishedCount;           // 发布的事件数
+    std::atomic<uint64_t> typeCounts[static_cast<size_t>(VmEventType::COUNT)]; // 按类型的发布数
+
+public:
+    VmEventBus();
+    VmEventBus(const VmEventBus&) = delete;
+    VmEventBus& operator=(const VmEventBus&) = delete;
+
+    /**
+     * @brief 新建订阅
+     * @param typeMask 订阅的事件类型（VmEventMask组合，VM_EVENT_MASK_ALL表示全部）
+     * @param vmId 只接收该VM的事件（0表示全部）
+     * @param capacity 事件环容量
+     * @return 订阅对象；eventfd创建失败（Linux）时返回nullptr
+     */
+    std::shared_ptr<VmEventSubscription> subscribe(uint32_t typeMask, uint32_t vmId,
+                                                   size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief 取消订阅（之后不再放入新事件，已在环中的事件仍可取出）
+     */
+    void unsubscribe(const std::shared_ptr<VmEventSubscription>& subscription);
+
+    void onVmEvent(const S_VmEvent& event) override;
+
+    uint32_t getSubscriberCount() const { return subscriberCount.load(std::memory_order_relaxed); }
+    std::string getStatistics() const;
+};
+
+/**
+ * @brief 解析事件类型名称列表（halted fault limit run stopped all，大小写不敏感）
+ * @param names 名称列表，空表示全部
+ * @param mask 输出的类型掩码
+ * @return bool 有无法识别的名称时返回false
+ */
+bool ParseVmEventMask(const std::vector<std::string>& names, uint32_t& mask);
+
+#endif // VM_EVENT_BUS_H
@@ -0,0 +1,138 @@
+#ifndef COVERAGE_MAP_H
+#define COVERAGE_MAP_H
+
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <vector>
+
+static const uint32_t COVERAGE_MAP_SIZE = 1u << 16;     // 边覆盖位图字节数（与AFL一致）
+
+/**
+ * @brief 单次执行的边覆盖位图（AFL式：map[cur ^ prev]++，prev = cur >> 1）
+ * @details 由执行VM的线程在每条指令后调用onInstruction()：只有PC不连续（跳转、中断进入/返回）
+ *          时才算进入新的基本块并记录一条边，顺序执行只做一次比较。
+ *          超级调用的返回值也作为一条边记录（客户机读取输入的结果不同，覆盖就不同）。
+ *          每次执行前reset()清零；只由一个线程使用，不加锁
+ */
+class CoverageTracer {
+private:
+    std::vector<uint8_t> hits;      // COVERAGE_MAP_SIZE个命中计数（超过255回绕，与AFL一致）
+    uint32_t instructionSize;       // 定长指令长度
+    uint64_t nextPc;                // 顺序执行时下一条指令的PC
+    uint32_t previous;              // 上一个块的位置（已右移一位）
+
+    static uint32_t GetLocation(uint64_t pc) {
+        uint64_t hash = pc * 0x9E3779B97F4A7C15ULL;
+        return static_cast<uint32_t>(hash >> 48) & (COVERAGE_MAP_SIZE - 1);
+    }
+
+    void addEdge(uint32_t location) {
+        hits[location ^ previous]++;
+        previous = location >> 1;
+    }
+
+public:
+    explicit CoverageTracer(uint32_t size)
+        : hits(COVERAGE_MAP_SIZE, 0), instructionSize(size ? size : 1), nextPc(0), previous(0) {}
+
+    /**
+     * @brief 开始一次执行
+     * @param entryPc 执行起点（第一个块）
+     */
+    void reset(uint64_t entryPc) {
+        std::memset(hits.data(), 0, hits.size());
+        nextPc = entryPc;
+        previous = 0;
+        addEdge(GetLocation(entryPc));
+    }
+
+    void onInstruction(uint64_t pcBefore) {
+        if (pcBefore != nextPc) {
+            addEdge(GetLocation(pcBefore));
+        }
+        nextPc = pcBefore + instructionSize;
+    }
+
+    void onHypercall(uint64_t pc, uint32_t result) {
+        addEdge(GetLocation(pc ^ (static_cast<uint64_t>(result + 1) << 40)));
+    }
+
+    const uint8_t* getHits() const { return hits.data(); }
+};
+
+/**
+ * @brief 所有工作线程共享的累计覆盖位图
+ * @details 命中计数先按AFL的桶（1、2、3、4-7、8-15、16-31、32-127、128+）归为一位，
+ *          每个字节记录见过的桶；一次执行出现新的边或新的桶时merge()返回true。
+ *          以64位原子字按位或合并，工作线程之间不加锁
+ */
+class SharedCoverageMap {
+private:
+    static const uint32_t WORDS = COVERAGE_MAP_SIZE / 8;
+
+    std::vector<std::atomic<uint64_t>> seen;    // 见过的桶位
+    uint8_t buckets[256];                       // 命中计数 -> 桶位
+
+public:
+    SharedCoverageMap() : seen(WORDS) {
+        for (uint32_t i = 0; i < WORDS; i++) {
+            seen[i].store(0, std::memory_order_relaxed);
+        }
+        buckets[0] = 0;
+        for (uint32_t count = 1; count < 256; count++) {
+            uint8_t bit;
+            if (count == 1) bit = 1;
+            else if (count == 2) bit = 2;
+            else if (count == 3) bit = 4;
+            else if (count < 8) bit = 8;
+            else if (count < 16) bit = 16;
+            else if (count < 32) bit = 32;
+            else if (count < 128) bit = 64;
+            else bit = 128;
+            buckets[count] = bit;
+        }
+    }
+
+    /**
+     * @brief 合并一次执行的覆盖
+     * @return bool 出现了新的边或新的命中计数桶返回true
+     */
+    bool merge(const uint8_t* hits) {
+        bool found = false;
+        for (uint32_t word = 0; word < WORDS; word++) {
+            uint64_t raw;
+            std::memcpy(&raw, hits + word * 8, sizeof(raw));
+            if (raw == 0) {
+                continue;
+            }
+            uint64_t classified = 0;
+            for (uint32_t i = 0; i < 8; i++) {
+                classified |= static_cast<uint64_t>(buckets[hits[word * 8 + i]]) << (i * 8);
+            }
+            if ((classified & ~seen[word].load(std::memory_order_relaxed)) != 0) {
+                seen[word].fetch_or(classified, std::memory_order_relaxed);
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    /**
+     * @brief 至少命中过一次的边数
+     */
+    uint32_t getEdgeCount() const {
+        uint32_t count = 0;
+        for (uint32_t word = 0; word < WORDS; word++) {
+            uint64_t bits = seen[word].load(std::memory_order_relaxed);
+            for (uint32_t i = 0; i < 8; i++) {
+                if ((bits >> (i * 8)) & 0xFF) {
+                    count++;
+                }
+            }
+        }
+        return count;
+    }
+};
+
+#endif // COVERAGE_MAP_H
@@ -0,0 +1,532 @@
+#include "differential.h"
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include "../payload/payload_entry.h"
+
+const uint32_t DifferentialRunner::REQUEST_COUNT;
+const uint32_t DifferentialRunner::MAX_REQUEST_BYTES;
+const uint32_t DifferentialRunner::TRACE_BUFFER_BYTES;
+
+namespace {
+
+// xorshift64*：与模糊测试相同，同一种子生成同一载荷与初始状态
+uint64_t nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+uint32_t randomBelow(uint64_t& state, uint32_t limit) {
+    return limit ? static_cast<uint32_t>(nextRandom(state) % limit) : 0;
+}
+
+// 种子乘奇数常数后相加（一一对应，相邻种子不会得到同一状态），状态不能为0
+uint64_t seedState(uint64_t seed, uint64_t salt) {
+    uint64_t state = seed * 0x9E3779B97F4A7C15ULL + salt;
+    return state ? state : salt;
+}
+
+/**
+ * @brief 按权重选取的单字节指令
+ */
+struct S_WeightedOpcode {
+    uint8_t opcode;
+    uint32_t weight;
+};
+
+// 0x90为未实现指令（按未知指令跳过），0xCC为载荷自带的INT3（不是断点处时按未知指令跳过）
+const S_WeightedOpcode X86_OPCODES[] = {
+    { 0x00, 2 }, { 0x01, 8 }, { 0x02, 8 }, { 0x03, 8 }, { 0x04, 8 }, { 0x05, 8 }, { 0x06, 6 }, { 0x07, 6 },
+    { 0x0F, 4 }, { 0x30, 3 }, { 0x31, 3 }, { 0xCF, 2 }, { 0xF4, 2 }, { 0xCC, 1 }, { 0x90, 1 }
+};
+
+const S_WeightedOpcode X64_OPCODES[] = {
+    { 0x48, 6 }, { 0x89, 8 }, { 0x01, 8 }, { 0x29, 8 }, { 0xFF, 8 }, { 0xFE, 8 }, { 0x50, 6 }, { 0x58, 6 },
+    { 0x0F, 4 }, { 0x30, 3 }, { 0x31, 3 }, { 0xCF, 2 }, { 0xF4, 2 }, { 0xCC, 1 }, { 0x90, 1 }
+};
+
+// arm系统指令子功能：HVC、WFI、ERET、RDCYCLE、定时器编程、BKPT
+const S_WeightedOpcode ARM_SYSTEM_FUNCTIONS[] = {
+    { 0x0, 5 }, { 0x1, 2 }, { 0x2, 2 }, { 0x3, 3 }, { 0x4, 3 }, { 0x7, 1 }
+};
+
+const uint32_t ARM_ALU_OPCODES[] = { 0x0, 0x1, 0x2, 0x4, 0x5, 0xD };    // AND/EOR/SUB/ADD/ADC/MOV
+const uint32_t ARM_UNDEFINED_OPCODES[] = { 0x3, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC };
+const uint32_t ARM_PC = 15;
+
+template <size_t N>
+uint8_t pickWeighted(const S_WeightedOpcode (&table)[N], uint64_t& rng) {
+    uint32_t total = 0;
+    for (size_t i = 0; i < N; i++) {
+        total += table[i].weight;
+    }
+    uint32_t pick = randomBelow(rng, total);
+    for (size_t i = 0; i < N; i++) {
+        if (pick < table[i].weight) {
+            return table[i].opcode;
+        }
+        pick -= table[i].weight;
+    }
+    return table[N - 1].opcode;
+}
+
+uint32_t encodeArm(uint32_t opcode, uint32_t rn, uint32_t rd, uint32_t operand2) {
+    return (opcode << 21) | (rn << 16) | (rd << 12) | (operand2 & 0xFFF);
+}
+
+/**
+ * @brief 生成一条arm指令
+ * @details 写PC的SUB向后跳转1~8条指令形成循环，写PC的MOV跳到载荷前1K条指令内的任意位置；
+ *          B指令的偏移字段与操作码位重叠，总是跳出载荷（执行结束）
+ */
+uint32_t generateArmInstruction(uint32_t index, uint32_t instructions, uint64_t& rng) {
+    uint32_t kind = randomBelow(rng, 100);
+    if (kind < 66 || (kind < 74 && index == 0)) {
+        uint32_t opcode = ARM_ALU_OPCODES[randomBelow(rng, sizeof(ARM_ALU_OPCODES) / sizeof(ARM_ALU_OPCODES[0]))];
+        uint32_t operand2 = randomBelow(rng, 2) ? randomBelow(rng, 16) : randomBelow(rng, 0x1000);
+        return encodeArm(opcode, randomBelow(rng, 16), randomBelow(rng, 13), operand2);
+    }
+    if (kind < 74) {
+        uint32_t back = 1 + randomBelow(rng, std::min(index, 8u));
+        return encodeArm(0x2, ARM_PC, ARM_PC, back * 4 + 4);        // SUB pc, pc, #(4k+4)
+    }
+    if (kind < 78) {
+        uint32_t target = randomBelow(rng, std::min(instructions, 0x400u));
+        return encodeArm(0xD, 0, ARM_PC, target * 4);                // MOV pc, #imm（执行后pc = imm + 4）
+    }
+    if (kind < 80) {
+        return (0xEu << 21) | randomBelow(rng, 1u << 21);           // B
+    }
+    if (kind < 96) {
+        return encodeArm(0xF, 0, 0, pickWeighted(ARM_SYSTEM_FUNCTIONS, rng));
+    }
+    uint32_t opcode = ARM_UNDEFINED_OPCODES[randomBelow(rng, sizeof(ARM_UNDEFINED_OPCODES) /
+                                                              sizeof(ARM_UNDEFINED_OPCODES[0]))];
+    return encodeArm(opcode, randomBelow(rng, 16), randomBelow(rng, 16), randomBelow(rng, 0x1000));
+}
+
+bool differs(S_DiffDivergence& divergence, const std::string& field, uint64_t reference, uint64_t candidate) {
+    if (reference == candidate) {
+        return false;
+    }
+    divergence.found = true;
+    divergence.field = field;
+    divergence.referenceValue = reference;
+    divergence.candidateValue = candidate;
+    return true;
+}
+
+std::string indexedField(const char* name, uint64_t index, bool hex) {
+    std::ostringstream oss;
+    oss << name << '[';
+    if (hex) {
+        oss << "0x" << std::hex;
+    }
+    oss << index << ']';
+    return oss.str();
+}
+
+} // namespace
+
+uint32_t DiffHypercallTable::dispatchBatch(S_HypercallContext& ctx, uint32_t batchAddr, uint32_t count) {
+    if (count == 0 || count > HypercallTable::MAX_BATCH) {
+        return table.dispatchBatch(ctx, batchAddr, count);
+    }
+    uint32_t batchBytes = count * static_cast<uint32_t>(sizeof(S_HypercallRequest));
+    uint8_t* records = ctx.memory.translate(batchAddr, batchBytes, GUEST_PERM_RW);
+    if (!records) {
+        return table.dispatchBatch(ctx, batchAddr, count);
+    }
+
+    // 把不可复现的请求改成未知服务，处理后写回原服务号
+    uint32_t replaced[HypercallTable::MAX_BATCH];
+    uint32_t services[HypercallTable::MAX_BATCH];
+    uint32_t replacedCount = 0;
+    const uint32_t unknown = static_cast<uint32_t>(HypercallService::COUNT);
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t* slot = records + i * sizeof(S_HypercallRequest);
+        uint32_t service = 0;
+        std::memcpy(&service, slot, sizeof(service));
+        if (service == static_cast<uint32_t>(HypercallService::TIME) ||
+            service == static_cast<uint32_t>(HypercallService::LOG) ||
+            service == static_cast<uint32_t>(HypercallService::DOORBELL)) {
+            std::memcpy(slot, &unknown, sizeof(unknown));
+            replaced[replacedCount] = i;
+            services[replacedCount] = service;
+            replacedCount++;
+        }
+    }
+    uint32_t completed = table.dispatchBatch(ctx, batchAddr, count);
+    for (uint32_t i = 0; i < replacedCount; i++) {
+        std::memcpy(records + replaced[i] * sizeof(S_HypercallRequest), &services[i], sizeof(uint32_t));
+    }
+    return completed;
+}
+
+DifferentialRunner::DifferentialRunner(const S_DiffConfig& diffConfig, DiffVmFactory vmFactory)
+    : config(diffConfig), factory(vmFactory), interruptEntry(0) {
+    reference.engine = config.reference;
+    candidate.engine = config.candidate;
+}
+
+bool DifferentialRunner::prepareSide(S_DiffSide& side, DiffEngine engine, std::string& error) {
+    side.engine = engine;
+    side.vm = factory();
+    if (!side.vm) {
+        error = "failed to create VM";
+        return false;
+    }
+    side.vm->setHypercallHandler(&hypercalls);
+    side.vm->setResourceLimit(UINT32_MAX);      // 执行长度由maxInstructions限制
+    if (!side.vm->getMemory().allocate(config.memorySize)) {
+        error = "failed to allocate guest memory";
+        return false;
+    }
+    side.tracer.reset(new CoverageTracer(side.vm->getDebugTarget().instructionSize));
+    return true;
+}
+
+bool DifferentialRunner::prepare(std::string& error) {
+    if (config.reference >= DiffEngine::COUNT || config.candidate >= DiffEngine::COUNT) {
+        error = "unknown engine";
+        return false;
+    }
+    if (config.blockInstructions == 0 || config.maxInstructions == 0 || config.breakpointStride == 0) {
+        error = "block size, instruction budget and breakpoint stride must be positive";
+        return false;
+    }
+    if (config.memorySize < GuestMemory::PAGE_SIZE || config.memorySize % GuestMemory::PAGE_SIZE != 0) {
+        error = "memory size must be a positive multiple of " + std::to_string(GuestMemory::PAGE_SIZE);
+        return false;
+    }
+    if (!prepareSide(reference, config.reference, error) || !prepareSide(candidate, config.candidate, error)) {
+        return false;
+    }
+    reference.vm->captureSnapshot(blank);
+    if (!candidate.vm->restoreSnapshot(blank)) {
+        error = "the two VMs do not share an architecture";
+        return false;
+    }
+    return true;
+}
+
+bool DifferentialRunner::buildInitialState(const S_PayloadImage& payload, uint64_t seed, std::string& error) {
+    uint64_t rng = seedState(seed, 0x9E3779B97F4A7C15ULL);
+    initial = blank;
+    std::vector<uint8_t>& memory = initial.memory;
+    for (size_t i = 0; i < memory.size(); i += sizeof(uint64_t)) {
+        uint64_t value = nextRandom(rng);
+        std::memcpy(&memory[i], &value, std::min(sizeof(value), memory.size() - i));
+    }
+
+    // 地址0处的请求表只含可复现的服务，区间可能越界或与请求表自身重叠
+    static const HypercallService SERVICES[] = {
+        HypercallService::MEMCPY, HypercallService::MEMSET, HypercallService::HASH, HypercallService::RANDOM
+    };
+    uint32_t size = static_cast<uint32_t>(memory.size());
+    for (uint32_t i = 0; i < REQUEST_COUNT; i++) {
+        S_HypercallRequest request;
+        request.service = static_cast<uint32_t>(SERVICES[randomBelow(rng, sizeof(SERVICES) / sizeof(SERVICES[0]))]);
+        request.status = 0;
+        request.result = 0;
+        request.args[0] = randomBelow(rng, size);
+        request.args[1] = request.service == static_cast<uint32_t>(HypercallService::MEMCPY)
+                        ? randomBelow(rng, size) : randomBelow(rng, MAX_REQUEST_BYTES + 1);
+        request.args[2] = request.service == static_cast<uint32_t>(HypercallService::HASH)
+                        ? static_cast<uint32_t>(nextRandom(rng)) : randomBelow(rng, MAX_REQUEST_BYTES + 1);
+        request.args[3] = 0;
+        std::memcpy(&memory[i * sizeof(request)], &request, sizeof(request));
+    }
+    initial.running = true;
+    initial.rngState = nextRandom(rng) | 1;
+
+    I_VmInterface& vm = *reference.vm;
+    uint32_t instructionSize = vm.getDebugTarget().instructionSize;
+    interruptEntry = randomBelow(rng, static_cast<uint32_t>(payload.code.size() / instructionSize)) * instructionSize;
+    if (payload.interruptEntry != PAYLOAD_NO_INTERRUPT_ENTRY) {
+        interruptEntry = payload.interruptEntry;
+    }
+    vm.debugDetach();
+    vm.setPayload(payload.code.data(), payload.code.size());
+    vm.restoreSnapshot(initial);
+
+    // 通用寄存器：请求表地址、请求条数、内存内地址或任意值；栈指针取x86栈内的对齐位置
+    const S_DebugTarget& target = vm.getDebugTarget();
+    for (uint32_t i = 0; i < target.registerCount; i++) {
+        const S_DebugRegisterInfo& info = target.registers[i];
+        if (info.bits > 64 || std::strcmp(info.type, "code_ptr") == 0) {
+            continue;
+        }
+        uint64_t value = 0;
+        if (std::strcmp(info.type, "data_ptr") == 0) {
+            value = randomBelow(rng, 1025) * 4;
+        } else {
+            switch (randomBelow(rng, 4)) {
+                case 0: value = 0; break;
+                case 1: value = 1 + randomBelow(rng, REQUEST_COUNT); break;
+                case 2: value = randomBelow(rng, size); break;
+                default: value = nextRandom(rng); break;
+            }
+        }
+        vm.writeDebugRegister(i, value);
+    }
+    vm.setProgramCounter(0);
+    if (!PayloadApplyEntryState(vm, payload.architecture, payload, error)) {
+        return false;
+    }
+    vm.captureSnapshot(initial);
+    if (config.reference == DiffEngine::COW || config.candidate == DiffEngine::COW) {
+        image = std::make_shared<const std::vector<uint8_t>>(initial.memory);
+    }
+    return true;
+}
+
+bool DifferentialRunner::load(S_DiffSide& side, const std::vector<uint8_t>& payload) {
+    I_VmInterface& vm = *side.vm;
+    vm.debugDetach();
+    vm.stopTrace();
+    vm.setCoverageTracer(nullptr);
+
+    // 中断控制器不在快照内：清空上一次留下的待处理中断
+    VirtualInterruptController& interrupts = vm.getInterruptController();
+    while (interrupts.acknowledge() >= 0) {
+    }
+    interrupts.setVectorEntry(IRQ_VECTOR_TIMER, interruptEntry);
+    vm.setPayload(payload.data(), payload.size());
+
+    if (side.engine == DiffEngine::COW) {
+        if (!vm.getMemory().cloneFrom(image) || !vm.restoreSnapshot(initial, true)) {
+            return false;
+        }
+    } else if (!vm.restoreSnapshot(initial)) {
+        return false;
+    }
+
+    if (side.engine == DiffEngine::TRACED) {
+        vm.startTrace(TRACE_BUFFER_BYTES);
+        side.tracer->reset(vm.getProgramCounter());
+        vm.setCoverageTracer(side.tracer.get());
+    } else if (side.engine == DiffEngine::DEBUG) {
+        vm.debugAttach();
+        uint64_t stride = static_cast<uint64_t>(vm.getDebugTarget().instructionSize) * config.breakpointStride;
+        for (uint64_t pc = 0; pc < payload.size(); pc += stride) {
+            vm.insertBreakpoint(pc);
+        }
+    }
+    return true;
+}
+
+bool DifferentialRunner::advance(S_DiffSide& side, uint64_t target) {
+    I_VmInterface& vm = *side.vm;
+    uint32_t executed = 0;
+    switch (side.engine) {
+        case DiffEngine::STEP:
+            while (vm.getResourceUsage() < target) {
+                vm.runBatch(1, executed);
+                if (executed == 0) {
+                    return false;
+                }
+            }
+            return true;
+
+        case DiffEngine::DEBUG:
+            // 停机唤醒与执行到载荷末尾交给runBatch（推进虚拟时间、不输出日志地停止），其余经调试器单步；
+            // 命中断点时没有进展，下一次debugRun越过它
+            while (vm.getResourceUsage() < target) {
+                uint32_t before = vm.getResourceUsage();
+                if (vm.isHalted() || vm.getProgramCounter() >= vm.getPayloadSize()) {
+                    vm.runBatch(1, executed);
+                    if (executed == 0) {
+                        return false;
+                    }
+                } else if (vm.debugRun(1) != DebugStopReason::BREAKPOINT && vm.getResourceUsage() == before) {
+                    return false;
+                }
+            }
+            return true;
+
+        default: {
+            uint64_t count = vm.getResourceUsage();
+            if (count < target) {
+                vm.runBatch(static_cast<uint32_t>(target - count), executed);
+            }
+            return vm.getResourceUsage() >= target;
+        }
+    }
+}
+
+bool DifferentialRunner::compare(S_DiffDivergence& divergence) {
+    I_VmInterface& left = *reference.vm;
+    I_VmInterface& right = *candidate.vm;
+    const S_DebugTarget& target = left.getDebugTarget();
+    for (uint32_t i = 0; i < target.registerCount; i++) {
+        if (target.registers[i].bits <= 64 &&
+            differs(divergence, target.registers[i].name, left.readDebugRegister(i), right.readDebugRegister(i))) {
+            return false;
+        }
+    }
+
+    left.captureSnapshot(reference.state);
+    right.captureSnapshot(candidate.state);
+    const S_VmSnapshot& a = reference.state;
+    const S_VmSnapshot& b = candidate.state;
+    if (differs(divergence, "arch.size", a.archState.size(), b.archState.size())) {
+        return false;
+    }
+    for (size_t i = 0; i < a.archState.size(); i++) {
+        if (a.archState[i] != b.archState[i]) {
+            differs(divergence, i + 1 == a.archState.size() ? "instructions" : indexedField("arch", i, false),
+                    a.archState[i], b.archState[i]);
+            return false;
+        }
+    }
+
+    const uint32_t S_VmContext::* const contextRegisters[] = {
+        &S_VmContext::eax, &S_VmContext::ebx, &S_VmContext::ecx, &S_VmContext::edx, &S_VmContext::esi,
+        &S_VmContext::edi, &S_VmContext::ebp, &S_VmContext::esp, &S_VmContext::eip, &S_VmContext::eflags
+    };
+    static const char* const contextNames[] = {
+        "context.eax", "context.ebx", "context.ecx", "context.edx", "context.esi",
+        "context.edi", "context.ebp", "context.esp", "context.eip", "context.eflags"
+    };
+    for (size_t i = 0; i < sizeof(contextRegisters) / sizeof(contextRegisters[0]); i++) {
+        if (differs(divergence, contextNames[i], a.context.*contextRegisters[i], b.context.*contextRegisters[i])) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.context.stack.size() && i < b.context.stack.size(); i++) {
+        if (a.context.stack[i] != b.context.stack[i]) {
+            differs(divergence, indexedField("stack", i, false), a.context.stack[i], b.context.stack[i]);
+            return false;
+        }
+    }
+
+    if (differs(divergence, "memory.size", a.memory.size(), b.memory.size())) {
+        return false;
+    }
+    if (std::memcmp(a.memory.data(), b.memory.data(), a.memory.size()) != 0) {
+        size_t i = 0;
+        while (a.memory[i] == b.memory[i]) {
+            i++;
+        }
+        differs(divergence, indexedField("mem", i, true), a.memory[i], b.memory[i]);
+        return false;
+    }
+
+    return !(differs(divergence, "timer.mode", static_cast<uint64_t>(a.timer.getMode()),
+                     static_cast<uint64_t>(b.timer.getMode())) ||
+             differs(divergence, "timer.deadline", a.timer.getDeadline(), b.timer.getDeadline()) ||
+             differs(divergence, "timer.fired", a.timer.getFiredCount(), b.timer.getFiredCount()) ||
+             differs(divergence, "rngState", a.rngState, b.rngState) ||
+             differs(divergence, "interruptReturnPc", a.interruptReturnPc, b.interruptReturnPc) ||
+             differs(divergence, "idleTicks", a.idleTicks, b.idleTicks) ||
+             differs(divergence, "running", a.running, b.running) ||
+             differs(divergence, "halted", a.halted, b.halted) ||
+             differs(divergence, "inInterrupt", a.inInterrupt, b.inInterrupt) ||
+             differs(divergence, "pendingIrqs", left.getInterruptController().getPendingBitmap(),
+                     right.getInterruptController().getPendingBitmap()));
+}
+
+uint64_t DifferentialRunner::blockEnd(uint32_t block) const {
+    return std::min(static_cast<uint64_t>(block + 1) * config.blockInstructions,
+                    static_cast<uint64_t>(config.maxInstructions));
+}
+
+void DifferentialRunner::locate(const std::vector<uint8_t>& payload, S_DiffDivergence& divergence) {
+    // 从头按同样的分批方式重放到上一个一致的块边界，再逐条执行
+    if (!load(reference, payload) || !load(candidate, payload)) {
+        return;
+    }
+    for (uint32_t block = 0; block < divergence.block; block++) {
+        advance(reference, blockEnd(block));
+        advance(candidate, blockEnd(block));
+    }
+    uint64_t end = blockEnd(divergence.block);
+    for (uint64_t count = reference.vm->getResourceUsage(); count < end; count = reference.vm->getResourceUsage()) {
+        uint64_t pc = reference.vm->getProgramCounter();
+        bool moved = advance(reference, count + 1);
+        advance(candidate, count + 1);
+        S_DiffDivergence step;
+        if (!compare(step)) {
+            step.singleStep = true;
+            step.block = divergence.block;
+            step.instruction = count;
+            step.pc = pc;
+            divergence = step;
+            return;
+        }
+        if (!moved) {
+            break;
+        }
+    }
+    // 逐条执行时不再出现：不一致与分批方式有关，保留块级结果
+}
+
+bool DifferentialRunner::run(const S_PayloadImage& payload, uint64_t seed, S_DiffDivergence& divergence,
+                             std::string& error) {
+    divergence = S_DiffDivergence();
+    if (!reference.vm || !candidate.vm) {
+        error = "runner is not prepared";
+        return false;
+    }
+    if (payload.code.empty()) {
+        error = "payload is empty";
+        return false;
+    }
+    if (!buildInitialState(payload, seed, error)) {
+        return false;
+    }
+    if (!load(reference, payload.code) || !load(candidate, payload.code)) {
+        error = "VM cannot restore the initial state";
+        return false;
+    }
+    stats.payloads++;
+
+    for (uint32_t block = 0; ; block++) {
+        uint64_t start = reference.vm->getResourceUsage();
+        uint64_t startPc = reference.vm->getProgramCounter();
+        uint64_t end = blockEnd(block);
+        bool moved = advance(reference, end);
+        advance(candidate, end);
+        stats.blocks++;
+        if (!compare(divergence)) {
+            divergence.block = block;
+            divergence.instruction = start;
+            divergence.pc = startPc;
+            stats.instructions += reference.vm->getResourceUsage();
+            stats.divergences++;
+            locate(payload.code, divergence);
+            return true;
+        }
+        if (!moved || end >= config.maxInstructions) {
+            break;
+        }
+    }
+    stats.instructions += reference.vm->getResourceUsage();
+    return true;
+}
+
+bool GenerateDiffPayload(const std::string& type, uint32_t instructions, uint64_t seed, std::vector<uint8_t>& payload) {
+    uint64_t rng = seedState(seed, 0xD1B54A32D192ED03ULL);
+    payload.clear();
+    if (type == "x86" || type == "x64") {
+        payload.reserve(instructions);
+        for (uint32_t i = 0; i < instructions; i++) {
+            payload.push_back(type == "x86" ? pickWeighted(X86_OPCODES, rng) : pickWeighted(X64_OPCODES, rng));
+        }
+        return true;
+    }
+    if (type == "arm") {
+        payload.reserve(instructions * 4);
+        for (uint32_t i = 0; i < instructions; i++) {
+            uint32_t instruction = generateArmInstruction(i, instructions, rng);
+            for (uint32_t byte = 0; byte < 4; byte++) {
+                payload.push_back(static_cast<uint8_t>(instruction >> (8 * byte)));  // 小端
+            }
+        }
+        return true;
+    }
+    return false;
+}
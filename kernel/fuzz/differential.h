@@ -0,0 +1,189 @@
+#ifndef DIFFERENTIAL_H
+#define DIFFERENTIAL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include "../CPUvm/baseVM.h"
+#include "../hypercall/hypercall.h"
+#include "coverage_map.h"
+#include "../payload/payload_format.h"
+
+/**
+ * @brief 创建一台未分配内存的VM（差分测试的两侧各一台，架构相同）
+ */
+typedef std::function<std::shared_ptr<I_VmInterface>()> DiffVmFactory;
+
+/**
+ * @brief 被比较的执行方式
+ * @details 各方式执行同一套指令语义，但经过不同的执行路径：
+ *          STEP为参照（每次只执行一条），BATCH为连续批量执行，TRACED在批量执行的同时开启
+ *          指令跟踪与边覆盖记录（每条指令走观察路径），COW在写时复制的客户机内存上批量执行，
+ *          DEBUG经调试器单步执行，载荷每隔若干条指令打一个断点（陷阱指令与越过断点的路径）
+ */
+enum class DiffEngine : uint8_t {
+    STEP    = 0,
+    BATCH   = 1,
+    TRACED  = 2,
+    COW     = 3,
+    DEBUG   = 4,
+    COUNT
+};
+
+inline const char* GetDiffEngineName(DiffEngine engine) {
+    static const char* const names[] = {
+        "step",
+        "batch",
+        "traced",
+        "cow",
+        "debug"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(DiffEngine::COUNT),
+                  "diff engine name table out of sync with DiffEngine");
+    uint8_t index = static_cast<uint8_t>(engine);
+    return index < static_cast<uint8_t>(DiffEngine::COUNT) ? names[index] : "unknown";
+}
+
+inline bool ParseDiffEngine(const std::string& name, DiffEngine& engine) {
+    for (uint8_t i = 0; i < static_cast<uint8_t>(DiffEngine::COUNT); i++) {
+        if (name == GetDiffEngineName(static_cast<DiffEngine>(i))) {
+            engine = static_cast<DiffEngine>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 差分测试参数
+ */
+struct S_DiffConfig {
+    DiffEngine reference;           // 参照执行方式
+    DiffEngine candidate;           // 被检查的执行方式
+    uint32_t blockInstructions;     // 每隔多少条指令比较一次完整状态
+    uint32_t maxInstructions;       // 每个载荷最多执行的指令数
+    uint32_t memorySize;            // 客户机私有内存大小
+    uint32_t breakpointStride;      // DEBUG方式每隔多少条指令打一个断点
+
+    S_DiffConfig() : reference(DiffEngine::STEP), candidate(DiffEngine::BATCH), blockInstructions(64),
+                     maxInstructions(4096), memorySize(16 * 1024), breakpointStride(5) {}
+};
+
+/**
+ * @brief 第一处不一致
+ */
+struct S_DiffDivergence {
+    bool found;                     // 是否发现不一致
+    bool singleStep;                // 已定位到单条指令（否则只定位到块，说明与分批方式有关）
+    uint32_t block;                 // 发现不一致的块序号
+    uint64_t instruction;           // 不一致的指令序号（singleStep为false时为块的第一条）
+    uint64_t pc;                    // 该指令执行前参照侧的PC
+    std::string field;              // 第一个不一致的状态项（寄存器名、mem[地址]、timer.deadline等）
+    uint64_t referenceValue;
+    uint64_t candidateValue;
+
+    S_DiffDivergence() : found(false), singleStep(false), block(0), instruction(0), pc(0),
+                         referenceValue(0), candidateValue(0) {}
+};
+
+/**
+ * @brief 累计统计
+ */
+struct S_DiffStats {
+    uint64_t payloads;              // 比较过的载荷数
+    uint64_t instructions;          // 参照侧累计执行的指令数
+    uint64_t blocks;                // 累计比较的块边界数
+    uint64_t divergences;           // 出现不一致的载荷数
+
+    S_DiffStats() : payloads(0), instructions(0), blocks(0), divergences(0) {}
+};
+
+/**
+ * @brief 差分测试用的宿主服务表
+ * @details 转发给HypercallTable；结果不可复现（TIME）或有外部副作用（LOG输出、DOORBELL通知其他VM）
+ *          的请求按未知服务处理，请求记录的service字段在处理后原样写回
+ */
+class DiffHypercallTable : public I_HypercallHandler {
+private:
+    HypercallTable table;
+
+public:
+    uint32_t dispatchBatch(S_HypercallContext& ctx, uint32_t batchAddr, uint32_t count) override;
+};
+
+/**
+ * @brief 两种执行方式的锁步差分测试
+ * @details 两侧各一台同架构VM，从同一初始状态出发（随机填充的客户机内存，开头放一张可复现服务的
+ *          超级调用请求表；通用寄存器随机取0、小计数、内存内地址或任意值；定时器中断入口指向载荷内
+ *          随机一条指令；载荷容器的数据段、初始寄存器、入口PC与中断入口覆盖在随机状态之上），
+ *          每执行blockInstructions条指令比较一次完整状态：寄存器、架构状态、栈、
+ *          全部私有内存、虚拟定时器、随机数状态、中断与停机状态、待处理中断。
+ *          发现不一致后从头重放到上一个一致的块边界，再逐条执行定位第一条不一致的指令。
+ *          中断控制器的待处理位在每次开始前清空；未经快照保存的其他设置（页权限、共享内存映射）不参与比较
+ */
+class DifferentialRunner {
+public:
+    static const uint32_t REQUEST_COUNT = 8;            // 初始内存中的请求表条数（地址0）
+    static const uint32_t MAX_REQUEST_BYTES = 256;      // 请求表中单个请求的最大区间长度
+    static const uint32_t TRACE_BUFFER_BYTES = 64 * 1024; // TRACED方式的跟踪缓冲大小
+
+private:
+    /**
+     * @brief 一侧的VM与执行方式
+     */
+    struct S_DiffSide {
+        DiffEngine engine;
+        std::shared_ptr<I_VmInterface> vm;
+        std::unique_ptr<CoverageTracer> tracer;     // TRACED方式的边覆盖记录
+        S_VmSnapshot state;                         // 块边界处捕获的状态（复用缓冲）
+    };
+
+    S_DiffConfig config;
+    DiffVmFactory factory;
+    DiffHypercallTable hypercalls;
+    S_DiffSide reference;
+    S_DiffSide candidate;
+    S_VmSnapshot blank;                             // 新建VM的状态（生成初始状态的起点）
+    S_VmSnapshot initial;                           // 当前载荷的初始状态
+    std::shared_ptr<const std::vector<uint8_t>> image; // COW方式共享的初始内存
+    uint32_t interruptEntry;                        // 当前载荷的定时器中断入口
+    S_DiffStats stats;
+
+    bool prepareSide(S_DiffSide& side, DiffEngine engine, std::string& error);
+    bool buildInitialState(const S_PayloadImage& payload, uint64_t seed, std::string& error);
+    bool load(S_DiffSide& side, const std::vector<uint8_t>& payload);
+    bool advance(S_DiffSide& side, uint64_t target);
+    bool compare(S_DiffDivergence& divergence);
+    uint64_t blockEnd(uint32_t block) const;
+    void locate(const std::vector<uint8_t>& payload, S_DiffDivergence& divergence);
+
+public:
+    DifferentialRunner(const S_DiffConfig& diffConfig, DiffVmFactory vmFactory);
+
+    /**
+     * @brief 创建两侧的VM（只需调用一次，之后可多次run）
+     * @return bool 参数无效或VM无法创建时返回false
+     */
+    bool prepare(std::string& error);
+
+    /**
+     * @brief 以seed生成初始状态，两侧锁步执行载荷并比较
+     * @param divergence 输出：第一处不一致（found为false表示全程一致）
+     * @return bool 载荷为空、入口状态无法装入或VM无法恢复初始状态时返回false
+     */
+    bool run(const S_PayloadImage& payload, uint64_t seed, S_DiffDivergence& divergence, std::string& error);
+
+    const S_DiffStats& getStats() const { return stats; }
+};
+
+/**
+ * @brief 生成随机的合法载荷（x86/arm/x64的已实现指令，混入少量未知指令与载荷自带的陷阱指令）
+ * @details arm以写PC的MOV/SUB产生向后跳转的循环；x86/x64没有跳转指令，控制流只来自定时器中断
+ * @param instructions 指令条数
+ * @return bool 架构未知时返回false
+ */
+bool GenerateDiffPayload(const std::string& type, uint32_t instructions, uint64_t seed, std::vector<uint8_t>& payload);
+
+#endif // DIFFERENTIAL_H
@@ -0,0 +1,358 @@
+#include "fuzzer.h"
+#include "../Cross_PlatformUnifiedMacro.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+const uint32_t Fuzzer::MAX_WORKERS;
+const size_t Fuzzer::MAX_CORPUS;
+const size_t Fuzzer::MAX_CRASHES;
+const uint32_t Fuzzer::MAX_STACKED_MUTATIONS;
+
+namespace {
+
+uint64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// xorshift64*：每个工作线程一份状态，不共享
+uint64_t nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+uint32_t randomBelow(uint64_t& state, uint32_t limit) {
+    return limit ? static_cast<uint32_t>(nextRandom(state) % limit) : 0;
+}
+
+const uint8_t INTERESTING_8[] = { 0x00, 0x01, 0x10, 0x20, 0x40, 0x7F, 0x80, 0xFF };
+const uint32_t INTERESTING_32[] = { 0x00000000, 0x00000001, 0x000000FF, 0x00000100, 0x00001000,
+                                    0x0000FFFF, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF };
+
+enum MutationOp {
+    MUTATE_FLIP_BIT,
+    MUTATE_RANDOM_BYTE,
+    MUTATE_INTERESTING_BYTE,
+    MUTATE_ARITH_BYTE,
+    MUTATE_INTERESTING_DWORD,
+    MUTATE_DELETE_BLOCK,
+    MUTATE_CLONE_BLOCK,
+    MUTATE_OP_COUNT
+};
+
+} // namespace
+
+Fuzzer::Fuzzer(const S_FuzzConfig& fuzzConfig, FuzzVmFactory vmFactory)
+    : config(fuzzConfig), factory(vmFactory), code(nullptr), codeSize(0), memorySize(0), addressSpaceSize(0),
+      hypercalls(nullptr), targetVmId(0), seedCount(0), stopRequested(false), executions(0), newCoverageInputs(0),
+      droppedCrashes(0), elapsedNs(0) {
+    for (size_t i = 0; i < static_cast<size_t>(FuzzOutcome::COUNT); i++) {
+        outcomeCounts[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+bool Fuzzer::run(I_VmInterface& target, const std::vector<std::vector<uint8_t>>& seeds, std::string& error) {
+    if (config.workers == 0 || config.workers > MAX_WORKERS) {
+        error = "worker count must be 1.." + std::to_string(MAX_WORKERS);
+        return false;
+    }
+    if (config.maxInputLength == 0 || config.execInstructions == 0) {
+        error = "input length and instruction budget must be positive";
+        return false;
+    }
+    if (!target.getRunningStatus()) {
+        error = "target VM is not running (start it and run it to the point where it reads its input)";
+        return false;
+    }
+    if (!target.getMemory().checkAccess(config.inputAddress, config.maxInputLength, GUEST_PERM_WRITE)) {
+        error = "input region is outside the VM's writable guest memory";
+        return false;
+    }
+    if (!target.getOriginalCode() || target.getPayloadSize() == 0) {
+        error = "target VM has no payload";
+        return false;
+    }
+
+    target.captureSnapshot(baseline);
+    code = target.getOriginalCode();
+    codeSize = target.getPayloadSize();
+    memorySize = target.getMemory().getSize();
+    addressSpaceSize = target.getMemory().getAddressSpaceSize();
+    hypercalls = target.getHypercallHandler();
+    targetVmId = target.getVmId();
+    architecture = target.getDebugTarget().architecture;
+
+    corpus.clear();
+    crashes.clear();
+    for (const std::vector<uint8_t>& seed : seeds) {
+        if (!seed.empty() && corpus.size() < MAX_CORPUS) {
+            corpus.push_back(seed);
+            corpus.back().resize(std::min<size_t>(seed.size(), config.maxInputLength));
+        }
+    }
+    if (corpus.empty()) {
+        corpus.push_back(std::vector<uint8_t>(config.maxInputLength));
+        target.getMemory().peek(config.inputAddress, corpus.back().data(), config.maxInputLength);
+    }
+    seedCount = corpus.size();
+    stopRequested.store(false, std::memory_order_release);
+    executions.store(0, std::memory_order_relaxed);
+    newCoverageInputs.store(0, std::memory_order_relaxed);
+    droppedCrashes.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < static_cast<size_t>(FuzzOutcome::COUNT); i++) {
+        outcomeCounts[i].store(0, std::memory_order_relaxed);
+    }
+    workerStats.assign(config.workers, S_FuzzWorkerStats());
+    workerError.clear();
+
+    uint64_t start = monotonicNs();
+    uint64_t deadline = start + static_cast<uint64_t>(config.durationMs) * 1000000ULL;
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < config.workers; i++) {
+        threads.push_back(std::thread(&Fuzzer::workerLoop, this, i, deadline));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    elapsedNs = monotonicNs() - start;
+
+    if (!workerError.empty()) {
+        error = workerError;
+        return false;
+    }
+    return true;
+}
+
+void Fuzzer::workerLoop(uint32_t index, uint64_t deadlineNs) {
+    S_FuzzWorkerStats stats;
+    stats.core = config.cores.empty() ? -1 : config.cores[index % config.cores.size()];
+    if (stats.core >= 0 && SetThreadCPUAffinity(stats.core) != 0) {
+        std::cerr << "Warning: Failed to set fuzz worker " << index << " affinity to core " << stats.core << std::endl;
+        stats.core = -1;
+    }
+
+    // 私有工作VM：同一载荷与宿主服务表，恢复基准快照后开始脏页跟踪
+    std::shared_ptr<I_VmInterface> vm = factory(index);
+    if (!vm) {
+        std::lock_guard<std::mutex> lock(corpusMutex);
+        workerError = "failed to create worker VM";
+        stopRequested.store(true, std::memory_order_release);
+        return;
+    }
+    vm->setPayload(code, codeSize);
+    vm->setHypercallHandler(hypercalls);
+    vm->setResourceLimit(UINT32_MAX);      // 执行长度由execInstructions限制
+    if (!vm->getMemory().allocate(memorySize, GUEST_PERM_RW, static_cast<uint32_t>(addressSpaceSize)) ||
+        !vm->restoreSnapshot(baseline)) {
+        std::lock_guard<std::mutex> lock(corpusMutex);
+        workerError = "worker VM cannot restore the target snapshot";
+        stopRequested.store(true, std::memory_order_release);
+        return;
+    }
+    vm->getMemory().startDirtyTracking();
+    CoverageTracer tracer(vm->getDebugTarget().instructionSize);
+    vm->setCoverageTracer(&tracer);
+
+    uint64_t rng = (config.seed ^ (0x9E3779B97F4A7C15ULL * (index + 1))) | 1;
+    uint64_t started = monotonicNs();
+    std::vector<uint8_t> input;
+    while (!stopRequested.load(std::memory_order_acquire) && monotonicNs() < deadlineNs) {
+        {
+            std::lock_guard<std::mutex> lock(corpusMutex);
+            input = corpus[randomBelow(rng, static_cast<uint32_t>(corpus.size()))];
+            // 偶尔与另一条语料拼接：前一段取自当前输入，后一段取自另一条
+            if (corpus.size() > 1 && randomBelow(rng, 8) == 0) {
+                const std::vector<uint8_t>& other = corpus[randomBelow(rng, static_cast<uint32_t>(corpus.size()))];
+                size_t cut = randomBelow(rng, static_cast<uint32_t>(std::min(input.size(), other.size()) + 1));
+                input.resize(cut);
+                input.insert(input.end(), other.begin() + cut, other.end());
+            }
+        }
+        mutate(input, rng);
+
+        stats.restoredPages += vm->getMemory().getDirtyPageCount();
+        VmFaultCode fault = VmFaultCode::NONE;
+        FuzzOutcome outcome = execute(*vm, tracer, input, fault);
+        stats.executions++;
+        executions.fetch_add(1, std::memory_order_relaxed);
+        outcomeCounts[static_cast<size_t>(outcome)].fetch_add(1, std::memory_order_relaxed);
+
+        if (outcome == FuzzOutcome::FAULT) {
+            recordCrash(input, fault, vm->getLastFault().pc);
+        }
+        if (coverage.merge(tracer.getHits())) {
+            newCoverageInputs.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(corpusMutex);
+            if (corpus.size() < MAX_CORPUS) {
+                corpus.push_back(input);
+            }
+        }
+    }
+    stats.activeNs = monotonicNs() - started;
+    vm->setCoverageTracer(nullptr);
+
+    std::lock_guard<std::mutex> lock(corpusMutex);
+    workerStats[index] = stats;
+}
+
+FuzzOutcome Fuzzer::execute(I_VmInterface& vm, CoverageTracer& tracer, const std::vector<uint8_t>& input,
+                            VmFaultCode& fault) {
+    vm.restoreSnapshot(baseline, true);
+    if (!input.empty()) {
+        vm.getMemory().poke(config.inputAddress, input.data(), static_cast<uint32_t>(input.size()));
+    }
+    vm.writeDebugRegister(0, input.size());
+    tracer.reset(vm.getProgramCounter());
+
+    uint32_t executed = 0;
+    fault = vm.runBatch(config.execInstructions, executed);
+    if (fault != VmFaultCode::NONE && fault != VmFaultCode::RESOURCE_LIMIT) {
+        return FuzzOutcome::FAULT;
+    }
+    if (!vm.getRunningStatus()) {
+        return FuzzOutcome::EXITED;
+    }
+    if (executed >= config.execInstructions) {
+        return FuzzOutcome::TIMEOUT;
+    }
+    return FuzzOutcome::HALTED;
+}
+
+void Fuzzer::mutate(std::vector<uint8_t>& data, uint64_t& rng) {
+    uint32_t limit = config.maxInputLength;
+    if (data.empty()) {
+        data.push_back(static_cast<uint8_t>(nextRandom(rng)));
+    }
+    uint32_t rounds = 1 + randomBelow(rng, MAX_STACKED_MUTATIONS);
+    for (uint32_t round = 0; round < rounds; round++) {
+        uint32_t size = static_cast<uint32_t>(data.size());
+        uint32_t pos = randomBelow(rng, size);
+        switch (randomBelow(rng, MUTATE_OP_COUNT)) {
+            case MUTATE_FLIP_BIT:
+                data[pos] ^= static_cast<uint8_t>(1u << randomBelow(rng, 8));
+                break;
+            case MUTATE_RANDOM_BYTE:
+                data[pos] = static_cast<uint8_t>(nextRandom(rng));
+                break;
+            case MUTATE_INTERESTING_BYTE:
+                data[pos] = INTERESTING_8[randomBelow(rng, sizeof(INTERESTING_8))];
+                break;
+            case MUTATE_ARITH_BYTE: {
+                uint8_t delta = static_cast<uint8_t>(1 + randomBelow(rng, 35));
+                data[pos] = randomBelow(rng, 2) ? static_cast<uint8_t>(data[pos] + delta)
+                                                : static_cast<uint8_t>(data[pos] - delta);
+                break;
+            }
+            case MUTATE_INTERESTING_DWORD: {
+                uint32_t value = INTERESTING_32[randomBelow(rng, sizeof(INTERESTING_32) / sizeof(INTERESTING_32[0]))];
+                for (uint32_t i = 0; i < 4 && pos + i < size; i++) {
+                    data[pos + i] = static_cast<uint8_t>(value >> (i * 8));
+                }
+                break;
+            }
+            case MUTATE_DELETE_BLOCK:
+                if (size > 1) {
+                    uint32_t length = std::min(1 + randomBelow(rng, std::min<uint32_t>(size - pos, 16)), size - 1);
+                    data.erase(data.begin() + pos, data.begin() + pos + length);
+                }
+                break;
+            case MUTATE_CLONE_BLOCK:
+                if (size < limit) {
+                    uint32_t length = 1 + randomBelow(rng, std::min<uint32_t>(size - pos, 16));
+                    length = std::min(length, limit - size);
+                    std::vector<uint8_t> block(data.begin() + pos, data.begin() + pos + length);
+                    uint32_t at = randomBelow(rng, size + 1);
+                    data.insert(data.begin() + at, block.begin(), block.end());
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    if (data.size() > limit) {
+        data.resize(limit);
+    }
+}
+
+void Fuzzer::recordCrash(const std::vector<uint8_t>& input, VmFaultCode fault, uint64_t pc) {
+    std::lock_guard<std::mutex> lock(corpusMutex);
+    for (const S_FuzzCrash& crash : crashes) {
+        if (crash.fault == fault && crash.pc == pc) {
+            return;
+        }
+    }
+    if (crashes.size() >= MAX_CRASHES) {
+        droppedCrashes.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    S_FuzzCrash crash;
+    crash.input = input;
+    crash.fault = fault;
+    crash.pc = pc;
+    crash.execution = executions.load(std::memory_order_relaxed);
+    crashes.push_back(crash);
+}
+
+std::vector<std::vector<uint8_t>> Fuzzer::getCorpus() const {
+    std::lock_guard<std::mutex> lock(corpusMutex);
+    return corpus;
+}
+
+std::vector<S_FuzzCrash> Fuzzer::getCrashes() const {
+    std::lock_guard<std::mutex> lock(corpusMutex);
+    return crashes;
+}
+
+std::string Fuzzer::getReport() const {
+    std::lock_guard<std::mutex> lock(corpusMutex);
+    std::ostringstream oss;
+    double seconds = static_cast<double>(elapsedNs) / 1e9;
+    uint64_t total = executions.load(std::memory_order_relaxed);
+    oss << "Target: VM " << targetVmId << " (" << architecture << "), input at 0x" << std::hex
+        << config.inputAddress << std::dec << " up to " << config.maxInputLength << " bytes, "
+        << config.execInstructions << " instructions per execution" << std::endl;
+    oss << std::fixed << std::setprecision(1);
+    oss << "Duration: " << seconds << " s, Workers: " << workerStats.size() << std::endl;
+    double perSecond = seconds > 0 ? static_cast<double>(total) / seconds : 0.0;
+    uint64_t restored = 0;
+    for (const S_FuzzWorkerStats& stats : workerStats) {
+        restored += stats.restoredPages;
+    }
+    oss << "Executions: " << total << " (" << perSecond << " execs/s, "
+        << (workerStats.empty() ? 0.0 : perSecond / workerStats.size()) << " execs/s per core)" << std::endl;
+    for (size_t i = 0; i < workerStats.size(); i++) {
+        const S_FuzzWorkerStats& stats = workerStats[i];
+        double active = static_cast<double>(stats.activeNs) / 1e9;
+        oss << "  Worker " << i << " (" << (stats.core >= 0 ? "core " + std::to_string(stats.core) : "unpinned")
+            << "): " << stats.executions << " executions, "
+            << (active > 0 ? static_cast<double>(stats.executions) / active : 0.0) << " execs/s" << std::endl;
+    }
+    oss << std::setprecision(2);
+    oss << "Reset: " << (total ? static_cast<double>(restored) / total : 0.0)
+        << " dirty pages restored per execution (guest memory " << memorySize / GuestMemory::PAGE_SIZE
+        << " pages)" << std::endl;
+    oss << "Outcomes:";
+    for (size_t i = 0; i < static_cast<size_t>(FuzzOutcome::COUNT); i++) {
+        oss << " " << GetFuzzOutcomeName(static_cast<FuzzOutcome>(i)) << " "
+            << outcomeCounts[i].load(std::memory_order_relaxed);
+    }
+    oss << std::endl;
+    oss << "Coverage: " << coverage.getEdgeCount() << " edges, corpus " << corpus.size() << " (" << seedCount
+        << " seeds, " << newCoverageInputs.load(std::memory_order_relaxed) << " inputs with new coverage)" << std::endl;
+    oss << "Crashes: " << crashes.size() << " unique";
+    if (droppedCrashes.load(std::memory_order_relaxed) > 0) {
+        oss << " (" << droppedCrashes.load(std::memory_order_relaxed) << " more not kept)";
+    }
+    oss << std::endl;
+    for (size_t i = 0; i < crashes.size(); i++) {
+        oss << "  #" << i << " " << GetVmFaultName(crashes[i].fault) << " at pc 0x" << std::hex << crashes[i].pc
+            << std::dec << ", " << crashes[i].input.size() << " bytes, execution " << crashes[i].execution << std::endl;
+    }
+    return oss.str();
+}
@@ -0,0 +1,161 @@
+#ifndef FUZZER_H
+#define FUZZER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include "../CPUvm/baseVM.h"
+#include "coverage_map.h"
+
+/**
+ * @brief 为工作线程创建与目标同架构的VM（参数为工作线程序号）
+ */
+typedef std::function<std::shared_ptr<I_VmInterface>(uint32_t worker)> FuzzVmFactory;
+
+/**
+ * @brief 一次执行的结束方式
+ */
+enum class FuzzOutcome : uint8_t {
+    EXITED  = 0,    // VM停止（执行到载荷末尾或被停止）
+    HALTED  = 1,    // 停机且没有定时器可等
+    TIMEOUT = 2,    // 用完每次执行的指令数
+    FAULT   = 3,    // 执行中发生故障（记为崩溃）
+    COUNT
+};
+
+inline const char* GetFuzzOutcomeName(FuzzOutcome outcome) {
+    static const char* const names[] = {
+        "EXITED",
+        "HALTED",
+        "TIMEOUT",
+        "FAULT"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(FuzzOutcome::COUNT),
+                  "fuzz outcome name table out of sync with FuzzOutcome");
+    uint8_t index = static_cast<uint8_t>(outcome);
+    return index < static_cast<uint8_t>(FuzzOutcome::COUNT) ? names[index] : "UNKNOWN";
+}
+
+/**
+ * @brief 模糊测试参数
+ */
+struct S_FuzzConfig {
+    uint32_t inputAddress;          // 输入写入的客户机地址
+    uint32_t maxInputLength;        // 输入最大长度
+    uint32_t execInstructions;      // 每次执行的指令数上限（用完记为TIMEOUT）
+    uint32_t workers;               // 工作线程数
+    uint32_t durationMs;            // 运行时间
+    uint64_t seed;                  // 变异随机数种子
+    std::vector<int> cores;         // 工作线程依次绑定的核心（为空时不绑定）
+
+    S_FuzzConfig() : inputAddress(0), maxInputLength(256), execInstructions(10000), workers(1),
+                     durationMs(10000), seed(1) {}
+};
+
+/**
+ * @brief 一个崩溃输入（按故障码+PC去重）
+ */
+struct S_FuzzCrash {
+    std::vector<uint8_t> input;     // 触发崩溃的输入
+    VmFaultCode fault;              // 故障码
+    uint64_t pc;                    // 故障时的PC
+    uint64_t execution;             // 发现时的累计执行次数
+};
+
+/**
+ * @brief 单个工作线程的统计
+ */
+struct S_FuzzWorkerStats {
+    int core;                       // 绑定的核心（-1表示未绑定）
+    uint64_t executions;            // 执行次数
+    uint64_t activeNs;              // 线程运行时间
+    uint64_t restoredPages;         // 复位时恢复的脏页总数
+
+    S_FuzzWorkerStats() : core(-1), executions(0), activeNs(0), restoredPages(0) {}
+};
+
+/**
+ * @brief 进程内覆盖率引导的客户机载荷模糊测试
+ * @details 以目标VM当前状态为基准快照，每个工作线程创建一台同架构的私有VM
+ *          （同一载荷、同样大小的客户机内存、同一宿主服务表），按核心池绑定核心后循环：
+ *          从语料中取一个输入变异（位翻转、特殊值、算术、块删除/复制、与其他语料拼接），
+ *          复位到基准快照，把输入写入客户机内存inputAddress处、长度写入第一个通用寄存器
+ *          （eax/r0/rax），执行至多execInstructions条指令。
+ *          复位只恢复寄存器与上次执行写过的页（GuestMemory脏页跟踪），不复制整块内存。
+ *          边覆盖见CoverageTracer，合并到共享的SharedCoverageMap，出现新覆盖的输入加入语料；
+ *          执行中发生故障（资源限制除外）的输入按故障码+PC去重记为崩溃。
+ *          客户机页权限、共享内存映射与未投递的中断不复制到工作VM。
+ */
+class Fuzzer {
+public:
+    static const uint32_t MAX_WORKERS = 64;         // 工作线程数上限
+    static const size_t MAX_CORPUS = 4096;          // 语料数上限（之后只统计新覆盖，不再加入）
+    static const size_t MAX_CRASHES = 256;          // 保留的崩溃数上限
+    static const uint32_t MAX_STACKED_MUTATIONS = 8;// 每次变异叠加的操作数上限
+
+private:
+    S_FuzzConfig config;
+    FuzzVmFactory factory;
+
+    // 目标（run期间只读）
+    S_VmSnapshot baseline;                          // 基准快照
+    const uint8_t* code;                            // 目标原载荷
+    size_t codeSize;
+    uint32_t memorySize;                            // 客户机私有内存大小
+    uint64_t addressSpaceSize;                      // 客户机地址空间大小
+    I_HypercallHandler* hypercalls;                 // 目标的宿主服务表
+    uint32_t targetVmId;
+    std::string architecture;
+
+    SharedCoverageMap coverage;                     // 累计覆盖
+    mutable std::mutex corpusMutex;                 // 保护corpus与crashes
+    std::vector<std::vector<uint8_t>> corpus;       // 语料（种子在前）
+    std::vector<S_FuzzCrash> crashes;               // 崩溃输入
+    size_t seedCount;                               // 种子数
+
+    std::atomic<bool> stopRequested;
+    std::atomic<uint64_t> executions;                               // 累计执行次数
+    std::atomic<uint64_t> outcomeCounts[static_cast<size_t>(FuzzOutcome::COUNT)];
+    std::atomic<uint64_t> newCoverageInputs;                        // 带来新覆盖的输入数
+    std::atomic<uint64_t> droppedCrashes;                           // 超过上限未保留的新崩溃
+    std::vector<S_FuzzWorkerStats> workerStats;                     // 各工作线程统计（线程结束时写入）
+    std::string workerError;                                        // 工作VM准备失败的原因
+    uint64_t elapsedNs;                                             // 最近一次run的耗时
+
+    void workerLoop(uint32_t index, uint64_t deadlineNs);
+    void mutate(std::vector<uint8_t>& data, uint64_t& rng);
+    FuzzOutcome execute(I_VmInterface& vm, CoverageTracer& tracer, const std::vector<uint8_t>& input,
+                        VmFaultCode& fault);
+    void recordCrash(const std::vector<uint8_t>& input, VmFaultCode fault, uint64_t pc);
+
+public:
+    Fuzzer(const S_FuzzConfig& fuzzConfig, FuzzVmFactory vmFactory);
+
+    /**
+     * @brief 以目标VM当前状态为基准运行模糊测试，运行durationMs后返回
+     * @details 调用方需持有目标VM执行权（只在捕获基准快照时使用目标VM）
+     * @param seeds 初始语料（为空时使用目标内存中inputAddress处的maxInputLength字节）
+     * @param error 失败原因
+     * @return bool 参数无效或工作VM无法恢复基准快照时返回false
+     */
+    bool run(I_VmInterface& target, const std::vector<std::vector<uint8_t>>& seeds, std::string& error);
+
+    /**
+     * @brief 请求提前结束（任意线程）
+     */
+    void requestStop() { stopRequested.store(true, std::memory_order_release); }
+
+    /**
+     * @brief 最近一次run之后的语料与崩溃（run返回后调用）
+     */
+    std::vector<std::vector<uint8_t>> getCorpus() const;
+    std::vector<S_FuzzCrash> getCrashes() const;
+
+    std::string getReport() const;
+};
+
+#endif // FUZZER_H
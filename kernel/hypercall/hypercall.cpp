@@ -0,0 +1,230 @@
+#include "hypercall.h"
+#include "../common/fast_hash.h"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+// xorshift64*：VM私有状态推进，便于同一种子下复现
+uint64_t nextRandom(uint64_t& state) {
+    if (state == 0) {
+        state = 0x9E3779B97F4A7C15ULL;
+    }
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+} // namespace
+
+HypercallTable::HypercallTable()
+    : doorbellTarget(nullptr), batchCount(0), requestCount(0), failedCount(0), bulkBytes(0) {
+    for (uint32_t i = 0; i < static_cast<uint32_t>(HypercallService::COUNT); i++) {
+        services[i] = nullptr;
+    }
+    services[static_cast<uint32_t>(HypercallService::MEMCPY)] = &HypercallTable::serviceMemcpy;
+    services[static_cast<uint32_t>(HypercallService::MEMSET)] = &HypercallTable::serviceMemset;
+    services[static_cast<uint32_t>(HypercallService::HASH)] = &HypercallTable::serviceHash;
+    services[static_cast<uint32_t>(HypercallService::TIME)] = &HypercallTable::serviceTime;
+    services[static_cast<uint32_t>(HypercallService::RANDOM)] = &HypercallTable::serviceRandom;
+    services[static_cast<uint32_t>(HypercallService::LOG)] = &HypercallTable::serviceLog;
+    services[static_cast<uint32_t>(HypercallService::DOORBELL)] = &HypercallTable::serviceDoorbell;
+}
+
+uint32_t HypercallTable::dispatchBatch(S_HypercallContext& ctx, uint32_t batchAddr, uint32_t count) {
+    if (count == 0 || count > MAX_BATCH) {
+        return 0;
+    }
+
+    // 请求数组需要整体可读写（原地写回status/result）
+    uint32_t batchBytes = count * static_cast<uint32_t>(sizeof(S_HypercallRequest));
+    uint8_t* records = ctx.memory.translate(batchAddr, batchBytes, GUEST_PERM_RW);
+    if (!records) {
+        failedCount.fetch_add(count, std::memory_order_relaxed);
+        return 0;
+    }
+
+    uint32_t succeeded = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t* slot = records + i * sizeof(S_HypercallRequest);
+        S_HypercallRequest req;
+        std::memcpy(&req, slot, sizeof(req));  // 客户机地址未必对齐
+
+        HypercallStatus status = HypercallStatus::INVALID_SERVICE;
+        req.result = 0;
+        if (req.service < static_cast<uint32_t>(HypercallService::COUNT) && services[req.service]) {
+            status = (this->*services[req.service])(ctx, req);
+        }
+
+        req.status = static_cast<uint32_t>(status);
+        std::memcpy(slot, &req, sizeof(req));
+        if (status == HypercallStatus::OK) {
+            succeeded++;
+        }
+    }
+
+    batchCount.fetch_add(1, std::memory_order_relaxed);
+    requestCount.fetch_add(count, std::memory_order_relaxed);
+    failedCount.fetch_add(count - succeeded, std::memory_order_relaxed);
+    return succeeded;
+}
+
+HypercallStatus HypercallTable::serviceMemcpy(S_HypercallContext& ctx, S_HypercallRequest& req) {
+    uint32_t dstAddr = req.args[0];
+    uint32_t srcAddr = req.args[1];
+    uint32_t length = req.args[2];
+    if (length == 0) {
+        return HypercallStatus::OK;
+    }
+
+    const uint8_t* src = ctx.memory.translate(srcAddr, length, GUEST_PERM_READ);
+    uint8_t* dst = ctx.memory.translate(dstAddr, length, GUEST_PERM_WRITE);
+    if (!src || !dst) {
+        return HypercallStatus::ACCESS_VIOLATION;
+    }
+
+    std::memmove(dst, src, length);
+    req.result = length;
+    bulkBytes.fetch_add(length, std::memory_order_relaxed);
+    return HypercallStatus::OK;
+}
+
+HypercallStatus HypercallTable::serviceMemset(S_HypercallContext& ctx, S_HypercallRequest& req) {
+    uint32_t dstAddr = req.args[0];
+    uint32_t value = req.args[1];
+    uint32_t length = req.args[2];
+    if (value > 0xFF) {
+        return HypercallStatus::INVALID_ARGUMENT;
+    }
+    if (length == 0) {
+        return HypercallStatus::OK;
+    }
+
+    uint8_t* dst = ctx.memory.translate(dstAddr, length, GUEST_PERM_WRITE);
+    if (!dst) {
+        return HypercallStatus::ACCESS_VIOLATION;
+    }
+
+    std::memset(dst, static_cast<int>(value), length);
+    req.result = length;
+    bulkBytes.fetch_add(length, std::memory_order_relaxed);
+    return HypercallStatus::OK;
+}
+
+HypercallStatus HypercallTable::serviceHash(S_HypercallContext& ctx, S_HypercallRequest& req) {
+    uint32_t addr = req.args[0];
+    uint32_t length = req.args[1];
+    uint64_t seed = req.args[2];
+
+    if (length == 0) {
+        req.result = FastHash64(nullptr, 0, seed);
+        return HypercallStatus::OK;
+    }
+
+    const uint8_t* data = ctx.memory.translate(addr, length, GUEST_PERM_READ);
+    if (!data) {
+        return HypercallStatus::ACCESS_VIOLATION;
+    }
+
+    req.result = FastHash64(data, length, seed);
+    bulkBytes.fetch_add(length, std::memory_order_relaxed);
+    return HypercallStatus::OK;
+}
+
+HypercallStatus HypercallTable::serviceTime(S_HypercallContext& ctx, S_HypercallRequest& req) {
+    if (req.args[0] > 1) {
+        return HypercallStatus::INVALID_ARGUMENT;
+    }
+    // 宿主时钟不可重放：调试器挂接期间两种时钟都返回VM虚拟时间
+    if (ctx.virtualClock) {
+        req.result = ctx.virtualTime;
+        return HypercallStatus::OK;
+    }
+    switch (req.args[0]) {
+        case 0:
+            req.result = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            return HypercallStatus::OK;
+        case 1:
+            req.result = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            return HypercallStatus::OK;
+        default:
+            return HypercallStatus::INVALID_ARGUMENT;
+    }
+}
+
+HypercallStatus HypercallTable::serviceRandom(S_HypercallContext& ctx, S_HypercallRequest& req) {
+    uint32_t addr = req.args[0];
+    uint32_t length = req.args[1];
+
+    req.result = nextRandom(ctx.rngState);
+    if (length == 0) {
+        return HypercallStatus::OK;
+    }
+
+    uint8_t* dst = ctx.memory.translate(addr, length, GUEST_PERM_WRITE);
+    if (!dst) {
+        return HypercallStatus::ACCESS_VIOLATION;
+    }
+
+    // 每次生成8字节整块写入
+    uint32_t offset = 0;
+    while (offset + 8 <= length) {
+        uint64_t value = nextRandom(ctx.rngState);
+        std::memcpy(dst + offset, &value, 8);
+        offset += 8;
+    }
+    if (offset < length) {
+        uint64_t value = nextRandom(ctx.rngState);
+        std::memcpy(dst + offset, &value, length - offset);
+    }
+    bulkBytes.fetch_add(length, std::memory_order_relaxed);
+    return HypercallStatus::OK;
+}
+
+HypercallStatus HypercallTable::serviceLog(S_HypercallContext& ctx, S_HypercallRequest& req) {
+    uint32_t addr = req.args[0];
+    uint32_t length = req.args[1];
+    if (length > MAX_LOG_LENGTH) {
+        return HypercallStatus::INVALID_ARGUMENT;
+    }
+
+    std::string text;
+    if (length > 0) {
+        const uint8_t* data = ctx.memory.translate(addr, length, GUEST_PERM_READ);
+        if (!data) {
+            return HypercallStatus::ACCESS_VIOLATION;
+        }
+        text.assign(reinterpret_cast<const char*>(data), length);
+    }
+
+    std::cout << "[GUEST_LOG] VM:" << ctx.vmId << " " << text << std::endl;
+    req.result = length;
+    return HypercallStatus::OK;
+}
+
+HypercallStatus HypercallTable::serviceDoorbell(S_HypercallContext& ctx, S_HypercallRequest& req) {
+    if (!doorbellTarget) {
+        return HypercallStatus::INVALID_SERVICE;
+    }
+    
+    uint32_t notified = 0;
+    if (!doorbellTarget->ringDoorbell(ctx.vmId, req.args[0], notified)) {
+        return HypercallStatus::ACCESS_VIOLATION;
+    }
+    req.result = notified;
+    return HypercallStatus::OK;
+}
+
+std::string HypercallTable::getStatistics() const {
+    std::ostringstream oss;
+    oss << "Hypercall Batches: " << batchCount.load()
+        << ", Requests: " << requestCount.load()
+        << ", Failed: " << failedCount.load()
+        << ", Bulk Bytes: " << bulkBytes.load();
+    return oss.str();
+}
@@ -0,0 +1,142 @@
+#ifndef HYPERCALL_H
+#define HYPERCALL_H
+
+#include <cstdint>
+#include <atomic>
+#include <string>
+#include "../memory/guest_memory.h"
+
+/**
+ * @brief 宿主服务编号（客户机请求记录中的service字段）
+ */
+enum class HypercallService : uint32_t {
+    NONE    = 0,
+    MEMCPY  = 1,    // args: dst, src, len
+    MEMSET  = 2,    // args: dst, value, len
+    HASH    = 3,    // args: addr, len, seed  -> result: 64位哈希
+    TIME    = 4,    // args: clock(0=单调,1=墙上时间) -> result: 纳秒（调试器挂接期间为虚拟时间tick）
+    RANDOM  = 5,    // args: addr, len（len为0时只返回result）-> result: 随机数
+    LOG     = 6,    // args: addr, len
+    DOORBELL = 7,   // args: 共享区域内任意地址 -> result: 被通知的VM数
+    COUNT
+};
+
+/**
+ * @brief 单个请求的处理结果（写回请求记录的status字段）
+ */
+enum class HypercallStatus : uint32_t {
+    OK                  = 0,
+    INVALID_SERVICE     = 1,    // 未知服务编号
+    ACCESS_VIOLATION    = 2,    // 参数区间越界或权限不足
+    INVALID_ARGUMENT    = 3     // 参数超出服务允许的范围
+};
+
+/**
+ * @brief 客户机内存中的请求记录（小端，32字节）
+ * @details 客户机在内存中连续放置count条记录，执行一次超级调用指令即提交整批；
+ *          宿主原地写回status与result
+ */
+struct S_HypercallRequest {
+    uint32_t service;       // HypercallService
+    uint32_t status;        // 输出：HypercallStatus
+    uint32_t args[4];       // 服务参数
+    uint64_t result;        // 输出：服务返回值
+};
+
+static_assert(sizeof(S_HypercallRequest) == 32, "hypercall request ABI must be 32 bytes");
+
+/**
+ * @brief 一次超级调用的调用方上下文
+ */
+struct S_HypercallContext {
+    uint32_t vmId;          // 发起调用的VM
+    GuestMemory& memory;    // 发起调用的VM的客户机内存
+    uint64_t& rngState;     // VM私有随机数状态（保证同一VM可复现）
+    bool virtualClock;      // TIME返回虚拟时间而不是宿主时钟（调试器挂接期间，反向执行重放可复现）
+    uint64_t virtualTime;   // 调用时的VM虚拟时间（tick）
+
+    S_HypercallContext(uint32_t id, GuestMemory& mem, uint64_t& rng)
+        : vmId(id), memory(mem), rngState(rng), virtualClock(false), virtualTime(0) {}
+};
+
+/**
+ * @brief 超级调用处理接口，VM只依赖此接口
+ */
+class I_HypercallHandler {
+public:
+    virtual ~I_HypercallHandler() = default;
+
+    /**
+     * @brief 处理一批请求
+     * @param ctx 调用方上下文
+     * @param batchAddr 请求数组在客户机内存中的地址
+     * @param count 请求条数
+     * @return 状态为OK的请求条数；请求数组本身不可访问时返回0
+     */
+    virtual uint32_t dispatchBatch(S_HypercallContext& ctx, uint32_t batchAddr, uint32_t count) = 0;
+};
+
+/**
+ * @brief 门铃通知接口（由共享内存管理器实现）
+ */
+class I_DoorbellTarget {
+public:
+    virtual ~I_DoorbellTarget() = default;
+
+    /**
+     * @brief 通知映射了同一共享区域的其他VM
+     * @param vmId 发起方VM
+     * @param guestAddr 发起方映射内的任意客户机地址
+     * @param notified 输出：被通知的VM数
+     * @return bool 地址不在发起方的任何共享映射内返回false
+     */
+    virtual bool ringDoorbell(uint32_t vmId, uint32_t guestAddr, uint32_t& notified) = 0;
+};
+
+/**
+ * @brief 宿主服务表
+ * @details 按服务编号索引的成员函数指针表，一次陷入处理整批请求；
+ *          每个参数区间都先按客户机页权限校验，再以宿主memcpy/memset/哈希原地完成，
+ *          不再由客户机逐字节模拟
+ */
+class HypercallTable : public I_HypercallHandler {
+public:
+    static const uint32_t MAX_BATCH = 256;          // 单次调用最大请求数
+    static const uint32_t MAX_LOG_LENGTH = 256;     // 单条日志最大长度
+
+private:
+    typedef HypercallStatus (HypercallTable::*ServiceHandler)(S_HypercallContext&, S_HypercallRequest&);
+
+    ServiceHandler services[static_cast<uint32_t>(HypercallService::COUNT)];
+    I_DoorbellTarget* doorbellTarget;       // 门铃服务后端（nullptr表示未提供）
+
+    std::atomic<uint64_t> batchCount;       // 累计陷入次数
+    std::atomic<uint64_t> requestCount;     // 累计处理请求数
+    std::atomic<uint64_t> failedCount;      // 累计失败请求数
+    std::atomic<uint64_t> bulkBytes;        // 累计批量处理字节数
+
+    HypercallStatus serviceMemcpy(S_HypercallContext& ctx, S_HypercallRequest& req);
+    HypercallStatus serviceMemset(S_HypercallContext& ctx, S_HypercallRequest& req);
+    HypercallStatus serviceHash(S_HypercallContext& ctx, S_HypercallRequest& req);
+    HypercallStatus serviceTime(S_HypercallContext& ctx, S_HypercallRequest& req);
+    HypercallStatus serviceRandom(S_HypercallContext& ctx, S_HypercallRequest& req);
+    HypercallStatus serviceLog(S_HypercallContext& ctx, S_HypercallRequest& req);
+    HypercallStatus serviceDoorbell(S_HypercallContext& ctx, S_HypercallRequest& req);
+
+public:
+    HypercallTable();
+
+    uint32_t dispatchBatch(S_HypercallContext& ctx, uint32_t batchAddr, uint32_t count) override;
+    
+    /**
+     * @brief 挂接门铃服务后端（启动VM前调用）
+     */
+    void setDoorbellTarget(I_DoorbellTarget* target) { doorbellTarget = target; }
+
+    /**
+     * @brief 获取服务表统计信息
+     */
+    std::string getStatistics() const;
+};
+
+#endif // HYPERCALL_H
@@ -0,0 +1,598 @@
+#ifndef GUEST_MEMORY_H
+#define GUEST_MEMORY_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief 客户机内存页权限位
+ */
+enum GuestMemoryPermission : uint8_t {
+    GUEST_PERM_NONE  = 0,
+    GUEST_PERM_READ  = 1 << 0,
+    GUEST_PERM_WRITE = 1 << 1,
+    GUEST_PERM_EXEC  = 1 << 2,
+    GUEST_PERM_RW    = GUEST_PERM_READ | GUEST_PERM_WRITE,
+    GUEST_PERM_RWX   = GUEST_PERM_READ | GUEST_PERM_WRITE | GUEST_PERM_EXEC
+};
+
+/**
+ * @brief 客户机页表项
+ * @details 有观察点的页从permission中去掉被观察的访问权限，快速路径照常只检查permission；
+ *          granted保存真实权限，慢速路径据此放行并通知观察点处理者。
+ *          脏页跟踪期间未写过的私有页同样去掉写权限，第一次写入时由慢速路径标记为脏页；
+ *          写时复制的私有页在复制之前指向共享镜像，dirty表示已复制到自身的后备存储
+ */
+struct S_GuestPage {
+    uint8_t* hostBase;      // 该页对应的宿主内存起始地址（nullptr表示未映射）
+    uint8_t permission;     // 快速路径检查的权限（GuestMemoryPermission组合，已去掉被观察的访问）
+    uint8_t granted;        // 真实访问权限
+    uint8_t watch;          // 被观察的访问（GUEST_PERM_READ/GUEST_PERM_WRITE）
+    bool dirty;             // 脏页跟踪开始后写过
+
+    S_GuestPage() : hostBase(nullptr), permission(GUEST_PERM_NONE), granted(GUEST_PERM_NONE), watch(GUEST_PERM_NONE),
+                    dirty(false) {}
+};
+
+/**
+ * @brief 观察点处理者：访问落在被观察的页上时由慢速路径调用
+ * @details 只保证访问区间与被观察的页相交，处理者自行按精确地址区间判断；
+ *          设备可能在其他线程上访问客户机内存，实现需线程安全
+ */
+class I_GuestWatchHandler {
+public:
+    virtual ~I_GuestWatchHandler() {}
+    virtual void onWatchedAccess(uint32_t addr, uint32_t len, uint8_t permission) = 0;
+};
+
+/**
+ * @brief 客户机内存，按4KB分页并记录每页权限
+ * @details VM私有内存为一段连续宿主内存，地址从0开始；私有内存之上可预留一段
+ *          地址窗口，用mapExternal()映射外部宿主内存（如VM间共享内存区域）。
+ *          页表在allocate()时一次定长分配，之后映射只改写页表项、不会重新分配，
+ *          VM运行期间映射共享区域是安全的。
+ *          translate()在权限与宿主地址连续性都满足时直接返回宿主指针，
+ *          设备与宿主服务据此在客户机内存上原地读写，避免中间拷贝。
+ *          观察点按页实现：被观察的页去掉对应权限，未观察的页走原来的快速路径，
+ *          只有权限检查失败时才进入慢速路径按真实权限放行并通知I_GuestWatchHandler。
+ *          脏页跟踪用同样的办法：去掉私有页的写权限，第一次写入时记录该页并恢复写权限，
+ *          restoreDirty()只复制记录下的页（模糊测试每次执行后快速复位）。
+ *          cloneFrom()以只读的共享镜像作为私有内存初始内容（写时复制）：页表直接指向镜像，
+ *          第一次写入某页时才复制到自身后备存储，复位只把复制过的页指回镜像，不复制数据，
+ *          同一镜像可被任意多个实例共享（CTF题目实例）。
+ *          设备（虚拟交换机线程）与VM线程可能同时进入慢速路径，慢速路径与所有改写页表项的操作
+ *          由pageMutex串行化；快速路径不加锁，改写时先去掉权限再改宿主地址（映射时相反），
+ *          并发的快速路径只会看到无权限或完整的页表项。
+ *          对象持有指向自身后备存储的指针，因此不可拷贝。
+ */
+class GuestMemory {
+public:
+    static const uint32_t PAGE_SHIFT = 12;
+    static const uint32_t PAGE_SIZE = 1u << PAGE_SHIFT;
+    static const uint32_t PAGE_MASK = PAGE_SIZE - 1;
+
+private:
+    std::vector<uint8_t> privateBacking;    // VM私有内存后备存储
+    std::vector<S_GuestPage> pageTable;     // 页表（按页号索引）
+    uint32_t privatePages;                  // 私有内存页数（之上为外部映射窗口）
+    I_GuestWatchHandler* watchHandler;      // 观察点处理者（没有观察点时为空）
+    uint32_t watchedPages;                  // 有观察点的页数
+    bool dirtyTracking;                     // 正在跟踪脏页
+    std::vector<uint32_t> dirtyPages;       // 跟踪开始（或上次复位）后写过的私有页（写时复制时为已复制的页）
+    std::shared_ptr<const std::vector<uint8_t>> sharedImage; // 写时复制的共享镜像（为空表示普通私有内存）
+    mutable std::mutex pageMutex;           // 串行化慢速路径与页表改写（快速路径不加锁）
+
+    /**
+     * @brief 按真实权限、观察状态与脏页跟踪状态重新计算快速路径权限
+     */
+    void refreshPermission(uint64_t page) {
+        S_GuestPage& entry = pageTable[page];
+        entry.permission = entry.granted & ~entry.watch;
+        if ((dirtyTracking || sharedImage) && page < privatePages && !entry.dirty) {
+            entry.permission &= ~GUEST_PERM_WRITE;
+        }
+    }
+
+    /**
+     * @brief 记录私有页被写过；写时复制时先把该页从共享镜像复制到后备存储
+     * @details 后备存储在第一次复制时按私有内存大小一次分配，之后不再重新分配；调用方持有pageMutex
+     */
+    void markDirty(uint64_t page) {
+        S_GuestPage& entry = pageTable[page];
+        if (sharedImage) {
+            if (privateBacking.empty()) {
+                privateBacking.resize(static_cast<size_t>(privatePages) << PAGE_SHIFT);
+            }
+            uint8_t* copy = privateBacking.data() + (static_cast<size_t>(page) << PAGE_SHIFT);
+            std::memcpy(copy, entry.hostBase, PAGE_SIZE);
+            entry.hostBase = copy;
+        }
+        entry.dirty = true;
+        dirtyPages.push_back(static_cast<uint32_t>(page));
+        refreshPermission(page);
+    }
+
+    /**
+     * @brief 把复制过的页指回共享镜像（调用方持有pageMutex）
+     * @details 先去掉写权限再改宿主地址，并发的快速路径不会写入共享镜像
+     */
+    size_t rollbackPages() {
+        if (!sharedImage) {
+            return 0;
+        }
+        size_t count = dirtyPages.size();
+        uint8_t* base = const_cast<uint8_t*>(sharedImage->data());
+        for (uint32_t page : dirtyPages) {
+            pageTable[page].dirty = false;
+            refreshPermission(page);
+            pageTable[page].hostBase = base + (static_cast<size_t>(page) << PAGE_SHIFT);
+        }
+        dirtyPages.clear();
+        return count;
+    }
+
+    /**
+     * @brief 区间内各页的宿主内存是否连续
+     */
+    bool isContiguous(uint64_t firstPage, uint64_t lastPage) const {
+        const uint8_t* base = pageTable[firstPage].hostBase;
+        for (uint64_t page = firstPage + 1; page <= lastPage; page++) {
+            if (pageTable[page].hostBase != base + ((page - firstPage) << PAGE_SHIFT)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 慢速路径：按真实权限转换，区间与被观察的页相交时通知处理者
+     * @param notify 为false时只转换不通知（调试器自身的访问）
+     */
+    uint8_t* translateWatched(uint32_t addr, uint32_t len, uint8_t permission, bool notify) {
+        std::lock_guard<std::mutex> lock(pageMutex);
+        if (watchedPages == 0 && !dirtyTracking && !sharedImage) {
+            return nullptr;
+        }
+        uint32_t firstPage = addr >> PAGE_SHIFT;
+        uint64_t lastPage = (static_cast<uint64_t>(addr) + len - 1) >> PAGE_SHIFT;
+        bool watched = false;
+        for (uint64_t page = firstPage; page <= lastPage; page++) {
+            const S_GuestPage& entry = pageTable[page];
+            if ((entry.granted & permission) != permission || !entry.hostBase) {
+                return nullptr;
+            }
+            watched = watched || (entry.watch & permission) != 0;
+        }
+        // 写入时记录脏页；写时复制时跨越已复制与未复制页的访问同样先复制，使区间在后备存储中连续
+        bool write = (permission & GUEST_PERM_WRITE) != 0;
+        if ((dirtyTracking && write) ||
+            (sharedImage && (write || !isContiguous(firstPage, lastPage)))) {
+            for (uint64_t page = firstPage; page <= lastPage && page < privatePages; page++) {
+                if (!pageTable[page].dirty) {
+                    markDirty(page);
+                }
+            }
+        }
+        if (!isContiguous(firstPage, lastPage)) {
+            return nullptr;
+        }
+        const S_GuestPage& first = pageTable[firstPage];
+        if (watched && notify && watchHandler) {
+            watchHandler->onWatchedAccess(addr, len, permission);
+        }
+        return first.hostBase + (addr & PAGE_MASK);
+    }
+
+public:
+    GuestMemory() : privatePages(0), watchHandler(nullptr), watchedPages(0), dirtyTracking(false) {}
+    GuestMemory(const GuestMemory&) = delete;
+    GuestMemory& operator=(const GuestMemory&) = delete;
+
+    /**
+     * @brief 分配VM私有内存（已分配时会整体重建，之前的内容丢失）
+     * @param size 字节数，向上取整到页
+     * @param permission 初始页权限
+     * @param addressSpaceSize 客户机地址空间总大小（不小于size，多出部分留给外部映射）
+     * @return bool 分配成功返回true
+     */
+    bool allocate(uint32_t size, uint8_t permission = GUEST_PERM_RW, uint32_t addressSpaceSize = 0) {
+        uint32_t pageCount = (size + PAGE_MASK) >> PAGE_SHIFT;
+        if (pageCount == 0) {
+            return false;
+        }
+        uint32_t totalPages = static_cast<uint32_t>((static_cast<uint64_t>(addressSpaceSize) + PAGE_MASK) >> PAGE_SHIFT);
+        privateBacking.assign(static_cast<size_t>(pageCount) << PAGE_SHIFT, 0);
+        pageTable.assign(totalPages > pageCount ? totalPages : pageCount, S_GuestPage());
+        privatePages = pageCount;
+        for (uint32_t i = 0; i < pageCount; i++) {
+            pageTable[i].hostBase = privateBacking.data() + (static_cast<size_t>(i) << PAGE_SHIFT);
+            pageTable[i].permission = permission;
+            pageTable[i].granted = permission;
+        }
+        watchedPages = 0;
+        dirtyTracking = false;
+        dirtyPages.clear();
+        sharedImage.reset();
+        return true;
+    }
+
+    /**
+     * @brief 以共享镜像作为私有内存初始内容（写时复制，之前的内容丢失）
+     * @details 不分配也不复制私有内存，第一次写入某页时才复制该页
+     * @param image 私有内存内容（大小为页的整数倍，之后不得修改）
+     * @param permission 初始页权限
+     * @param addressSpaceSize 客户机地址空间总大小（不小于镜像大小，多出部分留给外部映射）
+     * @return bool 镜像为空或不是整页时返回false
+     */
+    bool cloneFrom(const std::shared_ptr<const std::vector<uint8_t>>& image, uint8_t permission = GUEST_PERM_RW,
+                   uint32_t addressSpaceSize = 0) {
+        if (!image || image->empty() || (image->size() & PAGE_MASK) ||
+            (image->size() >> PAGE_SHIFT) > UINT32_MAX) {
+            return false;
+        }
+        uint32_t pageCount = static_cast<uint32_t>(image->size() >> PAGE_SHIFT);
+        uint32_t totalPages = static_cast<uint32_t>((static_cast<uint64_t>(addressSpaceSize) + PAGE_MASK) >> PAGE_SHIFT);
+        privateBacking.clear();
+        privateBacking.shrink_to_fit();
+        pageTable.assign(totalPages > pageCount ? totalPages : pageCount, S_GuestPage());
+        privatePages = pageCount;
+        sharedImage = image;
+        watchedPages = 0;
+        dirtyTracking = false;
+        dirtyPages.clear();
+        // 镜像只通过去掉写权限的页表项访问，写入前总会先复制
+        uint8_t* base = const_cast<uint8_t*>(image->data());
+        for (uint32_t i = 0; i < pageCount; i++) {
+            pageTable[i].hostBase = base + (static_cast<size_t>(i) << PAGE_SHIFT);
+            pageTable[i].granted = permission;
+            refreshPermission(i);
+        }
+        return true;
+    }
+
+    bool isCopyOnWrite() const { return sharedImage != nullptr; }
+
+    // 私有内存大小（字节）
+    uint32_t getSize() const { return privatePages << PAGE_SHIFT; }
+    // 客户机地址空间大小（字节，含外部映射窗口）
+    uint64_t getAddressSpaceSize() const { return static_cast<uint64_t>(pageTable.size()) << PAGE_SHIFT; }
+    bool isAllocated() const { return !pageTable.empty(); }
+
+    /**
+     * @brief 将客户机地址区间转换为宿主指针
+     * @param addr 客户机地址
+     * @param len 区间长度
+     * @param permission 需要的访问权限
+     * @param notify 访问被观察的页时是否通知观察点处理者
+     * @return 区间内所有页都具备权限且宿主内存连续时返回宿主指针，否则返回nullptr
+     */
+    uint8_t* translate(uint32_t addr, uint32_t len, uint8_t permission, bool notify = true) {
+        if (len == 0) {
+            return nullptr;
+        }
+        uint64_t end = static_cast<uint64_t>(addr) + len - 1;
+        uint32_t firstPage = addr >> PAGE_SHIFT;
+        uint64_t lastPage = end >> PAGE_SHIFT;
+        if (lastPage >= pageTable.size()) {
+            return nullptr;
+        }
+
+        const S_GuestPage& first = pageTable[firstPage];
+        if (!first.hostBase || (first.permission & permission) != permission) {
+            return translateWatched(addr, len, permission, notify);
+        }
+        for (uint64_t page = firstPage + 1; page <= lastPage; page++) {
+            const S_GuestPage& entry = pageTable[page];
+            if ((entry.permission & permission) != permission ||
+                entry.hostBase != first.hostBase + ((page - firstPage) << PAGE_SHIFT)) {
+                return translateWatched(addr, len, permission, notify);
+            }
+        }
+        return first.hostBase + (addr & PAGE_MASK);
+    }
+
+    const uint8_t* translate(uint32_t addr, uint32_t len, uint8_t permission) const {
+        return const_cast<GuestMemory*>(this)->translate(addr, len, permission);
+    }
+
+    /**
+     * @brief 检查区间是否具备指定权限
+     * @details 只按真实权限检查，不通知观察点、不复制写时复制页也不记录脏页（提交时的校验不是访问）
+     */
+    bool checkAccess(uint32_t addr, uint32_t len, uint8_t permission) const {
+        if (len == 0) {
+            return false;
+        }
+        uint64_t lastPage = (static_cast<uint64_t>(addr) + len - 1) >> PAGE_SHIFT;
+        if (lastPage >= pageTable.size()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(pageMutex);
+        for (uint64_t page = addr >> PAGE_SHIFT; page <= lastPage; page++) {
+            const S_GuestPage& entry = pageTable[page];
+            if (!entry.hostBase || (entry.granted & permission) != permission) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool read(uint32_t addr, void* dst, uint32_t len) const {
+        const uint8_t* src = translate(addr, len, GUEST_PERM_READ);
+        if (!src) {
+            return false;
+        }
+        std::memcpy(dst, src, len);
+        return true;
+    }
+
+    bool write(uint32_t addr, const void* src, uint32_t len) {
+        uint8_t* dst = translate(addr, len, GUEST_PERM_WRITE);
+        if (!dst) {
+            return false;
+        }
+        std::memcpy(dst, src, len);
+        return true;
+    }
+
+    /**
+     * @brief 调试器读写：按真实权限访问，不触发观察点
+     */
+    bool peek(uint32_t addr, void* dst, uint32_t len) const {
+        GuestMemory* self = const_cast<GuestMemory*>(this);
+        const uint8_t* src = self->translate(addr, len, GUEST_PERM_READ, false);
+        if (!src) {
+            return false;
+        }
+        std::memcpy(dst, src, len);
+        return true;
+    }
+
+    bool poke(uint32_t addr, const void* src, uint32_t len) {
+        uint8_t* dst = translate(addr, len, GUEST_PERM_WRITE, false);
+        if (!dst) {
+            return false;
+        }
+        std::memcpy(dst, src, len);
+        return true;
+    }
+
+    /**
+     * @brief 修改区间内所有页的权限（被观察的访问仍从快速路径权限中去掉）
+     * @return bool 区间越界返回false
+     */
+    bool protect(uint32_t addr, uint32_t len, uint8_t permission) {
+        if (len == 0) {
+            return false;
+        }
+        uint64_t lastPage = (static_cast<uint64_t>(addr) + len - 1) >> PAGE_SHIFT;
+        if (lastPage >= pageTable.size()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(pageMutex);
+        for (uint64_t page = addr >> PAGE_SHIFT; page <= lastPage; page++) {
+            pageTable[page].granted = permission;
+            refreshPermission(page);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 设置观察点处理者（nullptr表示不再通知）
+     */
+    void setWatchHandler(I_GuestWatchHandler* handler) { watchHandler = handler; }
+
+    /**
+     * @brief 观察区间所在的页：去掉这些页快速路径上的access权限
+     * @param access 被观察的访问（GUEST_PERM_READ/GUEST_PERM_WRITE组合）
+     * @return bool 区间越界返回false
+     */
+    bool watchPages(uint32_t addr, uint32_t len, uint8_t access) {
+        if (len == 0) {
+            return false;
+        }
+        uint64_t lastPage = (static_cast<uint64_t>(addr) + len - 1) >> PAGE_SHIFT;
+        if (lastPage >= pageTable.size()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(pageMutex);
+        for (uint64_t page = addr >> PAGE_SHIFT; page <= lastPage; page++) {
+            S_GuestPage& entry = pageTable[page];
+            if (entry.watch == GUEST_PERM_NONE) {
+                watchedPages++;
+            }
+            entry.watch |= access;
+            refreshPermission(page);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 解除所有页的观察，恢复真实权限
+     */
+    void clearWatches() {
+        std::lock_guard<std::mutex> lock(pageMutex);
+        for (size_t page = 0; page < pageTable.size(); page++) {
+            pageTable[page].watch = GUEST_PERM_NONE;
+            refreshPermission(page);
+        }
+        watchedPages = 0;
+    }
+
+    uint32_t getWatchedPageCount() const { return watchedPages; }
+
+    /**
+     * @brief 开始脏页跟踪：当前内容作为基准，之后写过的私有页被记录下来
+     * @details 写时复制时始终在跟踪，基准固定为共享镜像
+     */
+    void startDirtyTracking() {
+        std::lock_guard<std::mutex> lock(pageMutex);
+        dirtyTracking = true;
+        if (sharedImage) {
+            return;
+        }
+        dirtyPages.clear();
+        for (uint32_t page = 0; page < privatePages; page++) {
+            pageTable[page].dirty = false;
+            refreshPermission(page);
+        }
+    }
+
+    /**
+     * @brief 结束脏页跟踪，恢复所有页的写权限
+     */
+    void stopDirtyTracking() {
+        std::lock_guard<std::mutex> lock(pageMutex);
+        dirtyTracking = false;
+        if (sharedImage) {
+            return;
+        }
+        dirtyPages.clear();
+        for (uint32_t page = 0; page < privatePages; page++) {
+            pageTable[page].dirty = false;
+            refreshPermission(page);
+        }
+    }
+
+    bool isDirtyTracking() const { return dirtyTracking || sharedImage; }
+    size_t getDirtyPageCount() const {
+        std::lock_guard<std::mutex> lock(pageMutex);
+        return dirtyPages.size();
+    }
+
+    /**
+     * @brief 只把写过的页恢复为image中的内容，并重新开始跟踪
+     * @details 写时复制时只把复制过的页指回共享镜像（image只用于校验大小）
+     * @param image 跟踪开始时的私有内存内容（由调用方保证一致，如同一快照）
+     * @return bool 未在跟踪或大小不一致时返回false
+     */
+    bool restoreDirty(const std::vector<uint8_t>& image) {
+        std::lock_guard<std::mutex> lock(pageMutex);
+        if (sharedImage) {
+            if (image.size() != sharedImage->size()) {
+                return false;
+            }
+            rollbackPages();
+            return true;
+        }
+        if (!dirtyTracking || image.size() != privateBacking.size()) {
+            return false;
+        }
+        for (uint32_t page : dirtyPages) {
+            size_t offset = static_cast<size_t>(page) << PAGE_SHIFT;
+            pageTable[page].dirty = false;
+            refreshPermission(page);
+            std::memcpy(privateBacking.data() + offset, image.data() + offset, PAGE_SIZE);
+        }
+        dirtyPages.clear();
+        return true;
+    }
+    
+    /**
+     * @brief 写时复制：把复制过的页指回共享镜像，私有内存恢复为镜像内容
+     * @return size_t 指回的页数（非写时复制时为0）
+     */
+    size_t rollback() {
+        std::lock_guard<std::mutex> lock(pageMutex);
+        return rollbackPages();
+    }
+    
+    /**
+     * @brief 复制私有内存内容（快照用，不含外部映射窗口）
+     */
+    void savePrivate(std::vector<uint8_t>& out) const {
+        std::lock_guard<std::mutex> lock(pageMutex);
+        if (!sharedImage) {
+            out.assign(privateBacking.begin(), privateBacking.end());
+            return;
+        }
+        out.resize(static_cast<size_t>(privatePages) << PAGE_SHIFT);
+        for (uint32_t page = 0; page < privatePages; page++) {
+            std::memcpy(out.data() + (static_cast<size_t>(page) << PAGE_SHIFT), pageTable[page].hostBase, PAGE_SIZE);
+        }
+    }
+
+    /**
+     * @brief 用快照内容覆盖私有内存（页表与权限不变）
+     * @details 写时复制时所有页先复制到后备存储，之后rollback()仍可回到共享镜像
+     * @return bool 大小与当前私有内存不一致时返回false
+     */
+    bool restorePrivate(const std::vector<uint8_t>& data) {
+        if (data.size() != getSize()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(pageMutex);
+        if (sharedImage) {
+            for (uint32_t page = 0; page < privatePages; page++) {
+                if (!pageTable[page].dirty) {
+                    markDirty(page);
+                }
+            }
+        }
+        if (!data.empty()) {
+            std::memcpy(privateBacking.data(), data.data(), data.size());
+        }
+        return true;
+    }
+    
+    /**
+     * @brief 把外部宿主内存映射到私有内存之上的地址窗口
+     * @param addr 客户机地址（页对齐）
+     * @param hostBase 宿主内存起始地址
+     * @param len 长度，向上取整到页
+     * @param permission 该VM对这段内存的访问权限
+     * @return bool 地址未对齐、越界或与已有映射重叠时返回false
+     */
+    bool mapExternal(uint32_t addr, uint8_t* hostBase, uint32_t len, uint8_t permission) {
+        if (!hostBase || len == 0 || (addr & PAGE_MASK)) {
+            return false;
+        }
+        uint64_t firstPage = addr >> PAGE_SHIFT;
+        uint64_t pageCount = (static_cast<uint64_t>(len) + PAGE_MASK) >> PAGE_SHIFT;
+        if (firstPage < privatePages || firstPage + pageCount > pageTable.size()) {
+            return false;
+        }
+        for (uint64_t i = 0; i < pageCount; i++) {
+            if (pageTable[firstPage + i].hostBase) {
+                return false;
+            }
+        }
+        // 先写宿主地址再写权限，并发的translate()只会看到无权限或完整的页表项
+        for (uint64_t i = 0; i < pageCount; i++) {
+            pageTable[firstPage + i].hostBase = hostBase + (i << PAGE_SHIFT);
+        }
+        for (uint64_t i = 0; i < pageCount; i++) {
+            pageTable[firstPage + i].granted = permission;
+            pageTable[firstPage + i].permission = permission & ~pageTable[firstPage + i].watch;
+        }
+        return true;
+    }
+    
+    /**
+     * @brief 解除外部映射
+     * @return bool 区间越界或落在私有内存内返回false
+     */
+    bool unmapExternal(uint32_t addr, uint32_t len) {
+        if (len == 0 || (addr & PAGE_MASK)) {
+            return false;
+        }
+        uint64_t firstPage = addr >> PAGE_SHIFT;
+        uint64_t pageCount = (static_cast<uint64_t>(len) + PAGE_MASK) >> PAGE_SHIFT;
+        if (firstPage < privatePages || firstPage + pageCount > pageTable.size()) {
+            return false;
+        }
+        for (uint64_t i = 0; i < pageCount; i++) {
+            pageTable[firstPage + i].permission = GUEST_PERM_NONE;
+            pageTable[firstPage + i].granted = GUEST_PERM_NONE;
+        }
+        for (uint64_t i = 0; i < pageCount; i++) {
+            pageTable[firstPage + i].hostBase = nullptr;
+        }
+        return true;
+    }
+};
+
+#endif // GUEST_MEMORY_H
@@ -0,0 +1,166 @@
+#include "shared_memory.h"
+#include <sstream>
+#include <algorithm>
+
+bool SharedMemoryManager::createRegion(const std::string& name, uint32_t size) {
+    if (name.empty() || size == 0 || size > MAX_REGION_SIZE) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(regionMutex);
+    if (regions.count(name)) {
+        return false;
+    }
+
+    std::unique_ptr<S_ShmRegion> region(new S_ShmRegion());
+    region->name = name;
+    region->size = (size + GuestMemory::PAGE_MASK) & ~GuestMemory::PAGE_MASK;
+    region->storage.reset(new uint8_t[region->size + SHM_ALIGNMENT]());
+    uintptr_t raw = reinterpret_cast<uintptr_t>(region->storage.get());
+    region->base = reinterpret_cast<uint8_t*>((raw + SHM_ALIGNMENT - 1) & ~static_cast<uintptr_t>(SHM_ALIGNMENT - 1));
+    regions[name] = std::move(region);
+    return true;
+}
+
+bool SharedMemoryManager::destroyRegion(const std::string& name) {
+    std::lock_guard<std::mutex> lock(regionMutex);
+    auto it = regions.find(name);
+    if (it == regions.end() || !it->second->mappings.empty()) {
+        return false;
+    }
+    regions.erase(it);
+    return true;
+}
+
+bool SharedMemoryManager::mapRegion(const std::string& name, I_VmInterface* vm,
+                                    uint32_t guestAddr, uint8_t permission) {
+    if (!vm) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(regionMutex);
+    auto it = regions.find(name);
+    if (it == regions.end()) {
+        return false;
+    }
+
+    S_ShmRegion& region = *it->second;
+    uint32_t vmId = vm->getVmId();
+    for (const auto& mapping : region.mappings) {
+        if (mapping.vmId == vmId) {
+            return false;
+        }
+    }
+
+    if (!vm->getMemory().mapExternal(guestAddr, region.base, region.size, permission)) {
+        return false;
+    }
+
+    S_ShmMapping mapping;
+    mapping.vmId = vmId;
+    mapping.vm = vm;
+    mapping.guestAddr = guestAddr;
+    mapping.permission = permission;
+    region.mappings.push_back(mapping);
+    return true;
+}
+
+bool SharedMemoryManager::unmapRegion(const std::string& name, uint32_t vmId) {
+    std::lock_guard<std::mutex> lock(regionMutex);
+    auto it = regions.find(name);
+    if (it == regions.end()) {
+        return false;
+    }
+
+    S_ShmRegion& region = *it->second;
+    auto mapping = std::find_if(region.mappings.begin(), region.mappings.end(),
+                                [vmId](const S_ShmMapping& m) { return m.vmId == vmId; });
+    if (mapping == region.mappings.end()) {
+        return false;
+    }
+
+    mapping->vm->getMemory().unmapExternal(mapping->guestAddr, region.size);
+    region.mappings.erase(mapping);
+    return true;
+}
+
+void SharedMemoryManager::unmapAll(uint32_t vmId) {
+    std::lock_guard<std::mutex> lock(regionMutex);
+    for (auto& pair : regions) {
+        S_ShmRegion& region = *pair.second;
+        for (auto it = region.mappings.begin(); it != region.mappings.end();) {
+            if (it->vmId == vmId) {
+                it->vm->getMemory().unmapExternal(it->guestAddr, region.size);
+                it = region.mappings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+uint32_t SharedMemoryManager::notifyPeers(S_ShmRegion& region, uint32_t fromVmId) {
+    uint32_t notified = 0;
+    for (const auto& mapping : region.mappings) {
+        if (mapping.vmId != fromVmId) {
+            mapping.vm->getInterruptController().raise(IRQ_VECTOR_DOORBELL);
+            notified++;
+        }
+    }
+    region.doorbells.fetch_add(1, std::memory_order_relaxed);
+    return notified;
+}
+
+int SharedMemoryManager::ringDoorbell(const std::string& name, uint32_t fromVmId) {
+    std::lock_guard<std::mutex> lock(regionMutex);
+    auto it = regions.find(name);
+    if (it == regions.end()) {
+        return -1;
+    }
+    return static_cast<int>(notifyPeers(*it->second, fromVmId));
+}
+
+bool SharedMemoryManager::ringDoorbell(uint32_t vmId, uint32_t guestAddr, uint32_t& notified) {
+    std::lock_guard<std::mutex> lock(regionMutex);
+    for (auto& pair : regions) {
+        S_ShmRegion& region = *pair.second;
+        for (const auto& mapping : region.mappings) {
+            if (mapping.vmId == vmId && guestAddr >= mapping.guestAddr &&
+                guestAddr - mapping.guestAddr < region.size) {
+                notified = notifyPeers(region, vmId);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+uint8_t* SharedMemoryManager::getRegionBase(const std::string& name, uint32_t* size) {
+    std::lock_guard<std::mutex> lock(regionMutex);
+    auto it = regions.find(name);
+    if (it == regions.end()) {
+        return nullptr;
+    }
+    if (size) {
+        *size = it->second->size;
+    }
+    return it->second->base;
+}
+
+std::string SharedMemoryManager::getStatistics() const {
+    std::lock_guard<std::mutex> lock(regionMutex);
+    std::ostringstream oss;
+    oss << "=== Shared Memory Regions ===" << std::endl;
+    oss << "Regions: " << regions.size() << std::endl;
+    for (const auto& pair : regions) {
+        const S_ShmRegion& region = *pair.second;
+        oss << "  " << region.name << ": " << region.size << " bytes, "
+            << region.mappings.size() << " mappings, "
+            << region.doorbells.load(std::memory_order_relaxed) << " doorbells" << std::endl;
+        for (const auto& mapping : region.mappings) {
+            oss << "    VM " << mapping.vmId << " @ 0x" << std::hex << mapping.guestAddr << std::dec
+                << " (" << ((mapping.permission & GUEST_PERM_WRITE) ? "rw" : "r") << ")" << std::endl;
+        }
+    }
+    return oss.str();
+}
@@ -0,0 +1,115 @@
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include "../CPUvm/baseVM.h"
+#include "../hypercall/hypercall.h"
+#include "shm_ring.h"
+
+/**
+ * @brief 共享区域在某个VM中的映射
+ */
+struct S_ShmMapping {
+    uint32_t vmId;              // 映射方VM
+    I_VmInterface* vm;          // 映射方VM（用于门铃中断）
+    uint32_t guestAddr;         // 映射到的客户机地址
+    uint8_t permission;         // 该VM的访问权限
+};
+
+/**
+ * @brief 命名共享内存区域
+ * @details 宿主内存只分配一次，各VM通过页表直接映射同一段内存，
+ *          数据在VM间传递时不经过宿主拷贝
+ */
+struct S_ShmRegion {
+    std::string name;                       // 区域名
+    uint32_t size;                          // 区域大小（页对齐）
+    std::unique_ptr<uint8_t[]> storage;     // 宿主后备存储（多分配一个缓存行用于对齐）
+    uint8_t* base;                          // 缓存行对齐后的区域起始地址
+    std::vector<S_ShmMapping> mappings;     // 当前映射列表
+    std::atomic<uint64_t> doorbells;        // 累计门铃次数
+
+    S_ShmRegion() : size(0), base(nullptr), doorbells(0) {}
+};
+
+/**
+ * @brief 共享内存管理器
+ * @details 管理命名区域的创建、按VM映射与门铃通知。映射关系由互斥锁保护，
+ *          数据面（环读写）完全在客户机映射上进行，不经过管理器。
+ *          门铃向映射同一区域的其他VM触发IRQ_VECTOR_DOORBELL中断。
+ */
+class SharedMemoryManager : public I_DoorbellTarget {
+public:
+    static const uint32_t MAX_REGION_SIZE = 64 * 1024 * 1024;  // 单个区域上限
+    static const uint32_t SHM_ALIGNMENT = 64;                   // 区域起始地址对齐（缓存行）
+
+private:
+    std::map<std::string, std::unique_ptr<S_ShmRegion>> regions;   // 按名称索引的区域
+    mutable std::mutex regionMutex;                                 // 保护regions与映射列表
+
+    uint32_t notifyPeers(S_ShmRegion& region, uint32_t fromVmId);
+
+public:
+    SharedMemoryManager() {}
+    SharedMemoryManager(const SharedMemoryManager&) = delete;
+    SharedMemoryManager& operator=(const SharedMemoryManager&) = delete;
+
+    /**
+     * @brief 创建区域
+     * @param name 区域名
+     * @param size 字节数，向上取整到页
+     * @return bool 重名或大小非法返回false
+     */
+    bool createRegion(const std::string& name, uint32_t size);
+
+    /**
+     * @brief 销毁区域（仍有VM映射时失败）
+     */
+    bool destroyRegion(const std::string& name);
+
+    /**
+     * @brief 把区域映射进VM的客户机地址空间
+     * @param name 区域名
+     * @param vm 目标VM
+     * @param guestAddr 客户机地址（页对齐，位于私有内存之上的映射窗口）
+     * @param permission 该VM的访问权限
+     * @return bool 区域不存在、已映射或地址不可用返回false
+     */
+    bool mapRegion(const std::string& name, I_VmInterface* vm, uint32_t guestAddr, uint8_t permission);
+
+    /**
+     * @brief 解除区域在VM中的映射
+     */
+    bool unmapRegion(const std::string& name, uint32_t vmId);
+
+    /**
+     * @brief 解除VM的全部映射（删除VM前调用）
+     */
+    void unmapAll(uint32_t vmId);
+
+    /**
+     * @brief 以发起方VM的名义按区域名敲门铃（控制台使用）
+     * @return 被通知的VM数，区域不存在返回-1
+     */
+    int ringDoorbell(const std::string& name, uint32_t fromVmId);
+
+    bool ringDoorbell(uint32_t vmId, uint32_t guestAddr, uint32_t& notified) override;
+
+    /**
+     * @brief 获取区域的宿主地址（宿主侧工具与测试使用）
+     */
+    uint8_t* getRegionBase(const std::string& name, uint32_t* size = nullptr);
+
+    /**
+     * @brief 获取区域与映射列表
+     */
+    std::string getStatistics() const;
+};
+
+#endif // SHARED_MEMORY_H
@@ -0,0 +1,235 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <new>
+
+static const uint32_t SHM_RING_MAGIC = 0x474E5253;     // "SRNG"
+static const uint32_t SHM_RING_CACHE_LINE = 64;
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared memory rings need address-free 64-bit atomics");
+
+/**
+ * @brief 共享内存消息环类型
+ */
+enum class ShmRingKind : uint32_t {
+    SPSC = 1,   // 单生产者单消费者：生产位置直接写入
+    MPSC = 2    // 多生产者单消费者：生产位置CAS抢占
+};
+
+/**
+ * @brief 消息环头部，位于共享区域起始处（192字节）
+ * @details 生产/消费位置各占一个缓存行，避免两端互相失效
+ */
+struct S_ShmRingHeader {
+    uint32_t magic;                                 // SHM_RING_MAGIC
+    uint32_t kind;                                  // ShmRingKind
+    uint32_t slotSize;                              // 每槽载荷容量（字节）
+    uint32_t slotCount;                             // 槽数（2的幂）
+    uint8_t pad0[SHM_RING_CACHE_LINE - 16];
+    std::atomic<uint64_t> head;                     // 下一个生产位置
+    uint8_t pad1[SHM_RING_CACHE_LINE - sizeof(std::atomic<uint64_t>)];
+    std::atomic<uint64_t> tail;                     // 下一个消费位置
+    uint8_t pad2[SHM_RING_CACHE_LINE - sizeof(std::atomic<uint64_t>)];
+};
+
+/**
+ * @brief 槽头部，紧随其后是slotSize字节载荷
+ * @details sequence采用Vyukov有界队列约定：等于位置时可写，等于位置+1时可读，
+ *          消费后置为位置+槽数供下一圈使用
+ */
+struct S_ShmSlotHeader {
+    std::atomic<uint64_t> sequence;                 // 槽状态序号
+    uint32_t length;                                // 已提交的消息长度
+    uint32_t reserved;
+};
+
+/**
+ * @brief 共享内存区域上的无锁消息环视图
+ * @details 区域由一方format()后，各参与方用自己的映射地址构造视图即可收发；
+ *          reserve()/commit()与peek()/release()直接返回槽内指针，消息只在
+ *          生产者填充时写入一次，消费者原地读取，不经过宿主中转拷贝。
+ *          仅支持单消费者；SPSC环的生产端也必须唯一。
+ */
+class ShmRing {
+private:
+    S_ShmRingHeader* header;    // 环头部
+    uint8_t* slots;             // 首个槽地址
+    uint32_t stride;            // 槽步长（槽头+载荷，按缓存行对齐）
+    uint64_t mask;              // 槽下标掩码
+
+    static uint32_t slotStride(uint32_t slotSize) {
+        uint32_t raw = static_cast<uint32_t>(sizeof(S_ShmSlotHeader)) + slotSize;
+        return (raw + SHM_RING_CACHE_LINE - 1) & ~(SHM_RING_CACHE_LINE - 1);
+    }
+
+    S_ShmSlotHeader* slotAt(uint64_t position) const {
+        return reinterpret_cast<S_ShmSlotHeader*>(slots + (position & mask) * stride);
+    }
+
+public:
+    /**
+     * @brief 在共享区域上初始化消息环
+     * @param base 区域起始地址（至少8字节对齐）
+     * @param regionSize 区域大小
+     * @param kind 环类型
+     * @param slotSize 每槽载荷容量
+     * @return 槽数，区域放不下两个槽时返回0
+     */
+    static uint32_t format(uint8_t* base, uint32_t regionSize, ShmRingKind kind, uint32_t slotSize) {
+        if (!base || slotSize == 0 || regionSize <= sizeof(S_ShmRingHeader)) {
+            return 0;
+        }
+        uint32_t stride = slotStride(slotSize);
+        uint32_t available = (regionSize - static_cast<uint32_t>(sizeof(S_ShmRingHeader))) / stride;
+        if (available < 2) {
+            return 0;
+        }
+        uint32_t slotCount = 1;
+        while (slotCount * 2 <= available) {
+            slotCount *= 2;
+        }
+
+        S_ShmRingHeader* header = new (base) S_ShmRingHeader();
+        header->kind = static_cast<uint32_t>(kind);
+        header->slotSize = slotSize;
+        header->slotCount = slotCount;
+        header->head.store(0, std::memory_order_relaxed);
+        header->tail.store(0, std::memory_order_relaxed);
+        uint8_t* slots = base + sizeof(S_ShmRingHeader);
+        for (uint32_t i = 0; i < slotCount; i++) {
+            S_ShmSlotHeader* slot = new (slots + static_cast<size_t>(i) * stride) S_ShmSlotHeader();
+            slot->sequence.store(i, std::memory_order_relaxed);
+            slot->length = 0;
+        }
+        // magic最后写入，attach方看到magic即可认为环已就绪
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = SHM_RING_MAGIC;
+        return slotCount;
+    }
+
+    /**
+     * @brief 附着到已格式化的区域
+     * @param base 本方映射得到的区域起始地址
+     * @param regionSize 区域大小（用于校验头部）
+     */
+    ShmRing(uint8_t* base, uint32_t regionSize) : header(nullptr), slots(nullptr), stride(0), mask(0) {
+        if (!base || regionSize <= sizeof(S_ShmRingHeader)) {
+            return;
+        }
+        S_ShmRingHeader* candidate = reinterpret_cast<S_ShmRingHeader*>(base);
+        if (candidate->magic != SHM_RING_MAGIC || candidate->slotCount == 0 ||
+            (candidate->slotCount & (candidate->slotCount - 1)) != 0) {
+            return;
+        }
+        uint32_t candidateStride = slotStride(candidate->slotSize);
+        uint64_t needed = sizeof(S_ShmRingHeader) + static_cast<uint64_t>(candidateStride) * candidate->slotCount;
+        if (needed > regionSize) {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        header = candidate;
+        slots = base + sizeof(S_ShmRingHeader);
+        stride = candidateStride;
+        mask = candidate->slotCount - 1;
+    }
+
+    bool isValid() const { return header != nullptr; }
+    uint32_t getSlotSize() const { return header ? header->slotSize : 0; }
+    uint32_t getSlotCount() const { return header ? header->slotCount : 0; }
+
+    /**
+     * @brief 预留一个槽（生产端）
+     * @param ticket 输出：提交时使用的位置
+     * @return 槽内载荷指针，环满返回nullptr
+     */
+    uint8_t* reserve(uint64_t& ticket) {
+        uint64_t position = header->head.load(std::memory_order_relaxed);
+        for (;;) {
+            S_ShmSlotHeader* slot = slotAt(position);
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+            if (diff < 0) {
+                return nullptr;
+            }
+            if (diff == 0) {
+                if (header->kind == static_cast<uint32_t>(ShmRingKind::SPSC)) {
+                    header->head.store(position + 1, std::memory_order_relaxed);
+                    break;
+                }
+                if (header->head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else {
+                position = header->head.load(std::memory_order_relaxed);
+            }
+        }
+        ticket = position;
+        return reinterpret_cast<uint8_t*>(slotAt(position)) + sizeof(S_ShmSlotHeader);
+    }
+
+    /**
+     * @brief 提交已填充的槽
+     */
+    void commit(uint64_t ticket, uint32_t length) {
+        S_ShmSlotHeader* slot = slotAt(ticket);
+        slot->length = length;
+        slot->sequence.store(ticket + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 查看下一条消息（消费端）
+     * @param length 输出：消息长度
+     * @return 槽内载荷指针，环空返回nullptr
+     */
+    const uint8_t* peek(uint32_t& length) const {
+        uint64_t position = header->tail.load(std::memory_order_relaxed);
+        S_ShmSlotHeader* slot = slotAt(position);
+        if (slot->sequence.load(std::memory_order_acquire) != position + 1) {
+            return nullptr;
+        }
+        length = slot->length;
+        return reinterpret_cast<const uint8_t*>(slot) + sizeof(S_ShmSlotHeader);
+    }
+
+    /**
+     * @brief 归还peek()得到的槽
+     */
+    void release() {
+        uint64_t position = header->tail.load(std::memory_order_relaxed);
+        slotAt(position)->sequence.store(position + header->slotCount, std::memory_order_release);
+        header->tail.store(position + 1, std::memory_order_release);
+    }
+
+    bool push(const void* data, uint32_t length) {
+        if (length > header->slotSize) {
+            return false;
+        }
+        uint64_t ticket;
+        uint8_t* dst = reserve(ticket);
+        if (!dst) {
+            return false;
+        }
+        std::memcpy(dst, data, length);
+        commit(ticket, length);
+        return true;
+    }
+
+    bool pop(void* out, uint32_t capacity, uint32_t& length) {
+        const uint8_t* src = peek(length);
+        if (!src || length > capacity) {
+            return false;
+        }
+        std::memcpy(out, src, length);
+        release();
+        return true;
+    }
+
+    uint64_t sizeApprox() const {
+        return header->head.load(std::memory_order_acquire) - header->tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif // SHM_RING_H
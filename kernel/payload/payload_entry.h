@@ -0,0 +1,40 @@
+#ifndef PAYLOAD_ENTRY_H
+#define PAYLOAD_ENTRY_H
+
+#include <string>
+#include "../CPUvm/baseVM.h"
+#include "payload_format.h"
+
+/**
+ * @brief 把载荷容器的入口状态装入VM
+ * @details 调用方先setPayload(image.code)并分配客户机内存；数据段写入私有内存，
+ *          初始寄存器按调试寄存器编号写入，最后设置入口PC与定时器中断入口
+ * @return bool 架构不符、数据段越界或寄存器编号无效时返回false（VM状态可能已部分修改）
+ */
+inline bool PayloadApplyEntryState(I_VmInterface& vm, const std::string& type, const S_PayloadImage& image,
+                                   std::string& error) {
+    if (!image.architecture.empty() && image.architecture != type) {
+        error = "payload is built for " + image.architecture + ", not " + type;
+        return false;
+    }
+    if (!image.data.empty() &&
+        !vm.getMemory().poke(image.dataAddress, image.data.data(), static_cast<uint32_t>(image.data.size()))) {
+        error = "payload data section does not fit in guest memory";
+        return false;
+    }
+    const S_DebugTarget& target = vm.getDebugTarget();
+    for (const S_PayloadRegister& reg : image.registers) {
+        if (reg.index >= target.registerCount || target.registers[reg.index].bits > 64) {
+            error = "invalid initial register " + std::to_string(reg.index);
+            return false;
+        }
+        vm.writeDebugRegister(reg.index, reg.value);
+    }
+    vm.setProgramCounter(image.entryPc);
+    if (image.interruptEntry != PAYLOAD_NO_INTERRUPT_ENTRY) {
+        vm.getInterruptController().setVectorEntry(IRQ_VECTOR_TIMER, image.interruptEntry);
+    }
+    return true;
+}
+
+#endif // PAYLOAD_ENTRY_H
@@ -0,0 +1,153 @@
+#ifndef PAYLOAD_FORMAT_H
+#define PAYLOAD_FORMAT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../common/fast_hash.h"
+
+/**
+ * @brief 载荷容器文件格式（payload_gen写出，控制台vm create与diff_test读取）
+ * @details 代码段之外还带有载荷运行所需的入口状态：初始数据段（装入客户机私有内存）、
+ *          初始寄存器（按调试寄存器编号）、入口PC与定时器中断入口。
+ *          文件 = S_PayloadFileHeader + registerCount个S_PayloadRegister + codeSize字节代码 + dataSize字节数据；
+ *          不以PAYLOAD_FILE_MAGIC开头的文件按原始代码处理（入口0，无数据段与初始寄存器）。
+ */
+static const uint32_t PAYLOAD_FILE_MAGIC = 0x4C50594D;  // "MYPL"
+static const uint32_t PAYLOAD_FILE_VERSION = 1;
+static const uint32_t PAYLOAD_MAX_REGISTERS = 64;        // 初始寄存器项数上限
+static const uint32_t PAYLOAD_NO_INTERRUPT_ENTRY = 0xFFFFFFFF; // 不设置定时器中断入口
+
+struct S_PayloadFileHeader {
+    uint32_t magic;                 // PAYLOAD_FILE_MAGIC
+    uint32_t version;               // PAYLOAD_FILE_VERSION
+    char architecture[16];          // 架构（x86/arm/x64，与vm create的类型一致）
+    uint32_t codeSize;              // 代码段字节数
+    uint32_t dataSize;              // 数据段字节数
+    uint32_t dataAddress;           // 数据段装入的客户机地址
+    uint32_t registerCount;         // 初始寄存器项数
+    uint32_t interruptEntry;        // 定时器中断入口（PAYLOAD_NO_INTERRUPT_ENTRY表示不设置）
+    uint32_t reserved;
+    uint64_t entryPc;               // 入口PC
+    uint64_t seed;                  // 生成器种子（非生成的载荷为0）
+    uint64_t codeHash;              // 代码段FastHash64
+    uint64_t dataHash;              // 数据段FastHash64
+};
+
+struct S_PayloadRegister {
+    uint32_t index;                 // 调试寄存器编号（getDebugTarget的寄存器表下标）
+    uint32_t reserved;
+    uint64_t value;
+};
+
+/**
+ * @brief 内存中的载荷容器
+ */
+struct S_PayloadImage {
+    std::string architecture;
+    std::vector<uint8_t> code;
+    std::vector<uint8_t> data;
+    std::vector<S_PayloadRegister> registers;
+    uint32_t dataAddress;
+    uint32_t interruptEntry;
+    uint64_t entryPc;
+    uint64_t seed;
+
+    S_PayloadImage() : dataAddress(0), interruptEntry(PAYLOAD_NO_INTERRUPT_ENTRY), entryPc(0), seed(0) {}
+};
+
+inline bool PayloadIsContainer(const uint8_t* data, size_t size) {
+    uint32_t magic = 0;
+    if (size < sizeof(S_PayloadFileHeader)) {
+        return false;
+    }
+    std::memcpy(&magic, data, sizeof(magic));
+    return magic == PAYLOAD_FILE_MAGIC;
+}
+
+inline void PayloadEncode(const S_PayloadImage& image, std::vector<uint8_t>& out) {
+    S_PayloadFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = PAYLOAD_FILE_MAGIC;
+    header.version = PAYLOAD_FILE_VERSION;
+    std::strncpy(header.architecture, image.architecture.c_str(), sizeof(header.architecture) - 1);
+    header.codeSize = static_cast<uint32_t>(image.code.size());
+    header.dataSize = static_cast<uint32_t>(image.data.size());
+    header.dataAddress = image.dataAddress;
+    header.registerCount = static_cast<uint32_t>(image.registers.size());
+    header.interruptEntry = image.interruptEntry;
+    header.entryPc = image.entryPc;
+    header.seed = image.seed;
+    header.codeHash = FastHash64(image.code.data(), image.code.size());
+    header.dataHash = FastHash64(image.data.data(), image.data.size());
+
+    size_t registerBytes = image.registers.size() * sizeof(S_PayloadRegister);
+    out.resize(sizeof(header) + registerBytes + image.code.size() + image.data.size());
+    uint8_t* p = out.data();
+    std::memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    if (registerBytes) {
+        std::memcpy(p, image.registers.data(), registerBytes);
+        p += registerBytes;
+    }
+    if (!image.code.empty()) {
+        std::memcpy(p, image.code.data(), image.code.size());
+        p += image.code.size();
+    }
+    if (!image.data.empty()) {
+        std::memcpy(p, image.data.data(), image.data.size());
+    }
+}
+
+/**
+ * @brief 解析载荷文件内容
+ * @details 不是容器时整个文件作为代码段；容器的长度、版本与两段哈希都校验
+ * @return bool 容器格式错误或校验失败时返回false
+ */
+inline bool PayloadDecode(const uint8_t* data, size_t size, S_PayloadImage& image, std::string& error) {
+    image = S_PayloadImage();
+    if (!PayloadIsContainer(data, size)) {
+        image.code.assign(data, data + size);
+        return true;
+    }
+    S_PayloadFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != PAYLOAD_FILE_VERSION) {
+        error = "unsupported payload container version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.registerCount > PAYLOAD_MAX_REGISTERS) {
+        error = "too many initial registers";
+        return false;
+    }
+    uint64_t registerBytes = static_cast<uint64_t>(header.registerCount) * sizeof(S_PayloadRegister);
+    if (sizeof(header) + registerBytes + header.codeSize + header.dataSize != size) {
+        error = "payload container size mismatch";
+        return false;
+    }
+    const uint8_t* p = data + sizeof(header);
+    image.registers.resize(header.registerCount);
+    if (registerBytes) {
+        std::memcpy(image.registers.data(), p, static_cast<size_t>(registerBytes));
+        p += registerBytes;
+    }
+    image.code.assign(p, p + header.codeSize);
+    p += header.codeSize;
+    image.data.assign(p, p + header.dataSize);
+    if (FastHash64(image.code.data(), image.code.size()) != header.codeHash ||
+        FastHash64(image.data.data(), image.data.size()) != header.dataHash) {
+        error = "payload container checksum mismatch";
+        return false;
+    }
+    header.architecture[sizeof(header.architecture) - 1] = '\0';
+    image.architecture = header.architecture;
+    image.dataAddress = header.dataAddress;
+    image.interruptEntry = header.interruptEntry;
+    image.entryPc = header.entryPc;
+    image.seed = header.seed;
+    return true;
+}
+
+#endif // PAYLOAD_FORMAT_H
@@ -0,0 +1,430 @@
+#include "payload_generator.h"
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include "../hypercall/hypercall.h"
+
+namespace {
+
+// xorshift64*：与模糊测试相同，同一种子生成同一载荷
+uint64_t nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+uint32_t randomBelow(uint64_t& state, uint32_t limit) {
+    return limit ? static_cast<uint32_t>(nextRandom(state) % limit) : 0;
+}
+
+// 种子乘奇数常数后相加（一一对应，相邻种子不会得到同一状态），状态不能为0
+uint64_t seedState(uint64_t seed, uint64_t salt) {
+    uint64_t state = seed * 0x9E3779B97F4A7C15ULL + salt;
+    return state ? state : salt;
+}
+
+/**
+ * @brief 指令组类别（一组为一条指令，arm的超级调用连同参数准备为3条）
+ */
+enum class UnitKind : uint8_t {
+    ALU,
+    STACK,
+    MEMORY,
+    TIME,
+    UNKNOWN
+};
+
+/**
+ * @brief x86/x64的单字节指令编码
+ */
+struct S_ByteIsa {
+    uint8_t alu[6];                 // 运算与传送（只改写eax/rax与标志）
+    uint8_t push;
+    uint8_t pop;
+    uint8_t vmcall;
+    uint8_t rdtsc;
+    uint8_t timer;
+    uint8_t iret;
+    uint8_t unknown;
+    uint32_t accumulator;           // eax/rax的调试寄存器编号
+    uint32_t batchAddress;          // ebx/rbx
+    uint32_t batchCount;            // ecx/rcx
+};
+
+const S_ByteIsa X86_ISA = {
+    { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 }, 0x06, 0x07, 0x0F, 0x31, 0x30, 0xCF, 0x90, 0, 3, 1
+};
+
+const S_ByteIsa X64_ISA = {
+    { 0x48, 0x89, 0x01, 0x29, 0xFF, 0xFE }, 0x50, 0x58, 0x0F, 0x31, 0x30, 0xCF, 0x90, 0, 1, 2
+};
+
+const uint32_t ARM_ALU_OPCODES[] = { 0x0, 0x1, 0x2, 0x4, 0x5, 0xD };    // AND/EOR/SUB/ADD/ADC/MOV
+const uint32_t ARM_UNDEFINED_OPCODES[] = { 0x3, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC };
+const uint32_t ARM_ADD = 0x4;
+const uint32_t ARM_MOV = 0xD;
+const uint32_t ARM_SYSTEM = 0xF;
+const uint32_t ARM_HVC = 0x0;
+const uint32_t ARM_ERET = 0x2;
+const uint32_t ARM_RDCYCLE = 0x3;
+const uint32_t ARM_TIMER = 0x4;
+const uint32_t ARM_DATA_REGISTERS = 9;      // 随机运算只使用r0~r8
+const uint32_t ARM_TABLE_BASE = 9;          // r9：请求表地址
+const uint32_t ARM_LOOP_TARGET = 10;        // r10：循环回跳目标（减4）
+const uint32_t ARM_LOOP_EXIT = 11;          // r11：循环出口（减4），中断处理程序复制到r10
+const uint32_t ARM_PC = 15;
+const uint32_t ARM_LOOP_SETUP = 5;          // 循环前的设置指令数
+const uint32_t TIMER_ONE_SHOT = 1;
+const uint32_t TIMER_PERIODIC = 2;
+
+uint32_t encodeArm(uint32_t opcode, uint32_t rn, uint32_t rd, uint32_t operand2) {
+    return (opcode << 21) | (rn << 16) | (rd << 12) | (operand2 & 0xFFF);
+}
+
+/**
+ * @brief 生成过程的状态
+ */
+struct S_GenState {
+    const S_PayloadGenConfig& config;
+    uint64_t rng;
+    uint32_t memoryWeight;          // 没有请求表时为0
+    uint32_t nextRequest;           // arm下一次超级调用使用的请求表项
+
+    S_GenState(const S_PayloadGenConfig& genConfig, bool hasTable)
+        : config(genConfig), rng(seedState(genConfig.seed, 0x6A09E667F3BCC909ULL)),
+          memoryWeight(hasTable ? genConfig.memoryWeight : 0), nextRequest(0) {}
+
+    uint32_t totalWeight() const {
+        return config.aluWeight + config.stackWeight + memoryWeight + config.timeWeight + config.unknownWeight;
+    }
+
+    UnitKind pick() {
+        uint32_t value = randomBelow(rng, totalWeight());
+        if (value < config.aluWeight) {
+            return UnitKind::ALU;
+        }
+        value -= config.aluWeight;
+        if (value < config.stackWeight) {
+            return UnitKind::STACK;
+        }
+        value -= config.stackWeight;
+        if (value < memoryWeight) {
+            return UnitKind::MEMORY;
+        }
+        value -= memoryWeight;
+        return value < config.timeWeight ? UnitKind::TIME : UnitKind::UNKNOWN;
+    }
+};
+
+/**
+ * @brief x86/x64的一段顺序代码，段末补齐出栈使压栈与出栈成对
+ */
+void emitByteRegion(S_GenState& state, const S_ByteIsa& isa, uint32_t count, std::vector<uint8_t>& code) {
+    uint32_t depth = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        switch (state.pick()) {
+            case UnitKind::ALU:
+                code.push_back(isa.alu[randomBelow(state.rng, sizeof(isa.alu))]);
+                break;
+            case UnitKind::STACK:
+                if (depth > 0 && (depth >= PayloadGenerator::MAX_STACK_DEPTH || randomBelow(state.rng, 2))) {
+                    code.push_back(isa.pop);
+                    depth--;
+                } else {
+                    code.push_back(isa.push);
+                    depth++;
+                }
+                break;
+            case UnitKind::MEMORY:
+                code.push_back(isa.vmcall);
+                break;
+            case UnitKind::TIME:
+                code.push_back(isa.rdtsc);
+                break;
+            case UnitKind::UNKNOWN:
+                code.push_back(isa.unknown);
+                break;
+        }
+    }
+    code.insert(code.end(), depth, isa.pop);
+}
+
+void generateByteCode(S_GenState& state, const S_ByteIsa& isa, S_PayloadImage& image) {
+    const S_PayloadGenConfig& config = state.config;
+    // 中断处理程序放在开头，入口跳过它（没有跳转指令，主程序执行到载荷末尾结束）
+    if (config.loops > 0) {
+        emitByteRegion(state, isa, config.loopBody, image.code);
+        image.code.push_back(isa.iret);
+        image.interruptEntry = 0;
+        image.entryPc = image.code.size();
+        image.code.push_back(isa.timer);
+    }
+    emitByteRegion(state, isa, config.instructions, image.code);
+
+    uint32_t count = config.loops > 0 ? TIMER_PERIODIC : config.requests;
+    if (config.loops > 0) {
+        image.registers.push_back(S_PayloadRegister{ isa.accumulator, 0, config.loopTicks });
+    }
+    if (state.memoryWeight > 0) {
+        image.registers.push_back(S_PayloadRegister{ isa.batchAddress, 0, config.dataAddress });
+    }
+    if (state.memoryWeight > 0 || config.loops > 0) {
+        image.registers.push_back(S_PayloadRegister{ isa.batchCount, 0, count });
+    }
+}
+
+void appendArm(std::vector<uint8_t>& code, uint32_t instruction) {
+    for (uint32_t byte = 0; byte < 4; byte++) {
+        code.push_back(static_cast<uint8_t>(instruction >> (8 * byte)));  // 小端
+    }
+}
+
+void emitArmUnit(S_GenState& state, std::vector<uint32_t>& out) {
+    uint64_t& rng = state.rng;
+    switch (state.pick()) {
+        case UnitKind::MEMORY: {
+            uint32_t slot = state.nextRequest++ % state.config.requests;
+            out.push_back(encodeArm(ARM_ADD, ARM_TABLE_BASE, 0, slot * sizeof(S_HypercallRequest)));
+            out.push_back(encodeArm(ARM_MOV, 0, 1, 1));
+            out.push_back(encodeArm(ARM_SYSTEM, 0, 0, ARM_HVC));
+            return;
+        }
+        case UnitKind::TIME:
+            out.push_back(encodeArm(ARM_SYSTEM, 0, 0, ARM_RDCYCLE));
+            return;
+        case UnitKind::UNKNOWN: {
+            uint32_t opcode = ARM_UNDEFINED_OPCODES[randomBelow(rng, sizeof(ARM_UNDEFINED_OPCODES) /
+                                                                      sizeof(ARM_UNDEFINED_OPCODES[0]))];
+            out.push_back(encodeArm(opcode, randomBelow(rng, 16), randomBelow(rng, 16), randomBelow(rng, 0x1000)));
+            return;
+        }
+        default: {
+            uint32_t opcode = ARM_ALU_OPCODES[randomBelow(rng, sizeof(ARM_ALU_OPCODES) / sizeof(ARM_ALU_OPCODES[0]))];
+            uint32_t operand2 = randomBelow(rng, 2) ? randomBelow(rng, 16) : randomBelow(rng, 0x1000);
+            out.push_back(encodeArm(opcode, randomBelow(rng, ARM_DATA_REGISTERS), randomBelow(rng, ARM_DATA_REGISTERS),
+                                    operand2));
+            return;
+        }
+    }
+}
+
+/**
+ * @brief arm的一段代码：count组指令，按分支密度在组前插入向前跳过1~3组的ADD pc, pc, #imm
+ */
+void emitArmBlock(S_GenState& state, uint32_t count, std::vector<uint32_t>& out) {
+    std::vector<std::vector<uint32_t>> units(count);
+    for (uint32_t i = 0; i < count; i++) {
+        emitArmUnit(state, units[i]);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t remaining = count - i;
+        if (remaining > 1 && randomBelow(state.rng, 100) < state.config.branchPercent) {
+            uint32_t skip = 1 + randomBelow(state.rng, std::min(remaining - 1, 3u));
+            uint32_t words = 0;
+            for (uint32_t j = 0; j < skip; j++) {
+                words += static_cast<uint32_t>(units[i + j].size());
+            }
+            out.push_back(encodeArm(ARM_ADD, ARM_PC, ARM_PC, words * 4));  // 执行后pc = pc + imm + 4
+        }
+        out.insert(out.end(), units[i].begin(), units[i].end());
+    }
+}
+
+/**
+ * @brief arm计数循环
+ * @details r10 = 循环头 - 4，r11 = 出口 - 4，单次定时器loopTicks后到期；
+ *          循环体末尾ADD pc, r10, #0回到循环头，中断处理程序把r10改为r11后返回，下一次回跳即离开循环
+ */
+void emitArmLoop(S_GenState& state, uint32_t body, std::vector<uint8_t>& code) {
+    std::vector<uint32_t> words;
+    emitArmBlock(state, body, words);
+    uint32_t start = static_cast<uint32_t>(code.size());
+    uint32_t head = start + ARM_LOOP_SETUP * 4;
+    uint32_t exit = head + static_cast<uint32_t>(words.size() + 1) * 4;
+    appendArm(code, encodeArm(ARM_ADD, ARM_PC, ARM_LOOP_TARGET, head - 4 - start));
+    appendArm(code, encodeArm(ARM_ADD, ARM_PC, ARM_LOOP_EXIT, exit - 4 - (start + 4)));
+    appendArm(code, encodeArm(ARM_MOV, 0, 0, state.config.loopTicks));
+    appendArm(code, encodeArm(ARM_MOV, 0, 1, TIMER_ONE_SHOT));
+    appendArm(code, encodeArm(ARM_SYSTEM, 0, 0, ARM_TIMER));
+    for (uint32_t word : words) {
+        appendArm(code, word);
+    }
+    appendArm(code, encodeArm(ARM_ADD, ARM_LOOP_TARGET, ARM_PC, 0));
+}
+
+void generateArmCode(S_GenState& state, S_PayloadImage& image) {
+    const S_PayloadGenConfig& config = state.config;
+    uint32_t loops = config.loops;
+    uint32_t body = 0;
+    if (loops > 0) {
+        appendArm(image.code, encodeArm(ARM_ADD, ARM_LOOP_EXIT, ARM_LOOP_TARGET, 0));
+        appendArm(image.code, encodeArm(ARM_SYSTEM, 0, 0, ARM_ERET));
+        image.interruptEntry = 0;
+        image.entryPc = image.code.size();
+        body = std::max(1u, std::min(config.loopBody, config.instructions / loops));
+    }
+    // 循环之外的指令组平均分成loops + 1段，与循环交替排列
+    uint32_t straight = config.instructions > loops * body ? config.instructions - loops * body : 0;
+    for (uint32_t segment = 0; segment <= loops; segment++) {
+        uint32_t count = straight / (loops + 1) + (segment == loops ? straight % (loops + 1) : 0);
+        std::vector<uint32_t> words;
+        emitArmBlock(state, count, words);
+        for (uint32_t word : words) {
+            appendArm(image.code, word);
+        }
+        if (segment < loops) {
+            emitArmLoop(state, body, image.code);
+        }
+    }
+    if (state.memoryWeight > 0) {
+        image.registers.push_back(S_PayloadRegister{ ARM_TABLE_BASE, 0, config.dataAddress });
+    }
+}
+
+/**
+ * @brief 请求表：MEMCPY/MEMSET/HASH，访问地址按模式排列在请求表之后的访问窗口内
+ */
+void buildRequestTable(S_GenState& state, S_PayloadImage& image) {
+    const S_PayloadGenConfig& config = state.config;
+    uint32_t tableBytes = config.requests * static_cast<uint32_t>(sizeof(S_HypercallRequest));
+    uint32_t base = (config.dataAddress + tableBytes + 63) & ~63u;
+    uint32_t span = config.memoryWindow - config.accessBytes + 1;
+    std::vector<uint32_t> addresses(config.requests);
+    for (uint32_t i = 0; i < config.requests; i++) {
+        uint64_t offset = 0;
+        switch (config.memoryPattern) {
+            case PayloadMemoryPattern::SEQUENTIAL: offset = static_cast<uint64_t>(i) * config.accessBytes; break;
+            case PayloadMemoryPattern::STRIDED: offset = static_cast<uint64_t>(i) * config.stride; break;
+            default: offset = randomBelow(state.rng, span) & ~7u; break;
+        }
+        addresses[i] = base + static_cast<uint32_t>(offset % span);
+    }
+
+    image.dataAddress = config.dataAddress;
+    image.data.resize(tableBytes);
+    for (uint32_t i = 0; i < config.requests; i++) {
+        S_HypercallRequest request;
+        uint32_t kind = randomBelow(state.rng, 4);
+        request.status = 0;
+        request.result = 0;
+        request.args[3] = 0;
+        if (kind < 2) {
+            request.service = static_cast<uint32_t>(HypercallService::MEMCPY);
+            request.args[0] = addresses[i];
+            request.args[1] = addresses[(i + 1) % config.requests];
+            request.args[2] = config.accessBytes;
+        } else if (kind == 2) {
+            request.service = static_cast<uint32_t>(HypercallService::MEMSET);
+            request.args[0] = addresses[i];
+            request.args[1] = randomBelow(state.rng, 256);
+            request.args[2] = config.accessBytes;
+        } else {
+            request.service = static_cast<uint32_t>(HypercallService::HASH);
+            request.args[0] = addresses[i];
+            request.args[1] = config.accessBytes;
+            request.args[2] = static_cast<uint32_t>(nextRandom(state.rng));
+        }
+        std::memcpy(&image.data[i * sizeof(request)], &request, sizeof(request));
+    }
+}
+
+} // namespace
+
+const uint32_t PayloadGenerator::MAX_INSTRUCTIONS;
+const uint32_t PayloadGenerator::MAX_ARM_LOOP_BODY;
+const uint32_t PayloadGenerator::MAX_ARM_REQUESTS;
+const uint32_t PayloadGenerator::MAX_ARM_TICKS;
+const uint32_t PayloadGenerator::MAX_STACK_DEPTH;
+
+bool PayloadGenerator::applyProfile(const std::string& name, S_PayloadGenConfig& config) {
+    S_PayloadGenConfig profile;
+    if (name == "alu") {
+        profile.aluWeight = 90;
+        profile.stackWeight = 8;
+        profile.memoryWeight = 0;
+        profile.timeWeight = 0;
+        profile.loops = 0;
+        profile.branchPercent = 0;
+        profile.memoryPattern = PayloadMemoryPattern::NONE;
+        profile.requests = 0;
+    } else if (name == "memory") {
+        profile.aluWeight = 30;
+        profile.stackWeight = 0;
+        profile.memoryWeight = 60;
+        profile.timeWeight = 8;
+        profile.loops = 0;
+        profile.branchPercent = 0;
+        profile.requests = 64;
+    } else if (name == "loops") {
+        profile.loops = 8;
+        profile.loopBody = 8;
+        profile.loopTicks = 100;
+        profile.branchPercent = 30;
+    } else if (name != "mixed") {
+        return false;
+    }
+    profile.architecture = config.architecture;
+    profile.seed = config.seed;
+    profile.instructions = config.instructions;
+    config = profile;
+    return true;
+}
+
+bool PayloadGenerator::generate(const S_PayloadGenConfig& config, S_PayloadImage& image, std::string& error) {
+    bool arm = config.architecture == "arm";
+    const S_ByteIsa* isa = config.architecture == "x86" ? &X86_ISA : (config.architecture == "x64" ? &X64_ISA : nullptr);
+    if (!arm && !isa) {
+        error = "unknown architecture: " + config.architecture;
+        return false;
+    }
+    if (config.instructions == 0 || config.instructions > MAX_INSTRUCTIONS) {
+        error = "instruction count must be 1.." + std::to_string(MAX_INSTRUCTIONS);
+        return false;
+    }
+    bool hasTable = config.memoryPattern != PayloadMemoryPattern::NONE && config.requests > 0;
+    if (hasTable) {
+        uint64_t end = static_cast<uint64_t>(config.dataAddress) + config.requests * sizeof(S_HypercallRequest) +
+                       64 + config.memoryWindow;
+        if (config.requests > (arm ? MAX_ARM_REQUESTS : HypercallTable::MAX_BATCH)) {
+            error = "too many requests for " + config.architecture;
+            return false;
+        }
+        if (config.accessBytes == 0 || config.accessBytes > config.memoryWindow || end > UINT32_MAX ||
+            (config.memoryPattern == PayloadMemoryPattern::STRIDED && config.stride == 0)) {
+            error = "memory access window is invalid";
+            return false;
+        }
+    }
+    if (config.loops > 0 && (config.loopBody == 0 || config.loopTicks == 0)) {
+        error = "loop body and loop ticks must be positive";
+        return false;
+    }
+    if (arm && config.loops > 0 && (config.loopBody > MAX_ARM_LOOP_BODY || config.loopTicks > MAX_ARM_TICKS)) {
+        error = "arm loops allow at most " + std::to_string(MAX_ARM_LOOP_BODY) + " body instructions and " +
+                std::to_string(MAX_ARM_TICKS) + " ticks";
+        return false;
+    }
+    if (config.branchPercent > 100) {
+        error = "branch density must be 0..100";
+        return false;
+    }
+    S_GenState state(config, hasTable);
+    if (state.totalWeight() == 0) {
+        error = "instruction mix is empty";
+        return false;
+    }
+
+    image = S_PayloadImage();
+    image.architecture = config.architecture;
+    image.seed = config.seed;
+    if (arm) {
+        generateArmCode(state, image);
+    } else {
+        generateByteCode(state, *isa, image);
+    }
+    if (hasTable) {
+        buildRequestTable(state, image);
+    }
+    return true;
+}
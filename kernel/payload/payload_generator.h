@@ -0,0 +1,108 @@
+#ifndef PAYLOAD_GENERATOR_H
+#define PAYLOAD_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include "payload_format.h"
+
+/**
+ * @brief 超级调用请求表的内存访问模式
+ * @details 决定请求表中每条请求访问的客户机地址：SEQUENTIAL按请求顺序连续排列，
+ *          STRIDED每条请求间隔stride字节（可跨页），RANDOM在访问窗口内随机；NONE不生成请求表
+ */
+enum class PayloadMemoryPattern : uint8_t {
+    NONE        = 0,
+    SEQUENTIAL  = 1,
+    STRIDED     = 2,
+    RANDOM      = 3,
+    COUNT
+};
+
+inline const char* GetPayloadMemoryPatternName(PayloadMemoryPattern pattern) {
+    static const char* const names[] = {
+        "none",
+        "sequential",
+        "strided",
+        "random"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(PayloadMemoryPattern::COUNT),
+                  "memory pattern name table out of sync with PayloadMemoryPattern");
+    uint8_t index = static_cast<uint8_t>(pattern);
+    return index < static_cast<uint8_t>(PayloadMemoryPattern::COUNT) ? names[index] : "unknown";
+}
+
+inline bool ParsePayloadMemoryPattern(const std::string& name, PayloadMemoryPattern& pattern) {
+    for (uint8_t i = 0; i < static_cast<uint8_t>(PayloadMemoryPattern::COUNT); i++) {
+        if (name == GetPayloadMemoryPatternName(static_cast<PayloadMemoryPattern>(i))) {
+            pattern = static_cast<PayloadMemoryPattern>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 载荷生成参数
+ * @details 指令组成按权重在五类之间选取：运算（算术/逻辑/传送）、栈（压栈与出栈成对出现）、
+ *          内存（超级调用，访问请求表描述的区间）、读虚拟时间、未实现的编码（解码后跳过）。
+ *          arm没有栈指令，栈权重计入运算。
+ *          循环：arm为计数循环，循环前以单次定时器设定运行时长，中断处理程序把回跳目标改为循环出口；
+ *          x86/x64没有跳转指令，loops不为0时生成一个周期定时器中断处理程序（每loopTicks执行一次循环体）。
+ *          分支密度只对arm有效：以该百分比在指令组前插入向前跳过1~3组指令的写PC指令
+ */
+struct S_PayloadGenConfig {
+    std::string architecture;       // x86/arm/x64
+    uint64_t seed;                  // 同一参数与种子生成同一载荷
+    uint32_t instructions;          // 主程序指令组数（不含生成器插入的循环控制与中断处理程序）
+    uint32_t aluWeight;             // 指令组成权重
+    uint32_t stackWeight;
+    uint32_t memoryWeight;
+    uint32_t timeWeight;
+    uint32_t unknownWeight;
+    uint32_t loops;                 // arm：循环个数；x86/x64：非0时生成周期中断处理程序
+    uint32_t loopBody;              // 循环体（中断处理程序）指令组数
+    uint32_t loopTicks;             // arm：每个循环运行的虚拟时间；x86/x64：定时器周期
+    uint32_t branchPercent;         // arm向前跳转的百分比
+    PayloadMemoryPattern memoryPattern;
+    uint32_t requests;              // 请求表条数
+    uint32_t accessBytes;           // 每条请求访问的字节数
+    uint32_t stride;                // STRIDED模式的间隔
+    uint32_t dataAddress;           // 请求表的客户机地址（访问窗口紧随其后）
+    uint32_t memoryWindow;          // 访问窗口大小
+
+    S_PayloadGenConfig() : seed(1), instructions(256), aluWeight(60), stackWeight(10), memoryWeight(15),
+                           timeWeight(5), unknownWeight(2), loops(2), loopBody(16), loopTicks(200),
+                           branchPercent(10), memoryPattern(PayloadMemoryPattern::SEQUENTIAL), requests(16),
+                           accessBytes(64), stride(4096), dataAddress(0), memoryWindow(32 * 1024) {}
+};
+
+/**
+ * @brief 载荷生成器
+ * @details 只生成合法的控制流：arm的跳转目标都在载荷内，循环都会结束，超级调用参数都指向请求表；
+ *          x86/x64的请求表地址与条数由初始寄存器提供（ebx/ecx、rbx/rcx）。
+ *          x86/x64生成周期中断时ecx同时是定时器模式，每次超级调用只提交前2条请求
+ */
+class PayloadGenerator {
+public:
+    static const uint32_t MAX_INSTRUCTIONS = 1024 * 1024;   // 主程序指令组数上限
+    static const uint32_t MAX_ARM_LOOP_BODY = 250;          // arm循环出口须在12位立即数范围内（每组最多4条指令）
+    static const uint32_t MAX_ARM_REQUESTS = 128;           // arm请求表偏移须在12位立即数范围内
+    static const uint32_t MAX_ARM_TICKS = 0xFFF;            // arm以MOV立即数设定定时器间隔
+    static const uint32_t MAX_STACK_DEPTH = 64;             // x86/x64未出栈的压栈条数上限
+
+    /**
+     * @brief 按名称套用预设的指令组成与结构
+     * @details alu：运算为主、无循环与内存访问；memory：超级调用为主，顺序访问；
+     *          loops：多个短循环、高分支密度；mixed：默认参数
+     * @return bool 名称未知时返回false
+     */
+    static bool applyProfile(const std::string& name, S_PayloadGenConfig& config);
+
+    /**
+     * @brief 生成载荷容器
+     * @return bool 架构未知或参数超出范围时返回false
+     */
+    static bool generate(const S_PayloadGenConfig& config, S_PayloadImage& image, std::string& error);
+};
+
+#endif // PAYLOAD_GENERATOR_H
@@ -0,0 +1,358 @@
+#include "payload_loader.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <sstream>
+#include <chrono>
+#include "../common/fast_hash.h"
+
+#ifdef PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const uint64_t PayloadLoader::HUGEPAGE_THRESHOLD;
+const size_t PayloadLoader::MAX_BATCH;
+const size_t PayloadLoader::MAX_CACHED_FILES;
+
+namespace {
+
+uint64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 读取文件长度与修改时间
+ * @return bool 非Linux平台或文件不存在时返回false（不使用缓存）
+ */
+bool statFile(const std::string& file, uint64_t& size, int64_t& modifiedNs) {
+#ifdef PLATFORM_LINUX
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+    size = static_cast<uint64_t>(st.st_size);
+    modifiedNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    return true;
+#else
+    (void)file;
+    (void)size;
+    (void)modifiedNs;
+    return false;
+#endif
+}
+
+/**
+ * @brief 给大块内存区间中按2MB对齐的部分加透明大页提示
+ * @return bool 提示被接受
+ */
+bool adviseHugePages(const void* data, uint64_t size) {
+#if defined(PLATFORM_LINUX) && defined(MADV_HUGEPAGE)
+    const uintptr_t hugePage = 2 * 1024 * 1024;
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + hugePage - 1) & ~(hugePage - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(data) + size) & ~(hugePage - 1);
+    return end > begin && madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE) == 0;
+#else
+    (void)data;
+    (void)size;
+    return false;
+#endif
+}
+
+} // namespace
+
+S_MappedPayloadFile::~S_MappedPayloadFile() {
+#ifdef PLATFORM_LINUX
+    if (mapped) {
+        munmap(const_cast<uint8_t*>(data), static_cast<size_t>(size));
+    }
+#endif
+}
+
+PayloadLoader::PayloadLoader()
+    : nextTicket(1), completedTicketMax(0), stopping(false), isRunning(false),
+      batchCount(0), requestCount(0), fileReads(0), cacheHits(0), batchedRequests(0), failedRequests(0),
+      bytesMapped(0), totalLoadNs(0) {}
+
+PayloadLoader::~PayloadLoader() {
+    stop();
+}
+
+void PayloadLoader::setCompletionNotifier(const std::function<void()>& notifier) {
+    completionNotifier = notifier;
+}
+
+void PayloadLoader::start(int coreId) {
+    if (isRunning) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = false;
+    }
+    isRunning = true;
+    loaderThread = std::thread(&PayloadLoader::loaderLoop, this, coreId);
+}
+
+void PayloadLoader::stop() {
+    if (!isRunning) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCV.notify_all();
+    if (loaderThread.joinable()) {
+        loaderThread.join();
+    }
+    std::lock_guard<std::mutex> lock(queueMutex);
+    isRunning = false;
+    completedCV.notify_all();
+}
+
+uint64_t PayloadLoader::submit(const std::string& file, const std::string& architecture, bool predecode) {
+    S_LoadRequest request;
+    request.file = file;
+    request.architecture = architecture;
+    request.predecode = predecode;
+    request.submitNs = monotonicNs();
+    std::lock_guard<std::mutex> lock(queueMutex);
+    request.ticket = nextTicket++;
+    pending.push_back(request);
+    queueCV.notify_one();
+    return request.ticket;
+}
+
+size_t PayloadLoader::collect(std::vector<S_PayloadLoadResult>& results) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    size_t count = completed.size();
+    for (auto& result : completed) {
+        results.push_back(std::move(result));
+    }
+    completed.clear();
+    return count;
+}
+
+bool PayloadLoader::wait(uint64_t ticket) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    completedCV.wait(lock, [this, ticket]() { return completedTicketMax >= ticket || !isRunning; });
+    return completedTicketMax >= ticket;
+}
+
+void PayloadLoader::loaderLoop(int coreId) {
+    if (coreId >= 0 && SetThreadCPUAffinity(coreId) != 0) {
+        std::cerr << "Warning: Failed to set payload loader affinity to core " << coreId << std::endl;
+    }
+
+    std::vector<S_LoadRequest> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCV.wait(lock, [this]() { return stopping || !pending.empty(); });
+            if (stopping) {
+                // 未处理的请求以失败结果完成，等待者不会挂起
+                for (const S_LoadRequest& request : pending) {
+                    S_PayloadLoadResult result;
+                    result.ticket = request.ticket;
+                    result.error = "payload loader stopped";
+                    completed.push_back(result);
+                    completedTicketMax = request.ticket;
+                }
+                pending.clear();
+                completedCV.notify_all();
+                return;
+            }
+            // 一次取出一批：突发的多个创建请求共用一轮处理与一次完成通知
+            while (!pending.empty() && batch.size() < MAX_BATCH) {
+                batch.push_back(pending.front());
+                pending.pop_front();
+            }
+        }
+        processBatch(batch);
+        batch.clear();
+        if (completionNotifier) {
+            completionNotifier();
+        }
+    }
+}
+
+void PayloadLoader::processBatch(std::vector<S_LoadRequest>& batch) {
+    std::vector<S_PayloadLoadResult> results(batch.size());
+    std::map<std::string, size_t> firstByKey;   // 同批次的同一请求内容只处理一次
+    for (size_t i = 0; i < batch.size(); i++) {
+        const S_LoadRequest& request = batch[i];
+        S_PayloadLoadResult& result = results[i];
+        result.ticket = request.ticket;
+
+        std::string key = request.file + '\0' + request.architecture + (request.predecode ? "+" : "-");
+        auto first = firstByKey.find(key);
+        if (first != firstByKey.end()) {
+            const S_PayloadLoadResult& shared = results[first->second];
+            result.ok = shared.ok;
+            result.error = shared.error;
+            result.cacheHit = shared.cacheHit;
+            result.file = shared.file;
+            result.code = shared.code;
+            result.image = shared.image;
+            result.batched = true;
+            batchedRequests.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            firstByKey[key] = i;
+            result.file = openFile(request.file, result.cacheHit, result.error);
+            if (result.file) {
+                result.ok = !request.predecode || predecode(*result.file, request.architecture, result);
+            }
+        }
+        if (!result.ok) {
+            failedRequests.fetch_add(1, std::memory_order_relaxed);
+        }
+        result.loadNs = monotonicNs() - request.submitNs;
+        totalLoadNs.fetch_add(result.loadNs, std::memory_order_relaxed);
+    }
+    batchCount.fetch_add(1, std::memory_order_relaxed);
+    requestCount.fetch_add(batch.size(), std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    for (auto& result : results) {
+        completed.push_back(std::move(result));
+    }
+    completedTicketMax = batch.back().ticket;
+    completedCV.notify_all();
+}
+
+std::shared_ptr<const S_MappedPayloadFile> PayloadLoader::openFile(const std::string& file, bool& cacheHit,
+                                                                   std::string& error) {
+    uint64_t size = 0;
+    int64_t modifiedNs = 0;
+    bool statOk = statFile(file, size, modifiedNs);
+    auto cached = cache.find(file);
+    if (cached != cache.end()) {
+        if (statOk && cached->second->size == size && cached->second->modifiedNs == modifiedNs) {
+            cacheHit = true;
+            cacheHits.fetch_add(1, std::memory_order_relaxed);
+            cacheOrder.erase(std::find(cacheOrder.begin(), cacheOrder.end(), file));
+            cacheOrder.push_back(file);
+            return cached->second;
+        }
+        // 文件已修改：丢弃旧映射（仍在使用的结果持有引用，用完后解除映射）
+        cache.erase(cached);
+        cacheOrder.erase(std::find(cacheOrder.begin(), cacheOrder.end(), file));
+    }
+
+    std::shared_ptr<S_MappedPayloadFile> mapped = std::make_shared<S_MappedPayloadFile>();
+    if (!mapFile(file, *mapped, error)) {
+        return nullptr;
+    }
+    fileReads.fetch_add(1, std::memory_order_relaxed);
+    bytesMapped.fetch_add(mapped->size, std::memory_order_relaxed);
+    if (statOk) {
+        cache[file] = mapped;
+        cacheOrder.push_back(file);
+        if (cacheOrder.size() > MAX_CACHED_FILES) {
+            cache.erase(cacheOrder.front());
+            cacheOrder.pop_front();
+        }
+    }
+    return mapped;
+}
+
+bool PayloadLoader::mapFile(const std::string& file, S_MappedPayloadFile& mapped, std::string& error) {
+    mapped.file = file;
+#ifdef PLATFORM_LINUX
+    int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "cannot open " + file;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        error = file + " is not a regular file";
+        return false;
+    }
+    mapped.size = static_cast<uint64_t>(st.st_size);
+    mapped.modifiedNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    if (mapped.size == 0) {
+        close(fd);
+        mapped.data = mapped.buffer.data();
+        mapped.fileHash = FastHash64(mapped.data, 0);
+        return true;
+    }
+    void* mapping = mmap(nullptr, static_cast<size_t>(mapped.size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        error = "mmap failed for " + file;
+        return false;
+    }
+    // 提示内核提前读入整个文件；大镜像再提示使用透明大页（文件系统不支持时忽略）
+    madvise(mapping, static_cast<size_t>(mapped.size), MADV_WILLNEED);
+    if (mapped.size >= HUGEPAGE_THRESHOLD) {
+        mapped.hugePageHint = adviseHugePages(mapping, mapped.size);
+    }
+    mapped.data = static_cast<const uint8_t*>(mapping);
+    mapped.mapped = true;
+#else
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream.is_open()) {
+        error = "cannot open " + file;
+        return false;
+    }
+    stream.seekg(0, std::ios::end);
+    mapped.size = static_cast<uint64_t>(stream.tellg());
+    stream.seekg(0, std::ios::beg);
+    mapped.buffer.resize(static_cast<size_t>(mapped.size));
+    stream.read(reinterpret_cast<char*>(mapped.buffer.data()), mapped.buffer.size());
+    if (!stream) {
+        error = "cannot read " + file;
+        return false;
+    }
+    mapped.data = mapped.buffer.data();
+#endif
+    // 计算哈希的同时把文件页全部读入
+    mapped.fileHash = FastHash64(mapped.data, static_cast<size_t>(mapped.size));
+    return true;
+}
+
+bool PayloadLoader::predecode(const S_MappedPayloadFile& mapped, const std::string& architecture,
+                              S_PayloadLoadResult& result) {
+    if (!PayloadDecode(mapped.data, static_cast<size_t>(mapped.size), result.image, result.error)) {
+        return false;
+    }
+    if (!architecture.empty() && !result.image.architecture.empty() && result.image.architecture != architecture) {
+        result.error = "payload is built for " + result.image.architecture + ", not " + architecture;
+        return false;
+    }
+    result.code = std::make_shared<std::vector<uint8_t>>();
+    if (result.image.code.size() >= HUGEPAGE_THRESHOLD) {
+        // 先预留并给出大页提示，复制时按大页分配物理内存
+        result.code->reserve(result.image.code.size());
+        adviseHugePages(result.code->data(), result.image.code.size());
+        result.code->assign(result.image.code.begin(), result.image.code.end());
+        std::vector<uint8_t>().swap(result.image.code);
+    } else {
+        result.code->swap(result.image.code);
+    }
+    return true;
+}
+
+std::string PayloadLoader::getStatistics() {
+    std::ostringstream oss;
+    size_t queued = 0;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queued = pending.size();
+    }
+    uint64_t requests = requestCount.load();
+    oss << "=== Payload Loader Statistics ===" << std::endl;
+    oss << "Running: " << (isRunning ? "YES" : "NO") << std::endl;
+    oss << "Requests: " << requests << " in " << batchCount.load() << " batches, " << queued << " queued" << std::endl;
+    oss << "File Reads: " << fileReads.load() << " (" << bytesMapped.load() << " bytes mapped), cache hits "
+        << cacheHits.load() << ", batched " << batchedRequests.load() << ", failed " << failedRequests.load()
+        << std::endl;
+    oss << "Average Load Latency: " << (requests ? totalLoadNs.load() / requests / 1000 : 0) << " us" << std::endl;
+    return oss.str();
+}
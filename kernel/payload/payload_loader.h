@@ -0,0 +1,165 @@
+#ifndef PAYLOAD_LOADER_H
+#define PAYLOAD_LOADER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "../Cross_PlatformUnifiedMacro.h"
+#include "payload_format.h"
+
+/**
+ * @brief 已映射的载荷文件
+ * @details Linux下为只读私有映射（mmap + madvise），其他平台整体读入内存；析构时解除映射
+ */
+struct S_MappedPayloadFile {
+    std::string file;
+    uint64_t size;                  // stat得到的文件长度
+    int64_t modifiedNs;             // stat得到的修改时间（缓存有效性校验）
+    uint64_t fileHash;              // 整个文件的FastHash64
+    const uint8_t* data;            // 文件内容（长度size）
+    bool mapped;                    // data来自mmap
+    bool hugePageHint;              // 已给出透明大页提示
+    std::vector<uint8_t> buffer;    // 非映射时的文件内容
+
+    S_MappedPayloadFile() : size(0), modifiedNs(0), fileHash(0), data(nullptr), mapped(false),
+                            hugePageHint(false) {}
+    ~S_MappedPayloadFile();
+    S_MappedPayloadFile(const S_MappedPayloadFile&) = delete;
+    S_MappedPayloadFile& operator=(const S_MappedPayloadFile&) = delete;
+};
+
+/**
+ * @brief 载荷加载结果
+ * @details 预解码的结果：image为入口状态（代码段已移到code），code由VM注册表持有；
+ *          只预取不预解码时code为空，file保留映射供之后解码
+ */
+struct S_PayloadLoadResult {
+    uint64_t ticket;                // submit返回的编号
+    bool ok;
+    std::string error;
+    bool cacheHit;                  // 命中预取缓存（未重新读取文件）
+    bool batched;                   // 与同批次的相同文件共用一次读取
+    uint64_t loadNs;                // 提交到完成的耗时
+    std::shared_ptr<const S_MappedPayloadFile> file;
+    std::shared_ptr<std::vector<uint8_t>> code;
+    S_PayloadImage image;
+
+    S_PayloadLoadResult() : ticket(0), ok(false), cacheHit(false), batched(false), loadNs(0) {}
+};
+
+/**
+ * @brief 异步载荷加载流水线
+ * @details 单个加载线程（默认绑定核1，即杂务核）依次对载荷文件stat、mmap、计算哈希，并可选地预解码
+ *          （解析载荷容器、校验两段哈希与架构，把代码段复制到VM注册表持有的缓冲）。
+ *          映射给出MADV_WILLNEED让内核提前读入；不小于HUGEPAGE_THRESHOLD的镜像再给出透明大页提示
+ *          （映射与代码缓冲各一次，提示失败不影响加载）。
+ *          加载线程每轮取出队列中全部请求（最多MAX_BATCH个）作为一批：同批次的同一文件只读取、解码一次，
+ *          各请求共用同一份代码缓冲（载荷对VM只读）。映射按路径缓存（修改时间或长度变化即失效），
+ *          预取过的文件创建VM时不再读盘。完成的结果放入完成队列，随后调用完成通知（在加载线程中）。
+ */
+class PayloadLoader {
+public:
+    static const uint64_t HUGEPAGE_THRESHOLD = 2 * 1024 * 1024;    // 给出大页提示的镜像大小
+    static const size_t MAX_BATCH = 64;                             // 每批最多处理的请求数
+    static const size_t MAX_CACHED_FILES = 32;                      // 映射缓存的文件数上限
+
+private:
+    struct S_LoadRequest {
+        uint64_t ticket;
+        std::string file;
+        std::string architecture;   // 预解码时校验的架构（空表示不校验）
+        bool predecode;
+        uint64_t submitNs;
+    };
+
+    std::deque<S_LoadRequest> pending;              // 待加载请求（queueMutex保护）
+    std::deque<S_PayloadLoadResult> completed;      // 已完成、未取走的结果（queueMutex保护）
+    std::mutex queueMutex;
+    std::condition_variable queueCV;                // 通知加载线程
+    std::condition_variable completedCV;            // 通知wait
+    uint64_t nextTicket;                            // 下一个编号（queueMutex保护）
+    uint64_t completedTicketMax;                    // 已完成的最大编号（按提交顺序完成，queueMutex保护）
+    bool stopping;                                  // 加载线程退出标志（queueMutex保护）
+    std::atomic<bool> isRunning;                    // 加载线程运行状态
+    std::thread loaderThread;                       // 加载线程
+    std::function<void()> completionNotifier;       // 一批完成后调用（start之前设置）
+
+    // 映射缓存，仅加载线程访问；cacheOrder按最近使用排序（末尾最新）
+    std::map<std::string, std::shared_ptr<const S_MappedPayloadFile>> cache;
+    std::deque<std::string> cacheOrder;
+
+    // 统计
+    std::atomic<uint64_t> batchCount;
+    std::atomic<uint64_t> requestCount;
+    std::atomic<uint64_t> fileReads;
+    std::atomic<uint64_t> cacheHits;
+    std::atomic<uint64_t> batchedRequests;
+    std::atomic<uint64_t> failedRequests;
+    std::atomic<uint64_t> bytesMapped;
+    std::atomic<uint64_t> totalLoadNs;
+
+    void loaderLoop(int coreId);
+    void processBatch(std::vector<S_LoadRequest>& batch);
+    std::shared_ptr<const S_MappedPayloadFile> openFile(const std::string& file, bool& cacheHit, std::string& error);
+    static bool mapFile(const std::string& file, S_MappedPayloadFile& mapped, std::string& error);
+    static bool predecode(const S_MappedPayloadFile& mapped, const std::string& architecture,
+                          S_PayloadLoadResult& result);
+
+public:
+    PayloadLoader();
+    ~PayloadLoader();
+
+    /**
+     * @brief 设置完成通知
+     * @details 在加载线程中、结果入队之后调用；start之前设置
+     */
+    void setCompletionNotifier(const std::function<void()>& notifier);
+
+    /**
+     * @brief 启动加载线程
+     * @param coreId 绑定的核心，-1表示不绑定
+     */
+    void start(int coreId = 1);
+
+    /**
+     * @brief 停止加载线程（未处理的请求以失败结果完成）
+     */
+    void stop();
+
+    /**
+     * @brief 提交加载请求，立即返回
+     * @param architecture 预解码时校验的架构（空表示不校验）
+     * @param predecode false时只stat、映射并计算哈希（预取）
+     * @return uint64_t 请求编号（从1开始）
+     */
+    uint64_t submit(const std::string& file, const std::string& architecture, bool predecode);
+
+    /**
+     * @brief 取出全部已完成的结果
+     * @return size_t 取出的结果数
+     */
+    size_t collect(std::vector<S_PayloadLoadResult>& results);
+
+    /**
+     * @brief 等待指定请求完成（结果仍需collect取出）
+     * @return bool 加载线程未运行时返回false
+     */
+    bool wait(uint64_t ticket);
+
+    bool getRunningStatus() const { return isRunning; }
+
+    /**
+     * @brief 获取加载统计信息
+     */
+    std::string getStatistics();
+};
+
+#endif // PAYLOAD_LOADER_H
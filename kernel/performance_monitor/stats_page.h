@@ -0,0 +1,220 @@
+#ifndef STATS_PAGE_H
+#define STATS_PAGE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <atomic>
+#include "../Cross_PlatformUnifiedMacro.h"
+#include "../common/seqlock.h"
+
+#ifdef PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief 共享内存统计页布局（外部监控进程与发布方共用，只依赖本头文件）
+ * @details 页面由发布方创建（POSIX共享内存），依次是：页头、全局记录、直方图记录、VM记录表。
+ *          除页头外每条记录各带一个顺序锁（SeqLock），读取方mmap之后直接读取一致的快照，
+ *          不需要系统调用，也不影响发布方。页头字段在magic写入之前全部就绪，
+ *          读取方先检查magic与version；布局不兼容时递增STATS_PAGE_VERSION。
+ *          顺序锁里的原子量必须免锁（与地址无关），才能跨进程共享。
+ */
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "stats page requires address-free lock-free atomics");
+
+static const uint32_t STATS_PAGE_MAGIC = 0x5453594D;    // "MYST"
+static const uint32_t STATS_PAGE_VERSION = 1;           // 布局版本
+static const uint32_t STATS_PAGE_MAX_CORES = 64;        // 记录的VM核心数上限
+static const uint32_t STATS_PAGE_HISTOGRAM_BUCKETS = 32; // 时间片耗时直方图桶数
+static const char* const DEFAULT_STATS_PAGE_NAME = "/myos_stats"; // 默认共享内存名称
+
+/**
+ * @brief 页头（发布方创建时写入一次）
+ */
+struct S_StatsPageHeader {
+    std::atomic<uint32_t> magic;    // 最后写入（release），读取方acquire读取后其余字段可用
+    uint32_t version;               // STATS_PAGE_VERSION
+    uint32_t totalSize;             // 页面总字节数
+    uint32_t globalOffset;          // 全局记录偏移
+    uint32_t histogramOffset;       // 直方图记录偏移
+    uint32_t vmOffset;              // VM记录表偏移
+    uint32_t vmCapacity;            // VM记录数
+    uint32_t vmRecordStride;        // 每条VM记录（含顺序锁）的字节数
+    uint32_t writerPid;             // 发布方进程ID
+    uint32_t intervalMs;            // 发布间隔
+    uint64_t createdNs;             // 创建时间（宿主单调时钟）
+};
+
+/**
+ * @brief 全局记录：调度器计数与核心归属
+ */
+struct S_StatsGlobal {
+    uint64_t publishedNs;           // 本次发布时间（宿主单调时钟，可据此判断发布方是否存活）
+    uint64_t publishCount;          // 发布次数
+    uint64_t totalInstructions;     // 全部VM已执行指令数之和
+    uint64_t timerFastForwards;     // 停机VM定时器快进次数
+    uint64_t sliceFaults;           // 时间片故障次数
+    uint64_t coreReclaims;          // 核心回收次数
+    uint64_t slicesExecuted;        // 已执行的时间片数
+    uint32_t schedulerRunning;      // 调度器运行状态
+    uint32_t vmCount;               // VM总数
+    uint32_t vmRecords;             // 写入记录表的VM数（超过容量的VM只计入vmCount）
+    uint32_t runningVms;            // 运行中的VM数
+    uint32_t haltedVms;             // 停机等待中断的VM数
+    uint32_t heldVms;               // 被控制动作挂起的VM数
+    uint32_t queuedVms;             // 动态调度队列长度
+    uint32_t staticBindings;        // 静态绑定数
+    uint32_t firstCoreId;           // coreOwners[0]对应的核心ID
+    uint32_t coreCount;             // 有效的coreOwners项数
+    uint32_t coreOwners[STATS_PAGE_MAX_CORES]; // 各VM核心当前绑定的VM（0表示空闲）
+
+    S_StatsGlobal() { std::memset(this, 0, sizeof(*this)); }
+};
+
+/**
+ * @brief 直方图记录：时间片耗时分布与摘要
+ */
+struct S_StatsHistogram {
+    uint64_t count;                 // 时间片数
+    uint64_t totalNs;               // 总耗时
+    uint64_t maxNs;                 // 最长耗时
+    uint64_t p50Ns;                 // 中位数（桶上界）
+    uint64_t p99Ns;                 // 99分位（桶上界）
+    uint64_t buckets[STATS_PAGE_HISTOGRAM_BUCKETS]; // 桶i：[2^i, 2^(i+1))纳秒
+
+    S_StatsHistogram() { std::memset(this, 0, sizeof(*this)); }
+};
+
+/**
+ * @brief VM记录（vmId为0表示空槽）
+ */
+struct S_StatsVmRecord {
+    uint32_t vmId;                  // VM ID
+    uint32_t instructions;          // 已执行指令数
+    uint8_t running;                // 运行状态
+    uint8_t halted;                 // 停机等待中断
+    uint8_t hold;                   // 未解除的控制动作（VmControlAction）
+    uint8_t lastFault;              // 最近一次故障码（VmFaultCode）
+    uint32_t reserved;
+
+    S_StatsVmRecord() { std::memset(this, 0, sizeof(*this)); }
+};
+
+typedef SeqLock<S_StatsGlobal> StatsGlobalSlot;
+typedef SeqLock<S_StatsHistogram> StatsHistogramSlot;
+typedef SeqLock<S_StatsVmRecord> StatsVmSlot;
+
+/**
+ * @brief 按容量计算各段偏移（发布方与读取方的自检共用）
+ */
+inline void ComputeStatsPageLayout(uint32_t vmCapacity, S_StatsPageHeader& header) {
+    const uint32_t align = 64;
+    uint32_t offset = (sizeof(S_StatsPageHeader) + align - 1) / align * align;
+    header.globalOffset = offset;
+    offset += (sizeof(StatsGlobalSlot) + align - 1) / align * align;
+    header.histogramOffset = offset;
+    offset += (sizeof(StatsHistogramSlot) + align - 1) / align * align;
+    header.vmOffset = offset;
+    header.vmCapacity = vmCapacity;
+    header.vmRecordStride = sizeof(StatsVmSlot);
+    header.totalSize = offset + vmCapacity * header.vmRecordStride;
+}
+
+/**
+ * @brief 统计页读取方（外部监控进程使用，只读映射）
+ */
+class StatsPageReader {
+private:
+    const uint8_t* base;
+    size_t size;
+    const S_StatsPageHeader* header;
+
+public:
+    StatsPageReader() : base(nullptr), size(0), header(nullptr) {}
+    ~StatsPageReader() { close(); }
+    StatsPageReader(const StatsPageReader&) = delete;
+    StatsPageReader& operator=(const StatsPageReader&) = delete;
+
+    /**
+     * @brief 映射统计页并校验页头
+     * @param name 共享内存名称（以/开头）
+     * @param error 失败原因
+     */
+    bool open(const std::string& name, std::string& error) {
+        close();
+#ifdef PLATFORM_LINUX
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            error = "cannot open shared memory " + name;
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(S_StatsPageHeader))) {
+            ::close(fd);
+            error = "stats page is not initialized";
+            return false;
+        }
+        void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            error = "mmap failed";
+            return false;
+        }
+        base = static_cast<const uint8_t*>(mapping);
+        size = static_cast<size_t>(st.st_size);
+        header = reinterpret_cast<const S_StatsPageHeader*>(base);
+
+        S_StatsPageHeader expected;
+        ComputeStatsPageLayout(header->vmCapacity, expected);
+        if (header->magic.load(std::memory_order_acquire) != STATS_PAGE_MAGIC) {
+            error = "stats page is not initialized";
+        } else if (header->version != STATS_PAGE_VERSION) {
+            error = "unsupported stats page version " + std::to_string(header->version);
+        } else if (header->totalSize > size || header->totalSize != expected.totalSize ||
+                   header->vmOffset != expected.vmOffset || header->vmRecordStride != expected.vmRecordStride) {
+            error = "stats page layout mismatch";
+        } else {
+            return true;
+        }
+        close();
+        return false;
+#else
+        (void)name;
+        error = "stats page requires Linux (POSIX shared memory)";
+        return false;
+#endif
+    }
+
+    void close() {
+#ifdef PLATFORM_LINUX
+        if (base) {
+            munmap(const_cast<uint8_t*>(base), size);
+        }
+#endif
+        base = nullptr;
+        size = 0;
+        header = nullptr;
+    }
+
+    const S_StatsPageHeader& getHeader() const { return *header; }
+
+    S_StatsGlobal readGlobal() const {
+        return reinterpret_cast<const StatsGlobalSlot*>(base + header->globalOffset)->load();
+    }
+
+    S_StatsHistogram readHistogram() const {
+        return reinterpret_cast<const StatsHistogramSlot*>(base + header->histogramOffset)->load();
+    }
+
+    S_StatsVmRecord readVm(uint32_t index) const {
+        return reinterpret_cast<const StatsVmSlot*>(base + header->vmOffset + index * header->vmRecordStride)->load();
+    }
+};
+
+#endif // STATS_PAGE_H
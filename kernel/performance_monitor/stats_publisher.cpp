@@ -0,0 +1,204 @@
+#include "stats_publisher.h"
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <sstream>
+
+static uint64_t MonotonicNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+StatsPagePublisher::StatsPagePublisher(const StatusWatchSource& watchSource, const Scheduler* sched)
+    : source(watchSource), scheduler(sched), page(nullptr), pageSize(0), vmCapacity(0), intervalMs(0),
+      stopping(false), publishCount(0) {}
+
+StatsPagePublisher::~StatsPagePublisher() {
+    stop();
+}
+
+bool StatsPagePublisher::start(const std::string& name, uint32_t interval, uint32_t capacity, std::string& error) {
+    if (page) {
+        error = "already publishing to " + pageName;
+        return false;
+    }
+#ifdef PLATFORM_LINUX
+    S_StatsPageHeader layout;
+    ComputeStatsPageLayout(capacity, layout);
+
+    // 已存在的同名页面（上次异常退出遗留）直接替换，读取方重新打开即可
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        error = "cannot create shared memory " + name;
+        return false;
+    }
+    if (ftruncate(fd, layout.totalSize) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        error = "cannot size shared memory " + name;
+        return false;
+    }
+    void* mapping = mmap(nullptr, layout.totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        error = "mmap failed";
+        return false;
+    }
+
+    // 新页面全零；先构造各段顺序锁，最后写magic
+    uint8_t* base = static_cast<uint8_t*>(mapping);
+    S_StatsPageHeader* header = new (base) S_StatsPageHeader();
+    ComputeStatsPageLayout(capacity, *header);
+    header->version = STATS_PAGE_VERSION;
+    header->writerPid = static_cast<uint32_t>(getpid());
+    header->intervalMs = interval;
+    header->createdNs = MonotonicNs();
+    new (base + header->globalOffset) StatsGlobalSlot();
+    new (base + header->histogramOffset) StatsHistogramSlot();
+    for (uint32_t i = 0; i < capacity; i++) {
+        new (base + header->vmOffset + i * header->vmRecordStride) StatsVmSlot();
+    }
+    header->magic.store(STATS_PAGE_MAGIC, std::memory_order_release);
+
+    page = base;
+    pageSize = layout.totalSize;
+    pageName = name;
+    vmCapacity = capacity;
+    intervalMs = interval;
+    publishCount.store(0, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = false;
+    }
+    publishOnce();
+    publishThread = std::thread(&StatsPagePublisher::publishLoop, this);
+    return true;
+#else
+    (void)name;
+    (void)interval;
+    (void)capacity;
+    error = "stats page requires Linux (POSIX shared memory)";
+    return false;
+#endif
+}
+
+void StatsPagePublisher::stop() {
+    if (!page) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+    }
+    stopCV.notify_all();
+    if (publishThread.joinable()) {
+        publishThread.join();
+    }
+#ifdef PLATFORM_LINUX
+    munmap(page, pageSize);
+    shm_unlink(pageName.c_str());
+#endif
+    page = nullptr;
+    pageSize = 0;
+}
+
+void StatsPagePublisher::publishLoop() {
+    std::unique_lock<std::mutex> lock(stopMutex);
+    while (!stopping) {
+        if (stopCV.wait_for(lock, std::chrono::milliseconds(intervalMs), [this] { return stopping; })) {
+            break;
+        }
+        lock.unlock();
+        publishOnce();
+        lock.lock();
+    }
+}
+
+void StatsPagePublisher::publishOnce() {
+    const S_StatsPageHeader* header = reinterpret_cast<const S_StatsPageHeader*>(page);
+    S_SchedulerSnapshot sched;
+    bool hasSched = source.collect(vmBuffer, sched);
+
+    // VM记录：只写内容变化的槽，未变化的槽读取方不会重试
+    S_StatsGlobal global;
+    uint32_t records = static_cast<uint32_t>(std::min<size_t>(vmBuffer.size(), vmCapacity));
+    for (uint32_t i = 0; i < vmCapacity; i++) {
+        S_StatsVmRecord record;
+        if (i < records) {
+            const S_VmStatus& status = vmBuffer[i].status;
+            record.vmId = vmBuffer[i].vmId;
+            record.instructions = status.instructions;
+            record.running = status.running ? 1 : 0;
+            record.halted = status.halted ? 1 : 0;
+            record.hold = static_cast<uint8_t>(status.hold);
+            record.lastFault = static_cast<uint8_t>(status.lastFault);
+        }
+        StatsVmSlot* slot = reinterpret_cast<StatsVmSlot*>(page + header->vmOffset + i * header->vmRecordStride);
+        S_StatsVmRecord previous = slot->load();
+        if (std::memcmp(&previous, &record, sizeof(record)) != 0) {
+            slot->store(record);
+        }
+    }
+    for (const auto& entry : vmBuffer) {
+        global.totalInstructions += entry.status.instructions;
+        if (entry.status.hold != VmControlAction::NONE) {
+            global.heldVms++;
+        } else if (entry.status.running) {
+            if (entry.status.halted) {
+                global.haltedVms++;
+            } else {
+                global.runningVms++;
+            }
+        }
+    }
+
+    global.publishedNs = MonotonicNs();
+    global.publishCount = publishCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    global.vmCount = static_cast<uint32_t>(vmBuffer.size());
+    global.vmRecords = records;
+    if (hasSched) {
+        global.schedulerRunning = sched.counters.running ? 1 : 0;
+        global.timerFastForwards = sched.counters.timerFastForwards;
+        global.sliceFaults = sched.counters.sliceFaults;
+        global.coreReclaims = sched.counters.coreReclaims;
+        global.slicesExecuted = sched.counters.slicesExecuted;
+        global.queuedVms = sched.counters.queuedVms;
+        global.staticBindings = sched.counters.staticBindings;
+        global.firstCoreId = sched.firstCoreId;
+        global.coreCount = std::min(sched.coreCount, STATS_PAGE_MAX_CORES);
+        for (uint32_t core = 0; core < global.coreCount; core++) {
+            global.coreOwners[core] = sched.coreOwners[core];
+        }
+    }
+    reinterpret_cast<StatsGlobalSlot*>(page + header->globalOffset)->store(global);
+
+    if (scheduler) {
+        S_SliceHistogram slices = scheduler->getSliceHistogram();
+        S_StatsHistogram histogram;
+        histogram.count = slices.count;
+        histogram.totalNs = slices.totalNs;
+        histogram.maxNs = slices.maxNs;
+        histogram.p50Ns = slices.percentileNs(0.50);
+        histogram.p99Ns = slices.percentileNs(0.99);
+        for (uint32_t i = 0; i < STATS_PAGE_HISTOGRAM_BUCKETS && i < SLICE_HISTOGRAM_BUCKETS; i++) {
+            histogram.buckets[i] = slices.buckets[i];
+        }
+        reinterpret_cast<StatsHistogramSlot*>(page + header->histogramOffset)->store(histogram);
+    }
+}
+
+std::string StatsPagePublisher::getStatistics() const {
+    std::ostringstream oss;
+    oss << "=== Stats Page ===" << std::endl;
+    if (!page) {
+        oss << "Not publishing" << std::endl;
+        return oss.str();
+    }
+    oss << "Name: " << pageName << std::endl;
+    oss << "Size: " << pageSize << " bytes (" << vmCapacity << " VM records)" << std::endl;
+    oss << "Interval: " << intervalMs << " ms" << std::endl;
+    oss << "Published: " << publishCount.load(std::memory_order_relaxed) << std::endl;
+    return oss.str();
+}
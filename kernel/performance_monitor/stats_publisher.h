@@ -0,0 +1,65 @@
+#ifndef STATS_PUBLISHER_H
+#define STATS_PUBLISHER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "stats_page.h"
+#include "status_watch.h"
+
+/**
+ * @brief 共享内存统计页发布方
+ * @details 后台线程按固定间隔采集调度器快照、时间片直方图与各VM发布的状态字，
+ *          写入共享内存统计页（见stats_page.h）。采集只读取无锁快照，不获取调度器锁；
+ *          外部监控进程mmap同一页面读取，不与本进程有任何交互。
+ *          页面只有这一个写者，各记录的顺序锁写入无需额外串行化。
+ */
+class StatsPagePublisher {
+private:
+    const StatusWatchSource& source;                // VM列表与调度器快照
+    const Scheduler* scheduler;                     // 时间片直方图来源（可为nullptr）
+    std::string pageName;                           // 共享内存名称
+    uint8_t* page;                                  // 映射的页面（nullptr表示未发布）
+    size_t pageSize;                                // 页面字节数
+    uint32_t vmCapacity;                            // VM记录数
+    uint32_t intervalMs;                            // 发布间隔
+    std::thread publishThread;                      // 发布线程
+    std::mutex stopMutex;                           // 配合stopCV中断等待
+    std::condition_variable stopCV;                 // 通知发布线程退出
+    bool stopping;                                  // 发布线程退出标志（stopMutex保护）
+    std::atomic<uint64_t> publishCount;             // 已发布次数
+    std::vector<S_WatchVmEntry> vmBuffer;           // 采集缓冲（仅发布线程使用）
+
+    void publishLoop();
+    void publishOnce();
+
+public:
+    StatsPagePublisher(const StatusWatchSource& watchSource, const Scheduler* sched);
+    ~StatsPagePublisher();
+    StatsPagePublisher(const StatsPagePublisher&) = delete;
+    StatsPagePublisher& operator=(const StatsPagePublisher&) = delete;
+
+    /**
+     * @brief 创建统计页并启动发布线程
+     * @param name 共享内存名称（以/开头）
+     * @param interval 发布间隔（毫秒）
+     * @param capacity VM记录数
+     * @param error 失败原因
+     */
+    bool start(const std::string& name, uint32_t interval, uint32_t capacity, std::string& error);
+
+    /**
+     * @brief 停止发布并删除共享内存（已映射的读取方仍可读取最后一次发布的内容）
+     */
+    void stop();
+
+    bool getRunningStatus() const { return page != nullptr; }
+    const std::string& getPageName() const { return pageName; }
+    std::string getStatistics() const;
+};
+
+#endif // STATS_PUBLISHER_H
@@ -0,0 +1,194 @@
+#include "status_watch.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+const char* GetWatchStateName(const S_VmStatus& status) {
+    if (status.hold != VmControlAction::NONE) {
+        return GetVmControlName(status.hold);
+    }
+    if (!status.running) {
+        return "STOPPED";
+    }
+    return status.halted ? "HALTED" : "RUNNING";
+}
+
+StatusWatchSource::StatusWatchSource() : vms(std::make_shared<const VmList>()), scheduler(nullptr) {}
+
+void StatusWatchSource::attachVm(const std::shared_ptr<I_VmInterface>& vm) {
+    if (!vm) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(updateMutex);
+    std::shared_ptr<VmList> updated = std::make_shared<VmList>(*std::atomic_load(&vms));
+    uint32_t vmId = vm->getVmId();
+    auto pos = std::lower_bound(updated->begin(), updated->end(), vmId,
+                                [](const std::shared_ptr<I_VmInterface>& entry, uint32_t id) {
+                                    return entry->getVmId() < id;
+                                });
+    if (pos != updated->end() && (*pos)->getVmId() == vmId) {
+        *pos = vm;
+    } else {
+        updated->insert(pos, vm);
+    }
+    std::atomic_store(&vms, std::shared_ptr<const VmList>(updated));
+}
+
+void StatusWatchSource::detachVm(uint32_t vmId) {
+    std::lock_guard<std::mutex> lock(updateMutex);
+    std::shared_ptr<VmList> updated = std::make_shared<VmList>(*std::atomic_load(&vms));
+    updated->erase(std::remove_if(updated->begin(), updated->end(),
+                                  [vmId](const std::shared_ptr<I_VmInterface>& entry) {
+                                      return entry->getVmId() == vmId;
+                                  }),
+                   updated->end());
+    std::atomic_store(&vms, std::shared_ptr<const VmList>(updated));
+}
+
+bool StatusWatchSource::collect(std::vector<S_WatchVmEntry>& entries, S_SchedulerSnapshot& sched) const {
+    std::shared_ptr<const VmList> current = std::atomic_load(&vms);
+    entries.resize(current->size());
+    for (size_t i = 0; i < current->size(); i++) {
+        entries[i].vmId = (*current)[i]->getVmId();
+        entries[i].status = (*current)[i]->getPublishedStatus();
+    }
+
+    const Scheduler* sch = scheduler.load(std::memory_order_acquire);
+    if (!sch) {
+        return false;
+    }
+    sched = sch->getSnapshot();
+    return true;
+}
+
+StatusWatcher::StatusWatcher(const StatusWatchSource& watchSource)
+    : source(watchSource), primed(false), sequence(0), lastHasSched(false), changeCount(0) {}
+
+std::string StatusWatcher::poll() {
+    S_SchedulerSnapshot sched;
+    bool hasSched = source.collect(currentVms, sched);
+
+    std::ostringstream body;
+    uint32_t lines = 0;
+
+    // VM状态：两个有序列表归并比较
+    int64_t instructionDelta = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < lastVms.size() || j < currentVms.size()) {
+        if (j >= currentVms.size() || (i < lastVms.size() && lastVms[i].vmId < currentVms[j].vmId)) {
+            body << "vm " << lastVms[i].vmId << " removed" << std::endl;
+            lines++;
+            i++;
+            continue;
+        }
+        const S_VmStatus& now = currentVms[j].status;
+        if (i >= lastVms.size() || currentVms[j].vmId < lastVms[i].vmId) {
+            body << "vm " << currentVms[j].vmId << (primed ? " added " : " ") << GetWatchStateName(now)
+                 << " instr " << now.instructions;
+            if (now.lastFault != VmFaultCode::NONE) {
+                body << " fault " << GetVmFaultName(now.lastFault);
+            }
+            body << std::endl;
+            lines++;
+            j++;
+            continue;
+        }
+
+        const S_VmStatus& before = lastVms[i].status;
+        const char* beforeName = GetWatchStateName(before);
+        const char* nowName = GetWatchStateName(now);
+        if (std::strcmp(beforeName, nowName) != 0 || before.lastFault != now.lastFault) {
+            body << "vm " << currentVms[j].vmId << " " << beforeName << " -> " << nowName;
+            if (before.lastFault != now.lastFault) {
+                body << " fault " << GetVmFaultName(now.lastFault);
+            }
+            body << std::endl;
+            lines++;
+        }
+        instructionDelta += static_cast<int64_t>(now.instructions) - static_cast<int64_t>(before.instructions);
+        i++;
+        j++;
+    }
+
+    // 核心归属
+    if (hasSched) {
+        for (uint32_t core = 0; core < sched.coreCount; core++) {
+            bool known = primed && lastHasSched && core < lastSched.coreCount;
+            if (known && lastSched.coreOwners[core] == sched.coreOwners[core]) {
+                continue;
+            }
+            body << "core " << (sched.firstCoreId + core) << ": ";
+            if (known) {
+                body << (lastSched.coreOwners[core] ? "VM " + std::to_string(lastSched.coreOwners[core])
+                                                    : std::string("free"))
+                     << " -> ";
+            }
+            body << (sched.coreOwners[core] ? "VM " + std::to_string(sched.coreOwners[core]) : std::string("free"))
+                 << std::endl;
+            lines++;
+        }
+    }
+
+    // 计数增量（首次输出绝对值）
+    if (hasSched) {
+        const S_SchedulerCounters& now = sched.counters;
+        if (!primed || !lastHasSched) {
+            body << "sched " << (now.running ? "running" : "stopped") << " slices " << now.slicesExecuted
+                 << " faults " << now.sliceFaults << " fast-forwards " << now.timerFastForwards
+                 << " reclaims " << now.coreReclaims << " queued " << now.queuedVms
+                 << " static " << now.staticBindings << std::endl;
+            lines++;
+        } else {
+            const S_SchedulerCounters& before = lastSched.counters;
+            std::ostringstream deltas;
+            if (now.running != before.running) {
+                deltas << (now.running ? " running" : " stopped");
+            }
+            if (now.slicesExecuted != before.slicesExecuted) {
+                deltas << " slices +" << (now.slicesExecuted - before.slicesExecuted);
+            }
+            if (now.sliceFaults != before.sliceFaults) {
+                deltas << " faults +" << (now.sliceFaults - before.sliceFaults);
+            }
+            if (now.timerFastForwards != before.timerFastForwards) {
+                deltas << " fast-forwards +" << (now.timerFastForwards - before.timerFastForwards);
+            }
+            if (now.coreReclaims != before.coreReclaims) {
+                deltas << " reclaims +" << (now.coreReclaims - before.coreReclaims);
+            }
+            if (now.queuedVms != before.queuedVms) {
+                deltas << " queued " << now.queuedVms;
+            }
+            if (now.staticBindings != before.staticBindings) {
+                deltas << " static " << now.staticBindings;
+            }
+            if (!deltas.str().empty()) {
+                body << "sched" << deltas.str() << std::endl;
+                lines++;
+            }
+        }
+    }
+    if (primed && instructionDelta != 0) {
+        body << "instructions " << (instructionDelta > 0 ? "+" : "") << instructionDelta << std::endl;
+        lines++;
+    }
+
+    lastVms.swap(currentVms);
+    if (hasSched) {
+        lastSched = sched;
+    }
+    lastHasSched = hasSched;
+    if (lines == 0 && primed) {
+        return std::string();
+    }
+
+    std::ostringstream out;
+    out << "[watch " << sequence << "] " << (primed ? "" : "baseline, ") << lastVms.size() << " VMs, "
+        << lines << (lines == 1 ? " change" : " changes") << std::endl
+        << body.str();
+    primed = true;
+    sequence++;
+    changeCount += lines;
+    return out.str();
+}
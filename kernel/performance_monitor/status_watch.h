@@ -0,0 +1,90 @@
+#ifndef STATUS_WATCH_H
+#define STATUS_WATCH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include "../CPUvm/baseVM.h"
+#include "../dispatch/scheduler.h"
+
+/**
+ * @brief 一台VM的观察记录
+ */
+struct S_WatchVmEntry {
+    uint32_t vmId;          // VM ID
+    S_VmStatus status;      // 已发布的状态
+
+    S_WatchVmEntry() : vmId(0) {}
+};
+
+/**
+ * @brief watch的数据来源：VM列表与调度器快照
+ * @details VM列表写时复制，VM创建/删除时替换（与命令串行化，频率很低）；
+ *          观察方只原子读取一次列表指针，再读取各VM发布的状态字与调度器顺序锁快照，
+ *          全程不获取终端锁、调度器锁，不与调度争用
+ */
+class StatusWatchSource {
+private:
+    typedef std::vector<std::shared_ptr<I_VmInterface>> VmList;
+
+    std::shared_ptr<const VmList> vms;              // 按VM ID升序（std::atomic_load/atomic_store访问）
+    std::mutex updateMutex;                         // 串行化列表修改
+    std::atomic<const Scheduler*> scheduler;        // 调度器（nullptr表示未初始化）
+
+public:
+    StatusWatchSource();
+    StatusWatchSource(const StatusWatchSource&) = delete;
+    StatusWatchSource& operator=(const StatusWatchSource&) = delete;
+
+    void attachVm(const std::shared_ptr<I_VmInterface>& vm);
+    void detachVm(uint32_t vmId);
+    void setScheduler(const Scheduler* sched) { scheduler.store(sched, std::memory_order_release); }
+
+    /**
+     * @brief 采集当前状态
+     * @param entries 输出的VM记录（按VM ID升序）
+     * @param sched 输出的调度器快照
+     * @return bool 调度器可用返回true（否则sched未填写）
+     */
+    bool collect(std::vector<S_WatchVmEntry>& entries, S_SchedulerSnapshot& sched) const;
+};
+
+/**
+ * @brief 一个watch观察者：与上一次输出比较，只输出变化
+ * @details 第一次poll()输出完整基线；之后只输出状态变化的VM、新增/删除的VM、
+ *          归属变化的核心与调度器计数增量，所有VM的指令数合并为一个增量。
+ *          观察者状态即上次发送的内容，跳过若干次poll()（例如连接背压）后下一次
+ *          输出的仍是相对上次发送的完整差异，不会丢失变化。只允许一个线程调用poll()。
+ */
+class StatusWatcher {
+private:
+    const StatusWatchSource& source;
+    bool primed;                                    // 已输出基线
+    uint64_t sequence;                              // 已输出的更新数
+    std::vector<S_WatchVmEntry> lastVms;            // 上次输出时的VM状态
+    S_SchedulerSnapshot lastSched;                  // 上次输出时的调度器快照
+    bool lastHasSched;                              // 上次采集时调度器可用
+    std::vector<S_WatchVmEntry> currentVms;         // 采集缓冲（复用，避免每次分配）
+    uint64_t changeCount;                           // 累计输出的变化行数
+
+public:
+    explicit StatusWatcher(const StatusWatchSource& watchSource);
+
+    /**
+     * @brief 采集并输出相对上次输出的变化
+     * @return std::string 变化文本（每行一项，以"[watch N]"标题开头）；没有变化时为空
+     */
+    std::string poll();
+
+    uint64_t getChangeCount() const { return changeCount; }
+};
+
+/**
+ * @brief VM状态的显示名称（控制动作优先，其次停机/运行/停止）
+ */
+const char* GetWatchStateName(const S_VmStatus& status);
+
+#endif // STATUS_WATCH_H
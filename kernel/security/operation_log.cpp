@@ -0,0 +1,448 @@
+#include "operation_log.h"
+#include "../Cross_PlatformUnifiedMacro.h"
+#include <fcntl.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+namespace {
+
+const size_t RECORD_OVERHEAD = sizeof(S_OpLogRecordHeader) + SHA256_DIGEST_SIZE;
+
+uint64_t wallClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+int openAppend(const std::string& filePath) {
+#ifdef PLATFORM_WINDOWS
+    return _open(filePath.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(filePath.c_str(), O_WRONLY | O_APPEND | O_CREAT, S_IRUSR | S_IWUSR);
+#endif
+}
+
+int truncateFile(int fd, uint64_t length) {
+#ifdef PLATFORM_WINDOWS
+    return _chsize_s(fd, static_cast<__int64>(length));
+#else
+    return ftruncate(fd, static_cast<off_t>(length));
+#endif
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+#ifdef PLATFORM_WINDOWS
+        int written = _write(fd, data, static_cast<unsigned int>(length));
+#else
+        ssize_t written = ::write(fd, data, length);
+#endif
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+void closeFile(int fd) {
+#ifdef PLATFORM_WINDOWS
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+bool readWholeFile(const std::string& filePath, std::vector<uint8_t>& data, bool& exists) {
+    std::ifstream file(filePath, std::ios::binary);
+    exists = file.is_open();
+    if (!exists) {
+        return true;
+    }
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    data.resize(static_cast<size_t>(size));
+    if (size > 0 && !file.read(reinterpret_cast<char*>(data.data()), size)) {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+const uint32_t OperationLog::GROUP_COMMIT_WINDOW_US;
+const uint32_t OperationLog::WRITE_RETRY_MS;
+
+OperationLog::OperationLog()
+    : fd(-1), nextSequence(0), pendingLastSequence(0), durableBytes(0), truncateNeeded(false), isRunning(false),
+      durableRecords(0), recordsAtOpen(0), appendedRecords(0), syncCount(0), bytesWritten(0), writeErrors(0) {
+    std::memset(lastHash, 0, sizeof(lastHash));
+}
+
+OperationLog::~OperationLog() {
+    close();
+}
+
+bool OperationLog::open(const std::string& filePath, std::string& error) {
+    if (fd >= 0) {
+        error = "log already open: " + path;
+        return false;
+    }
+
+    // 已有日志先完整校验，链尾状态从校验结果恢复
+    S_OpLogVerifyResult result;
+    if (!verifyFile(filePath, result)) {
+        error = "existing log failed verification: " + result.error;
+        return false;
+    }
+
+    int newFd = openAppend(filePath);
+    if (newFd < 0) {
+        error = "cannot open " + filePath;
+        return false;
+    }
+    if (result.truncatedTail && truncateFile(newFd, result.validBytes) != 0) {
+        closeFile(newFd);
+        error = "cannot truncate incomplete tail record";
+        return false;
+    }
+
+    fd = newFd;
+    path = filePath;
+    nextSequence = result.nextSequence;
+    std::memcpy(lastHash, result.lastHash, sizeof(lastHash));
+    durableRecords = result.nextSequence;
+    durableBytes = result.validBytes;
+    truncateNeeded = false;
+    recordsAtOpen = result.nextSequence;
+    appendedRecords = 0;
+
+    std::string detail = result.recordCount == 0 ? "new chain" : "resume at anchor " + hashToHex(lastHash);
+    if (result.truncatedTail) {
+        detail += " (truncated incomplete tail)";
+    }
+    append(OpLogEvent::LOG_OPEN, 0, detail);
+    return true;
+}
+
+void OperationLog::close() {
+    stop();
+    if (fd >= 0) {
+        closeFile(fd);
+        fd = -1;
+    }
+}
+
+void OperationLog::start(int coreId) {
+    if (isRunning || fd < 0) {
+        return;
+    }
+    isRunning = true;
+    writerThread = std::thread(&OperationLog::writerLoop, this, coreId);
+}
+
+void OperationLog::stop() {
+    if (!isRunning) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(appendMutex);
+        isRunning = false;
+    }
+    pendingCV.notify_one();
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+}
+
+uint64_t OperationLog::append(OpLogEvent event, uint32_t vmId, const std::string& detail) {
+    size_t detailLength = std::min<size_t>(detail.size(), OPLOG_MAX_DETAIL);
+
+    std::unique_lock<std::mutex> lock(appendMutex);
+    if (fd < 0) {
+        return 0;
+    }
+
+    S_OpLogRecordHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = OPLOG_RECORD_MAGIC;
+    header.event = static_cast<uint16_t>(event);
+    header.detailLength = static_cast<uint16_t>(detailLength);
+    header.vmId = vmId;
+    header.sequence = nextSequence;
+    header.timestampNs = wallClockNs();
+    std::memcpy(header.prevHash, lastHash, sizeof(lastHash));
+
+    size_t offset = pending.size();
+    pending.resize(offset + sizeof(header) + detailLength + SHA256_DIGEST_SIZE);
+    uint8_t* record = pending.data() + offset;
+    std::memcpy(record, &header, sizeof(header));
+    std::memcpy(record + sizeof(header), detail.data(), detailLength);
+    Sha256Digest(record, sizeof(header) + detailLength, lastHash);
+    std::memcpy(record + sizeof(header) + detailLength, lastHash, sizeof(lastHash));
+
+    pendingLastSequence = nextSequence;
+    uint64_t ticket = ++nextSequence;
+    appendedRecords.fetch_add(1, std::memory_order_relaxed);
+
+    if (isRunning) {
+        lock.unlock();
+        pendingCV.notify_one();
+        return ticket;
+    }
+
+    // 无写入线程：同步写入并落盘；失败的记录留在pending中，随下一次追加重试
+    if (writeBatch(pending)) {
+        pending.clear();
+        durableRecords.store(ticket, std::memory_order_release);
+    }
+    return ticket;
+}
+
+bool OperationLog::rollbackToDurable() {
+    if (truncateFile(fd, durableBytes) != 0) {
+        truncateNeeded = true;
+        return false;
+    }
+    truncateNeeded = false;
+    return true;
+}
+
+bool OperationLog::writeBatch(const std::vector<uint8_t>& batch) {
+    // 上次失败时未能截断：先去掉可能残留的部分记录，否则重写会在链中间留下残缺或重复的记录
+    if (truncateNeeded && !rollbackToDurable()) {
+        writeErrors.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (!writeAll(fd, batch.data(), batch.size()) || FileDataSync(fd) != 0) {
+        writeErrors.fetch_add(1, std::memory_order_relaxed);
+        rollbackToDurable();
+        return false;
+    }
+    durableBytes += batch.size();
+    syncCount.fetch_add(1, std::memory_order_relaxed);
+    bytesWritten.fetch_add(batch.size(), std::memory_order_relaxed);
+    return true;
+}
+
+void OperationLog::writerLoop(int coreId) {
+    if (coreId >= 0 && SetThreadCPUAffinity(coreId) != 0) {
+        std::cerr << "Warning: Failed to set operation log writer affinity to core " << coreId << std::endl;
+    }
+
+    std::vector<uint8_t> batch;
+    for (;;) {
+        uint64_t batchTicket;
+        {
+            std::unique_lock<std::mutex> lock(appendMutex);
+            pendingCV.wait(lock, [this] { return !pending.empty() || !isRunning; });
+            if (pending.empty()) {
+                break;
+            }
+            // 组提交：给同一突发中的后续记录一个短暂窗口，合并为一次同步
+            if (isRunning) {
+                pendingCV.wait_for(lock, std::chrono::microseconds(GROUP_COMMIT_WINDOW_US),
+                                   [this] { return !isRunning; });
+            }
+            batch.swap(pending);
+            batchTicket = pendingLastSequence + 1;
+        }
+
+        if (writeBatch(batch)) {
+            {
+                std::lock_guard<std::mutex> lock(appendMutex);
+                durableRecords.store(batchTicket, std::memory_order_release);
+            }
+            durableCV.notify_all();
+            batch.clear();
+            continue;
+        }
+
+        // 写入失败（磁盘满、I/O错误）：已链接的记录放回pending之前，间隔后重试；
+        // 停止时仍失败则放弃，文件停在最后落盘的位置，重新打开时仍可校验并续写
+        std::unique_lock<std::mutex> lock(appendMutex);
+        batch.insert(batch.end(), pending.begin(), pending.end());
+        pending.swap(batch);
+        batch.clear();
+        if (!isRunning) {
+            break;
+        }
+        pendingCV.wait_for(lock, std::chrono::milliseconds(WRITE_RETRY_MS), [this] { return !isRunning; });
+    }
+}
+
+bool OperationLog::waitDurable(uint64_t ticket, uint32_t timeoutMs) {
+    std::unique_lock<std::mutex> lock(appendMutex);
+    return durableCV.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this, ticket] {
+        return durableRecords.load(std::memory_order_acquire) >= ticket;
+    });
+}
+
+bool OperationLog::flush(uint32_t timeoutMs) {
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(appendMutex);
+        ticket = nextSequence;
+    }
+    return waitDurable(ticket, timeoutMs);
+}
+
+bool OperationLog::verifyFile(const std::string& filePath, S_OpLogVerifyResult& result, uint32_t threads,
+                              const uint8_t* anchor) {
+    result = S_OpLogVerifyResult();
+
+    std::vector<uint8_t> data;
+    bool exists = false;
+    if (!readWholeFile(filePath, data, exists)) {
+        result.error = "cannot read " + filePath;
+        return false;
+    }
+    if (!exists || data.empty()) {
+        result.valid = true;
+        return true;
+    }
+
+    // 第一遍（顺序）：记录边界、序号连续性、prevHash链接（只比较已存储的哈希）
+    std::vector<size_t> offsets;
+    size_t offset = 0;
+    const uint8_t* previousHash = result.lastHash;
+    while (offset < data.size()) {
+        if (data.size() - offset < RECORD_OVERHEAD) {
+            result.truncatedTail = true;
+            break;
+        }
+        S_OpLogRecordHeader header;
+        std::memcpy(&header, data.data() + offset, sizeof(header));
+        if (header.magic != OPLOG_RECORD_MAGIC) {
+            result.error = "bad record magic at offset " + std::to_string(offset);
+            return false;
+        }
+        size_t recordSize = RECORD_OVERHEAD + header.detailLength;
+        if (header.detailLength > OPLOG_MAX_DETAIL) {
+            result.error = "bad detail length at offset " + std::to_string(offset);
+            return false;
+        }
+        if (data.size() - offset < recordSize) {
+            result.truncatedTail = true;
+            break;
+        }
+        if (header.sequence != offsets.size()) {
+            result.error = "sequence gap: expected " + std::to_string(offsets.size()) +
+                           ", found " + std::to_string(header.sequence);
+            return false;
+        }
+        if (std::memcmp(header.prevHash, previousHash, SHA256_DIGEST_SIZE) != 0) {
+            result.error = "broken chain link at sequence " + std::to_string(header.sequence);
+            return false;
+        }
+        offsets.push_back(offset);
+        previousHash = data.data() + offset + recordSize - SHA256_DIGEST_SIZE;
+        if (anchor && !result.anchorFound && std::memcmp(previousHash, anchor, SHA256_DIGEST_SIZE) == 0) {
+            result.anchorFound = true;
+            result.anchorSequence = header.sequence;
+        }
+        offset += recordSize;
+    }
+
+    // 第二遍（并行）：重算每条记录的哈希并与存储值比较
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t recordCount = offsets.size();
+    threads = static_cast<uint32_t>(std::min<size_t>(threads, std::max<size_t>(1, recordCount / 64)));
+    std::atomic<size_t> firstBad(recordCount);
+    auto verifyRange = [&data, &offsets, &firstBad](size_t begin, size_t end) {
+        uint8_t digest[SHA256_DIGEST_SIZE];
+        for (size_t i = begin; i < end && i < firstBad.load(std::memory_order_relaxed); i++) {
+            const uint8_t* record = data.data() + offsets[i];
+            S_OpLogRecordHeader header;
+            std::memcpy(&header, record, sizeof(header));
+            size_t hashedLength = sizeof(header) + header.detailLength;
+            Sha256Digest(record, hashedLength, digest);
+            if (std::memcmp(digest, record + hashedLength, SHA256_DIGEST_SIZE) != 0) {
+                size_t current = firstBad.load(std::memory_order_relaxed);
+                while (i < current && !firstBad.compare_exchange_weak(current, i)) {
+                }
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    size_t chunk = (recordCount + threads - 1) / threads;
+    for (uint32_t t = 1; t < threads; t++) {
+        workers.emplace_back(verifyRange, t * chunk, std::min(recordCount, (t + 1) * chunk));
+    }
+    verifyRange(0, std::min(recordCount, chunk));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (firstBad.load() < recordCount) {
+        result.error = "record hash mismatch at sequence " + std::to_string(firstBad.load());
+        return false;
+    }
+
+    result.valid = true;
+    result.recordCount = recordCount;
+    result.validBytes = offset;
+    result.nextSequence = recordCount;
+    if (previousHash != result.lastHash) {
+        std::memcpy(result.lastHash, previousHash, SHA256_DIGEST_SIZE);
+    }
+    return true;
+}
+
+std::string OperationLog::hashToHex(const uint8_t hash[SHA256_DIGEST_SIZE]) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(SHA256_DIGEST_SIZE * 2, '0');
+    for (size_t i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        hex[i * 2] = digits[hash[i] >> 4];
+        hex[i * 2 + 1] = digits[hash[i] & 0x0F];
+    }
+    return hex;
+}
+
+bool OperationLog::hexToHash(const std::string& hex, uint8_t hash[SHA256_DIGEST_SIZE]) {
+    if (hex.size() != SHA256_DIGEST_SIZE * 2) {
+        return false;
+    }
+    for (size_t i = 0; i < hex.size(); i++) {
+        char c = hex[i];
+        uint8_t nibble;
+        if (c >= '0' && c <= '9') nibble = static_cast<uint8_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') nibble = static_cast<uint8_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') nibble = static_cast<uint8_t>(c - 'A' + 10);
+        else return false;
+        if (i % 2 == 0) {
+            hash[i / 2] = static_cast<uint8_t>(nibble << 4);
+        } else {
+            hash[i / 2] |= nibble;
+        }
+    }
+    return true;
+}
+
+std::string OperationLog::getStatistics() const {
+    std::ostringstream oss;
+    oss << "=== Operation Log ===" << std::endl;
+    oss << "File: " << (fd >= 0 ? path : std::string("(closed)")) << std::endl;
+    oss << "Writer Thread: " << (isRunning ? "RUNNING" : "STOPPED") << std::endl;
+    uint64_t durable = durableRecords.load(std::memory_order_acquire);
+    uint64_t syncs = syncCount.load(std::memory_order_relaxed);
+    oss << "Appended This Session: " << appendedRecords.load(std::memory_order_relaxed) << std::endl;
+    oss << "Durable Records: " << durable << std::endl;
+    oss << "Syncs: " << syncs;
+    if (syncs > 0) {
+        oss << " (" << static_cast<double>(durable - recordsAtOpen) / syncs << " records/sync)";
+    }
+    oss << std::endl;
+    oss << "Bytes Written: " << bytesWritten.load(std::memory_order_relaxed) << std::endl;
+    oss << "Write Errors: " << writeErrors.load(std::memory_order_relaxed) << std::endl;
+    return oss.str();
+}
@@ -0,0 +1,225 @@
+#ifndef OPERATION_LOG_H
+#define OPERATION_LOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include "../common/sha256.h"
+
+static const uint32_t OPLOG_RECORD_MAGIC = 0x474C504F;    // "OPLG"
+static const uint32_t OPLOG_MAX_DETAIL = 1024;             // 单条记录附加信息上限（字节）
+
+/**
+ * @brief 操作日志事件类型
+ * @details 新增类型时需同步更新GetOpLogEventName()的名称表
+ */
+enum class OpLogEvent : uint16_t {
+    LOG_OPEN            = 0,    // 日志打开（链起点或续写点）
+    VM_FORCE_STOP       = 1,    // 强制终结VM
+    VM_DELETE           = 2,    // 删除VM
+    USER_BAN            = 3,    // 封禁用户
+    USER_UNBAN          = 4,    // 解除封禁
+    CORE_UNBIND         = 5,    // 解除/回收VM核心绑定
+    QUOTA_CHANGE        = 6,    // 资源配额变更
+    FAULT_POLICY_CHANGE = 7,    // 故障策略变更
+    FAULT_ACTION        = 8,    // 故障策略对VM执行暂停/终止/隔离
+    QUARANTINE_RELEASE  = 9,    // 解除隔离
+    RATE_LIMIT_CHANGE   = 10,   // 故障日志限流参数变更
+    PAYLOAD_SWAP        = 11,   // 热替换VM载荷
+    COUNT
+};
+
+/**
+ * @brief 获取事件类型的显示名称
+ */
+inline const char* GetOpLogEventName(OpLogEvent event) {
+    static const char* const names[] = {
+        "LOG_OPEN",
+        "VM_FORCE_STOP",
+        "VM_DELETE",
+        "USER_BAN",
+        "USER_UNBAN",
+        "CORE_UNBIND",
+        "QUOTA_CHANGE",
+        "FAULT_POLICY_CHANGE",
+        "FAULT_ACTION",
+        "QUARANTINE_RELEASE",
+        "RATE_LIMIT_CHANGE",
+        "PAYLOAD_SWAP"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(OpLogEvent::COUNT),
+                  "event name table out of sync with OpLogEvent");
+    uint16_t index = static_cast<uint16_t>(event);
+    return index < static_cast<uint16_t>(OpLogEvent::COUNT) ? names[index] : "UNKNOWN";
+}
+
+/**
+ * @brief 日志记录头（64字节，按宿主字节序落盘）
+ * @details 落盘布局：记录头 + detailLength字节附加信息 + 32字节记录哈希。
+ *          记录哈希 = SHA-256(记录头 + 附加信息)，记录头中的prevHash是上一条记录的哈希，
+ *          第一条记录的prevHash全为0。修改、删除或重排任一记录都会使其后的链接校验失败。
+ */
+struct S_OpLogRecordHeader {
+    uint32_t magic;                         // OPLOG_RECORD_MAGIC
+    uint16_t event;                         // OpLogEvent
+    uint16_t detailLength;                  // 附加信息长度
+    uint32_t vmId;                          // 相关VM（0表示无）
+    uint32_t reserved;
+    uint64_t sequence;                      // 记录序号（从0连续递增）
+    uint64_t timestampNs;                   // 宿主墙钟时间（纳秒）
+    uint8_t prevHash[SHA256_DIGEST_SIZE];   // 上一条记录的哈希
+};
+
+static_assert(sizeof(S_OpLogRecordHeader) == 64, "operation log record header must stay 64 bytes");
+
+/**
+ * @brief 离线校验结果
+ */
+struct S_OpLogVerifyResult {
+    bool valid;                             // 整条链校验通过
+    bool truncatedTail;                     // 末尾存在不完整记录（写入中途崩溃）
+    uint64_t recordCount;                   // 校验通过的记录数
+    uint64_t validBytes;                    // 校验通过部分的字节数
+    uint64_t nextSequence;                  // 下一条记录应使用的序号
+    uint8_t lastHash[SHA256_DIGEST_SIZE];   // 最后一条有效记录的哈希（链锚点）
+    bool anchorFound;                       // 指定的锚点哈希出现在链中
+    uint64_t anchorSequence;                // 锚点所在记录的序号
+    std::string error;                      // 失败原因
+
+    S_OpLogVerifyResult() : valid(false), truncatedTail(false), recordCount(0), validBytes(0), nextSequence(0),
+                            anchorFound(false), anchorSequence(0) {
+        for (size_t i = 0; i < SHA256_DIGEST_SIZE; i++) {
+            lastHash[i] = 0;
+        }
+    }
+};
+
+/**
+ * @brief 防篡改操作日志
+ * @details 只追加、哈希链接的管理与安全事件日志。append()在调用线程上完成链接与哈希
+ *          （保证链顺序与序号一致）后放入待写缓冲立即返回；写入线程（默认绑定核心1）
+ *          把一批记录一次写入并只做一次FileDataSync，突发的管理操作合并为一次同步（组提交）。
+ *          写入线程未启动时append()同步写入并同步落盘。
+ *          写入或同步失败时把文件截断回最后落盘的位置，已链接的记录留在待写缓冲中重试，
+ *          文件中不会留下残缺记录，也不会出现链上缺失的记录。
+ *          打开已有日志时先完整校验：链被篡改则拒绝续写，仅末尾不完整（崩溃）时截断后续写。
+ */
+class OperationLog {
+public:
+    static const int DEFAULT_WRITER_CORE = 1;               // 写入线程默认绑定的核心
+    static const uint32_t GROUP_COMMIT_WINDOW_US = 200;     // 首条记录到达后等待同批记录的时间
+    static const uint32_t WRITE_RETRY_MS = 100;             // 写入失败后重试的间隔
+
+private:
+    int fd;                                         // 日志文件描述符（-1表示未打开）
+    std::string path;                               // 日志文件路径
+    uint64_t nextSequence;                          // 下一条记录序号
+    uint8_t lastHash[SHA256_DIGEST_SIZE];           // 链尾哈希
+    std::vector<uint8_t> pending;                   // 已链接、待写入的记录
+    uint64_t pendingLastSequence;                   // pending中最后一条记录的序号
+    uint64_t durableBytes;                          // 最后落盘位置（文件中完整、已同步的字节数）
+    bool truncateNeeded;                            // 上次写入失败，写入前先截断回durableBytes
+    std::mutex appendMutex;                         // 保护链状态与pending
+    std::condition_variable pendingCV;              // 通知写入线程
+    std::condition_variable durableCV;              // 通知等待落盘的调用方
+    std::atomic<bool> isRunning;                    // 写入线程运行状态
+    std::thread writerThread;                       // 写入线程
+
+    std::atomic<uint64_t> durableRecords;           // 已落盘的记录数（最后落盘序号+1）
+    uint64_t recordsAtOpen;                         // 打开时日志中已有的记录数
+    std::atomic<uint64_t> appendedRecords;          // 本次打开后追加的记录数
+    std::atomic<uint64_t> syncCount;                // FileDataSync次数
+    std::atomic<uint64_t> bytesWritten;             // 写入字节数
+    std::atomic<uint64_t> writeErrors;              // 写入或同步失败次数
+
+    void writerLoop(int coreId);
+    bool writeBatch(const std::vector<uint8_t>& batch);
+    bool rollbackToDurable();
+
+public:
+    OperationLog();
+    ~OperationLog();
+    OperationLog(const OperationLog&) = delete;
+    OperationLog& operator=(const OperationLog&) = delete;
+
+    /**
+     * @brief 打开（或创建）日志文件
+     * @param filePath 日志路径
+     * @param error 失败原因
+     * @return bool 已有日志校验失败或文件无法打开时返回false
+     */
+    bool open(const std::string& filePath, std::string& error);
+
+    /**
+     * @brief 关闭日志（先停止写入线程并落盘剩余记录）
+     */
+    void close();
+
+    /**
+     * @brief 启动组提交写入线程
+     * @param coreId 绑定的核心，-1表示不绑定
+     */
+    void start(int coreId = DEFAULT_WRITER_CORE);
+
+    /**
+     * @brief 停止写入线程（写完并同步剩余记录）
+     */
+    void stop();
+
+    /**
+     * @brief 追加一条记录
+     * @param event 事件类型
+     * @param vmId 相关VM
+     * @param detail 附加信息（超过OPLOG_MAX_DETAIL截断）
+     * @return 记录序号+1，日志未打开返回0
+     */
+    uint64_t append(OpLogEvent event, uint32_t vmId, const std::string& detail);
+
+    /**
+     * @brief 等待记录落盘
+     * @param ticket append()的返回值
+     * @param timeoutMs 最长等待时间
+     * @return bool 已落盘返回true
+     */
+    bool waitDurable(uint64_t ticket, uint32_t timeoutMs = 1000);
+    
+    /**
+     * @brief 等待已追加的全部记录落盘
+     */
+    bool flush(uint32_t timeoutMs = 1000);
+
+    bool isOpen() const { return fd >= 0; }
+    const std::string& getPath() const { return path; }
+
+    /**
+     * @brief 离线校验日志文件
+     * @details 先顺序检查记录边界、序号连续性与prevHash链接，再把各记录的哈希重算
+     *          分给多个线程并行完成；长日志的校验时间主要取决于SHA-256吞吐
+     * @param filePath 日志路径
+     * @param result 校验结果
+     * @param threads 并行线程数，0表示使用硬件并发数
+     * @param anchor 事先另行保存的某条记录哈希（可为空），用于发现整条链被重写
+     * @return bool 校验通过（允许末尾存在不完整记录）返回true
+     */
+    static bool verifyFile(const std::string& filePath, S_OpLogVerifyResult& result, uint32_t threads = 0,
+                           const uint8_t* anchor = nullptr);
+
+    /**
+     * @brief 把哈希转换为十六进制字符串
+     */
+    static std::string hashToHex(const uint8_t hash[SHA256_DIGEST_SIZE]);
+    
+    /**
+     * @brief 解析十六进制哈希字符串
+     * @return bool 格式错误返回false
+     */
+    static bool hexToHash(const std::string& hex, uint8_t hash[SHA256_DIGEST_SIZE]);
+
+    std::string getStatistics() const;
+};
+
+#endif // OPERATION_LOG_H
@@ -0,0 +1,119 @@
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief 指令跟踪文件格式（控制台trace dump写出，trace_decode离线解码）
+ * @details 只记录控制流不连续的位置：每条记录表示"从当前PC顺序执行count条指令，然后PC变为target"。
+ *          记录 = varint((count << 1) | kind) + zigzag varint(target - 顺序执行后的PC)，
+ *          顺序执行的指令与指令字节由解码器按载荷重建。
+ *          文件 = S_TraceFileHeader + chunkCount个(S_TraceChunkHeader + used字节记录)，块按时间先后排列；
+ *          每块头部带起始PC与指令序号，环形缓冲覆盖掉的旧块不影响后面的块解码。
+ */
+static const uint32_t TRACE_FILE_MAGIC = 0x4352544D;   // "MTRC"
+static const uint32_t TRACE_FILE_VERSION = 1;
+static const uint32_t TRACE_MAX_RECORD_BYTES = 20;      // 一条记录的最大编码长度（两个64位varint）
+
+/**
+ * @brief 跟踪记录类型
+ */
+enum class TraceRecordKind : uint8_t {
+    BRANCH  = 0,    // 指令改变了PC（跳转、中断返回），count包含该指令
+    JUMP    = 1,    // 两条指令之间PC被改变（中断投递、调试器修改、快照恢复）
+    COUNT
+};
+
+struct S_TraceFileHeader {
+    uint32_t magic;                 // TRACE_FILE_MAGIC
+    uint32_t version;               // TRACE_FILE_VERSION
+    uint32_t vmId;                  // 被跟踪的VM
+    uint32_t instructionSize;       // 指令长度（字节，定长指令集）
+    char architecture[16];          // 架构名（与gdb目标描述一致）
+    uint64_t payloadHash;           // 载荷FastHash64（解码时校验载荷一致）
+    uint64_t payloadSize;           // 载荷字节数
+    uint32_t chunkSize;             // 每块记录区字节数
+    uint32_t chunkCount;            // 文件中的块数
+    uint64_t droppedChunks;         // 环形缓冲覆盖掉的旧块数
+    uint64_t totalInstructions;     // 跟踪期间执行的指令总数
+    uint64_t tailPc;                // 最后一段顺序执行的起始PC（尚未形成记录）
+    uint64_t tailInstructions;      // 最后一段顺序执行的指令数
+};
+
+struct S_TraceChunkHeader {
+    uint64_t sequence;              // 块序号（从1开始）
+    uint64_t startPc;               // 块内第一条记录的起始PC
+    uint64_t startInstruction;      // 块起点的指令序号（跟踪开始后第几条）
+    uint32_t used;                  // 记录区已用字节数
+    uint32_t records;               // 记录数
+};
+
+inline size_t TraceWriteVarint(uint8_t* out, uint64_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+/**
+ * @return bool 数据不足或超过10字节时返回false
+ */
+inline bool TraceReadVarint(const uint8_t* data, size_t size, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (uint32_t shift = 0; shift < 64 && pos < size; shift += 7) {
+        uint8_t byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline uint64_t TraceZigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t TraceZigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * @brief 解码一个块：按顺序回调每条执行过的指令的PC
+ * @param visit 回调visit(指令序号, PC)，返回false时停止
+ * @param endPc 解码结束后的PC（下一块或尾段的起点）
+ * @param stopped 回调要求停止时置为true
+ * @return bool 记录区格式错误时返回false
+ */
+template <typename Visitor>
+bool TraceDecodeChunk(const S_TraceChunkHeader& header, const uint8_t* data, uint32_t instructionSize,
+                      Visitor& visit, uint64_t& endPc, bool& stopped) {
+    uint64_t pc = header.startPc;
+    uint64_t index = header.startInstruction;
+    size_t pos = 0;
+    for (uint32_t record = 0; record < header.records; record++) {
+        uint64_t tag = 0;
+        uint64_t delta = 0;
+        if (!TraceReadVarint(data, header.used, pos, tag) || !TraceReadVarint(data, header.used, pos, delta)) {
+            return false;
+        }
+        uint64_t count = tag >> 1;
+        for (uint64_t i = 0; i < count; i++) {
+            if (!visit(index++, pc + i * instructionSize)) {
+                stopped = true;
+                return true;
+            }
+        }
+        pc = pc + count * instructionSize + static_cast<uint64_t>(TraceZigzagDecode(delta));
+    }
+    endPc = pc;
+    return pos == header.used;
+}
+
+#endif // TRACE_FORMAT_H
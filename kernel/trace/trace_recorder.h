@@ -0,0 +1,154 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "trace_format.h"
+#include "../common/fast_hash.h"
+
+/**
+ * @brief 单个VM的压缩指令跟踪（环形块缓冲）
+ * @details 由执行VM的线程在每条指令后调用onInstruction()：顺序执行只累加计数，
+ *          PC不连续时才编码一条记录（见trace_format.h），典型代码每个基本块2~3字节。
+ *          缓冲由定长块组成，写满后覆盖最旧的块；每块头部记录起点，导出时丢弃的只是最旧的历史。
+ *          读取（导出、统计）时调用方需持有VM执行权。
+ */
+class TraceRecorder {
+public:
+    static const uint32_t CHUNK_SIZE = 4096;            // 每块记录区字节数
+    static const uint32_t MIN_CHUNKS = 2;               // 最少块数
+
+private:
+    uint32_t instructionSize;                   // 定长指令长度
+    uint32_t chunkCount;                        // 块数
+    std::vector<uint8_t> storage;               // chunkCount * CHUNK_SIZE字节记录区
+    std::vector<S_TraceChunkHeader> headers;    // 各块头部
+    uint64_t chunkSequence;                     // 已开始的块数（当前块序号）
+    bool started;                               // 已记录第一条指令
+    uint64_t nextPc;                            // 顺序执行时下一条指令的PC
+    uint64_t runStartPc;                        // 当前顺序段的起始PC
+    uint64_t pending;                           // 当前顺序段已执行的指令数
+    uint64_t totalInstructions;                 // 跟踪的指令总数
+    uint64_t totalRecords;                      // 记录总数
+    uint64_t totalBytes;                        // 编码字节总数
+
+    S_TraceChunkHeader& currentChunk() { return headers[(chunkSequence - 1) % chunkCount]; }
+
+    void openChunk() {
+        chunkSequence++;
+        S_TraceChunkHeader& header = currentChunk();
+        header.sequence = chunkSequence;
+        header.startPc = runStartPc;
+        header.startInstruction = totalInstructions - pending;
+        header.used = 0;
+        header.records = 0;
+    }
+
+    void emit(TraceRecordKind kind, uint64_t target) {
+        if (currentChunk().used + TRACE_MAX_RECORD_BYTES > CHUNK_SIZE) {
+            openChunk();
+        }
+        S_TraceChunkHeader& header = currentChunk();
+        uint8_t* out = storage.data() + static_cast<size_t>((chunkSequence - 1) % chunkCount) * CHUNK_SIZE + header.used;
+        uint64_t fallThrough = runStartPc + pending * instructionSize;
+        size_t length = TraceWriteVarint(out, (pending << 1) | static_cast<uint64_t>(kind));
+        length += TraceWriteVarint(out + length, TraceZigzagEncode(static_cast<int64_t>(target - fallThrough)));
+        header.used += static_cast<uint32_t>(length);
+        header.records++;
+        totalRecords++;
+        totalBytes += length;
+        runStartPc = target;
+        pending = 0;
+    }
+
+    static uint32_t GetChunkCount(uint32_t bufferBytes) {
+        uint32_t count = (bufferBytes + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        if (count < MIN_CHUNKS) {
+            count = MIN_CHUNKS;
+        }
+        return count;
+    }
+
+public:
+    /**
+     * @param size 定长指令长度（字节）
+     * @param bufferBytes 缓冲大小，向上取整到块，至少MIN_CHUNKS块
+     */
+    TraceRecorder(uint32_t size, uint32_t bufferBytes)
+        : instructionSize(size ? size : 1),
+          chunkCount(GetChunkCount(bufferBytes)),
+          storage(static_cast<size_t>(chunkCount) * CHUNK_SIZE), headers(chunkCount),
+          chunkSequence(0), started(false), nextPc(0), runStartPc(0), pending(0),
+          totalInstructions(0), totalRecords(0), totalBytes(0) {}
+
+    /**
+     * @brief 一条指令执行完（陷阱停下、没有执行的指令不调用）
+     * @param pcBefore 指令所在PC
+     * @param pcAfter 执行后的PC
+     */
+    void onInstruction(uint64_t pcBefore, uint64_t pcAfter) {
+        if (pcBefore != nextPc || !started) {
+            if (!started) {
+                started = true;
+                runStartPc = pcBefore;
+                openChunk();
+            } else {
+                emit(TraceRecordKind::JUMP, pcBefore);
+            }
+        }
+        pending++;
+        totalInstructions++;
+        nextPc = pcAfter;
+        if (pcAfter != pcBefore + instructionSize) {
+            emit(TraceRecordKind::BRANCH, pcAfter);
+        }
+    }
+
+    uint64_t getInstructionCount() const { return totalInstructions; }
+    uint64_t getRecordCount() const { return totalRecords; }
+    uint64_t getEncodedBytes() const { return totalBytes; }
+    uint64_t getDroppedChunks() const { return chunkSequence > chunkCount ? chunkSequence - chunkCount : 0; }
+    uint32_t getBufferBytes() const { return chunkCount * CHUNK_SIZE; }
+    size_t getBufferSize() const { return storage.size(); }
+
+    /**
+     * @brief 导出跟踪文件内容（最旧的块在前）
+     * @param code 原载荷（计算载荷哈希，解码时据此确认载荷一致）
+     */
+    void exportTrace(uint32_t vmId, const char* architecture, const uint8_t* code, size_t codeSize,
+                     std::vector<uint8_t>& out) const {
+        S_TraceFileHeader file;
+        std::memset(&file, 0, sizeof(file));
+        file.magic = TRACE_FILE_MAGIC;
+        file.version = TRACE_FILE_VERSION;
+        file.vmId = vmId;
+        file.instructionSize = instructionSize;
+        std::strncpy(file.architecture, architecture, sizeof(file.architecture) - 1);
+        file.payloadHash = code ? FastHash64(code, codeSize) : 0;
+        file.payloadSize = codeSize;
+        file.chunkSize = CHUNK_SIZE;
+        uint64_t first = chunkSequence > chunkCount ? chunkSequence - chunkCount + 1 : 1;
+        file.chunkCount = static_cast<uint32_t>(chunkSequence - first + 1);
+        if (chunkSequence == 0) {
+            file.chunkCount = 0;
+        }
+        file.droppedChunks = getDroppedChunks();
+        file.totalInstructions = totalInstructions;
+        file.tailPc = runStartPc;
+        file.tailInstructions = pending;
+
+        out.assign(reinterpret_cast<const uint8_t*>(&file), reinterpret_cast<const uint8_t*>(&file) + sizeof(file));
+        for (uint64_t sequence = first; file.chunkCount > 0 && sequence <= chunkSequence; sequence++) {
+            size_t slot = static_cast<size_t>((sequence - 1) % chunkCount);
+            const S_TraceChunkHeader& header = headers[slot];
+            const uint8_t* data = storage.data() + slot * CHUNK_SIZE;
+            out.insert(out.end(), reinterpret_cast<const uint8_t*>(&header),
+                       reinterpret_cast<const uint8_t*>(&header) + sizeof(header));
+            out.insert(out.end(), data, data + header.used);
+        }
+    }
+};
+
+#endif // TRACE_RECORDER_H
@@ -1,8 +1,23 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <fstream>
+#include <csignal>
 #include "kernel/console_terminal.h"
 
+/**
+ * @brief 命令行参数
+ */
+struct S_CommandLineOptions {
+    std::string mode;           // interactive/test/script，为空时询问用户
+    std::string scriptFile;     // 脚本文件（"-"表示标准输入）
+    std::string controlSocket;  // 控制套接字路径（为空时不启动控制服务）
+    S_ScriptOptions script;     // 脚本模式选项
+    bool showUsage;             // 只显示用法
+
+    S_CommandLineOptions() : showUsage(false) {}
+};
+
 /**
  * @brief 生成测试payload文件
  */
@@ -65,48 +80,223 @@ void showSystemInfo() {
     std::cout << "===========================================" << std::endl;
 }
 
+/**
+ * @brief 显示命令行用法
+ */
+void showUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]" << std::endl;
+    std::cout << "  --mode <interactive|test|serve>  Select operation mode without prompting" << std::endl;
+    std::cout << "                             (serve: headless, requires --control, stops on SIGINT/SIGTERM)" << std::endl;
+    std::cout << "  --control <socket>         Start the local control socket server" << std::endl;
+    std::cout << "  --script <file>            Run console commands from file at full speed" << std::endl;
+    std::cout << "  --batch                    Run console commands from stdin (same as --script -)" << std::endl;
+    std::cout << "  --no-echo                  Do not echo script commands" << std::endl;
+    std::cout << "  --no-timing                Do not print per-command timing" << std::endl;
+    std::cout << "  --stop-on-error            Stop the script at the first failed command" << std::endl;
+    std::cout << "  --help                     Show this help" << std::endl;
+    std::cout << "\nScript syntax: one console command per line; lines that do not start with a" << std::endl;
+    std::cout << "command (notes, headings) are skipped. Append '&' to run a command asynchronously;" << std::endl;
+    std::cout << "'wait' blocks until all asynchronous commands finish; 'exit' ends the script." << std::endl;
+    std::cout << "Exit status in script mode is 1 if any command failed." << std::endl;
+}
+
+/**
+ * @brief 解析命令行参数
+ * @param error 失败原因
+ * @return bool 参数不合法返回false
+ */
+bool parseCommandLine(int argc, char* argv[], S_CommandLineOptions& options, std::string& error) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            options.showUsage = true;
+        } else if (arg == "--mode" || arg == "--script" || arg == "--control") {
+            if (i + 1 >= argc) {
+                error = arg + " requires a value";
+                return false;
+            }
+            std::string value = argv[++i];
+            if (arg == "--script") {
+                options.scriptFile = value;
+                continue;
+            }
+            if (arg == "--control") {
+                options.controlSocket = value;
+                continue;
+            }
+            if (value != "interactive" && value != "test" && value != "serve") {
+                error = "invalid mode '" + value + "' (expected interactive, test or serve)";
+                return false;
+            }
+            options.mode = value;
+        } else if (arg == "--batch") {
+            options.scriptFile = "-";
+        } else if (arg == "--no-echo") {
+            options.script.echo = false;
+        } else if (arg == "--no-timing") {
+            options.script.timing = false;
+        } else if (arg == "--stop-on-error") {
+            options.script.stopOnError = true;
+        } else {
+            error = "unknown option '" + arg + "'";
+            return false;
+        }
+    }
+    
+    if (!options.scriptFile.empty()) {
+        if (!options.mode.empty()) {
+            error = "--mode cannot be combined with --script/--batch";
+            return false;
+        }
+        options.mode = "script";
+    }
+    if (options.mode == "serve" && options.controlSocket.empty()) {
+        error = "--mode serve requires --control <socket>";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 按命令行参数启动控制套接字服务
+ * @return bool 未要求启动或启动成功返回true
+ */
+bool startControlFromOptions(ConsoleTerminal& terminal, const S_CommandLineOptions& options) {
+    if (options.controlSocket.empty()) {
+        return true;
+    }
+    std::string error;
+    if (!terminal.startControlServer(options.controlSocket, error)) {
+        std::cerr << "Error: Failed to start control server: " << error << std::endl;
+        return false;
+    }
+    std::cout << "Control server listening on " << options.controlSocket << std::endl;
+    return true;
+}
+
+/**
+ * @brief 运行无界面的控制服务模式，直到收到SIGINT/SIGTERM
+ * @return 进程退出码
+ */
+int runServeMode(const S_CommandLineOptions& options) {
+#ifdef PLATFORM_WINDOWS
+    (void)options;
+    std::cerr << "Error: serve mode requires a Unix-like platform" << std::endl;
+    return 2;
+#else
+    // 在创建任何线程之前屏蔽信号，由主线程同步等待
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    
+    ConsoleTerminal terminal;
+    if (!startControlFromOptions(terminal, options)) {
+        return 1;
+    }
+    int received = 0;
+    sigwait(&signals, &received);
+    std::cout << "Received signal " << received << ", shutting down..." << std::endl;
+    return 0;
+#endif
+}
+
+/**
+ * @brief 运行脚本/批处理模式
+ * @return 进程退出码
+ */
+int runScriptMode(const S_CommandLineOptions& options) {
+    ConsoleTerminal terminal;
+    if (!startControlFromOptions(terminal, options)) {
+        return 1;
+    }
+    uint32_t failed = 0;
+    if (options.scriptFile == "-") {
+        failed = terminal.runScript(std::cin, "<stdin>", options.script);
+    } else {
+        std::ifstream scriptFile(options.scriptFile);
+        if (!scriptFile.is_open()) {
+            std::cerr << "Error: Failed to open script file: " << options.scriptFile << std::endl;
+            return 2;
+        }
+        failed = terminal.runScript(scriptFile, options.scriptFile, options.script);
+    }
+    return failed == 0 ? 0 : 1;
+}
+
 /**
  * @brief 运行交互式控制台
  */
-void runInteractiveConsole() {
+void runInteractiveConsole(const S_CommandLineOptions& options) {
     ConsoleTerminal terminal;
+    if (!startControlFromOptions(terminal, options)) {
+        return;
+    }
     terminal.start();
 }
 
 /**
  * @brief 运行自动化测试
  */
-void runAutomatedTests() {
+void runAutomatedTests(const S_CommandLineOptions& options) {
     ConsoleTerminal terminal;
+    if (!startControlFromOptions(terminal, options)) {
+        return;
+    }
     AutoTestSuite testSuite(terminal);
     testSuite.runAllTests();
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    S_CommandLineOptions options;
+    std::string error;
+    if (!parseCommandLine(argc, argv, options, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        std::cerr << "Try '" << argv[0] << " --help' for usage." << std::endl;
+        return 2;
+    }
+    if (options.showUsage) {
+        showUsage(argv[0]);
+        return 0;
+    }
+    
     try {
         showSystemInfo();
         
         // 生成测试文件
         generateTestPayloads();
         
-        // 询问用户选择模式
-        std::cout << "\nSelect operation mode:" << std::endl;
-        std::cout << "1. Interactive Console Terminal" << std::endl;
-        std::cout << "2. Automated Test Suite" << std::endl;
-        std::cout << "Enter choice (1 or 2): ";
+        if (options.mode == "script") {
+            return runScriptMode(options);
+        }
+        if (options.mode == "serve") {
+            return runServeMode(options);
+        }
         
         std::string choice;
-        std::getline(std::cin, choice);
+        if (options.mode == "interactive") {
+            choice = "1";
+        } else if (options.mode == "test") {
+            choice = "2";
+        } else {
+            // 未指定模式时询问用户
+            std::cout << "\nSelect operation mode:" << std::endl;
+            std::cout << "1. Interactive Console Terminal" << std::endl;
+            std::cout << "2. Automated Test Suite" << std::endl;
+            std::cout << "Enter choice (1 or 2): ";
+            std::getline(std::cin, choice);
+        }
         
         if (choice == "1") {
             std::cout << "\nStarting Interactive Console Terminal..." << std::endl;
-            runInteractiveConsole();
+            runInteractiveConsole(options);
         } else if (choice == "2") {
             std::cout << "\nStarting Automated Test Suite..." << std::endl;
-            runAutomatedTests();
+            runAutomatedTests(options);
         } else {
             std::cout << "Invalid choice. Starting Interactive Console Terminal..." << std::endl;
-            runInteractiveConsole();
+            runInteractiveConsole(options);
         }
         
         std::cout << "\nProgram terminated normally." << std::endl;
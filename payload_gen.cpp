@@ -0,0 +1,145 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include "kernel/hypercall/hypercall.h"
+#include "kernel/payload/payload_generator.h"
+
+/**
+ * @brief 随机合法载荷生成工具
+ * @details 按架构、种子与参数生成载荷，写出载荷容器（代码段、请求表数据段、初始寄存器与入口）；
+ *          同一参数与种子总是生成同一文件。--profile先套用预设，其后的参数再逐项覆盖。
+ *          --raw只写出代码段（入口不为0或需要数据段、初始寄存器时载荷不能按原设计运行）。
+ *
+ * 用法：payload_gen <x86|arm|x64> <output> [--profile mixed|alu|memory|loops] [--seed S] [--instructions N]
+ *                   [--mix ALU,STACK,MEMORY,TIME,UNKNOWN] [--loops N] [--loop-body N] [--loop-ticks T]
+ *                   [--branches PERCENT] [--pattern none|sequential|strided|random] [--requests N]
+ *                   [--access BYTES] [--stride BYTES] [--data-address ADDR] [--window BYTES] [--raw]
+ */
+namespace {
+
+bool ParseMix(const std::string& value, S_PayloadGenConfig& config) {
+    uint32_t* const weights[] = {
+        &config.aluWeight, &config.stackWeight, &config.memoryWeight, &config.timeWeight, &config.unknownWeight
+    };
+    size_t start = 0;
+    for (size_t i = 0; i < sizeof(weights) / sizeof(weights[0]); i++) {
+        size_t end = value.find(',', start);
+        if ((end == std::string::npos) != (i + 1 == sizeof(weights) / sizeof(weights[0]))) {
+            return false;
+        }
+        *weights[i] = static_cast<uint32_t>(std::strtoul(value.substr(start, end - start).c_str(), nullptr, 0));
+        start = end + 1;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <x86|arm|x64> <output> [--profile mixed|alu|memory|loops]"
+                  << " [--seed S] [--instructions N] [--mix ALU,STACK,MEMORY,TIME,UNKNOWN] [--loops N]"
+                  << " [--loop-body N] [--loop-ticks T] [--branches PERCENT]"
+                  << " [--pattern none|sequential|strided|random] [--requests N] [--access BYTES]"
+                  << " [--stride BYTES] [--data-address ADDR] [--window BYTES] [--raw]" << std::endl;
+        return 2;
+    }
+    S_PayloadGenConfig config;
+    config.architecture = argv[1];
+    std::string output = argv[2];
+    bool raw = false;
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--raw") {
+            raw = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return 2;
+        }
+        std::string value = argv[++i];
+        uint32_t number = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 0));
+        if (arg == "--profile") {
+            if (!PayloadGenerator::applyProfile(value, config)) {
+                std::cerr << "Unknown profile: " << value << std::endl;
+                return 2;
+            }
+        } else if (arg == "--seed") {
+            config.seed = std::strtoull(value.c_str(), nullptr, 0);
+        } else if (arg == "--instructions") {
+            config.instructions = number;
+        } else if (arg == "--mix") {
+            if (!ParseMix(value, config)) {
+                std::cerr << "Mix must be five comma-separated weights: " << value << std::endl;
+                return 2;
+            }
+        } else if (arg == "--loops") {
+            config.loops = number;
+        } else if (arg == "--loop-body") {
+            config.loopBody = number;
+        } else if (arg == "--loop-ticks") {
+            config.loopTicks = number;
+        } else if (arg == "--branches") {
+            config.branchPercent = number;
+        } else if (arg == "--pattern") {
+            if (!ParsePayloadMemoryPattern(value, config.memoryPattern)) {
+                std::cerr << "Unknown memory pattern: " << value << std::endl;
+                return 2;
+            }
+        } else if (arg == "--requests") {
+            config.requests = number;
+        } else if (arg == "--access") {
+            config.accessBytes = number;
+        } else if (arg == "--stride") {
+            config.stride = number;
+        } else if (arg == "--data-address") {
+            config.dataAddress = number;
+        } else if (arg == "--window") {
+            config.memoryWindow = number;
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    S_PayloadImage image;
+    std::string error;
+    if (!PayloadGenerator::generate(config, image, error)) {
+        std::cerr << "FAILED: " << error << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> bytes;
+    if (raw) {
+        bytes = image.code;
+    } else {
+        PayloadEncode(image, bytes);
+    }
+    std::ofstream file(output, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    if (!file) {
+        std::cerr << "FAILED: cannot write " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << output << (raw ? " (raw code)" : "") << ": " << image.architecture << ", seed "
+              << image.seed << ", " << image.code.size() << " code bytes, entry 0x" << std::hex << image.entryPc;
+    if (image.interruptEntry != PAYLOAD_NO_INTERRUPT_ENTRY) {
+        std::cout << ", timer entry 0x" << image.interruptEntry;
+    }
+    std::cout << std::dec << std::endl;
+    std::cout << "  mix alu/stack/memory/time/unknown " << config.aluWeight << "/" << config.stackWeight << "/"
+              << config.memoryWeight << "/" << config.timeWeight << "/" << config.unknownWeight << ", "
+              << config.loops << " loops, " << config.branchPercent << "% branches, "
+              << GetPayloadMemoryPatternName(config.memoryPattern) << " access" << std::endl;
+    if (!image.data.empty()) {
+        std::cout << "  " << image.data.size() / sizeof(S_HypercallRequest) << " requests at 0x" << std::hex
+                  << image.dataAddress << std::dec << ", " << config.accessBytes << " bytes each" << std::endl;
+    }
+    for (const S_PayloadRegister& reg : image.registers) {
+        std::cout << "  initial register " << reg.index << " = 0x" << std::hex << reg.value << std::dec << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include "kernel/performance_monitor/stats_page.h"
+#include "kernel/CPUvm/vmFault.h"
+
+/**
+ * @brief 共享内存统计页外部监控工具
+ * @details 只读映射控制台"perf publish"发布的统计页，按间隔打印调度器计数、核心归属、
+ *          时间片耗时摘要与各VM状态。读取只访问映射内存（顺序锁重试），不产生系统调用，
+ *          不影响被监控进程；页面内的发布时间停止前进说明发布方已退出或停止发布。
+ *          退出码：0=正常，1=无法打开统计页，2=用法错误。
+ *
+ * 用法：stats_monitor [name] [--interval MS] [--count N] [--vms]
+ */
+static void PrintSnapshot(const StatsPageReader& reader, bool showVms) {
+    const S_StatsPageHeader& header = reader.getHeader();
+    S_StatsGlobal global = reader.readGlobal();
+    S_StatsHistogram histogram = reader.readHistogram();
+
+    uint64_t nowNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    double ageMs = nowNs > global.publishedNs ? (nowNs - global.publishedNs) / 1e6 : 0.0;
+
+    std::cout << "[publish " << global.publishCount << "] pid " << header.writerPid
+              << ", age " << std::fixed << std::setprecision(1) << ageMs << " ms" << std::endl;
+    std::cout << "Scheduler: " << (global.schedulerRunning ? "running" : "stopped")
+              << ", slices " << global.slicesExecuted << ", faults " << global.sliceFaults
+              << ", fast-forwards " << global.timerFastForwards << ", reclaims " << global.coreReclaims
+              << ", queued " << global.queuedVms << ", static " << global.staticBindings << std::endl;
+    std::cout << "VMs: " << global.vmCount << " (running " << global.runningVms << ", halted " << global.haltedVms
+              << ", held " << global.heldVms << "), instructions " << global.totalInstructions << std::endl;
+    if (histogram.count > 0) {
+        std::cout << "Slice Time: avg " << (histogram.totalNs / histogram.count) << " ns, p50 <" << histogram.p50Ns
+                  << " ns, p99 <" << histogram.p99Ns << " ns, max " << histogram.maxNs << " ns ("
+                  << histogram.count << " slices)" << std::endl;
+    }
+    for (uint32_t core = 0; core < global.coreCount; core++) {
+        std::cout << "  Core " << (global.firstCoreId + core) << ": "
+                  << (global.coreOwners[core] ? "VM " + std::to_string(global.coreOwners[core]) : std::string("free"))
+                  << std::endl;
+    }
+
+    if (!showVms) {
+        return;
+    }
+    for (uint32_t i = 0; i < global.vmRecords && i < header.vmCapacity; i++) {
+        S_StatsVmRecord record = reader.readVm(i);
+        if (record.vmId == 0) {
+            continue;
+        }
+        const char* state = record.hold != 0 ? GetVmControlName(static_cast<VmControlAction>(record.hold))
+                            : !record.running ? "STOPPED"
+                            : record.halted ? "HALTED" : "RUNNING";
+        std::cout << "  VM " << record.vmId << ": " << state << ", instructions " << record.instructions;
+        if (record.lastFault != 0) {
+            std::cout << ", fault " << GetVmFaultName(static_cast<VmFaultCode>(record.lastFault));
+        }
+        std::cout << std::endl;
+    }
+    if (global.vmCount > global.vmRecords) {
+        std::cout << "  (" << (global.vmCount - global.vmRecords) << " more VMs not recorded)" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string name = DEFAULT_STATS_PAGE_NAME;
+    uint32_t intervalMs = 1000;
+    uint32_t count = 1;
+    bool showVms = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--interval" && i + 1 < argc) {
+            intervalMs = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--count" && i + 1 < argc) {
+            count = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--vms") {
+            showVms = true;
+        } else if (!arg.empty() && arg[0] == '/') {
+            name = arg;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [name] [--interval MS] [--count N] [--vms]" << std::endl;
+            return 2;
+        }
+    }
+    if (intervalMs == 0 || count == 0) {
+        std::cerr << "Interval and count must be positive" << std::endl;
+        return 2;
+    }
+
+    StatsPageReader reader;
+    std::string error;
+    if (!reader.open(name, error)) {
+        std::cerr << "FAILED: " << error << std::endl;
+        return 1;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (i > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+            std::cout << std::endl;
+        }
+        PrintSnapshot(reader, showVms);
+    }
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include "kernel/CPUvm/armVm.h"
 #include "kernel/CPUvm/x64Vm.h"
 #include "kernel/performance_monitor/performance_monitor.h"
+#include "kernel/payload/payload_generator.h"
 
 /**
  * @brief 压力测试类
@@ -15,13 +16,23 @@
 class StressTester {
 private:
     std::unique_ptr<PerformanceMonitor> perfMonitor;
-    std::vector<uint8_t> testPayload;
+    std::vector<uint8_t> testPayloads[3];   // 按x86/arm/x64排列
     
 public:
     StressTester() {
         perfMonitor.reset(new PerformanceMonitor());
-        // 创建测试payload
-        testPayload = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A};
+        // 创建测试payload：各架构生成运算为主的合法载荷（不需要数据段与初始寄存器）
+        static const char* const types[] = { "x86", "arm", "x64" };
+        for (int i = 0; i < 3; i++) {
+            S_PayloadGenConfig config;
+            config.architecture = types[i];
+            config.instructions = 1024;
+            PayloadGenerator::applyProfile("alu", config);
+            S_PayloadImage image;
+            std::string error;
+            PayloadGenerator::generate(config, image, error);
+            testPayloads[i].swap(image.code);
+        }
     }
     
     /**
@@ -51,7 +62,7 @@ public:
                     break;
             }
             
-            vm->setPayload(testPayload.data(), testPayload.size());
+            vm->setPayload(testPayloads[i % 3].data(), testPayloads[i % 3].size());
             vms.push_back(vm);
         }
         
@@ -142,8 +153,8 @@ public:
         };
         
         // 设置payload
-        for (auto& vm : vms) {
-            vm->setPayload(testPayload.data(), testPayload.size());
+        for (size_t i = 0; i < vms.size(); i++) {
+            vms[i]->setPayload(testPayloads[i].data(), testPayloads[i].size());
         }
         
         // 启动性能监控
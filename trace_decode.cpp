@@ -0,0 +1,214 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
+#include "kernel/trace/trace_format.h"
+#include "kernel/common/fast_hash.h"
+#include "kernel/payload/payload_format.h"
+
+/**
+ * @brief 指令跟踪离线解码工具
+ * @details 读取控制台"trace dump"写出的跟踪文件与VM的载荷，按记录重建完整的指令序列：
+ *          记录之间的顺序执行由载荷补全，输出每条指令的序号、PC与指令字节。
+ *          --blocks改为按基本块汇总执行次数（热点块在前）。载荷可以是创建VM时用的载荷容器或原始代码，
+ *          与控制台一样只比较代码段；哈希不一致时拒绝解码。
+ *          退出码：0=正常，1=文件错误或载荷不匹配，2=用法错误。
+ *
+ * 用法：trace_decode <trace> <payload> [--limit N] [--blocks]
+ */
+namespace {
+
+bool ReadFile(const std::string& path, std::vector<uint8_t>& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+/**
+ * @brief 逐条输出指令
+ */
+struct S_ListingVisitor {
+    const std::vector<uint8_t>& payload;
+    uint32_t instructionSize;
+    uint64_t limit;
+    uint64_t printed;
+
+    bool operator()(uint64_t index, uint64_t pc) {
+        if (printed >= limit) {
+            return false;
+        }
+        std::cout << std::setw(10) << index << "  0x" << std::hex << std::setw(8) << std::setfill('0') << pc << "  ";
+        for (uint32_t i = 0; i < instructionSize; i++) {
+            if (pc + i < payload.size()) {
+                std::cout << std::setw(2) << static_cast<uint32_t>(payload[pc + i]);
+            } else {
+                std::cout << "??";
+            }
+        }
+        std::cout << std::dec << std::setfill(' ') << std::endl;
+        printed++;
+        return true;
+    }
+};
+
+/**
+ * @brief 按基本块（PC连续的一段）统计执行次数
+ */
+struct S_BlockVisitor {
+    uint32_t instructionSize;
+    std::map<uint64_t, std::pair<uint64_t, uint64_t>> blocks;   // 起始PC -> (执行次数, 指令总数)
+    uint64_t blockStart;
+    uint64_t nextPc;
+    bool started;
+
+    bool operator()(uint64_t, uint64_t pc) {
+        if (!started || pc != nextPc) {
+            blockStart = pc;
+            blocks[blockStart].first++;
+            started = true;
+        }
+        blocks[blockStart].second++;
+        nextPc = pc + instructionSize;
+        return true;
+    }
+};
+
+/**
+ * @brief 依次解码所有块与尾段
+ */
+template <typename Visitor>
+bool DecodeTrace(const std::vector<uint8_t>& trace, const S_TraceFileHeader& header, Visitor& visit) {
+    size_t offset = sizeof(S_TraceFileHeader);
+    uint64_t pc = 0;
+    bool stopped = false;
+    for (uint32_t chunk = 0; chunk < header.chunkCount; chunk++) {
+        S_TraceChunkHeader chunkHeader;
+        if (offset + sizeof(chunkHeader) > trace.size()) {
+            return false;
+        }
+        std::memcpy(&chunkHeader, trace.data() + offset, sizeof(chunkHeader));
+        offset += sizeof(chunkHeader);
+        // 每块从上一块最后一条记录之后开始
+        if (chunkHeader.used > header.chunkSize || offset + chunkHeader.used > trace.size() ||
+            (chunk > 0 && chunkHeader.startPc != pc)) {
+            return false;
+        }
+        if (!TraceDecodeChunk(chunkHeader, trace.data() + offset, header.instructionSize, visit, pc, stopped)) {
+            return false;
+        }
+        if (stopped) {
+            return true;
+        }
+        offset += chunkHeader.used;
+    }
+    if (header.chunkCount > 0 && pc != header.tailPc) {
+        return false;
+    }
+    uint64_t tailStart = header.totalInstructions - header.tailInstructions;
+    for (uint64_t i = 0; i < header.tailInstructions; i++) {
+        if (!visit(tailStart + i, header.tailPc + i * header.instructionSize)) {
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <trace> <payload> [--limit N] [--blocks]" << std::endl;
+        return 2;
+    }
+    uint64_t limit = UINT64_MAX;
+    bool blocks = false;
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--limit" && i + 1 < argc) {
+            limit = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--blocks") {
+            blocks = true;
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<uint8_t> trace;
+    std::vector<uint8_t> fileData;
+    if (!ReadFile(argv[1], trace) || !ReadFile(argv[2], fileData)) {
+        std::cerr << "FAILED: cannot read " << (trace.empty() ? argv[1] : argv[2]) << std::endl;
+        return 1;
+    }
+    // 跟踪记录的是VM装入的代码段，载荷容器先解码
+    S_PayloadImage image;
+    std::string error;
+    if (!PayloadDecode(fileData.data(), fileData.size(), image, error)) {
+        std::cerr << "FAILED: invalid payload " << argv[2] << ": " << error << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> payload;
+    payload.swap(image.code);
+    S_TraceFileHeader header;
+    if (trace.size() < sizeof(header)) {
+        std::cerr << "FAILED: not a trace file" << std::endl;
+        return 1;
+    }
+    std::memcpy(&header, trace.data(), sizeof(header));
+    header.architecture[sizeof(header.architecture) - 1] = '\0';
+    if (header.magic != TRACE_FILE_MAGIC || header.version != TRACE_FILE_VERSION || header.instructionSize == 0) {
+        std::cerr << "FAILED: not a trace file (or unsupported version)" << std::endl;
+        return 1;
+    }
+    if (payload.size() != header.payloadSize || FastHash64(payload.data(), payload.size()) != header.payloadHash) {
+        std::cerr << "FAILED: payload does not match the traced VM's payload" << std::endl;
+        return 1;
+    }
+
+    uint64_t encoded = trace.size() - sizeof(header) - header.chunkCount * sizeof(S_TraceChunkHeader);
+    std::cout << "Trace: VM " << header.vmId << " (" << header.architecture << "), "
+              << header.totalInstructions << " instructions, " << encoded << " bytes of records";
+    if (header.totalInstructions > 0) {
+        std::cout << " (" << std::fixed << std::setprecision(2)
+                  << (8.0 * static_cast<double>(encoded) / static_cast<double>(header.totalInstructions))
+                  << " bits/instruction)";
+    }
+    std::cout << std::endl;
+    if (header.droppedChunks > 0) {
+        std::cout << "Ring buffer wrapped: " << header.droppedChunks << " oldest chunks overwritten" << std::endl;
+    }
+
+    bool ok = false;
+    if (blocks) {
+        S_BlockVisitor visitor = { header.instructionSize, {}, 0, 0, false };
+        ok = DecodeTrace(trace, header, visitor);
+        std::vector<std::pair<uint64_t, std::pair<uint64_t, uint64_t>>> sorted(visitor.blocks.begin(),
+                                                                                visitor.blocks.end());
+        std::sort(sorted.begin(), sorted.end(), [](const std::pair<uint64_t, std::pair<uint64_t, uint64_t>>& a,
+                                                   const std::pair<uint64_t, std::pair<uint64_t, uint64_t>>& b) {
+            return a.second.second > b.second.second;
+        });
+        std::cout << "Blocks: " << sorted.size() << std::endl;
+        for (size_t i = 0; i < sorted.size() && i < limit; i++) {
+            std::cout << "  0x" << std::hex << std::setw(8) << std::setfill('0') << sorted[i].first << std::dec
+                      << std::setfill(' ') << "  entered " << sorted[i].second.first << ", instructions "
+                      << sorted[i].second.second << std::endl;
+        }
+    } else {
+        S_ListingVisitor visitor = { payload, header.instructionSize, limit, 0 };
+        ok = DecodeTrace(trace, header, visitor);
+    }
+    if (!ok) {
+        std::cerr << "FAILED: corrupt trace records" << std::endl;
+        return 1;
+    }
+    return 0;
+}